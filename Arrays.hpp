@@ -2,40 +2,136 @@
 #define _ARRAYS
 
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <vector>
 #include <algorithm>
 #include <stdexcept>
+#include <cstdlib>
+#include <cstddef>
+#include <complex>
+
+// Type for sizes, offsets and strides. 64 bits wide on 64-bit
+// platforms, so arrays may hold more than 2^31 elements.
+typedef std::ptrdiff_t Index;
 
 class DimensionError : public std::runtime_error {
 public:
     DimensionError(const std::string& s) : std::runtime_error(s) {}
 };
 
+// Element types with a stable numeric code
+enum DataType {
+    UNKNOWN_TYPE = -1,
+    INT_TYPE = 0,
+    LONG_TYPE = 1,
+    FLOAT_TYPE = 2,
+    DOUBLE_TYPE = 3,
+    COMPLEX_FLOAT_TYPE = 4,
+    COMPLEX_DOUBLE_TYPE = 5,
+    CHAR_TYPE = 6,
+    POINTER_TYPE = 7
+};
+
+template <class T> struct TypeCode {
+    static const DataType value = UNKNOWN_TYPE;
+};
+template <> struct TypeCode<int> {
+    static const DataType value = INT_TYPE;
+};
+template <> struct TypeCode<long> {
+    static const DataType value = LONG_TYPE;
+};
+template <> struct TypeCode<float> {
+    static const DataType value = FLOAT_TYPE;
+};
+template <> struct TypeCode<double> {
+    static const DataType value = DOUBLE_TYPE;
+};
+template <> struct TypeCode<std::complex<float>> {
+    static const DataType value = COMPLEX_FLOAT_TYPE;
+};
+template <> struct TypeCode<std::complex<double>> {
+    static const DataType value = COMPLEX_DOUBLE_TYPE;
+};
+template <> struct TypeCode<char> {
+    static const DataType value = CHAR_TYPE;
+};
+template <> struct TypeCode<void*> {
+    static const DataType value = POINTER_TYPE;
+};
+
+// Size of the scalars that make up T
+template <class T> struct ScalarSize {
+    static const std::size_t value = sizeof(T);
+};
+template <class R> struct ScalarSize<std::complex<R>> {
+    static const std::size_t value = sizeof(R);
+};
+
+// Alignment in bytes of newly allocated arrays
+#ifndef NAR_ALIGNMENT
+#define NAR_ALIGNMENT 64
+#endif
+
+// Tag for allocating arrays whose contents will be overwritten anyway
+struct Uninitialized {};
+const Uninitialized uninitialized = {};
+
 // Array backed by shared data
 template <class T>
 class ArrayPtr {
 public:
     ArrayPtr() {}
-    ArrayPtr(int n) : data(std::make_shared<std::vector<T>>(n)), n(n) {}
+    // Zero-initialized array
+    ArrayPtr(Index n) : ArrayPtr(n, uninitialized) {
+        std::uninitialized_value_construct_n(pointer(), n);
+    }
+    // Elements are left uninitialized for trivially copyable types
+    ArrayPtr(Index n, Uninitialized) : 
+        data(allocate(n), Deallocator{n}), n(n) {
+        if (!std::is_trivially_copyable<T>::value) {
+            std::uninitialized_default_construct_n(pointer(), n);
+        }
+    }
+    // Foreign memory of n elements. release(ptr) is called 
+    // once no array refers to it anymore.
+    template <class Release>
+    ArrayPtr(T* ptr, Index n, Release release) : data(ptr, release), n(n) {}
     // Element access
-    T& operator[](int i) const {
-        return (*data)[i];
+    T& operator[](Index i) const {
+        return data.get()[i];
     }
     // Copies the contents of this array to a new array
     ArrayPtr<T> copy() const {
-        ArrayPtr<T> cp(n);
-        std::copy(data->begin(), data->end(), cp.data->begin());
+        ArrayPtr<T> cp(n, uninitialized);
+        std::uninitialized_copy_n(pointer(), n, cp.pointer());
         return cp;
     }
-    int size() const {
+    Index size() const {
         return n;
     }
     T* pointer() const {
-        return &(*data)[0];
+        return data.get();
+    }
+    static constexpr std::size_t alignment() {
+        return std::max<std::size_t>(NAR_ALIGNMENT, alignof(T));
     }
 private:
-    std::shared_ptr<std::vector<T>> data;
-    int n;
+    static T* allocate(Index n) {
+        std::size_t bytes = sizeof(T) * std::max<Index>(n, 1);
+        return static_cast<T*>(::operator new(bytes, 
+            std::align_val_t(alignment())));
+    }
+    struct Deallocator {
+        Index n;
+        void operator()(T* p) const {
+            std::destroy_n(p, n);
+            ::operator delete(p, std::align_val_t(alignment()));
+        }
+    };
+    std::shared_ptr<T> data;
+    Index n = 0;
 };
 
 // Returns true iff x in [lower,upper)
@@ -44,34 +140,144 @@ bool between_eq(T lower, T x, T upper) {
     return (lower <= x && x < upper);
 }
 
+// Returns true iff [start,end) is a range, possibly empty, within [0,n)
+inline bool valid_range(Index start, Index end, Index n) {
+    return 0 <= start && start <= end && end <= n;
+}
+
+// Copies n elements between strided buffers
+template <class T>
+void strided_copy(T* dest, Index dest_inc, 
+    const T* src, Index src_inc, Index n) {
+    if (dest_inc == 1 && src_inc == 1) {
+        std::copy(src, src + n, dest); // memmove for trivial types
+    } else {
+        for (Index i = 0; i < n; ++i) {
+            dest[dest_inc * i] = src[src_inc * i];
+        }
+    }
+}
+
+// Compares n elements of two strided buffers
+template <class T>
+bool strided_equal(const T* x, Index x_inc, 
+    const T* y, Index y_inc, Index n) {
+    if (x_inc == 1 && y_inc == 1) {
+        return std::equal(x, x + n, y); // memcmp for integral types
+    }
+    for (Index i = 0; i < n; ++i) {
+        if (x[x_inc * i] != y[y_inc * i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Copies a rows x cols block between strided buffers.
+// Walks along the unit stride dimension when there is one.
+template <class T>
+void strided_copy_2d(T* dest, Index dest_inc_row, Index dest_inc_col,
+    const T* src, Index src_inc_row, Index src_inc_col, 
+    Index rows, Index cols) {
+    if (rows <= 0 || cols <= 0) {
+        return;
+    }
+    if (dest_inc_col == 1 && src_inc_col == 1 &&
+        dest_inc_row == cols && src_inc_row == cols) {
+        strided_copy(dest, 1, src, 1, rows * cols); // Both row major
+    } else if (dest_inc_row == 1 && src_inc_row == 1 &&
+        dest_inc_col == rows && src_inc_col == rows) {
+        strided_copy(dest, 1, src, 1, rows * cols); // Both column major
+    } else if (dest_inc_row == 1 || 
+        (src_inc_row == 1 && dest_inc_col != 1)) {
+        for (Index j = 0; j < cols; ++j) {
+            strided_copy(dest + dest_inc_col * j, dest_inc_row,
+                src + src_inc_col * j, src_inc_row, rows);
+        }
+    } else {
+        for (Index i = 0; i < rows; ++i) {
+            strided_copy(dest + dest_inc_row * i, dest_inc_col,
+                src + src_inc_row * i, src_inc_col, cols);
+        }
+    }
+}
+
+// Compares two rows x cols blocks of strided buffers
+template <class T>
+bool strided_equal_2d(const T* x, Index x_inc_row, Index x_inc_col,
+    const T* y, Index y_inc_row, Index y_inc_col, 
+    Index rows, Index cols) {
+    if (rows <= 0 || cols <= 0) {
+        return true;
+    }
+    if (x_inc_col == 1 && y_inc_col == 1 &&
+        x_inc_row == cols && y_inc_row == cols) {
+        return strided_equal(x, 1, y, 1, rows * cols);
+    } else if (x_inc_row == 1 && y_inc_row == 1 &&
+        x_inc_col == rows && y_inc_col == rows) {
+        return strided_equal(x, 1, y, 1, rows * cols);
+    } else if (x_inc_row == 1 && y_inc_row == 1) {
+        for (Index j = 0; j < cols; ++j) {
+            if (!strided_equal(x + x_inc_col * j, x_inc_row,
+                y + y_inc_col * j, y_inc_row, rows)) {
+                return false;
+            }
+        }
+    } else {
+        for (Index i = 0; i < rows; ++i) {
+            if (!strided_equal(x + x_inc_row * i, x_inc_col,
+                y + y_inc_row * i, y_inc_col, cols)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Lazy elementwise expressions, defined below
+template <class E> class VectorExpression;
+template <class E> class MatrixExpression;
+
 // A strided vector
 template <class T>
 class Vector {
 public:
     Vector() {}
-    Vector(int n) : n(n), data(ArrayPtr<T>(n)) {}
+    Vector(Index n) : n(n), data(ArrayPtr<T>(n)) {}
+    Vector(Index n, Uninitialized) : 
+        n(n), data(ArrayPtr<T>(n, uninitialized)) {}
     // Create Vector from parts
-    Vector(const ArrayPtr<T>& data, int offset, int inc, int n) :
+    Vector(const ArrayPtr<T>& data, Index offset, Index inc, Index n) :
         data(data), offset(offset), inc(inc), n(n) {}
     // Create Vector from the given data
     Vector(const std::vector<T>& x) :
-    data(ArrayPtr<T>(x.size())), n(x.size()) {
-        for (int i = 0; i < n; ++i) {
-            data[i] = x[i];
-        }
+    data(ArrayPtr<T>(x.size(), uninitialized)), n(x.size()) {
+        std::copy(x.begin(), x.end(), data.pointer());
+    }
+    // Create Vector from the value of an expression
+    template <class E>
+    Vector(const VectorExpression<E>& e) : Vector(e.size(), uninitialized) {
+        assign(e);
+    }
+    // Like assigning a vector, makes this a view of new elements, here
+    // holding the value of the expression. assign overwrites the
+    // elements of this view instead.
+    template <class E>
+    Vector<T>& operator=(const VectorExpression<E>& e) {
+        return *this = Vector<T>(e);
     }
     // 0-based indexing!
-    int get_index(int i) const {
+    Index get_index(Index i) const {
         return offset + inc * i;
     }
-    bool in_range(int i) const {
-        return between_eq(0, i, n);
+    bool in_range(Index i) const {
+        return between_eq<Index>(0, i, n);
     }
     // Referencing
-    T& operator[](int i) const {
+    T& operator[](Index i) const {
         return data[get_index(i)];
     }
-    T& at(int i) const {
+    T& at(Index i) const {
         if (!in_range(i)) {
             throw std::out_of_range("Vector index is out of range.");
         } else {
@@ -83,40 +289,68 @@ public:
         if (v.get_n() != n) {
             throw DimensionError(
                 "Can't assign vectors with different dimensions.");
-        } else {
-            for (int i = 0; i < n; ++i) {
-                operator[](i) = v[i];
-            }
+        } else if (n > 0) {
+            strided_copy(pointer(), inc, v.pointer(), v.get_inc(), n);
         }
     }
+    // Overwrite this vector with the value of an expression, in one pass
+    template <class E>
+    void assign(const VectorExpression<E>& e) {
+        if (e.size() != n) {
+            throw DimensionError(
+                "Can't assign vectors with different dimensions.");
+        }
+        e.evaluate_into(pointer(), inc);
+    }
     // Equality
     bool operator==(const Vector<T>& other) const {
         if (n != other.get_n()) {
             return false;
         }
-        for (int i = 0; i < n; ++i) {
-            if (operator[](i) != other[i]) {
-                return false;
-            }
+        if (n == 0) {
+            return true;
         }
-        return true;
+        return strided_equal(pointer(), inc, 
+            other.pointer(), other.get_inc(), n);
     }
     // Slicing
     template <bool safe=false>
-    Vector<T> slice(int start, int end) const {
-        if (!in_range(start) || !in_range(end-1)) {
+    Vector<T> slice(Index start, Index end) const {
+        if (!valid_range(start, end, n)) {
             throw std::out_of_range("Vector index is out of range.");
         }
-        int new_offset = get_index(start);
-        int new_n = end - start;
-        int new_inc = inc;
+        Index new_offset = get_index(start);
+        Index new_n = end - start;
+        Index new_inc = inc;
         return Vector<T>(data, new_offset, new_inc, new_n);
     }
+    // Copies the elements at indices idx[0..count) to out
+    template <bool safe=false, class I>
+    void gather(T* out, const I* idx, Index count) const {
+        if (safe) {
+            check_indices(idx, count);
+        }
+        const T* p = pointer();
+        for (Index k = 0; k < count; ++k) {
+            out[k] = p[inc * idx[k]];
+        }
+    }
+    // Writes in[0..count) to the elements at indices idx[0..count)
+    template <bool safe=false, class I>
+    void scatter(const I* idx, Index count, const T* in) const {
+        if (safe) {
+            check_indices(idx, count);
+        }
+        T* p = pointer();
+        for (Index k = 0; k < count; ++k) {
+            p[inc * idx[k]] = in[k];
+        }
+    }
     // Copies contents of Vector to a new Vector
     Vector<T> copy() const {
-        Vector<T> cp(n);
-        for (int i = 0; i < n; ++i) {
-            cp[i] = operator[](i);
+        Vector<T> cp(n, uninitialized);
+        if (n > 0) {
+            strided_copy(cp.pointer(), 1, pointer(), inc, n);
         }
         return cp;
     }
@@ -124,13 +358,33 @@ public:
     T* pointer() const { // to first element
         return data.pointer() + offset;
     }
-    int get_inc() const {return inc;} // stride
-    int get_n() const {return n;}
+    Index get_inc() const {return inc;} // stride
+    Index get_n() const {return n;}
 private:
+    template <class I>
+    void check_indices(const I* idx, Index count) const {
+        for (Index k = 0; k < count; ++k) {
+            if (!in_range(idx[k])) {
+                throw std::out_of_range("Vector index is out of range.");
+            }
+        }
+    }
     ArrayPtr<T> data;
-    int offset = 0, inc = 1, n;
+    Index offset = 0, inc = 1, n = 0;
 };
 
+// Vector over existing memory starting at ptr.
+// release(ptr) is called when the last view is destroyed.
+template <class T, class Release>
+Vector<T> wrap_vector(T* ptr, Index n, Index inc, Release release) {
+    // Lowest address touched (for negative strides)
+    Index first = (n > 0 && inc < 0) ? (n-1)*inc : 0;
+    Index extent = (n > 0) ? (n-1)*std::abs(inc) + 1 : 0;
+    ArrayPtr<T> data(ptr + first, extent, 
+        [ptr, release](T*) { release(ptr); });
+    return Vector<T>(data, -first, inc, n);
+}
+
 enum MatrixOrder {
     ROW_MAJOR_ORDER = 0,
     COL_MAJOR_ORDER = 1,
@@ -142,34 +396,46 @@ template <class T>
 class Matrix {
 public:
     Matrix() {}
-    Matrix(int rows, int cols, bool row_major = true) : 
+    Matrix(Index rows, Index cols, bool row_major = true) : 
     rows(rows), cols(cols),
     data(ArrayPtr<T>(rows * cols)) {
-        if (row_major) {
-            inc_row = cols;
-            inc_col = 1;
-        } else { // Column major
-            inc_row = 1;
-            inc_col = rows;
-        }
+        set_order(row_major);
+    }
+    Matrix(Index rows, Index cols, bool row_major, Uninitialized) : 
+    rows(rows), cols(cols),
+    data(ArrayPtr<T>(rows * cols, uninitialized)) {
+        set_order(row_major);
     }
-    Matrix(const ArrayPtr<T>& data, int offset, 
-        int inc_row, int inc_col, int rows, int cols) :
+    Matrix(const ArrayPtr<T>& data, Index offset, 
+        Index inc_row, Index inc_col, Index rows, Index cols) :
         data(data), offset(offset), 
         inc_row(inc_row), inc_col(inc_col), 
         rows(rows), cols(cols) {}
+    // Create a row major Matrix from the value of an expression
+    template <class E>
+    Matrix(const MatrixExpression<E>& e) : 
+        Matrix(e.get_rows(), e.get_cols(), true, uninitialized) {
+        assign(e);
+    }
+    // Like assigning a matrix, makes this a view of a new row major
+    // matrix holding the value of the expression. assign overwrites the
+    // elements of this view instead.
+    template <class E>
+    Matrix<T>& operator=(const MatrixExpression<E>& e) {
+        return *this = Matrix<T>(e);
+    }
     // Referencing
-    int get_index(int i, int j) const {
+    Index get_index(Index i, Index j) const {
         return offset + inc_row*i + inc_col*j;
     }
-    bool in_range(int i, int j) const {
-        return between_eq(0, i, rows) &&
-            between_eq(0, j, cols);
+    bool in_range(Index i, Index j) const {
+        return between_eq<Index>(0, i, rows) &&
+            between_eq<Index>(0, j, cols);
     }
-    T& operator()(int i, int j) const {
+    T& operator()(Index i, Index j) const {
         return data[get_index(i,j)];
     }
-    T& at(int i, int j) const {
+    T& at(Index i, Index j) const {
         if (!in_range(i,j)) {
             throw std::out_of_range(
                 "Matrix subscripts are out of range.");
@@ -182,68 +448,97 @@ public:
         if (mat.get_rows() != rows || mat.get_cols() != cols) {
             throw DimensionError(
                 "Can't assign matrices with different dimensions.");
-        } else {
-            for (int i = 0; i < rows; ++i) {
-                for (int j = 0; j < cols; ++j) {
-                    operator()(i,j) = mat(i,j);
-                }
-            }
+        } else if (rows > 0 && cols > 0) {
+            strided_copy_2d(pointer(), inc_row, inc_col,
+                mat.pointer(), mat.get_inc_row(), mat.get_inc_col(),
+                rows, cols);
         }
     }
+    // Overwrite this matrix with the value of an expression, in one pass
+    template <class E>
+    void assign(const MatrixExpression<E>& e) {
+        if (e.get_rows() != rows || e.get_cols() != cols) {
+            throw DimensionError(
+                "Can't assign matrices with different dimensions.");
+        }
+        e.evaluate_into(pointer(), inc_row, inc_col);
+    }
     // Equality
     bool operator==(const Matrix& other) const {
         if (rows != other.get_rows() || 
             cols != other.get_cols()) {
                 return false;
         }
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                if (operator()(i,j) != other(i,j)) {
-                    return false;
-                }
-            }
+        if (rows == 0 || cols == 0) {
+            return true;
         }
-        return true;
+        return strided_equal_2d(pointer(), inc_row, inc_col,
+            other.pointer(), other.get_inc_row(), other.get_inc_col(),
+            rows, cols);
     }
     // Slicing
     template <bool safe=false>
-    Vector<T> row(int i) const {
+    Vector<T> row(Index i) const {
         if (safe && !in_range(i, 0)) {
             throw std::out_of_range("Row index is out of range.");
         }
-        int new_offset = get_index(i, 0);
-        int new_inc = inc_col;
-        int new_n = cols;
+        Index new_offset = get_index(i, 0);
+        Index new_inc = inc_col;
+        Index new_n = cols;
         return Vector<T>(data, new_offset, new_inc, new_n);
     }
     template <bool safe=false>
-    Vector<T> col(int j) const {
+    Vector<T> col(Index j) const {
         if (safe && !in_range(0, j)) {
             throw std::out_of_range("Column index is out of range.");
         }
-        int new_offset = get_index(0, j);
-        int new_inc = inc_row;
-        int new_n = rows;
+        Index new_offset = get_index(0, j);
+        Index new_inc = inc_row;
+        Index new_n = rows;
         return Vector<T>(data, new_offset, new_inc, new_n);
     }
     // Returns part of matrix from [start_row, end_row)
     // and [start_col, end_col)
     template <bool safe=false>
-    Matrix<T> subarray(int start_row, int start_col, 
-    int end_row, int end_col) const {
+    Matrix<T> subarray(Index start_row, Index start_col, 
+    Index end_row, Index end_col) const {
         if (safe) {
-            if (!in_range(start_row, start_col) ||
-                !in_range(end_row-1, end_col-1)) {
+            if (!valid_range(start_row, end_row, rows) ||
+                !valid_range(start_col, end_col, cols)) {
                 throw std::out_of_range(
                     "Subarray indices are out of range.");
             }
         }
-        int new_offset = get_index(start_row, start_col);
-        int new_rows = end_row - start_row;
-        int new_cols = end_col - start_col;
+        Index new_offset = get_index(start_row, start_col);
+        Index new_rows = end_row - start_row;
+        Index new_cols = end_col - start_col;
         return Matrix<T>(data, new_offset, inc_row, inc_col,
             new_rows, new_cols);
     }
+    // Copies the elements at (rows_idx[k], cols_idx[k]) to out[k]
+    template <bool safe=false, class I>
+    void gather(T* out, const I* rows_idx, const I* cols_idx, 
+        Index count) const {
+        if (safe) {
+            check_indices(rows_idx, cols_idx, count);
+        }
+        const T* p = pointer();
+        for (Index k = 0; k < count; ++k) {
+            out[k] = p[inc_row * rows_idx[k] + inc_col * cols_idx[k]];
+        }
+    }
+    // Writes in[k] to the elements at (rows_idx[k], cols_idx[k])
+    template <bool safe=false, class I>
+    void scatter(const I* rows_idx, const I* cols_idx, Index count, 
+        const T* in) const {
+        if (safe) {
+            check_indices(rows_idx, cols_idx, count);
+        }
+        T* p = pointer();
+        for (Index k = 0; k < count; ++k) {
+            p[inc_row * rows_idx[k] + inc_col * cols_idx[k]] = in[k];
+        }
+    }
     // Returns the matrix storage order
     MatrixOrder get_order() const {
         if (inc_col == 1) {
@@ -256,11 +551,10 @@ public:
     }
     // Copies contents to a new matrix
     Matrix<T> copy() const {
-        Matrix<T> cp(rows, cols);
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                cp(i,j) = operator()(i,j);
-            }
+        Matrix<T> cp(rows, cols, true, uninitialized);
+        if (rows > 0 && cols > 0) {
+            strided_copy_2d(cp.pointer(), cols, 1,
+                pointer(), inc_row, inc_col, rows, cols);
         }
         return cp;
     }
@@ -268,7 +562,7 @@ public:
     T* pointer() const {
         return data.pointer() + offset;
     }
-    int get_ld() const { // Get leading dimension
+    Index get_ld() const { // Get leading dimension
         switch (get_order()) {
             case ROW_MAJOR_ORDER: 
                 return inc_row;
@@ -282,12 +576,380 @@ public:
                 break;
         }
     }
-    int get_rows() const {return rows;}
-    int get_cols() const {return cols;}
+    Index get_rows() const {return rows;}
+    Index get_cols() const {return cols;}
+    Index get_inc_row() const {return inc_row;} // strides
+    Index get_inc_col() const {return inc_col;}
 private:
+    template <class I>
+    void check_indices(const I* rows_idx, const I* cols_idx, 
+        Index count) const {
+        for (Index k = 0; k < count; ++k) {
+            if (!in_range(rows_idx[k], cols_idx[k])) {
+                throw std::out_of_range(
+                    "Matrix subscripts are out of range.");
+            }
+        }
+    }
+    // Contiguous strides for a newly allocated matrix
+    void set_order(bool row_major) {
+        if (row_major) {
+            inc_row = cols;
+            inc_col = 1;
+        } else { // Column major
+            inc_row = 1;
+            inc_col = rows;
+        }
+    }
     ArrayPtr<T> data;
-    int offset = 0, inc_row = 0, inc_col = 0;
-    int rows = 0, cols = 0;
+    Index offset = 0, inc_row = 0, inc_col = 0;
+    Index rows = 0, cols = 0;
+};
+
+// Matrix over existing memory starting at ptr.
+// release(ptr) is called when the last view is destroyed.
+template <class T, class Release>
+Matrix<T> wrap_matrix(T* ptr, Index rows, Index cols, 
+    Index inc_row, Index inc_col, Release release) {
+    Index first = 0, extent = 0;
+    if (rows > 0 && cols > 0) {
+        Index last = 0;
+        // Lowest and highest offsets touched
+        for (Index d : {(rows-1)*inc_row, (cols-1)*inc_col}) {
+            if (d < 0) {
+                first += d;
+            } else {
+                last += d;
+            }
+        }
+        extent = last - first + 1;
+    }
+    ArrayPtr<T> data(ptr + first, extent, 
+        [ptr, release](T*) { release(ptr); });
+    return Matrix<T>(data, -first, inc_row, inc_col, rows, cols);
+}
+
+// Elementwise arithmetic. +, -, * and / on vectors, matrices and
+// scalars build an expression that is evaluated in a single pass when
+// it's assigned, so y = a*x + b*z - w makes no temporaries. As with
+// arrays, = makes y a view of new elements, while y.assign(a*x + b*z - w)
+// overwrites y's own. An operand may be the array assigned to, but not
+// another view that overlaps it. * and / are elementwise for two arrays.
+// Scalars and elements are combined in their common type, as in C++
+// arithmetic. Expressions hold views of their operands.
+
+// Leaves and nodes of expressions. line(o, by_rows) gives the operand
+// of row o, or column o if !by_rows, as a node whose leaves are
+// StridedOperands. get<unit>(i) reads element i of such a line, where
+// unit says all of its strides are 1.
+
+// n elements p[i * inc]
+template <class T>
+struct StridedOperand {
+    typedef T value_type;
+    const T* p;
+    Index inc;
+    template <bool unit>
+    T get(Index i) const {
+        return unit ? p[i] : p[i * inc];
+    }
+    bool unit_stride() const {
+        return inc == 1;
+    }
+};
+
+template <class T>
+struct ScalarOperand {
+    typedef T value_type;
+    T x;
+    ScalarOperand<T> line(Index, bool) const {
+        return *this;
+    }
+    template <bool unit>
+    T get(Index) const {
+        return x;
+    }
+    bool unit_stride() const {
+        return true;
+    }
+};
+
+template <class T>
+struct VectorOperand {
+    typedef T value_type;
+    Vector<T> v;
+    StridedOperand<T> line(Index, bool) const {
+        return {v.pointer(), v.get_inc()};
+    }
+};
+
+template <class T>
+struct MatrixOperand {
+    typedef T value_type;
+    Matrix<T> mat;
+    StridedOperand<T> line(Index o, bool by_rows) const {
+        if (by_rows) {
+            return {mat.pointer() + o * mat.get_inc_row(), mat.get_inc_col()};
+        } else {
+            return {mat.pointer() + o * mat.get_inc_col(), mat.get_inc_row()};
+        }
+    }
+};
+
+template <class Op, class A>
+struct UnaryOperation {
+    typedef decltype(Op::apply(std::declval<typename A::value_type>()))
+        value_type;
+    A a;
+    auto line(Index o, bool by_rows) const {
+        return UnaryOperation<Op, decltype(a.line(o, by_rows))>{
+            a.line(o, by_rows)};
+    }
+    template <bool unit>
+    value_type get(Index i) const {
+        return Op::apply(a.template get<unit>(i));
+    }
+    bool unit_stride() const {
+        return a.unit_stride();
+    }
+};
+
+template <class Op, class A, class B>
+struct BinaryOperation {
+    typedef decltype(Op::apply(std::declval<typename A::value_type>(),
+        std::declval<typename B::value_type>())) value_type;
+    A a;
+    B b;
+    auto line(Index o, bool by_rows) const {
+        return BinaryOperation<Op, decltype(a.line(o, by_rows)),
+            decltype(b.line(o, by_rows))>{
+                a.line(o, by_rows), b.line(o, by_rows)};
+    }
+    template <bool unit>
+    value_type get(Index i) const {
+        return Op::apply(a.template get<unit>(i), b.template get<unit>(i));
+    }
+    bool unit_stride() const {
+        return a.unit_stride() && b.unit_stride();
+    }
+};
+
+struct AddOp {
+    template <class X, class Y>
+    static auto apply(X x, Y y) {return x + y;}
 };
+struct SubtractOp {
+    template <class X, class Y>
+    static auto apply(X x, Y y) {return x - y;}
+};
+struct MultiplyOp {
+    template <class X, class Y>
+    static auto apply(X x, Y y) {return x * y;}
+};
+struct DivideOp {
+    template <class X, class Y>
+    static auto apply(X x, Y y) {return x / y;}
+};
+struct NegateOp {
+    template <class X>
+    static auto apply(X x) {return -x;}
+};
+
+// Writes the n elements of line to dest. The loop for unit strides
+// is separate so the compiler vectorizes it.
+template <class T, class L>
+void evaluate_line(T* dest, Index inc, Index n, L line) {
+    if (inc == 1 && line.unit_stride()) {
+        for (Index i = 0; i < n; ++i) {
+            dest[i] = T(line.template get<true>(i));
+        }
+    } else {
+        for (Index i = 0; i < n; ++i) {
+            dest[i * inc] = T(line.template get<false>(i));
+        }
+    }
+}
+
+template <class E>
+class VectorExpression {
+public:
+    typedef typename E::value_type value_type;
+    VectorExpression(const E& e, Index n) : e(e), n(n) {}
+    const E& operand() const {return e;}
+    Index size() const {return n;}
+    template <class T>
+    void evaluate_into(T* dest, Index inc) const {
+        evaluate_line(dest, inc, n, e.line(0, true));
+    }
+private:
+    E e;
+    Index n;
+};
+
+template <class E>
+class MatrixExpression {
+public:
+    typedef typename E::value_type value_type;
+    MatrixExpression(const E& e, Index rows, Index cols) :
+        e(e), rows(rows), cols(cols) {}
+    const E& operand() const {return e;}
+    Index get_rows() const {return rows;}
+    Index get_cols() const {return cols;}
+    // Walks along the shorter stride of dest
+    template <class T>
+    void evaluate_into(T* dest, Index inc_row, Index inc_col) const {
+        if (rows <= 0 || cols <= 0) {
+            return;
+        }
+        bool by_rows = std::abs(inc_col) <= std::abs(inc_row);
+        Index outer = by_rows ? rows : cols;
+        for (Index o = 0; o < outer; ++o) {
+            if (by_rows) {
+                evaluate_line(dest + o * inc_row, inc_col, cols,
+                    e.line(o, true));
+            } else {
+                evaluate_line(dest + o * inc_col, inc_row, rows,
+                    e.line(o, false));
+            }
+        }
+    }
+private:
+    E e;
+    Index rows, cols;
+};
+
+template <class X> struct IsScalar {
+    static const bool value = std::is_arithmetic<X>::value;
+};
+template <class R> struct IsScalar<std::complex<R>> {
+    static const bool value = true;
+};
+
+// How an array enters an expression. Kind is 1 for vectors, 2 for
+// matrices and 0 for anything else.
+template <class X> struct ExpressionTerm {
+    static const int kind = 0;
+};
+template <class T> struct ExpressionTerm<Vector<T>> {
+    static const int kind = 1;
+    typedef VectorOperand<T> type;
+    static type operand(const Vector<T>& v) {return {v};}
+    static Index rows(const Vector<T>& v) {return v.get_n();}
+    static Index cols(const Vector<T>&) {return 1;}
+};
+template <class E> struct ExpressionTerm<VectorExpression<E>> {
+    static const int kind = 1;
+    typedef E type;
+    static type operand(const VectorExpression<E>& e) {return e.operand();}
+    static Index rows(const VectorExpression<E>& e) {return e.size();}
+    static Index cols(const VectorExpression<E>&) {return 1;}
+};
+template <class T> struct ExpressionTerm<Matrix<T>> {
+    static const int kind = 2;
+    typedef MatrixOperand<T> type;
+    static type operand(const Matrix<T>& mat) {return {mat};}
+    static Index rows(const Matrix<T>& mat) {return mat.get_rows();}
+    static Index cols(const Matrix<T>& mat) {return mat.get_cols();}
+};
+template <class E> struct ExpressionTerm<MatrixExpression<E>> {
+    static const int kind = 2;
+    typedef E type;
+    static type operand(const MatrixExpression<E>& e) {return e.operand();}
+    static Index rows(const MatrixExpression<E>& e) {return e.get_rows();}
+    static Index cols(const MatrixExpression<E>& e) {return e.get_cols();}
+};
+
+// Wraps node e in the expression type of an array of the given kind
+template <int kind, class E>
+auto make_expression(const E& e, Index rows, Index cols) {
+    if constexpr (kind == 1) {
+        return VectorExpression<E>(e, rows);
+    } else {
+        return MatrixExpression<E>(e, rows, cols);
+    }
+}
+
+// Operand of an expression, with scalars converted to their common
+// type with the elements of the array on the other side, so 2.5 * x
+// isn't truncated for integer x
+template <class X, class Other>
+auto expression_operand(const X& x, const Other&) {
+    if constexpr (ExpressionTerm<X>::kind != 0) {
+        return ExpressionTerm<X>::operand(x);
+    } else {
+        typedef typename std::common_type<X, 
+            typename ExpressionTerm<Other>::type::value_type>::type T;
+        return ScalarOperand<T>{T(x)};
+    }
+}
+
+// Whichever of a and b is an array
+template <class A, class B>
+const auto& array_operand(const A& a, const B& b) {
+    if constexpr (ExpressionTerm<A>::kind != 0) {
+        return a;
+    } else {
+        return b;
+    }
+}
+
+template <class Op, class A, class B>
+auto combine(const A& a, const B& b) {
+    const int kind_a = ExpressionTerm<A>::kind;
+    const int kind_b = ExpressionTerm<B>::kind;
+    static_assert(kind_a == 0 || kind_b == 0 || kind_a == kind_b,
+        "Can't combine vectors with matrices.");
+    typedef typename std::conditional<kind_a != 0, A, B>::type Array;
+    const Array& array = array_operand(a, b);
+    Index rows = ExpressionTerm<Array>::rows(array);
+    Index cols = ExpressionTerm<Array>::cols(array);
+    if constexpr (kind_a != 0 && kind_b != 0) {
+        if (ExpressionTerm<B>::rows(b) != rows || 
+            ExpressionTerm<B>::cols(b) != cols) {
+            throw DimensionError("Operands have different dimensions.");
+        }
+    }
+    auto operand_a = expression_operand(a, b);
+    auto operand_b = expression_operand(b, a);
+    return make_expression<ExpressionTerm<Array>::kind>(
+        BinaryOperation<Op, decltype(operand_a), decltype(operand_b)>{
+            operand_a, operand_b}, rows, cols);
+}
+
+// Whether an operator applies to A and B: at least one is an array or
+// expression and the other is too or is a scalar
+template <class A, class B>
+using IfExpression = typename std::enable_if<
+    (ExpressionTerm<A>::kind != 0 || ExpressionTerm<B>::kind != 0) &&
+    (ExpressionTerm<A>::kind != 0 || IsScalar<A>::value) &&
+    (ExpressionTerm<B>::kind != 0 || IsScalar<B>::value)>::type;
+
+template <class A, class B, class = IfExpression<A, B>>
+auto operator+(const A& a, const B& b) {
+    return combine<AddOp>(a, b);
+}
+
+template <class A, class B, class = IfExpression<A, B>>
+auto operator-(const A& a, const B& b) {
+    return combine<SubtractOp>(a, b);
+}
+
+template <class A, class B, class = IfExpression<A, B>>
+auto operator*(const A& a, const B& b) {
+    return combine<MultiplyOp>(a, b);
+}
+
+template <class A, class B, class = IfExpression<A, B>>
+auto operator/(const A& a, const B& b) {
+    return combine<DivideOp>(a, b);
+}
+
+template <class A, class = IfExpression<A, A>>
+auto operator-(const A& a) {
+    auto operand = ExpressionTerm<A>::operand(a);
+    return make_expression<ExpressionTerm<A>::kind>(
+        UnaryOperation<NegateOp, decltype(operand)>{operand},
+        ExpressionTerm<A>::rows(a), ExpressionTerm<A>::cols(a));
+}
 
 #endif
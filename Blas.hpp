@@ -0,0 +1,619 @@
+#ifndef _BLAS
+#define _BLAS
+
+#include <cmath>
+#include <cstdint>
+#include <complex>
+#include <limits>
+#include <type_traits>
+#include <algorithm>
+
+#include "Arrays.hpp"
+#include "Threads.hpp"
+
+// BLAS level 1 kernels. The loops are written so the compiler
+// vectorizes them for whatever instruction set it targets.
+
+// Partial sums kept by reductions, so they vectorize without
+// reassociating floating point sums
+const int blas_lanes = 8;
+
+// Type of the real and imaginary parts of T
+template <class T> struct RealPart {
+    typedef T type;
+};
+template <class R> struct RealPart<std::complex<R>> {
+    typedef R type;
+};
+
+// Integers are summed and multiplied unsigned, so overflow wraps around
+template <class T, bool integral = std::is_integral<T>::value>
+struct SumType {
+    typedef T type;
+};
+template <class T> struct SumType<T, true> {
+    typedef typename std::make_unsigned<T>::type type;
+};
+
+// Type of norms of T. Integer norms are doubles.
+template <class T, bool integral = std::is_integral<T>::value>
+struct NormType {
+    typedef typename RealPart<T>::type type;
+};
+template <class T> struct NormType<T, true> {
+    typedef double type;
+};
+
+// Type of sums of magnitudes of T. Integer sums are 64 bit unsigned, so
+// they only wrap around past 2^64.
+template <class T, bool integral = std::is_integral<T>::value>
+struct AsumType {
+    typedef typename RealPart<T>::type type;
+};
+template <class T> struct AsumType<T, true> {
+    typedef std::uint64_t type;
+};
+
+template <class T>
+T multiply(T a, T b) {
+    typedef typename SumType<T>::type S;
+    return T(S(a) * S(b));
+}
+// Without the checks for infinite parts that keep std::complex's
+// operator* from vectorizing
+template <class R>
+std::complex<R> multiply(std::complex<R> a, std::complex<R> b) {
+    return std::complex<R>(a.real() * b.real() - a.imag() * b.imag(),
+        a.real() * b.imag() + a.imag() * b.real());
+}
+
+template <class T>
+T add(T a, T b) {
+    typedef typename SumType<T>::type S;
+    return T(S(a) + S(b));
+}
+
+template <class T>
+T conjugate(T a) {
+    return a;
+}
+template <class R>
+std::complex<R> conjugate(std::complex<R> a) {
+    return std::conj(a);
+}
+
+// |x|, or |Re x| + |Im x| for complex x as in BLAS
+template <class T>
+typename SumType<T>::type magnitude(T x) {
+    typedef typename SumType<T>::type S;
+    if constexpr (std::is_integral<T>::value) {
+        return x < 0 ? S(0) - S(x) : S(x);
+    } else {
+        return std::abs(x);
+    }
+}
+template <class R>
+R magnitude(std::complex<R> x) {
+    return std::abs(x.real()) + std::abs(x.imag());
+}
+
+// |x|^2
+template <class T>
+typename NormType<T>::type squared(T x) {
+    typedef typename NormType<T>::type N;
+    return N(x) * N(x);
+}
+template <class R>
+R squared(std::complex<R> x) {
+    return x.real() * x.real() + x.imag() * x.imag();
+}
+
+// Calls f(inc_x, inc_y), with unit strides as compile time constants,
+// so one loop is vectorized for contiguous vectors and still runs
+// for strided ones
+template <class F>
+void with_strides(Index inc_x, Index inc_y, F f) {
+    typedef std::integral_constant<Index, 1> Unit;
+    if (inc_x == 1 && inc_y == 1) {
+        f(Unit(), Unit());
+    } else {
+        f(inc_x, inc_y);
+    }
+}
+
+// Sums term(x[i * inc_x], y[i * inc_y]) as S, in blas_lanes partial sums
+template <class S, class T, class F>
+S reduce(Index n, const T* x, Index inc_x, const T* y, Index inc_y,
+    F term) {
+    S sum = S();
+    with_strides(inc_x, inc_y, [&](auto ix, auto iy) {
+        S partial[blas_lanes] = {};
+        Index i = 0;
+        for (; i + blas_lanes <= n; i += blas_lanes) {
+            for (int l = 0; l < blas_lanes; ++l) {
+                partial[l] += term(x[(i + l) * ix], y[(i + l) * iy]);
+            }
+        }
+        for (const T *px = x + i * ix, *py = y + i * iy; i < n;
+            ++i, px += ix, py += iy) {
+            sum += term(*px, *py);
+        }
+        for (int l = 0; l < blas_lanes; ++l) {
+            sum += partial[l];
+        }
+    });
+    return sum;
+}
+
+// y += alpha x
+template <class T>
+void axpy(Index n, T alpha, const T* x, Index inc_x, T* y, Index inc_y) {
+    with_strides(inc_x, inc_y, [&](auto ix, auto iy) {
+        for (Index i = 0; i < n; ++i) {
+            y[i * iy] = add(y[i * iy], multiply(alpha, x[i * ix]));
+        }
+    });
+}
+
+// Sum of x[i] y[i], with x conjugated if conj
+template <bool conj = false, class T>
+T dot(Index n, const T* x, Index inc_x, const T* y, Index inc_y) {
+    typedef typename SumType<T>::type S;
+    return T(reduce<S>(n, x, inc_x, y, inc_y, [](T a, T b) {
+        return S(multiply(conj ? conjugate(a) : a, b));
+    }));
+}
+
+// x *= alpha
+template <class T>
+void scal(Index n, T alpha, T* x, Index inc_x) {
+    with_strides(inc_x, 1, [&](auto ix, auto) {
+        for (Index i = 0; i < n; ++i) {
+            x[i * ix] = multiply(alpha, x[i * ix]);
+        }
+    });
+}
+
+// Sum of magnitudes
+template <class T>
+typename AsumType<T>::type asum(Index n, const T* x, Index inc_x) {
+    typedef typename AsumType<T>::type S;
+    return reduce<S>(n, x, inc_x, x, inc_x,
+        [](T a, T) { return S(magnitude(a)); });
+}
+
+// Euclidean norm. Vectors whose sum of squares overflows or underflows
+// are summed again, scaled by their largest part.
+template <class T>
+typename NormType<T>::type nrm2(Index n, const T* x, Index inc_x) {
+    typedef typename NormType<T>::type N;
+    N sum = reduce<N>(n, x, inc_x, x, inc_x,
+        [](T a, T) { return squared(a); });
+    if (std::isnan(sum) || (std::isfinite(sum) &&
+        sum >= std::numeric_limits<N>::min() /
+            std::numeric_limits<N>::epsilon())) {
+        return std::sqrt(sum);
+    }
+    N scale = 0;
+    for (Index i = 0; i < n; ++i) {
+        if constexpr (std::is_same<T, std::complex<N>>::value) {
+            scale = std::max({scale, std::abs(x[i * inc_x].real()),
+                std::abs(x[i * inc_x].imag())});
+        } else {
+            scale = std::max(scale, std::abs(N(x[i * inc_x])));
+        }
+    }
+    if (scale == 0 || std::isinf(scale)) {
+        return scale;
+    }
+    N scaled = reduce<N>(n, x, inc_x, x, inc_x, [scale](T a, T) {
+        if constexpr (std::is_same<T, std::complex<N>>::value) {
+            return squared(std::complex<N>(a.real() / scale,
+                a.imag() / scale));
+        } else {
+            return squared(N(a) / scale);
+        }
+    });
+    return scale * std::sqrt(scaled);
+}
+
+// Index of the first element of largest magnitude, or -1 if n is 0. A NaN
+// counts as larger than any number, so the first NaN is found wherever it
+// is. Reference BLAS skips NaNs unless x[0] is one.
+template <class T>
+Index iamax(Index n, const T* x, Index inc_x) {
+    if (n == 0) {
+        return -1;
+    }
+    Index best = 0;
+    auto largest = magnitude(x[0]);
+    for (Index i = 1; i < n && largest == largest; ++i) {
+        auto m = magnitude(x[i * inc_x]);
+        if (m > largest || m != m) {
+            largest = m;
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Vector versions
+
+template <class T>
+void check_lengths(const Vector<T>& x, const Vector<T>& y) {
+    if (x.get_n() != y.get_n()) {
+        throw DimensionError("Vectors have different lengths.");
+    }
+}
+
+template <class T>
+void axpy(T alpha, const Vector<T>& x, Vector<T>& y) {
+    check_lengths(x, y);
+    axpy(x.get_n(), alpha, x.pointer(), x.get_inc(),
+        y.pointer(), y.get_inc());
+}
+
+template <class T>
+T dot(const Vector<T>& x, const Vector<T>& y) {
+    check_lengths(x, y);
+    return dot(x.get_n(), x.pointer(), x.get_inc(),
+        y.pointer(), y.get_inc());
+}
+
+// Dot product with x conjugated
+template <class T>
+T dotc(const Vector<T>& x, const Vector<T>& y) {
+    check_lengths(x, y);
+    return dot<true>(x.get_n(), x.pointer(), x.get_inc(),
+        y.pointer(), y.get_inc());
+}
+
+template <class T>
+void scal(T alpha, Vector<T>& x) {
+    scal(x.get_n(), alpha, x.pointer(), x.get_inc());
+}
+
+template <class T>
+typename AsumType<T>::type asum(const Vector<T>& x) {
+    return asum(x.get_n(), x.pointer(), x.get_inc());
+}
+
+template <class T>
+typename NormType<T>::type nrm2(const Vector<T>& x) {
+    return nrm2(x.get_n(), x.pointer(), x.get_inc());
+}
+
+template <class T>
+Index iamax(const Vector<T>& x) {
+    return iamax(x.get_n(), x.pointer(), x.get_inc());
+}
+
+// BLAS level 3. C = alpha op(A) op(B) + beta C is computed by packing
+// blocks of op(A) and op(B) into contiguous panels, so operands of any
+// storage order are multiplied by the same register blocked kernel.
+
+// How gemm uses a matrix operand
+enum Transpose {
+    NO_TRANSPOSE = 0,
+    TRANSPOSE = 1,
+    CONJUGATE_TRANSPOSE = 2
+};
+
+// Width in bytes of the vector registers the compiler targets
+#if defined(__AVX512F__)
+const int blas_vector_bytes = 64;
+#elif defined(__AVX__)
+const int blas_vector_bytes = 32;
+#else
+const int blas_vector_bytes = 16;
+#endif
+
+// The kernel keeps an mr x nr block of C in registers, sized from the
+// vector width. It isn't written with intrinsics: it relies on the
+// compiler to vectorize its fixed size loops, which by default only use
+// 16 byte SSE2 registers. make native builds for wider registers, and a
+// larger block. Packed kc x nr panels of op(B) stay in L1, mc x kc blocks
+// of op(A) in L2 and kc x nc blocks of op(B) in L3.
+template <class T> struct GemmBlocking {
+    static constexpr int mr = blas_vector_bytes > 16 ? 6 : 4;
+    static constexpr int nr = std::max<int>(2, 2 * blas_vector_bytes / sizeof(T));
+    static constexpr Index kc = 256;
+    static constexpr Index mc = std::max<Index>(mr,
+        (192 * 1024 / (kc * sizeof(T))) / mr * mr);
+    static constexpr Index nc = 4096;
+};
+
+// Element (i,j) is p[i * inc_row + j * inc_col]
+template <class T>
+struct StridedMatrix {
+    T* p;
+    Index inc_row, inc_col;
+    T& operator()(Index i, Index j) const {
+        return p[i * inc_row + j * inc_col];
+    }
+    StridedMatrix<T> block(Index i, Index j) const {
+        return {&(*this)(i, j), inc_row, inc_col};
+    }
+    StridedMatrix<T> transpose() const {
+        return {p, inc_col, inc_row};
+    }
+};
+
+// Packs the m x k block a into panels of mr rows, each stored one
+// column of mr elements after another and padded with zeros
+template <int mr, class T>
+void pack_a(Index m, Index k, StridedMatrix<const T> a, bool conj, T* buf) {
+    for (Index i0 = 0; i0 < m; i0 += mr) {
+        Index rows = std::min<Index>(mr, m - i0);
+        for (Index p = 0; p < k; ++p) {
+            for (Index i = 0; i < rows; ++i) {
+                T x = a(i0 + i, p);
+                buf[i] = conj ? conjugate(x) : x;
+            }
+            std::fill(buf + rows, buf + mr, T());
+            buf += mr;
+        }
+    }
+}
+
+// Packs the k x n block b into panels of nr columns, each stored one
+// row of nr elements after another and padded with zeros
+template <int nr, class T>
+void pack_b(Index k, Index n, StridedMatrix<const T> b, bool conj, T* buf) {
+    pack_a<nr>(n, k, b.transpose(), conj, buf);
+}
+
+// ab = sum over p of the outer products of a's and b's columns. Plain
+// C++, unrolled so acc stays in registers and vectorized by the compiler.
+template <int mr, int nr, class T>
+void gemm_kernel(Index k, const T* a, const T* b, T* ab) {
+    T acc[mr * nr] = {};
+    for (Index p = 0; p < k; ++p) {
+#pragma GCC unroll 16
+        for (int i = 0; i < mr; ++i) {
+#pragma GCC unroll 64
+            for (int j = 0; j < nr; ++j) {
+                acc[i * nr + j] = add(acc[i * nr + j], multiply(a[i], b[j]));
+            }
+        }
+        a += mr;
+        b += nr;
+    }
+    std::copy(acc, acc + mr * nr, ab);
+}
+
+// c = alpha ab + beta c for the m x n top left corner of ab.
+// c isn't read if beta is 0.
+template <int nr, class T>
+void gemm_update(Index m, Index n, T alpha, const T* ab, T beta,
+    StridedMatrix<T> c) {
+    for (Index i = 0; i < m; ++i) {
+        for (Index j = 0; j < n; ++j) {
+            T x = multiply(alpha, ab[i * nr + j]);
+            c(i, j) = beta == T() ? x : add(x, multiply(beta, c(i, j)));
+        }
+    }
+}
+
+// c = beta c
+template <class T>
+void gemm_scale(Index m, Index n, T beta, StridedMatrix<T> c) {
+    for (Index i = 0; i < m; ++i) {
+        for (Index j = 0; j < n; ++j) {
+            c(i, j) = beta == T() ? T() : multiply(beta, c(i, j));
+        }
+    }
+}
+
+// c = alpha a b + beta c for packed m x k a and k x n b
+template <class T>
+void gemm_packed(Index m, Index n, Index k, T alpha, const T* a,
+    const T* b, T beta, StridedMatrix<T> c) {
+    typedef GemmBlocking<T> B;
+    T ab[B::mr * B::nr];
+    for (Index j = 0; j < n; j += B::nr) {
+        for (Index i = 0; i < m; i += B::mr) {
+            gemm_kernel<B::mr, B::nr>(k, a + i * k, b + j * k, ab);
+            gemm_update<B::nr>(std::min<Index>(B::mr, m - i),
+                std::min<Index>(B::nr, n - j), alpha, ab, beta,
+                c.block(i, j));
+        }
+    }
+}
+
+// Rounds n up to a multiple of r
+inline Index round_up(Index n, Index r) {
+    return (n + r - 1) / r * r;
+}
+
+// Least number of multiply-adds worth a thread of their own
+const Index gemm_min_work = Index(1) << 21;
+const Index gemv_min_work = Index(1) << 16;
+
+// Splits tasks into a grid of rows x cols tasks over an m x n product,
+// with blocks as close to square as the factors of tasks allow
+inline std::pair<int, int> task_grid(int tasks, Index m, Index n) {
+    int rows = 1;
+    double best = -1;
+    for (int r = 1; r <= tasks; ++r) {
+        if (tasks % r == 0) {
+            double size = double(m) / r + double(n) / (tasks / r);
+            if (best < 0 || size < best) {
+                rows = r;
+                best = size;
+            }
+        }
+    }
+    return {rows, tasks / rows};
+}
+
+// c = alpha a b + beta c, for m x k a, k x n b and m x n c, where a and
+// b are conjugated if conj_a and conj_b. c must not overlap a or b.
+// Large products are split across the thread pool into a grid of
+// blocks of c, which share each packed block of b.
+template <class T>
+void gemm(Index m, Index n, Index k, T alpha,
+    StridedMatrix<const T> a, bool conj_a,
+    StridedMatrix<const T> b, bool conj_b,
+    T beta, StridedMatrix<T> c) {
+    typedef GemmBlocking<T> B;
+    if (m <= 0 || n <= 0) {
+        return;
+    }
+    if (k <= 0 || alpha == T()) {
+        gemm_scale(m, n, beta, c);
+        return;
+    }
+    int tasks = parallel_tasks(m * n * k, gemm_min_work,
+        round_up(m, B::mr) / B::mr * (round_up(std::min(B::nc, n), B::nr) /
+            B::nr));
+    std::pair<int, int> grid = task_grid(tasks, m, std::min(B::nc, n));
+    std::vector<ArrayPtr<T>> a_bufs;
+    for (int t = 0; t < tasks; ++t) {
+        a_bufs.emplace_back(round_up(std::min(B::mc, m), B::mr) *
+            std::min(B::kc, k), uninitialized);
+    }
+    ArrayPtr<T> b_buf(round_up(std::min(B::nc, n), B::nr) *
+        std::min(B::kc, k), uninitialized);
+    for (Index jc = 0; jc < n; jc += B::nc) {
+        Index nb = std::min(B::nc, n - jc);
+        for (Index pc = 0; pc < k; pc += B::kc) {
+            Index kb = std::min(B::kc, k - pc);
+            thread_pool().run(tasks, [&](int t) {
+                Index j0 = split_start(nb, B::nr, tasks, t);
+                Index j1 = split_start(nb, B::nr, tasks, t + 1);
+                pack_b<B::nr>(kb, j1 - j0, b.block(pc, jc + j0), conj_b,
+                    b_buf.pointer() + j0 * kb);
+            });
+            T beta_block = pc == 0 ? beta : T(1);
+            thread_pool().run(tasks, [&](int t) {
+                int ti = t / grid.second, tj = t % grid.second;
+                Index i0 = split_start(m, B::mr, grid.first, ti);
+                Index i1 = split_start(m, B::mr, grid.first, ti + 1);
+                Index j0 = split_start(nb, B::nr, grid.second, tj);
+                Index j1 = split_start(nb, B::nr, grid.second, tj + 1);
+                if (j0 == j1) {
+                    return;
+                }
+                T* a_buf = a_bufs[t].pointer();
+                for (Index ic = i0; ic < i1; ic += B::mc) {
+                    Index mb = std::min(B::mc, i1 - ic);
+                    pack_a<B::mr>(mb, kb, a.block(ic, pc), conj_a, a_buf);
+                    gemm_packed(mb, j1 - j0, kb, alpha, a_buf,
+                        b_buf.pointer() + j0 * kb, beta_block,
+                        c.block(ic, jc + j0));
+                }
+            });
+        }
+    }
+}
+
+// y = alpha a x + beta y for rows [i0, i1) of m x n a.
+// y isn't read if beta is 0.
+template <class T>
+void gemv_rows(Index i0, Index i1, Index n, T alpha,
+    StridedMatrix<const T> a, bool conj_a, const T* x, Index inc_x,
+    T beta, T* y, Index inc_y) {
+    // Rows updated together when walking down columns, sized to keep
+    // their part of y in L1
+    const Index block_rows = 2048;
+    if (a.inc_row == 1 && !conj_a) {
+        for (Index r0 = i0; r0 < i1; r0 += block_rows) {
+            Index rows = std::min(block_rows, i1 - r0);
+            T* yb = y + r0 * inc_y;
+            if (beta == T()) {
+                for (Index i = 0; i < rows; ++i) {
+                    yb[i * inc_y] = T();
+                }
+            } else if (beta != T(1)) {
+                scal(rows, beta, yb, inc_y);
+            }
+            for (Index j = 0; j < n; ++j) {
+                axpy(rows, multiply(alpha, x[j * inc_x]), &a(r0, j), 1,
+                    yb, inc_y);
+            }
+        }
+    } else {
+        for (Index i = i0; i < i1; ++i) {
+            const T* row = &a(i, 0);
+            T sum = conj_a ? dot<true>(n, row, a.inc_col, x, inc_x) :
+                dot(n, row, a.inc_col, x, inc_x);
+            T yi = multiply(alpha, sum);
+            y[i * inc_y] = beta == T() ? yi :
+                add(yi, multiply(beta, y[i * inc_y]));
+        }
+    }
+}
+
+// y = alpha a x + beta y for m x n a, conjugated if conj_a. y must not
+// overlap a or x. Large products are split across the thread pool by
+// blocks of rows.
+template <class T>
+void gemv(Index m, Index n, T alpha, StridedMatrix<const T> a,
+    bool conj_a, const T* x, Index inc_x, T beta, T* y, Index inc_y) {
+    if (m <= 0) {
+        return;
+    }
+    if (n <= 0 || alpha == T()) {
+        gemm_scale(m, 1, beta, StridedMatrix<T>{y, inc_y, 0});
+        return;
+    }
+    int tasks = parallel_tasks(m * n, gemv_min_work, m / blas_lanes);
+    thread_pool().run(tasks, [&](int t) {
+        gemv_rows(split_start(m, blas_lanes, tasks, t),
+            split_start(m, blas_lanes, tasks, t + 1), n, alpha, a, conj_a,
+            x, inc_x, beta, y, inc_y);
+    });
+}
+
+// op(a) as a strided matrix
+template <class T>
+StridedMatrix<const T> operand(const Matrix<T>& a, Transpose trans) {
+    StridedMatrix<const T> op = {a.pointer(), a.get_inc_row(),
+        a.get_inc_col()};
+    return trans == NO_TRANSPOSE ? op : op.transpose();
+}
+
+// c = alpha op(a) op(b) + beta c, where op(x) is x, its transpose or its
+// conjugate transpose. c must not overlap a or b.
+template <class T>
+void gemm(T alpha, const Matrix<T>& a, Transpose trans_a,
+    const Matrix<T>& b, Transpose trans_b, T beta, Matrix<T>& c) {
+    Index m = trans_a == NO_TRANSPOSE ? a.get_rows() : a.get_cols();
+    Index k = trans_a == NO_TRANSPOSE ? a.get_cols() : a.get_rows();
+    Index k_b = trans_b == NO_TRANSPOSE ? b.get_rows() : b.get_cols();
+    Index n = trans_b == NO_TRANSPOSE ? b.get_cols() : b.get_rows();
+    if (k != k_b || m != c.get_rows() || n != c.get_cols()) {
+        throw DimensionError("Matrix dimensions don't match.");
+    }
+    StridedMatrix<T> dest = {c.pointer(), c.get_inc_row(),
+        c.get_inc_col()};
+    gemm(m, n, k, alpha, operand(a, trans_a),
+        trans_a == CONJUGATE_TRANSPOSE, operand(b, trans_b),
+        trans_b == CONJUGATE_TRANSPOSE, beta, dest);
+}
+
+// y = alpha op(a) x + beta y, where op(a) is a, its transpose or its
+// conjugate transpose. y must not overlap a or x.
+template <class T>
+void gemv(T alpha, const Matrix<T>& a, Transpose trans,
+    const Vector<T>& x, T beta, Vector<T>& y) {
+    Index m = trans == NO_TRANSPOSE ? a.get_rows() : a.get_cols();
+    Index n = trans == NO_TRANSPOSE ? a.get_cols() : a.get_rows();
+    if (x.get_n() != n || y.get_n() != m) {
+        throw DimensionError("Matrix and vector dimensions don't match.");
+    }
+    gemv(m, n, alpha, operand(a, trans), trans == CONJUGATE_TRANSPOSE,
+        x.pointer(), x.get_inc(), beta, y.pointer(), y.get_inc());
+}
+
+// Matrix vector product a x, through gemv. Unlike * on two arrays, this
+// isn't elementwise and is computed when called.
+template <class T>
+Vector<T> operator*(const Matrix<T>& a, const Vector<T>& x) {
+    Vector<T> y(a.get_rows(), uninitialized);
+    gemv(T(1), a, NO_TRANSPOSE, x, T(), y);
+    return y;
+}
+
+#endif
@@ -0,0 +1,340 @@
+#ifndef _CODEC
+#define _CODEC
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <type_traits>
+#include <algorithm>
+#include <stdexcept>
+
+#include "Arrays.hpp"
+
+// How a chunk of a compressed binary file is encoded
+enum ChunkCodec {
+    RAW_CHUNK = 0, // Bytes as stored in memory
+    DELTA_CHUNK = 1, // Integers as bit packed zigzag differences
+    SHUFFLE_LZ_CHUNK = 2 // Bytes grouped by significance, then LZ compressed
+};
+
+// Raised when compressed data is corrupt
+class CodecError : public std::runtime_error {
+public:
+    CodecError(const std::string& s) : std::runtime_error(s) {}
+};
+
+// Writes bit fields least significant bit first
+class BitWriter {
+public:
+    BitWriter(std::vector<char>& out) : out(out) {}
+    void put(std::uint64_t x, int bits) {
+        while (bits > 0) {
+            int take = std::min(bits, 8 - used);
+            current |= (x & ((1u << take) - 1)) << used;
+            x >>= take;
+            bits -= take;
+            used += take;
+            if (used == 8) {
+                out.push_back(char(current));
+                current = 0;
+                used = 0;
+            }
+        }
+    }
+    void finish() {
+        if (used > 0) {
+            out.push_back(char(current));
+            current = 0;
+            used = 0;
+        }
+    }
+private:
+    std::vector<char>& out;
+    unsigned current = 0;
+    int used = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const char* begin, const char* end) : p(begin), end(end) {}
+    std::uint64_t get(int bits) {
+        std::uint64_t x = 0;
+        int got = 0;
+        while (got < bits) {
+            if (left == 0) {
+                if (p == end) {
+                    throw CodecError("Compressed chunk is truncated.");
+                }
+                current = std::uint8_t(*p++);
+                left = 8;
+            }
+            int take = std::min(bits - got, left);
+            x |= std::uint64_t(current & ((1u << take) - 1)) << got;
+            current >>= take;
+            left -= take;
+            got += take;
+        }
+        return x;
+    }
+    // Skips to the next whole byte
+    void align() {
+        left = 0;
+    }
+    const char* position() const {
+        return p;
+    }
+private:
+    const char* p;
+    const char* end;
+    unsigned current = 0;
+    int left = 0;
+};
+
+// Values per bit width in delta chunks
+const Index delta_block_size = 128;
+
+// Differences between neighbours, zigzag encoded so small negative
+// differences are small too, then packed in blocks of delta_block_size
+// that each use the fewest bits for their largest value
+template <class T>
+void delta_encode(const T* p, Index n, std::vector<char>& out) {
+    typedef typename std::make_unsigned<T>::type U;
+    const int bits = 8 * sizeof(U);
+    std::vector<U> zigzag(delta_block_size);
+    BitWriter writer(out);
+    U previous = 0;
+    for (Index i = 0; i < n; i += delta_block_size) {
+        Index count = std::min(delta_block_size, n - i);
+        U largest = 0;
+        for (Index k = 0; k < count; ++k) {
+            U d = U(p[i + k]) - previous;
+            previous = U(p[i + k]);
+            zigzag[k] = U(d << 1) ^ U(0 - (d >> (bits - 1)));
+            largest |= zigzag[k];
+        }
+        int width = 0;
+        while (width < bits && (largest >> width) != 0) {
+            ++width;
+        }
+        out.push_back(char(width));
+        for (Index k = 0; k < count; ++k) {
+            writer.put(zigzag[k], width);
+        }
+        writer.finish();
+    }
+}
+
+template <class T>
+void delta_decode(const char* begin, const char* end, T* p, Index n) {
+    typedef typename std::make_unsigned<T>::type U;
+    const int bits = 8 * sizeof(U);
+    U previous = 0;
+    const char* q = begin;
+    for (Index i = 0; i < n; i += delta_block_size) {
+        Index count = std::min(delta_block_size, n - i);
+        if (q == end) {
+            throw CodecError("Compressed chunk is truncated.");
+        }
+        int width = std::uint8_t(*q++);
+        if (width > bits) {
+            throw CodecError("Bad bit width in compressed chunk.");
+        }
+        BitReader reader(q, end);
+        for (Index k = 0; k < count; ++k) {
+            U z = U(reader.get(width));
+            U d = U(z >> 1) ^ U(0 - (z & 1));
+            previous = U(previous + d);
+            p[i + k] = T(previous);
+        }
+        q = reader.position();
+    }
+}
+
+// Groups byte k of every width-byte scalar together, so the slowly
+// changing high bytes of numbers form long runs
+inline void shuffle_bytes(const char* in, char* out, std::size_t bytes,
+    std::size_t width) {
+    std::size_t n = bytes / width;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t k = 0; k < width; ++k) {
+            out[k * n + i] = in[i * width + k];
+        }
+    }
+}
+
+inline void unshuffle_bytes(const char* in, char* out, std::size_t bytes,
+    std::size_t width) {
+    std::size_t n = bytes / width;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t k = 0; k < width; ++k) {
+            out[i * width + k] = in[k * n + i];
+        }
+    }
+}
+
+// LZ77 with byte aligned sequences. Each sequence is a token holding
+// the literal count (high 4 bits) and match length - lz_min_match
+// (low 4 bits), extended by bytes of 255 and a final smaller byte when
+// 15, then the literals, a 2 byte little endian offset and the match
+// length extension. The last sequence has only literals.
+const std::size_t lz_min_match = 4;
+const std::size_t lz_max_offset = 65535;
+const int lz_hash_bits = 14;
+
+inline void lz_put_length(std::vector<char>& out, std::size_t n) {
+    while (n >= 255) {
+        out.push_back(char(255));
+        n -= 255;
+    }
+    out.push_back(char(n));
+}
+
+inline void lz_sequence(std::vector<char>& out, const char* literals,
+    std::size_t literal_count, std::size_t offset, std::size_t match) {
+    std::size_t extra = match ? match - lz_min_match : 0;
+    out.push_back(char((std::min<std::size_t>(literal_count, 15) << 4) |
+        std::min<std::size_t>(extra, 15)));
+    if (literal_count >= 15) {
+        lz_put_length(out, literal_count - 15);
+    }
+    out.insert(out.end(), literals, literals + literal_count);
+    if (match) {
+        out.push_back(char(offset & 0xff));
+        out.push_back(char(offset >> 8));
+        if (extra >= 15) {
+            lz_put_length(out, extra - 15);
+        }
+    }
+}
+
+inline void lz_compress(const char* in, std::size_t n, std::vector<char>& out) {
+    std::vector<std::int64_t> table(std::size_t(1) << lz_hash_bits, -1);
+    auto load = [&](std::size_t i) {
+        std::uint32_t x;
+        std::memcpy(&x, in + i, sizeof(x));
+        return x;
+    };
+    std::size_t anchor = 0, i = 0;
+    while (i + lz_min_match <= n) {
+        std::uint32_t x = load(i);
+        std::size_t h = (x * 2654435761u) >> (32 - lz_hash_bits);
+        std::int64_t candidate = table[h];
+        table[h] = i;
+        if (candidate >= 0 && i - candidate <= lz_max_offset &&
+            load(candidate) == x) {
+            std::size_t match = lz_min_match;
+            while (i + match < n && in[candidate + match] == in[i + match]) {
+                ++match;
+            }
+            lz_sequence(out, in + anchor, i - anchor, i - candidate, match);
+            i += match;
+            anchor = i;
+        } else {
+            ++i;
+        }
+    }
+    lz_sequence(out, in + anchor, n - anchor, 0, 0);
+}
+
+inline void lz_decompress(const char* begin, const char* end, char* out,
+    std::size_t n) {
+    const char* q = begin;
+    std::size_t filled = 0;
+    auto get_length = [&](std::size_t length) {
+        if (length == 15) {
+            std::uint8_t b;
+            do {
+                if (q == end) {
+                    throw CodecError("Compressed chunk is truncated.");
+                }
+                b = *q++;
+                length += b;
+            } while (b == 255);
+        }
+        return length;
+    };
+    while (q != end) {
+        std::uint8_t token = *q++;
+        std::size_t literals = get_length(token >> 4);
+        if (std::size_t(end - q) < literals || n - filled < literals) {
+            throw CodecError("Compressed chunk overruns its data.");
+        }
+        std::memcpy(out + filled, q, literals);
+        q += literals;
+        filled += literals;
+        if (q == end) {
+            break;
+        }
+        if (end - q < 2) {
+            throw CodecError("Compressed chunk is truncated.");
+        }
+        std::size_t offset = std::uint8_t(q[0]) | (std::uint8_t(q[1]) << 8);
+        q += 2;
+        std::size_t match = get_length(token & 15) + lz_min_match;
+        if (offset == 0 || offset > filled || n - filled < match) {
+            throw CodecError("Compressed chunk overruns its data.");
+        }
+        for (std::size_t k = 0; k < match; ++k) { // May overlap itself
+            out[filled + k] = out[filled - offset + k];
+        }
+        filled += match;
+    }
+    if (filled != n) {
+        throw CodecError("Compressed chunk has the wrong length.");
+    }
+}
+
+// Appends n elements encoded with the best codec for T, or stored raw
+// when that doesn't make them smaller. The first byte is the ChunkCodec.
+template <class T>
+void compress_chunk(const T* p, Index n, std::vector<char>& out) {
+    std::size_t start = out.size();
+    std::size_t bytes = sizeof(T) * n;
+    if constexpr (std::is_integral<T>::value) {
+        out.push_back(DELTA_CHUNK);
+        delta_encode(p, n, out);
+    } else {
+        out.push_back(SHUFFLE_LZ_CHUNK);
+        std::vector<char> shuffled(bytes);
+        shuffle_bytes((const char*) p, shuffled.data(), bytes, 
+            ScalarSize<T>::value);
+        lz_compress(shuffled.data(), bytes, out);
+    }
+    if (out.size() - start > bytes) {
+        out.resize(start);
+        out.push_back(RAW_CHUNK);
+        out.insert(out.end(), (const char*) p, (const char*) p + bytes);
+    }
+}
+
+// Decodes a chunk of n elements. Unless the chunk is DELTA_CHUNK, the
+// elements come out in the writer's byte order. Returns the codec.
+template <class T>
+ChunkCodec decompress_chunk(const char* begin, const char* end, T* p, 
+    Index n) {
+    std::size_t bytes = sizeof(T) * n;
+    if (begin == end) {
+        throw CodecError("Compressed chunk is empty.");
+    }
+    ChunkCodec codec = ChunkCodec(*begin++);
+    if (codec == RAW_CHUNK) {
+        if (std::size_t(end - begin) != bytes) {
+            throw CodecError("Compressed chunk has the wrong length.");
+        }
+        std::memcpy((char*) p, begin, bytes);
+    } else if (codec == DELTA_CHUNK && std::is_integral<T>::value) {
+        if constexpr (std::is_integral<T>::value) {
+            delta_decode(begin, end, p, n);
+        }
+    } else if (codec == SHUFFLE_LZ_CHUNK) {
+        std::vector<char> shuffled(bytes);
+        lz_decompress(begin, end, shuffled.data(), bytes);
+        unshuffle_bytes(shuffled.data(), (char*) p, bytes, 
+            ScalarSize<T>::value);
+    } else {
+        throw CodecError("Unknown chunk codec.");
+    }
+    return codec;
+}
+
+#endif
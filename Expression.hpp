@@ -0,0 +1,304 @@
+#ifndef _EXPRESSION
+#define _EXPRESSION
+
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+#include "Arrays.hpp"
+#include "Threads.hpp"
+
+// Elementwise expressions over double vectors and matrices built at
+// run time, for callers that can't use the expression templates in
+// Arrays.hpp. An expression is a graph whose shared subexpressions are
+// computed once. It's evaluated in one fused pass over chunks of its
+// operands that fit in L1, split across the thread pool when large.
+
+enum ExprOp {
+    VARIABLE_EXPR, CONSTANT_EXPR,
+    ADD_EXPR, SUBTRACT_EXPR, MULTIPLY_EXPR, DIVIDE_EXPR,
+    POW_EXPR, MIN_EXPR, MAX_EXPR,
+    NEGATE_EXPR, ABS_EXPR, EXP_EXPR, LOG_EXPR, SQRT_EXPR,
+    SIN_EXPR, COS_EXPR, TANH_EXPR
+};
+
+// Elements evaluated at a time by each thread, per subexpression
+const Index expr_chunk_size = 256;
+
+// Least number of element operations worth a thread of their own
+const Index expr_min_work = Index(1) << 16;
+
+class RuntimeExpression {
+public:
+    static RuntimeExpression variable(const Vector<double>& v) {
+        auto node = std::make_shared<Node>(VARIABLE_EXPR, v.get_n(), 1);
+        node->vector = v;
+        node->p = v.pointer();
+        node->inc_row = v.get_inc();
+        return RuntimeExpression(node);
+    }
+    static RuntimeExpression variable(const Matrix<double>& mat) {
+        auto node = std::make_shared<Node>(VARIABLE_EXPR,
+            mat.get_rows(), mat.get_cols());
+        node->matrix = mat;
+        node->p = mat.pointer();
+        node->inc_row = mat.get_inc_row();
+        node->inc_col = mat.get_inc_col();
+        return RuntimeExpression(node);
+    }
+    // Scalars take the shape of whatever they're combined with
+    static RuntimeExpression constant(double x) {
+        auto node = std::make_shared<Node>(CONSTANT_EXPR, 0, 0);
+        node->scalar = true;
+        node->value = x;
+        return RuntimeExpression(node);
+    }
+    static RuntimeExpression unary(ExprOp op, const RuntimeExpression& a) {
+        auto node = std::make_shared<Node>(op, a.node->rows, a.node->cols);
+        node->scalar = a.node->scalar;
+        node->valid = a.node->valid;
+        node->a = a.node;
+        return RuntimeExpression(node);
+    }
+    // Operands that aren't scalars must have the same dimensions,
+    // which evaluate_into checks
+    static RuntimeExpression binary(ExprOp op, const RuntimeExpression& a,
+        const RuntimeExpression& b) {
+        const Node& shape = a.node->scalar ? *b.node : *a.node;
+        auto node = std::make_shared<Node>(op, shape.rows, shape.cols);
+        node->scalar = a.node->scalar && b.node->scalar;
+        node->valid = a.node->valid && b.node->valid &&
+            (a.node->scalar || b.node->scalar ||
+                (a.node->rows == b.node->rows &&
+                    a.node->cols == b.node->cols));
+        node->a = a.node;
+        node->b = b.node;
+        return RuntimeExpression(node);
+    }
+    // Overwrites the elements of dest with the value of this expression.
+    // Variables may be dest itself, but not other views that overlap it.
+    void evaluate_into(const Vector<double>& dest) const {
+        evaluate_into(dest.pointer(), dest.get_n(), 1, dest.get_inc(), 0);
+    }
+    void evaluate_into(const Matrix<double>& dest) const {
+        evaluate_into(dest.pointer(), dest.get_rows(), dest.get_cols(),
+            dest.get_inc_row(), dest.get_inc_col());
+    }
+private:
+    struct Node {
+        Node(ExprOp op, Index rows, Index cols) :
+            op(op), rows(rows), cols(cols) {}
+        ExprOp op;
+        Index rows, cols;
+        bool scalar = false, valid = true;
+        std::shared_ptr<const Node> a, b;
+        double value = 0;
+        // Element (i,j) of a variable is p[i * inc_row + j * inc_col]
+        const double* p = nullptr;
+        Index inc_row = 0, inc_col = 0;
+        // Keep the variable's elements alive
+        Vector<double> vector;
+        Matrix<double> matrix;
+    };
+    // One step of the compiled expression, which puts the value of a
+    // node in slot out
+    struct Step {
+        const Node* node;
+        int out, a, b;
+    };
+    // An expression in evaluation order. Slots hold chunks of
+    // intermediate values and are reused once their value is dead.
+    // Constants have slots of their own, filled once.
+    struct Program {
+        std::vector<Step> steps;
+        int slots = 0;
+    };
+    RuntimeExpression(std::shared_ptr<const Node> node) : node(node) {}
+
+    // Appends the nodes below n to order, after their operands
+    static void sort(const Node* n, std::vector<const Node*>& order,
+        std::map<const Node*, int>& uses) {
+        if (uses[n]++ > 0) {
+            return;
+        }
+        for (const Node* operand : {n->a.get(), n->b.get()}) {
+            if (operand) {
+                sort(operand, order, uses);
+            }
+        }
+        order.push_back(n);
+    }
+    Program compile() const {
+        std::vector<const Node*> order;
+        std::map<const Node*, int> uses;
+        sort(node.get(), order, uses);
+        Program program;
+        std::map<const Node*, int> slot;
+        std::vector<int> free_slots;
+        auto release = [&](const Node* n) {
+            if (n && --uses[n] == 0 && n->op != CONSTANT_EXPR) {
+                free_slots.push_back(slot[n]);
+            }
+        };
+        for (const Node* n : order) {
+            Step step = {n, 0, -1, -1};
+            if (n->a) {
+                step.a = slot[n->a.get()];
+            }
+            if (n->b) {
+                step.b = slot[n->b.get()];
+            }
+            release(n->a.get());
+            release(n->b.get());
+            if (!free_slots.empty() && n->op != CONSTANT_EXPR) {
+                step.out = free_slots.back();
+                free_slots.pop_back();
+            } else {
+                step.out = program.slots++;
+            }
+            slot[n] = step.out;
+            program.steps.push_back(step);
+        }
+        return program;
+    }
+
+    void evaluate_into(double* dest, Index rows, Index cols,
+        Index inc_row, Index inc_col) const {
+        if (!node->valid || (!node->scalar &&
+            (node->rows != rows || node->cols != cols))) {
+            throw DimensionError("Expression dimensions don't match.");
+        }
+        if (rows <= 0 || cols <= 0) {
+            return;
+        }
+        Program program = compile();
+        // Walk along the shorter stride of dest, in lines of inner
+        // elements
+        bool by_rows = cols > 1 &&
+            (rows == 1 || std::abs(inc_col) <= std::abs(inc_row));
+        Index lines = by_rows ? rows : cols;
+        Index inner = by_rows ? cols : rows;
+        Index line_chunks = (inner + expr_chunk_size - 1) / expr_chunk_size;
+        Index chunks = lines * line_chunks;
+        int tasks = parallel_tasks(rows * cols * program.steps.size(),
+            expr_min_work, chunks);
+        thread_pool().run(tasks, [&](int t) {
+            ArrayPtr<double> buf(program.slots * expr_chunk_size,
+                uninitialized);
+            std::vector<const double*> values(program.slots);
+            for (const Step& step : program.steps) {
+                if (step.node->op == CONSTANT_EXPR) {
+                    double* out = buf.pointer() + step.out * expr_chunk_size;
+                    std::fill(out, out + expr_chunk_size, step.node->value);
+                }
+            }
+            Index c1 = split_start(chunks, 1, tasks, t + 1);
+            for (Index c = split_start(chunks, 1, tasks, t); c < c1; ++c) {
+                Index line = c / line_chunks;
+                Index start = c % line_chunks * expr_chunk_size;
+                Index n = std::min(expr_chunk_size, inner - start);
+                Index i = by_rows ? line : start;
+                Index j = by_rows ? start : line;
+                evaluate_chunk(program, buf.pointer(), values.data(),
+                    i, j, by_rows, n,
+                    dest + i * inc_row + j * inc_col,
+                    by_rows ? inc_col : inc_row);
+            }
+        });
+    }
+    // Evaluates the n elements from (i,j) along a row if by_rows or a
+    // column if not, and writes them to out[k * inc]
+    static void evaluate_chunk(const Program& program, double* buf,
+        const double** values, Index i, Index j, bool by_rows, Index n,
+        double* out, Index inc) {
+        for (std::size_t s = 0; s < program.steps.size(); ++s) {
+            const Step& step = program.steps[s];
+            const Node* node = step.node;
+            double* slot = buf + step.out * expr_chunk_size;
+            if (node->op == VARIABLE_EXPR) {
+                const double* p = node->p + i * node->inc_row +
+                    j * node->inc_col;
+                Index stride = by_rows ? node->inc_col : node->inc_row;
+                if (stride == 1) {
+                    values[step.out] = p;
+                } else {
+                    strided_copy(slot, 1, p, stride, n);
+                    values[step.out] = slot;
+                }
+                continue;
+            }
+            if (node->op == CONSTANT_EXPR) {
+                values[step.out] = slot;
+                continue;
+            }
+            // The last step writes straight to contiguous destinations.
+            // out may be the slot of an operand.
+            bool last = s + 1 == program.steps.size();
+            double* result = last && inc == 1 ? out : slot;
+            apply(node->op, n, values[step.a],
+                step.b >= 0 ? values[step.b] : nullptr, result);
+            values[step.out] = result;
+        }
+        const double* result = values[program.steps.back().out];
+        if (result != out) {
+            strided_copy(out, inc, result, 1, n);
+        }
+    }
+    static void apply(ExprOp op, Index n, const double* a, const double* b,
+        double* out) {
+        switch (op) {
+            case ADD_EXPR:
+                for (Index k = 0; k < n; ++k) out[k] = a[k] + b[k];
+                break;
+            case SUBTRACT_EXPR:
+                for (Index k = 0; k < n; ++k) out[k] = a[k] - b[k];
+                break;
+            case MULTIPLY_EXPR:
+                for (Index k = 0; k < n; ++k) out[k] = a[k] * b[k];
+                break;
+            case DIVIDE_EXPR:
+                for (Index k = 0; k < n; ++k) out[k] = a[k] / b[k];
+                break;
+            case POW_EXPR:
+                for (Index k = 0; k < n; ++k) out[k] = std::pow(a[k], b[k]);
+                break;
+            case MIN_EXPR:
+                for (Index k = 0; k < n; ++k) out[k] = std::fmin(a[k], b[k]);
+                break;
+            case MAX_EXPR:
+                for (Index k = 0; k < n; ++k) out[k] = std::fmax(a[k], b[k]);
+                break;
+            case NEGATE_EXPR:
+                for (Index k = 0; k < n; ++k) out[k] = -a[k];
+                break;
+            case ABS_EXPR:
+                for (Index k = 0; k < n; ++k) out[k] = std::abs(a[k]);
+                break;
+            case EXP_EXPR:
+                for (Index k = 0; k < n; ++k) out[k] = std::exp(a[k]);
+                break;
+            case LOG_EXPR:
+                for (Index k = 0; k < n; ++k) out[k] = std::log(a[k]);
+                break;
+            case SQRT_EXPR:
+                for (Index k = 0; k < n; ++k) out[k] = std::sqrt(a[k]);
+                break;
+            case SIN_EXPR:
+                for (Index k = 0; k < n; ++k) out[k] = std::sin(a[k]);
+                break;
+            case COS_EXPR:
+                for (Index k = 0; k < n; ++k) out[k] = std::cos(a[k]);
+                break;
+            case TANH_EXPR:
+                for (Index k = 0; k < n; ++k) out[k] = std::tanh(a[k]);
+                break;
+            default:
+                break;
+        }
+    }
+    std::shared_ptr<const Node> node;
+};
+
+#endif
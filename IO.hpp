@@ -7,8 +7,36 @@
 #include <string>
 #include <stdexcept>
 #include <typeinfo>
+#include <cstdint>
+#include <limits>
+#include <initializer_list>
+#include <charconv>
+#include <cstring>
+#include <cstdlib>
+#include <type_traits>
+#include <vector>
+#include <map>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <deque>
+#include <chrono>
+#include <exception>
+#include <algorithm>
+#include <iterator>
+#include <charconv>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "Arrays.hpp"
+#include "Codec.hpp"
 
 // Raised when a file couldn't be opened
 class FileError : public std::runtime_error {
@@ -24,6 +52,451 @@ public:
 
 using std::ios_base;
 
+// Types parsed with std::from_chars. Others go through iostreams, 
+// which treat char as a single character and complex as (a,b).
+template <class T>
+struct FastParse {
+    static const bool value = std::is_arithmetic<T>::value &&
+        !std::is_same<T, char>::value && !std::is_same<T, bool>::value;
+};
+
+// Parses the token [begin, end) as a T. Returns false if it isn't one.
+template <class T>
+bool parse_token(const char* begin, const char* end, T& x) {
+    if (begin != end && *begin == '+') {
+        ++begin; // from_chars doesn't accept a leading plus sign
+    }
+    auto result = std::from_chars(begin, end, x);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+// Digits written for floating point values by default, like iostreams
+const int default_precision = 6;
+// Enough for any formatted token
+const std::size_t max_token_size = 256;
+
+// Writes x to [first, last) and returns the end of the text. Floating
+// point values get precision significant digits, or the fewest digits
+// that read back exactly if precision is negative.
+template <class T>
+char* format_token(char* first, char* last, const T& x, int precision) {
+    if constexpr (std::is_floating_point<T>::value) {
+        if (precision < 0) {
+            return std::to_chars(first, last, x).ptr;
+        }
+        return std::to_chars(first, last, x, std::chars_format::general,
+            std::min(precision, 64)).ptr;
+    } else if constexpr (FastParse<T>::value) {
+        return std::to_chars(first, last, x).ptr;
+    } else if constexpr (ScalarSize<T>::value != sizeof(T)) {
+        // Complex as (a,b)
+        *first++ = '(';
+        first = format_token(first, last, x.real(), precision);
+        *first++ = ',';
+        first = format_token(first, last, x.imag(), precision);
+        *first++ = ')';
+        return first;
+    } else {
+        std::ostringstream out;
+        out << x;
+        std::string text = out.str();
+        std::size_t n = std::min<std::size_t>(text.size(), last - first);
+        return std::copy(text.begin(), text.begin() + n, first);
+    }
+}
+
+inline bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Calls f(token_begin, token_end) for each whitespace separated token
+// in [begin, end) and returns the number of tokens
+template <class F>
+Index for_each_token(const char* begin, const char* end, F f) {
+    Index count = 0;
+    const char* p = begin;
+    while (true) {
+        while (p != end && is_blank(*p)) {
+            ++p;
+        }
+        if (p == end) {
+            return count;
+        }
+        const char* token = p;
+        while (p != end && !is_blank(*p)) {
+            ++p;
+        }
+        f(token, p);
+        ++count;
+    }
+}
+
+// Calls put(j, x) for the jth value of type T in the line [begin, end).
+// Returns the number of values.
+template <class T, class F>
+Index parse_line(const char* begin, const char* end, F put) {
+    Index j = 0;
+    if constexpr (FastParse<T>::value) {
+        for_each_token(begin, end, 
+            [&](const char* token, const char* token_end) {
+                T x;
+                if (!parse_token(token, token_end, x)) {
+                    throw FormatError("Couldn't read value.");
+                }
+                put(j++, x);
+            });
+    } else {
+        std::istringstream iss(std::string(begin, end));
+        T x;
+        while (iss >> x) {
+            put(j++, x);
+        }
+    }
+    return j;
+}
+
+// Number of threads for parallel file routines. 0 means one per core.
+inline std::atomic<int>& io_threads() {
+    static std::atomic<int> threads(0);
+    return threads;
+}
+
+inline int io_thread_count() {
+    int threads = io_threads();
+    if (threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return threads;
+}
+
+// Runs f(k) for k in [0, tasks) on separate threads.
+// Rethrows the exception from the lowest numbered failed task.
+template <class F>
+void run_parallel(int tasks, F f) {
+    std::vector<std::exception_ptr> errors(tasks);
+    std::vector<std::thread> threads;
+    for (int k = 1; k < tasks; ++k) {
+        threads.emplace_back([&errors, &f, k]() {
+            try {
+                f(k);
+            } catch (...) {
+                errors[k] = std::current_exception();
+            }
+        });
+    }
+    try {
+        f(0);
+    } catch (...) {
+        errors[0] = std::current_exception();
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (auto& e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+}
+
+// Background threads that run queued tasks, for asynchronous I/O.
+// Queued tasks still run when the pool is destroyed.
+class IOPool {
+public:
+    IOPool() {}
+    ~IOPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto* list : {&workers, &retired}) {
+            for (auto& w : *list) {
+                w->thread.join();
+            }
+        }
+    }
+    IOPool(const IOPool&) = delete;
+    IOPool& operator=(const IOPool&) = delete;
+    // Number of workers as of the last resize
+    int size() const {
+        return threads;
+    }
+    // Starts or stops workers so there are the given number. Stopped
+    // workers finish their current task first and aren't waited for, 
+    // so tasks can resize the pool too.
+    void resize(int count) {
+        std::vector<std::unique_ptr<Worker>> finished;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            while ((int) workers.size() > count) {
+                workers.back()->stop = true;
+                retired.push_back(std::move(workers.back()));
+                workers.pop_back();
+            }
+            while ((int) workers.size() < count) {
+                std::unique_ptr<Worker> w(new Worker);
+                Worker* p = w.get();
+                w->thread = std::thread([this, p]() { work(p); });
+                workers.push_back(std::move(w));
+            }
+            threads = count;
+            // Workers stopped earlier that have returned are joined
+            auto running = std::partition(retired.begin(), retired.end(),
+                [](const std::unique_ptr<Worker>& w) { return !w->done; });
+            std::move(running, retired.end(), std::back_inserter(finished));
+            retired.erase(running, retired.end());
+        }
+        wake.notify_all();
+        for (auto& w : finished) {
+            w->thread.join();
+        }
+    }
+    // Queues f and returns the future of its result
+    template <class F>
+    auto submit(F f) -> std::future<decltype(f())> {
+        auto task = std::make_shared<std::packaged_task<decltype(f())()>>(
+            std::move(f));
+        std::future<decltype(f())> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace_back([task]() { (*task)(); });
+        }
+        wake.notify_one();
+        return result;
+    }
+private:
+    struct Worker {
+        std::thread thread;
+        bool stop = false; // Set by resize
+        bool done = false; // Set by the worker as it returns
+    };
+    // Runs tasks until the pool is destroyed or w is stopped
+    void work(Worker* w) {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this, w]() { 
+                    return stopping || w->stop || !tasks.empty(); 
+                });
+                if (w->stop || tasks.empty()) {
+                    if (!tasks.empty()) { // Pass on a wake up meant for others
+                        wake.notify_one();
+                    }
+                    w->done = true;
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::unique_ptr<Worker>> retired; // Stopped, not joined
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::atomic<int> threads{0};
+    bool stopping = false;
+};
+
+// Pool for asynchronous I/O, resized when io_thread_count() changes
+inline IOPool& io_pool() {
+    static IOPool pool;
+    int threads = io_thread_count();
+    if (pool.size() != threads) {
+        pool.resize(threads);
+    }
+    return pool;
+}
+
+// Handle to an asynchronous read or write. The result is the array
+// read, or null, and an error code.
+class Future {
+public:
+    typedef std::pair<void*, int> Result;
+    Future(std::future<Result> f) : f(std::move(f)) {}
+    // Whether the result is ready, without waiting
+    bool ready() const {
+        return f.wait_for(std::chrono::seconds(0)) == 
+            std::future_status::ready;
+    }
+    Result get() {
+        return f.get();
+    }
+private:
+    std::future<Result> f;
+};
+
+// Error code of asynchronous reads and writes that failed other than
+// with a FileError or FormatError, such as by running out of memory
+const int async_error = 3;
+
+// Runs f, which returns a Future::Result, on the I/O threads. Exceptions
+// f lets through, and failing to start it, give async_error.
+template <class F>
+Future* start_async(F f) {
+    auto task = [f]() {
+        try {
+            return f();
+        } catch (...) {
+            return Future::Result(nullptr, async_error);
+        }
+    };
+    try {
+        return new Future(io_pool().submit(task));
+    } catch (...) {
+        std::promise<Future::Result> failed;
+        failed.set_value(Future::Result(nullptr, async_error));
+        return new Future(failed.get_future());
+    }
+}
+
+// How a file is mapped into memory
+enum MapMode {
+    READ_ONLY_MAP = 0, // Writing to the mapping crashes
+    SHARED_MAP = 1, // Writes go to the file
+    PRIVATE_MAP = 2 // Writes stay private to the process (copy on write)
+};
+
+// Memory mapping of a whole file
+class MappedFile {
+public:
+    MappedFile(const std::string& filename, MapMode mode = READ_ONLY_MAP) {
+        int fd = ::open(filename.c_str(), 
+            mode == SHARED_MAP ? O_RDWR : O_RDONLY);
+        if (fd < 0) {
+            throw FileError("Couldn't open " + filename);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw FileError("Couldn't open " + filename);
+        }
+        length = info.st_size;
+        if (length > 0) {
+            int protection = PROT_READ;
+            if (mode != READ_ONLY_MAP) {
+                protection |= PROT_WRITE;
+            }
+            void* p = mmap(nullptr, length, protection, 
+                mode == PRIVATE_MAP ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw FileError("Couldn't map " + filename);
+            }
+            start = static_cast<char*>(p);
+        }
+        ::close(fd);
+    }
+    ~MappedFile() {
+        if (start) {
+            munmap(start, length);
+        }
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    char* data() const {
+        return start;
+    }
+    std::size_t size() const {
+        return length;
+    }
+private:
+    char* start = nullptr;
+    std::size_t length = 0;
+};
+
+// Whether rows * cols elements of the given size fit in bytes, checked
+// without overflowing
+inline bool fits_in(Index rows, Index cols, std::size_t size, 
+    std::uint64_t bytes) {
+    if (rows < 0 || cols < 0) {
+        return false;
+    }
+    std::uint64_t count = bytes / size;
+    return cols == 0 || std::uint64_t(rows) <= count / std::uint64_t(cols);
+}
+
+// Array of rows * cols elements pointing into a mapped file at the
+// given byte offset. The dimensions come from the file, so they're
+// checked against its size without overflowing.
+// The file stays mapped until the last view of it is destroyed.
+template <class T>
+ArrayPtr<T> mapped_array(const std::string& filename, MapMode mode,
+    std::size_t offset, Index rows, Index cols = 1) {
+    auto map = std::make_shared<MappedFile>(filename, mode);
+    if (rows < 0 || cols < 0) {
+        throw FormatError("Negative dimensions.");
+    }
+    if (offset > map->size() || 
+        !fits_in(rows, cols, sizeof(T), map->size() - offset)) {
+        throw FormatError("File is too short.");
+    }
+    Index n = rows * cols;
+    if (offset % alignof(T) != 0) {
+        throw FormatError("Data in file isn't aligned for mapping.");
+    }
+    T* p = reinterpret_cast<T*>(map->data() + offset);
+    return ArrayPtr<T>(p, n, [map](T*) {});
+}
+
+// Reads a stream one line at a time through a large buffer.
+// Lines are split like std::getline.
+class LineBuffer {
+public:
+    LineBuffer(std::istream& in, std::size_t capacity = 1 << 20) :
+        in(in), buffer(capacity) {}
+    // Points [begin, end) at the next line without its newline.
+    // Returns false at the end of the stream.
+    bool next(const char*& begin, const char*& end) {
+        while (true) {
+            const char* start = buffer.data() + pos;
+            const char* stop = buffer.data() + filled;
+            const char* newline = static_cast<const char*>(
+                std::memchr(start, '\n', stop - start));
+            if (newline) {
+                begin = start;
+                end = newline;
+                pos = newline - buffer.data() + 1;
+                return true;
+            }
+            if (eof) {
+                if (start == stop) {
+                    return false;
+                }
+                begin = start; // Last line has no newline
+                end = stop;
+                pos = filled;
+                return true;
+            }
+            refill();
+        }
+    }
+private:
+    // Moves the partial line to the front and reads more after it
+    void refill() {
+        std::size_t rest = filled - pos;
+        std::memmove(buffer.data(), buffer.data() + pos, rest);
+        pos = 0;
+        filled = rest;
+        if (filled == buffer.size()) {
+            buffer.resize(2 * buffer.size()); // Very long line
+        }
+        in.read(buffer.data() + filled, buffer.size() - filled);
+        filled += in.gcount();
+        if (!in) {
+            eof = true;
+        }
+    }
+    std::istream& in;
+    std::vector<char> buffer;
+    std::size_t pos = 0, filled = 0;
+    bool eof = false;
+};
+
 // Tabular text file
 template <class T>
 class File {
@@ -43,6 +516,7 @@ public:
         if (!file.is_open()) {
             throw FileError("Couldn't open " + filename);
         }
+        name = filename;
     }
     void close() {
         file.close();
@@ -52,16 +526,16 @@ public:
         file.clear();
         file.seekg(file.beg);
     }
-    std::pair<int,int> dimensions() {
+    std::pair<Index,Index> dimensions() {
         rewind();
         std::string line;
-        int lines = 0; // how many lines in file
+        Index lines = 0; // how many lines in file
         T x;
-        int file_cols = -1;
+        Index file_cols = -1;
         while (std::getline(file, line)) {
             std::istringstream iss(line);
             // Count how many columns on this line
-            int line_cols = 0;
+            Index line_cols = 0;
             while (iss >> x) {
                 line_cols++;
             }
@@ -94,35 +568,284 @@ public:
         Vector<T> out(lst);
         return out;
     }
-    // Writes vector to file
+    // Writes vector to file. See format_token for precision.
     void write_vector(const Vector<T>& v, 
-        const std::string& sep = " ") {
-        int n = v.get_n();
+        const std::string& sep = " ", int precision = default_precision) {
+        Index n = v.get_n();
         rewind();
-        for (int i = 0; i < n; ++i) {
-            file << v[i];
+        std::string text;
+        char token[max_token_size];
+        for (Index i = 0; i < n; ++i) {
+            text.append(token, format_token(token, token + max_token_size, 
+                v[i], precision));
             if (i != n-1) {
-                file << sep;
+                text += sep;
+            }
+            if (text.size() >= write_chunk_size) {
+                file.write(text.data(), text.size());
+                text.clear();
             }
         }
+        file.write(text.data(), text.size());
+        if (!file.good()) {
+            throw FileError("Couldn't write to file.");
+        }
         file.flush();
         rewind();
     }
     // Reads a matrix of type T from file
     Matrix<T> read_matrix(bool row_major = true) {
+        if constexpr (FastParse<T>::value) {
+            rewind();
+            file.seekg(0, file.end);
+            Index file_size = file.tellg();
+            rewind();
+            int threads = std::min<Index>(io_thread_count(),
+                file_size / parallel_chunk_size);
+            if (threads > 1) {
+                return read_matrix_parallel(row_major, threads);
+            }
+            return read_matrix_fast(row_major);
+        } else {
+            return read_matrix_stream(row_major);
+        }
+    }
+    // Reads into dest, which must have the file's length.
+    // dest may be partly overwritten if there's an error.
+    void read_vector_into(Vector<T>& dest) {
+        Index n = dest.get_n();
+        Index i = 0;
+        rewind();
+        LineBuffer lines(file);
+        const char *begin, *end;
+        while (lines.next(begin, end)) {
+            parse_line<T>(begin, end, [&](Index, const T& x) {
+                if (i == n) {
+                    throw FormatError("File holds a vector of another length.");
+                }
+                dest[i++] = x;
+            });
+        }
+        if (i != n) {
+            throw FormatError("File holds a vector of another length.");
+        }
+        rewind();
+    }
+    // Reads into dest, which must have the file's dimensions.
+    // dest may be partly overwritten if there's an error.
+    void read_matrix_into(Matrix<T>& dest) {
+        Index rows = dest.get_rows();
+        Index cols = dest.get_cols();
+        Index inc_row = dest.get_inc_row(), inc_col = dest.get_inc_col();
+        Index i = 0;
+        rewind();
+        LineBuffer lines(file);
+        const char *begin, *end;
+        while (lines.next(begin, end)) {
+            if (i == rows) {
+                throw FormatError("File holds a matrix of other dimensions.");
+            }
+            T* row = dest.pointer() + inc_row * i;
+            Index line_cols = parse_line<T>(begin, end, 
+                [&](Index j, const T& x) {
+                    if (j == cols) {
+                        throw FormatError(
+                            "File holds a matrix of other dimensions.");
+                    }
+                    row[inc_col * j] = x;
+                });
+            if (line_cols != cols) {
+                throw FormatError("File holds a matrix of other dimensions.");
+            }
+            i++;
+        }
+        if (i != rows) {
+            throw FormatError("File holds a matrix of other dimensions.");
+        }
+        rewind();
+    }
+    // Writes matrix to a file.
+    // sep is the separator between entries. See format_token for precision.
+    // Blocks of rows are formatted in parallel, then written in order.
+    void write_matrix(const Matrix<T>& mat, 
+        const std::string& sep=" ", int precision = default_precision) {
+        Index rows = mat.get_rows();
+        Index cols = mat.get_cols();
+        // Rows per block, aiming for a chunk of text each
+        Index block = std::max<Index>(1, 
+            write_chunk_size / (16 * std::max<Index>(cols, 1)));
+        int threads = std::min<Index>(io_thread_count(), 
+            (rows + block - 1) / block);
+        threads = std::max(threads, 1);
+        std::vector<std::string> text(threads);
+        auto format_block = [&](Index begin, Index end, std::string& out) {
+            char token[max_token_size];
+            out.clear();
+            for (Index i = begin; i < end; ++i) {
+                for (Index j = 0; j < cols; ++j) {
+                    out.append(token, format_token(token, 
+                        token + max_token_size, mat(i,j), precision));
+                    if (j != cols-1) {
+                        out += sep;
+                    }
+                }
+                out += '\n';
+            }
+        };
+        for (Index i = 0; i < rows; i += block * threads) {
+            int tasks = std::min<Index>(threads, 
+                (rows - i + block - 1) / block);
+            auto format = [&](int k) {
+                Index begin = i + block * k;
+                format_block(begin, std::min(begin + block, rows), text[k]);
+            };
+            if (tasks > 1) {
+                run_parallel(tasks, format);
+            } else {
+                format(0);
+            }
+            for (int k = 0; k < tasks; ++k) {
+                file.write(text[k].data(), text[k].size());
+            }
+        }
+        if (!file.good()) {
+            throw FileError("Couldn't write to file.");
+        }
+        file.flush();
+    }
+private:
+    // Scans the file once, growing the storage as rows are parsed
+    Matrix<T> read_matrix_fast(bool row_major) {
+        rewind();
+        file.seekg(0, file.end);
+        Index file_size = file.tellg();
+        rewind();
+        LineBuffer lines(file);
+        ArrayPtr<T> storage;
+        Index size = 0, rows = 0, cols = -1;
+        const char *begin, *end;
+        while (lines.next(begin, end)) {
+            Index line_cols = for_each_token(begin, end,
+                [&](const char* token, const char* token_end) {
+                    if (size == storage.size()) {
+                        storage = grow(storage, size, 2 * size + 16);
+                    }
+                    if (!parse_token(token, token_end, 
+                        storage.pointer()[size])) {
+                        throw FormatError("Couldn't read value.");
+                    }
+                    ++size;
+                });
+            if (cols < 0) {
+                cols = line_cols;
+                // Guess the number of rows from the first line's length
+                Index estimate = (file_size / (end - begin + 1) + 1) * cols;
+                storage = grow(storage, size, estimate + estimate / 16);
+            } else if (cols != line_cols) {
+                throw FormatError("Uneven line lengths.");
+            }
+            rows++;
+        }
+        rewind();
+        cols = std::max<Index>(cols, 0);
+        if (row_major && storage.size() - size <= size / 4) {
+            return Matrix<T>(storage, 0, cols, 1, rows, cols);
+        }
+        // Copy to exactly sized storage in the requested order
+        Matrix<T> out(rows, cols, row_major, uninitialized);
+        if (size > 0) {
+            strided_copy_2d(out.pointer(), 
+                out.get_inc_row(), out.get_inc_col(),
+                storage.pointer(), cols, Index(1), rows, cols);
+        }
+        return out;
+    }
+    // Bytes of text per thread worth parsing in parallel
+    static const Index parallel_chunk_size = Index(4) << 20;
+    // Bytes of text formatted before each write
+    static const Index write_chunk_size = Index(1) << 20;
+    // Splits the mapped file into chunks at line boundaries.
+    // Counts the lines of each chunk in parallel, then parses each chunk
+    // straight into its rows of the output.
+    Matrix<T> read_matrix_parallel(bool row_major, int threads) {
+        MappedFile map(name);
+        const char* text = map.data();
+        const char* text_end = text + map.size();
+        // Chunk k is [bounds[k], bounds[k+1])
+        std::vector<const char*> bounds(threads + 1, text_end);
+        bounds[0] = text;
+        for (int k = 1; k < threads; ++k) {
+            const char* guess = std::max(bounds[k-1], 
+                text + map.size() / threads * k);
+            const char* newline = static_cast<const char*>(
+                std::memchr(guess, '\n', text_end - guess));
+            bounds[k] = newline ? newline + 1 : text_end;
+        }
+        // Lines are split like std::getline
+        std::vector<Index> first_row(threads + 1, 0);
+        run_parallel(threads, [&](int k) {
+            Index lines = std::count(bounds[k], bounds[k+1], '\n');
+            if (bounds[k+1] == text_end && bounds[k] != text_end &&
+                text_end[-1] != '\n') {
+                lines++; // Last line has no newline
+            }
+            first_row[k+1] = lines;
+        });
+        for (int k = 0; k < threads; ++k) {
+            first_row[k+1] += first_row[k];
+        }
+        Index rows = first_row[threads];
+        const char* first_end = static_cast<const char*>(
+            std::memchr(text, '\n', map.size()));
+        Index cols = (rows == 0) ? 0 : for_each_token(text, 
+            first_end ? first_end : text_end,
+            [](const char*, const char*) {});
+        Matrix<T> out(rows, cols, row_major, uninitialized);
+        T* base = out.pointer();
+        Index inc_row = out.get_inc_row(), inc_col = out.get_inc_col();
+        run_parallel(threads, [&](int k) {
+            const char* p = bounds[k];
+            const char* chunk_end = bounds[k+1];
+            for (Index i = first_row[k]; i < first_row[k+1]; ++i) {
+                const char* newline = static_cast<const char*>(
+                    std::memchr(p, '\n', chunk_end - p));
+                const char* line_end = newline ? newline : chunk_end;
+                T* row = base + inc_row * i;
+                Index j = 0;
+                for_each_token(p, line_end,
+                    [&](const char* token, const char* token_end) {
+                        if (j == cols) {
+                            throw FormatError("Uneven line lengths.");
+                        }
+                        if (!parse_token(token, token_end, 
+                            row[inc_col * j])) {
+                            throw FormatError("Couldn't read value.");
+                        }
+                        ++j;
+                    });
+                if (j != cols) {
+                    throw FormatError("Uneven line lengths.");
+                }
+                p = line_end + 1;
+            }
+        });
+        return out;
+    }
+    // Reads a matrix through iostreams, for types from_chars can't parse
+    Matrix<T> read_matrix_stream(bool row_major) {
         auto dims = dimensions();
-        int rows = dims.first;
-        int cols = dims.second;
+        Index rows = dims.first;
+        Index cols = dims.second;
         rewind();
-        Matrix<T> out(rows, cols, row_major);
+        Matrix<T> out(rows, cols, row_major, uninitialized);
         // Read each line
         std::string line;
         T x;
-        for (int i = 0; i < rows; ++i) {
+        for (Index i = 0; i < rows; ++i) {
             std::getline(file, line);
             std::istringstream iss(line);
             // Read each column in the line
-            for (int j = 0; j < cols; ++j) {
+            for (Index j = 0; j < cols; ++j) {
                 iss >> x;
                 if (iss.fail()) {
                     throw FormatError("Couldn't read value.");
@@ -133,31 +856,64 @@ public:
         rewind();
         return out;
     }
-    // Writes matrix to a file.
-    // sep is the separator between entries
-    void write_matrix(const Matrix<T>& mat, 
-        const std::string& sep=" ") {
-        // Find the dimensions
-        int rows = mat.get_rows();
-        int cols = mat.get_cols();
-        // Write the elements of matrix
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                file << mat(i,j);
-                if (j != cols-1) {
-                    file << sep;
-                } else {
-                    file << std::endl;
-                }
-            }
-        }
-        if (!file.good()) {
-            throw FileError("Couldn't write to file.");
-        }
-        file.flush();
+    // Copies the first size elements of data to a larger array
+    static ArrayPtr<T> grow(const ArrayPtr<T>& data, Index size, 
+        Index capacity) {
+        ArrayPtr<T> bigger(std::max(capacity, size), uninitialized);
+        std::copy(data.pointer(), data.pointer() + size, bigger.pointer());
+        return bigger;
     }
-private:
     std::fstream file;
+    std::string name;
+};
+
+// Binary format, version 1. Fields use the writer's byte order.
+//   0  magic                 6 bytes
+//   6  version               uint8
+//   7  byte order            uint8 (1 little endian, 2 big endian)
+//   8  element type          uint8 (DataType)
+//   9  storage order         uint8 (MatrixOrder)
+//  10  number of dimensions  uint8 (1 or 2)
+//  11  element size          uint8
+//  12  reserved              4 bytes
+//  16  dimensions            2 x int64
+//  32  data offset           uint64
+//  40  reserved up to binary_header_size
+// The data starts at the data offset, which is aligned for mapping.
+// Version 2 is written for compressed data. Byte 12 holds 1, and the
+// data offset points to a chunk table in the same byte order:
+//   0  elements per chunk    uint64
+//   8  number of chunks      uint64
+//  16  chunk offsets         (number of chunks + 1) x uint64
+// The offsets count from the start of the table. Each chunk is encoded
+// on its own (see Codec.hpp), so chunks decode in parallel and can be
+// read without the others.
+const char binary_magic[6] = {'\x93', 'N', 'U', 'M', 'A', 'R'};
+const std::uint8_t binary_version = 1;
+const std::uint8_t binary_compressed_version = 2;
+const std::size_t binary_header_size = 64;
+// Bytes of data in each compressed chunk
+const std::size_t compressed_chunk_bytes = std::size_t(256) << 10;
+
+inline std::uint8_t native_byte_order() {
+    const std::uint16_t one = 1;
+    return *reinterpret_cast<const std::uint8_t*>(&one) == 1 ? 1 : 2;
+}
+
+// Reverses the bytes of each width-byte scalar in [p, p + bytes)
+inline void swap_bytes(char* p, std::size_t bytes, std::size_t width) {
+    for (std::size_t k = 0; k + width <= bytes; k += width) {
+        std::reverse(p + k, p + k + width);
+    }
+}
+
+// Layout of the array in a binary file
+struct BinaryHeader {
+    Index rows = 0, cols = 1; // Vectors have one column
+    MatrixOrder order = ROW_MAJOR_ORDER;
+    bool swapped = false; // Written with the other byte order
+    bool compressed = false;
+    std::size_t data_offset = 0;
 };
 
 // Binary format file
@@ -179,67 +935,579 @@ public:
         if (!file.is_open()) {
             throw FileError("Couldn't open " + filename);
         }
+        name = filename;
     }
     void close() {
         file.close();
     }
     Vector<T> read_vector() {
-        int n = read_binary<int>(); // Read the dimensions
-        Vector<T> read(n);
-        for (int i = 0; i < n; ++i) {
-            read[i] = read_binary<T>();
-            if (file.fail()) {
-                throw FileError("Couldn't read file.");
-            }
-        }
+        Index n = read_header(1).rows; // Read the dimensions
+        Vector<T> read(n, uninitialized);
+        read_block(read.pointer(), n);
         return read;
     }
     void write_vector(const Vector<T>& v) {
-        int n = v.get_n(); // Write the dimensions
-        write_binary(n);
-        for (int i = 0; i < n; ++i) {
-            write_binary(v[i]);
-            if (file.fail()) {
-                throw FileError("Couldn't write file.");
-            }
-        }
+        Index n = v.get_n(); // Write the dimensions
+        write_header(1, n, 1, ROW_MAJOR_ORDER);
+        write_rows(v.pointer(), v.get_inc(), 1, n, 1);
+        finish_chunks();
     }
     Matrix<T> read_matrix(bool row_major = true) {
         // Read the dimensions
-        int rows, cols;
-        rows = read_binary<int>();
-        cols = read_binary<int>();
+        BinaryHeader header = read_header(2);
+        Index rows = header.rows;
+        Index cols = header.cols;
         // Place to put the read values
-        Matrix<T> read(rows, cols, row_major);
-        T x;
-        // Read the file
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                read(i,j) = read_binary<T>();
-                if (file.fail()) {
-                    throw FileError("Couldn't read file.");
-                }
-            }
+        Matrix<T> read(rows, cols, row_major, uninitialized);
+        if (header.order == COL_MAJOR_ORDER) { // Read the transpose
+            read_rows(read.pointer(), read.get_inc_col(), 
+                read.get_inc_row(), cols, rows);
+        } else {
+            read_rows(read.pointer(), read.get_inc_row(), 
+                read.get_inc_col(), rows, cols);
         }
         return read;
     }
+    // Reads into dest, which must have the file's length
+    void read_vector_into(Vector<T>& dest) {
+        if (read_header(1).rows != dest.get_n()) {
+            throw FormatError("File holds a vector of another length.");
+        }
+        read_rows(dest.pointer(), dest.get_inc(), 1, dest.get_n(), 1);
+    }
+    // Reads into dest, which must have the file's dimensions
+    void read_matrix_into(Matrix<T>& dest) {
+        BinaryHeader header = read_header(2);
+        Index rows = dest.get_rows();
+        Index cols = dest.get_cols();
+        if (header.rows != rows || header.cols != cols) {
+            throw FormatError("File holds a matrix of other dimensions.");
+        }
+        if (header.order == COL_MAJOR_ORDER) { // Read the transpose
+            read_rows(dest.pointer(), dest.get_inc_col(), 
+                dest.get_inc_row(), cols, rows);
+        } else {
+            read_rows(dest.pointer(), dest.get_inc_row(), 
+                dest.get_inc_col(), rows, cols);
+        }
+    }
+    // Reads rows [start_row, end_row) and columns [start_col, end_col)
+    // of the stored matrix, reading only the bytes they span
+    Matrix<T> read_subarray(Index start_row, Index start_col,
+        Index end_row, Index end_col, bool row_major = true) {
+        BinaryHeader header = read_header(2);
+        if (start_row < 0 || start_col < 0 || start_row > end_row || 
+            start_col > end_col || end_row > header.rows || 
+            end_col > header.cols) {
+            throw FormatError("Subarray isn't inside the stored matrix.");
+        }
+        Index rows = end_row - start_row;
+        Index cols = end_col - start_col;
+        Matrix<T> read(rows, cols, row_major, uninitialized);
+        if (header.order == COL_MAJOR_ORDER) { // Runs are columns
+            read_runs(read.pointer(), read.get_inc_col(), 
+                read.get_inc_row(), header.data_offset, header.rows,
+                start_col, cols, start_row, rows);
+        } else {
+            read_runs(read.pointer(), read.get_inc_row(), 
+                read.get_inc_col(), header.data_offset, header.cols,
+                start_row, rows, start_col, cols);
+        }
+        return read;
+    }
+    // Maps the file's data into memory instead of reading it
+    Vector<T> map_vector(MapMode mode = READ_ONLY_MAP) {
+        BinaryHeader header = mappable_header(1);
+        Index n = header.rows;
+        return Vector<T>(mapped_array<T>(name, mode, 
+            header.data_offset, n), 0, 1, n);
+    }
+    Matrix<T> map_matrix(MapMode mode = READ_ONLY_MAP) {
+        BinaryHeader header = mappable_header(2);
+        Index rows = header.rows;
+        Index cols = header.cols;
+        ArrayPtr<T> data = mapped_array<T>(name, mode, 
+            header.data_offset, rows, cols);
+        if (header.order == COL_MAJOR_ORDER) {
+            return Matrix<T>(data, 0, 1, rows, rows, cols);
+        }
+        return Matrix<T>(data, 0, cols, 1, rows, cols);
+    }
+    // Column major matrices are stored in column major order
     void write_matrix(const Matrix<T>& mat) {
         // Write the dimensions
-        int rows = mat.get_rows();
-        int cols = mat.get_cols();
-        write_binary(rows);
-        write_binary(cols);
-        // Write the entries
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                write_binary(mat(i,j));
-                if (file.fail()) {
-                    throw FileError("Couldn't write file.");
+        Index rows = mat.get_rows();
+        Index cols = mat.get_cols();
+        Index inc_row = mat.get_inc_row();
+        Index inc_col = mat.get_inc_col();
+        if (inc_row == 1 && inc_col != 1) {
+            write_header(2, rows, cols, COL_MAJOR_ORDER);
+            write_rows(mat.pointer(), inc_col, inc_row, cols, rows);
+        } else {
+            write_header(2, rows, cols, ROW_MAJOR_ORDER);
+            write_rows(mat.pointer(), inc_row, inc_col, rows, cols);
+        }
+        finish_chunks();
+    }
+    // Later writes compress the data in chunks
+    void set_compressed(bool on) {
+        compress = on;
+    }
+protected:
+    void write_header(int ndim, Index rows, Index cols, 
+        MatrixOrder order) {
+        char bytes[binary_header_size] = {};
+        std::memcpy(bytes, binary_magic, sizeof(binary_magic));
+        bytes[6] = compress ? binary_compressed_version : binary_version;
+        bytes[7] = native_byte_order();
+        bytes[8] = TypeCode<T>::value;
+        bytes[9] = order;
+        bytes[10] = ndim;
+        bytes[11] = sizeof(T);
+        bytes[12] = compress;
+        std::int64_t dims[2] = {rows, ndim == 2 ? cols : 0};
+        std::memcpy(bytes + 16, dims, sizeof(dims));
+        std::uint64_t offset = binary_header_size;
+        std::memcpy(bytes + 32, &offset, sizeof(offset));
+        file.write(bytes, binary_header_size);
+        if (file.fail()) {
+            throw FileError("Couldn't write file.");
+        }
+        if (compress) {
+            start_chunks(rows * cols);
+        }
+    }
+    // Reads the header and moves to the start of the data.
+    // Files without the magic number are read in the legacy layout.
+    BinaryHeader read_header(int ndim) {
+        BinaryHeader header;
+        char bytes[binary_header_size];
+        file.seekg(0);
+        file.read(bytes, binary_header_size);
+        if (file.gcount() < Index(sizeof(binary_magic)) ||
+            std::memcmp(bytes, binary_magic, sizeof(binary_magic)) != 0) {
+            file.clear();
+            file.seekg(0);
+            auto dims = read_dimensions(ndim);
+            header.rows = dims[0];
+            header.cols = (ndim == 2) ? dims[1] : 1;
+            header.data_offset = file.tellg();
+            check_data_size(header);
+            file.seekg(header.data_offset);
+            swapped = false;
+            compressed = false;
+            return header;
+        }
+        if (file.fail()) {
+            throw FileError("Couldn't read file.");
+        }
+        std::uint8_t version = bytes[6];
+        if (version != binary_version && 
+            version != binary_compressed_version) {
+            throw FormatError("Unsupported binary format version.");
+        }
+        if (bytes[8] != TypeCode<T>::value || bytes[11] != sizeof(T)) {
+            throw FormatError("File holds a different element type.");
+        }
+        if (bytes[10] != ndim) {
+            throw FormatError("File holds a different number of dimensions.");
+        }
+        swapped = bytes[7] != native_byte_order();
+        std::int64_t dims[2];
+        std::uint64_t offset;
+        std::memcpy(dims, bytes + 16, sizeof(dims));
+        std::memcpy(&offset, bytes + 32, sizeof(offset));
+        if (swapped) {
+            swap_bytes((char*) dims, sizeof(dims), sizeof(dims[0]));
+            swap_bytes((char*) &offset, sizeof(offset), sizeof(offset));
+        }
+        if (dims[0] < 0 || dims[1] < 0) {
+            throw FormatError("Negative dimension.");
+        }
+        header.rows = dims[0];
+        header.cols = (ndim == 2) ? dims[1] : 1;
+        header.order = (bytes[9] == COL_MAJOR_ORDER) ? 
+            COL_MAJOR_ORDER : ROW_MAJOR_ORDER;
+        header.swapped = swapped;
+        header.data_offset = offset;
+        compressed = (version == binary_compressed_version && bytes[12]);
+        header.compressed = compressed;
+        if (compressed) {
+            if (!fits_in(header.rows, header.cols, 1, 
+                std::numeric_limits<Index>::max())) {
+                throw FormatError("Dimensions are too large.");
+            }
+            read_chunk_table(offset, header.rows * header.cols);
+        } else {
+            check_data_size(header);
+        }
+        file.seekg(offset);
+        return header;
+    }
+    std::uint64_t file_size() {
+        file.seekg(0, file.end);
+        std::streamoff size = file.tellg();
+        if (size < 0) {
+            throw FileError("Couldn't read file.");
+        }
+        return size;
+    }
+    // Uncompressed data must fit in the file, so corrupt dimensions
+    // fail before anything is allocated for them
+    void check_data_size(const BinaryHeader& header) {
+        std::uint64_t size = file_size();
+        if (header.data_offset > size || !fits_in(header.rows, 
+            header.cols, sizeof(T), size - header.data_offset)) {
+            throw FormatError("File is too short for its dimensions.");
+        }
+    }
+    BinaryHeader mappable_header(int ndim) {
+        BinaryHeader header = read_header(ndim);
+        if (header.swapped) {
+            throw FormatError("Can't map a file with the other byte order.");
+        }
+        if (header.compressed) {
+            throw FormatError("Can't map a compressed file.");
+        }
+        return header;
+    }
+    // Legacy files start with 32-bit dimensions
+    std::vector<Index> read_dimensions(std::size_t count) {
+        std::vector<Index> dims(count);
+        for (std::size_t k = 0; k < count; ++k) {
+            dims[k] = read_binary<std::int32_t>();
+        }
+        if (file.fail()) {
+            throw FileError("Couldn't read file.");
+        }
+        for (Index d : dims) {
+            if (d < 0) {
+                throw FormatError("Negative dimension.");
+            }
+        }
+        return dims;
+    }
+    // Elements are moved in one call when contiguous,
+    // otherwise through a staging buffer of about this many bytes
+    static const Index staging_bytes = Index(1) << 20;
+    void read_block(T* p, Index count) {
+        if (compressed) {
+            read_chunks(p, cursor, count);
+            cursor += count;
+            return;
+        }
+        file.read((char*) p, sizeof(T) * count);
+        if (file.fail()) {
+            throw FileError("Couldn't read file.");
+        }
+        if (swapped) {
+            swap_bytes((char*) p, sizeof(T) * count, ScalarSize<T>::value);
+        }
+    }
+    void write_block(const T* p, Index count) {
+        if (compress) {
+            while (count > 0) {
+                Index n = std::min(count, chunk_elements * pending_chunks -
+                    pending_count);
+                std::copy(p, p + n, pending.pointer() + pending_count);
+                pending_count += n;
+                p += n;
+                count -= n;
+                if (pending_count == chunk_elements * pending_chunks) {
+                    write_chunks();
                 }
             }
+            return;
+        }
+        file.write((const char*) p, sizeof(T) * count);
+        if (file.fail()) {
+            throw FileError("Couldn't write file.");
+        }
+    }
+    // Number of rows of the given length that fit in the staging buffer
+    Index staging_rows(Index cols) {
+        Index rows = std::max<Index>(1, staging_bytes / sizeof(T) / cols);
+        if (staging.size() < rows * cols) {
+            staging = ArrayPtr<T>(rows * cols, uninitialized);
+        }
+        return rows;
+    }
+    // Reads rows x cols elements stored in row major order
+    void read_rows(T* p, Index inc_row, Index inc_col, 
+        Index rows, Index cols) {
+        if (rows == 0 || cols == 0) {
+            return;
+        }
+        if (inc_col == 1 && (inc_row == cols || rows == 1)) {
+            read_block(p, rows * cols);
+            return;
+        }
+        Index block = staging_rows(cols);
+        for (Index i = 0; i < rows; i += block) {
+            Index n = std::min(block, rows - i);
+            read_block(staging.pointer(), n * cols);
+            strided_copy_2d(p + inc_row * i, inc_row, inc_col,
+                staging.pointer(), cols, Index(1), n, cols);
+        }
+    }
+    // Writes rows x cols elements in row major order
+    void write_rows(const T* p, Index inc_row, Index inc_col, 
+        Index rows, Index cols) {
+        if (rows == 0 || cols == 0) {
+            return;
+        }
+        if (inc_col == 1 && (inc_row == cols || rows == 1)) {
+            write_block(p, rows * cols);
+            return;
+        }
+        Index block = staging_rows(cols);
+        for (Index i = 0; i < rows; i += block) {
+            Index n = std::min(block, rows - i);
+            strided_copy_2d(staging.pointer(), cols, Index(1),
+                p + inc_row * i, inc_row, inc_col, n, cols);
+            write_block(staging.pointer(), n * cols);
+        }
+    }
+    // Seeking past fewer bytes than this costs more than reading them
+    static const Index coalesce_bytes = Index(64) << 10;
+    // Reads elements [first, first + width) of lines [line, line + count)
+    // of data stored as lines of line_length elements
+    void read_runs(T* p, Index inc_line, Index inc_elem, 
+        std::size_t data_offset, Index line_length, 
+        Index line, Index count, Index first, Index width) {
+        if (count == 0 || width == 0) {
+            return;
+        }
+        seek_element(data_offset, line * line_length + first);
+        if (width == line_length) { // One contiguous run
+            read_rows(p, inc_line, inc_elem, count, width);
+            return;
+        }
+        if (sizeof(T) * (line_length - width) <= Index(coalesce_bytes)) {
+            // Read through the gaps, a block of lines at a time
+            Index block = staging_rows(line_length);
+            for (Index k = 0; k < count; k += block) {
+                Index n = std::min(block, count - k);
+                read_block(staging.pointer(), (n - 1) * line_length + width);
+                strided_copy_2d(p + inc_line * k, inc_line, inc_elem,
+                    staging.pointer(), line_length, Index(1), n, width);
+                // Skip the rest of the last line
+                skip_elements(line_length - width);
+            }
+            return;
+        }
+        for (Index k = 0; k < count; ++k) {
+            if (k > 0) {
+                skip_elements(line_length - width);
+            }
+            read_rows(p + inc_line * k, inc_line, inc_elem, 1, width);
+        }
+    }
+    // Moves to element k of data starting at byte data_offset
+    void seek_element(std::size_t data_offset, Index k) {
+        if (compressed) {
+            cursor = k;
+        } else {
+            file.seekg(data_offset + sizeof(T) * k);
+        }
+    }
+    void skip_elements(Index k) {
+        if (compressed) {
+            cursor += k;
+        } else {
+            file.seekg(sizeof(T) * k, file.cur);
+        }
+    }
+    // Compressed data is written a chunk per thread at a time
+    void start_chunks(Index count) {
+        chunk_elements = std::max<std::size_t>(1, 
+            compressed_chunk_bytes / sizeof(T));
+        chunk_count = (count + chunk_elements - 1) / chunk_elements;
+        chunk_table = file.tellp();
+        chunk_offsets.assign(1, 2 * sizeof(std::uint64_t) + 
+            sizeof(std::uint64_t) * (chunk_count + 1));
+        std::uint64_t sizes[2] = {std::uint64_t(chunk_elements), 
+            std::uint64_t(chunk_count)};
+        file.write((const char*) sizes, sizeof(sizes));
+        // Offsets are filled in by finish_chunks
+        std::vector<std::uint64_t> blank(chunk_count + 1);
+        file.write((const char*) blank.data(), 
+            sizeof(std::uint64_t) * blank.size());
+        pending_chunks = std::max<Index>(1, std::min<Index>(
+            io_thread_count(), chunk_count));
+        pending = ArrayPtr<T>(chunk_elements * pending_chunks, uninitialized);
+        pending_count = 0;
+    }
+    // Compresses the pending elements and writes them
+    void write_chunks() {
+        Index chunks = (pending_count + chunk_elements - 1) / chunk_elements;
+        std::vector<std::vector<char>> packed_chunks(chunks);
+        run_parallel(std::min<Index>(pending_chunks, chunks), [&](int k) {
+            for (Index c = k; c < chunks; c += pending_chunks) {
+                Index begin = c * chunk_elements;
+                compress_chunk(pending.pointer() + begin, 
+                    std::min(chunk_elements, pending_count - begin),
+                    packed_chunks[c]);
+            }
+        });
+        for (const auto& chunk : packed_chunks) {
+            file.write(chunk.data(), chunk.size());
+            chunk_offsets.push_back(chunk_offsets.back() + chunk.size());
+        }
+        pending_count = 0;
+        if (file.fail()) {
+            throw FileError("Couldn't write file.");
+        }
+    }
+    // Writes the last chunks and the chunk table
+    void finish_chunks() {
+        if (!compress) {
+            return;
+        }
+        if (pending_count > 0) {
+            write_chunks();
+        }
+        file.seekp(chunk_table + 2 * sizeof(std::uint64_t));
+        file.write((const char*) chunk_offsets.data(), 
+            sizeof(std::uint64_t) * chunk_offsets.size());
+        file.seekp(0, file.end);
+        if (file.fail()) {
+            throw FileError("Couldn't write file.");
+        }
+    }
+    void read_chunk_table(std::size_t offset, Index count) {
+        std::uint64_t sizes[2];
+        file.seekg(offset);
+        file.read((char*) sizes, sizeof(sizes));
+        if (file.fail()) {
+            throw FormatError("Bad chunk table.");
+        }
+        if (swapped) {
+            swap_bytes((char*) sizes, sizeof(sizes), sizeof(sizes[0]));
+        }
+        // Chunks hold no more than writers put in them, and the table
+        // and chunks must be inside the file
+        std::uint64_t max_elements = std::max<std::size_t>(1, 
+            compressed_chunk_bytes / sizeof(T));
+        std::uint64_t size = file_size();
+        if (sizes[0] == 0 || sizes[0] > max_elements ||
+            sizes[1] != (count + sizes[0] - 1) / sizes[0] ||
+            offset > size || (size - offset) / sizeof(std::uint64_t) < 
+            sizes[1] + 3) {
+            throw FormatError("Bad chunk table.");
+        }
+        chunk_elements = sizes[0];
+        chunk_count = sizes[1];
+        chunk_table = offset;
+        chunk_offsets.resize(chunk_count + 1);
+        file.seekg(offset + sizeof(sizes));
+        file.read((char*) chunk_offsets.data(), 
+            sizeof(std::uint64_t) * chunk_offsets.size());
+        if (swapped) {
+            swap_bytes((char*) chunk_offsets.data(), 
+                sizeof(std::uint64_t) * chunk_offsets.size(), 
+                sizeof(std::uint64_t));
+        }
+        std::uint64_t table_size = sizeof(std::uint64_t) * (chunk_count + 3);
+        if (file.fail() || chunk_offsets[0] < table_size || 
+            chunk_offsets.back() > size - offset ||
+            !std::is_sorted(chunk_offsets.begin(), chunk_offsets.end())) {
+            throw FormatError("Bad chunk table.");
+        }
+        element_count = count;
+        cursor = 0;
+        cached_chunk = -1;
+    }
+    // Decodes elements [first, first + count) from the chunks holding
+    // them, reading the chunks in one go and decoding them in parallel.
+    // The last chunk only partly read stays decoded, since reads of
+    // runs usually start or end in it.
+    void read_chunks(T* p, Index first, Index count) {
+        if (count == 0) {
+            return;
+        }
+        if (first < 0 || first + count > element_count) {
+            throw FormatError("File is too short.");
+        }
+        Index last = first + count;
+        if (cached_chunk >= 0) {
+            Index begin = cached_chunk * chunk_elements;
+            Index end = begin + cached.size();
+            if (first >= begin && first < end) {
+                Index hi = std::min(last, end);
+                std::copy(cached.begin() + (first - begin), 
+                    cached.begin() + (hi - begin), p);
+                p += hi - first;
+                first = hi;
+            } else if (last > begin && last <= end) {
+                std::copy(cached.begin(), cached.begin() + (last - begin), 
+                    p + (begin - first));
+                last = begin;
+            }
+            if (first == last) {
+                return;
+            }
+            count = last - first;
+        }
+        Index c0 = first / chunk_elements;
+        Index c1 = (last - 1) / chunk_elements + 1;
+        // Chunk to keep decoded
+        Index keep = -1;
+        if (last < std::min(c1 * chunk_elements, element_count)) {
+            keep = c1 - 1;
+        } else if (first > c0 * chunk_elements) {
+            keep = c0;
+        }
+        cached_chunk = -1;
+        if (keep >= 0) {
+            cached.resize(std::min(chunk_elements, 
+                element_count - keep * chunk_elements));
+        }
+        std::uint64_t start = chunk_offsets[c0];
+        packed.resize(chunk_offsets[c1] - start);
+        file.seekg(chunk_table + start);
+        file.read(packed.data(), packed.size());
+        if (file.fail()) {
+            throw FileError("Couldn't read file.");
+        }
+        int threads = std::min<Index>(io_thread_count(), c1 - c0);
+        run_parallel(threads, [&](int k) {
+            std::vector<T> partial;
+            for (Index c = c0 + k; c < c1; c += threads) {
+                const char* in = packed.data() + (chunk_offsets[c] - start);
+                const char* in_end = packed.data() + 
+                    (chunk_offsets[c+1] - start);
+                Index begin = c * chunk_elements;
+                Index n = std::min(chunk_elements, element_count - begin);
+                Index lo = std::max(begin, first);
+                Index hi = std::min(begin + n, first + count);
+                if (lo == begin && hi == begin + n) {
+                    decode_chunk(in, in_end, p + (begin - first), n);
+                } else if (c == keep) {
+                    decode_chunk(in, in_end, cached.data(), n);
+                    std::copy(cached.begin() + (lo - begin), 
+                        cached.begin() + (hi - begin), p + (lo - first));
+                } else { // Only part of the chunk is wanted
+                    partial.resize(n);
+                    decode_chunk(in, in_end, partial.data(), n);
+                    std::copy(partial.begin() + (lo - begin), 
+                        partial.begin() + (hi - begin), p + (lo - first));
+                }
+            }
+        });
+        cached_chunk = keep;
+    }
+    void decode_chunk(const char* in, const char* in_end, T* p, Index n) {
+        ChunkCodec codec;
+        try {
+            codec = decompress_chunk(in, in_end, p, n);
+        } catch (const CodecError& e) {
+            throw FormatError(e.what());
+        }
+        if (swapped && codec != DELTA_CHUNK) {
+            swap_bytes((char*) p, sizeof(T) * n, ScalarSize<T>::value);
         }
     }
-private:
     template <class U>
     U read_binary() {
         U x;
@@ -251,6 +1519,971 @@ private:
         file.write((const char*) &x, sizeof(U));
     }
     std::fstream file;
+    std::string name;
+    ArrayPtr<T> staging;
+    bool swapped = false; // Data has the other byte order
+    // Compressed data
+    bool compress = false; // Writes compress
+    bool compressed = false; // The file read is compressed
+    Index chunk_elements = 0, chunk_count = 0;
+    std::size_t chunk_table = 0; // Byte offset of the chunk table
+    std::vector<std::uint64_t> chunk_offsets;
+    Index element_count = 0;
+    Index cursor = 0; // Next element read
+    std::vector<char> packed; // Compressed chunks read
+    std::vector<T> cached; // Last chunk partly read, decoded
+    Index cached_chunk = -1;
+    ArrayPtr<T> pending; // Elements waiting to be compressed
+    Index pending_chunks = 0, pending_count = 0;
+};
+
+// Reads a text or binary matrix file a block of rows at a time,
+// for files too large to read at once
+template <class T>
+class MatrixReader : private BinaryFile<T> {
+public:
+    MatrixReader(const std::string& filename, bool binary) :
+        BinaryFile<T>(filename, ios_base::in), binary(binary) {
+        if (binary) {
+            header = this->read_header(2);
+            cols = header.cols;
+        } else {
+            lines.reset(new LineBuffer(this->file));
+        }
+    }
+    // Reads up to max_rows more rows. The block is a view of a buffer
+    // that the next call reuses. It has no rows at the end of the file.
+    const Matrix<T>& next(Index max_rows) {
+        if (max_rows < 0) {
+            throw DimensionError("Negative number of rows.");
+        }
+        if (binary) {
+            next_binary(max_rows);
+        } else {
+            next_text(max_rows);
+        }
+        return block;
+    }
+private:
+    void next_binary(Index max_rows) {
+        Index rows = std::min(max_rows, header.rows - row);
+        reserve(rows * cols, 0);
+        T* p = buffer.pointer();
+        if (header.order == COL_MAJOR_ORDER) {
+            // One run per column
+            for (Index j = 0; j < cols && rows > 0; ++j) {
+                this->seek_element(header.data_offset, 
+                    j * header.rows + row);
+                this->read_block(p + rows * j, rows);
+            }
+            block = Matrix<T>(buffer, 0, 1, rows, rows, cols);
+        } else {
+            this->read_block(p, rows * cols);
+            block = Matrix<T>(buffer, 0, cols, 1, rows, cols);
+        }
+        row += rows;
+    }
+    void next_text(Index max_rows) {
+        Index rows = 0;
+        const char *begin, *end;
+        while (rows < max_rows && lines->next(begin, end)) {
+            if (cols < 0) {
+                // The first line sets the number of columns
+                std::vector<T> first;
+                parse_line<T>(begin, end, [&](Index, const T& x) {
+                    first.push_back(x);
+                });
+                cols = first.size();
+                reserve(cols, 0);
+                std::copy(first.begin(), first.end(), buffer.pointer());
+            } else {
+                reserve((rows + 1) * cols, rows * cols);
+                T* p = buffer.pointer() + cols * rows;
+                Index line_cols = parse_line<T>(begin, end, 
+                    [&](Index j, const T& x) {
+                        if (j < cols) {
+                            p[j] = x;
+                        }
+                    });
+                if (line_cols != cols) {
+                    throw FormatError("Uneven line lengths.");
+                }
+            }
+            rows++;
+        }
+        block = Matrix<T>(buffer, 0, std::max<Index>(cols, 0), 1, 
+            rows, std::max<Index>(cols, 0));
+    }
+    // Makes the buffer hold at least n elements, keeping the first kept.
+    // Text blocks grow as lines are read, since max_rows can be far more
+    // than the file has.
+    void reserve(Index n, Index kept) {
+        if (buffer.size() < n) {
+            ArrayPtr<T> larger(std::max(n, 2 * buffer.size()), 
+                uninitialized);
+            std::copy(buffer.pointer(), buffer.pointer() + kept, 
+                larger.pointer());
+            buffer = larger;
+        }
+    }
+    bool binary;
+    BinaryHeader header; // Binary files only
+    std::unique_ptr<LineBuffer> lines; // Text files only
+    Index row = 0; // Rows read so far
+    Index cols = -1;
+    ArrayPtr<T> buffer;
+    Matrix<T> block;
+};
+
+// NumPy type descriptor kind of T, e.g. 'f' for float
+template <class T>
+char npy_kind() {
+    if (ScalarSize<T>::value != sizeof(T)) {
+        return 'c'; // Complex
+    } else if (std::is_floating_point<T>::value) {
+        return 'f';
+    } else if (std::is_pointer<T>::value || std::is_unsigned<T>::value) {
+        return 'u';
+    }
+    return 'i';
+}
+
+// Reads a little endian unsigned integer of the given size
+inline std::uint64_t read_le(const char* p, int bytes) {
+    std::uint64_t x = 0;
+    for (int k = bytes - 1; k >= 0; --k) {
+        x = (x << 8) | std::uint8_t(p[k]);
+    }
+    return x;
+}
+
+// NumPy .npy file, or an uncompressed entry of a .npz archive
+template <class T>
+class NpyFile : public BinaryFile<T> {
+public:
+    NpyFile() {}
+    NpyFile(const std::string& filename, 
+        ios_base::openmode mode = ios_base::in | ios_base::out) :
+        BinaryFile<T>(filename, mode) {}
+    // Reads a 1D array starting at byte offset start
+    Vector<T> read_vector(std::size_t start = 0) {
+        std::vector<Index> shape = read_header(start);
+        if (shape.size() != 1) {
+            throw FormatError("Array isn't one dimensional.");
+        }
+        Vector<T> read(shape[0], uninitialized);
+        this->read_block(read.pointer(), shape[0]);
+        return read;
+    }
+    // Reads a 2D array starting at byte offset start.
+    // Fortran order arrays are read as column major matrices.
+    Matrix<T> read_matrix(std::size_t start = 0) {
+        std::vector<Index> shape = read_header(start);
+        if (shape.size() != 2) {
+            throw FormatError("Array isn't two dimensional.");
+        }
+        Index rows = shape[0];
+        Index cols = shape[1];
+        Matrix<T> read(rows, cols, !fortran_order, uninitialized);
+        if (fortran_order) {
+            this->read_rows(read.pointer(), rows, 1, cols, rows);
+        } else {
+            this->read_rows(read.pointer(), cols, 1, rows, cols);
+        }
+        return read;
+    }
+    void write_vector(const Vector<T>& v) {
+        Index n = v.get_n();
+        write_header("(" + std::to_string(n) + ",)", false);
+        this->write_rows(v.pointer(), v.get_inc(), 1, n, 1);
+    }
+    // Column major matrices are written in Fortran order
+    void write_matrix(const Matrix<T>& mat) {
+        Index rows = mat.get_rows();
+        Index cols = mat.get_cols();
+        Index inc_row = mat.get_inc_row();
+        Index inc_col = mat.get_inc_col();
+        std::string shape = "(" + std::to_string(rows) + ", " +
+            std::to_string(cols) + ")";
+        if (inc_row == 1 && inc_col != 1) {
+            write_header(shape, true);
+            this->write_rows(mat.pointer(), inc_col, inc_row, cols, rows);
+        } else {
+            write_header(shape, false);
+            this->write_rows(mat.pointer(), inc_row, inc_col, rows, cols);
+        }
+    }
+    // Byte offset of the named array in a .npz (zip) archive.
+    // Only the central directory and the entry's local header are read.
+    std::size_t find_entry(const std::string& entry) {
+        std::fstream& file = this->file;
+        file.seekg(0, file.end);
+        std::size_t size = file.tellg();
+        if (size < 22) {
+            throw FormatError("Not a zip archive.");
+        }
+        // End of central directory record, possibly followed by a comment
+        std::size_t tail_size = std::min<std::size_t>(size, 22 + 65535);
+        std::vector<char> tail = read_at(size - tail_size, tail_size);
+        std::size_t eocd = tail_size;
+        for (std::size_t k = tail_size - 22; k != std::size_t(-1); --k) {
+            if (read_le(&tail[k], 4) == 0x06054b50) {
+                eocd = k;
+                break;
+            }
+        }
+        if (eocd == tail_size) {
+            throw FormatError("Not a zip archive.");
+        }
+        std::uint64_t entries = read_le(&tail[eocd + 10], 2);
+        std::uint64_t dir_size = read_le(&tail[eocd + 12], 4);
+        std::uint64_t dir_offset = read_le(&tail[eocd + 16], 4);
+        if (dir_offset == 0xffffffff || entries == 0xffff) {
+            // Zip64 locator sits right before the record
+            if (eocd < 20 || read_le(&tail[eocd - 20], 4) != 0x07064b50) {
+                throw FormatError("Missing zip64 locator.");
+            }
+            std::uint64_t record_offset = read_le(&tail[eocd - 20 + 8], 8);
+            if (record_offset > size || size - record_offset < 56) {
+                throw FormatError("Bad zip64 record.");
+            }
+            std::vector<char> record = read_at(record_offset, 56);
+            if (read_le(&record[0], 4) != 0x06064b50) {
+                throw FormatError("Bad zip64 record.");
+            }
+            entries = read_le(&record[32], 8);
+            dir_size = read_le(&record[40], 8);
+            dir_offset = read_le(&record[48], 8);
+        }
+        if (dir_offset > size || size - dir_offset < dir_size) {
+            throw FormatError("Bad zip central directory.");
+        }
+        std::vector<char> dir = read_at(dir_offset, dir_size);
+        std::size_t p = 0;
+        for (std::uint64_t e = 0; e < entries; ++e) {
+            if (p + 46 > dir.size() || read_le(&dir[p], 4) != 0x02014b50) {
+                throw FormatError("Bad zip central directory.");
+            }
+            int method = read_le(&dir[p + 10], 2);
+            std::uint64_t uncompressed = read_le(&dir[p + 24], 4);
+            std::uint64_t compressed = read_le(&dir[p + 20], 4);
+            std::size_t name_length = read_le(&dir[p + 28], 2);
+            std::size_t extra_length = read_le(&dir[p + 30], 2);
+            std::size_t comment_length = read_le(&dir[p + 32], 2);
+            std::uint64_t local = read_le(&dir[p + 42], 4);
+            if (dir.size() - p - 46 < 
+                name_length + extra_length + comment_length) {
+                throw FormatError("Bad zip central directory.");
+            }
+            std::string name(&dir[p + 46], name_length);
+            if (name == entry || name == entry + ".npy") {
+                if (method != 0) {
+                    throw FormatError(
+                        "Compressed npz entries aren't supported.");
+                }
+                // Zip64 extra field holds the sizes that didn't fit
+                std::size_t x = p + 46 + name_length;
+                std::size_t x_end = x + extra_length;
+                while (x + 4 <= x_end) {
+                    int id = read_le(&dir[x], 2);
+                    std::size_t length = read_le(&dir[x + 2], 2);
+                    std::size_t field = x + 4;
+                    if (length > x_end - field) {
+                        throw FormatError("Bad zip extra field.");
+                    }
+                    if (id == 0x0001) {
+                        for (std::uint64_t* value : 
+                            {&uncompressed, &compressed, &local}) {
+                            if (*value == 0xffffffff) {
+                                if (field + 8 > x + 4 + length) {
+                                    throw FormatError("Bad zip64 field.");
+                                }
+                                *value = read_le(&dir[field], 8);
+                                field += 8;
+                            }
+                        }
+                    }
+                    x += 4 + length;
+                }
+                if (local > size || size - local < 30) {
+                    throw FormatError("Bad zip local header.");
+                }
+                std::vector<char> header = read_at(local, 30);
+                if (read_le(&header[0], 4) != 0x04034b50) {
+                    throw FormatError("Bad zip local header.");
+                }
+                return local + 30 + read_le(&header[26], 2) + 
+                    read_le(&header[28], 2);
+            }
+            p += 46 + name_length + extra_length + comment_length;
+        }
+        throw FormatError("No array named " + entry + " in archive.");
+    }
+private:
+    // Reads the magic string and header dictionary. Returns the shape.
+    std::vector<Index> read_header(std::size_t start) {
+        std::vector<char> prefix = read_at(start, 10);
+        if (std::memcmp(&prefix[0], "\x93NUMPY", 6) != 0) {
+            throw FormatError("Not a npy file.");
+        }
+        int major = prefix[6];
+        std::size_t length;
+        if (major == 1) {
+            length = read_le(&prefix[8], 2);
+        } else {
+            prefix = read_at(start, 12);
+            length = read_le(&prefix[8], 4);
+        }
+        std::vector<char> dict = read_at(start + prefix.size(), length);
+        std::string header(dict.begin(), dict.end());
+        // Type descriptor like '<f8'
+        std::string descr = dict_value(header, "descr");
+        if (descr.size() < 2 || (descr[0] != '\'' && descr[0] != '"')) {
+            throw FormatError("Bad npy type descriptor.");
+        }
+        descr = descr.substr(1, descr.find(descr[0], 1) - 1);
+        char byte_order = '=';
+        if (!descr.empty() && std::strchr("<>|=", descr[0])) {
+            byte_order = descr[0];
+            descr = descr.substr(1);
+        }
+        // Kind and size like f8
+        std::size_t size = 0;
+        const char* size_end = descr.data() + descr.size();
+        if (descr.size() < 2 || std::from_chars(descr.data() + 1, size_end, 
+            size).ptr != size_end) {
+            throw FormatError("Bad npy type descriptor.");
+        }
+        char kind = descr[0];
+        bool kind_matches = (kind == npy_kind<T>()) || 
+            (sizeof(T) == 1 && std::strchr("iubS", kind));
+        if (!kind_matches || size != sizeof(T)) {
+            throw FormatError("Array holds a different element type.");
+        }
+        this->swapped = (byte_order == '<' && native_byte_order() != 1) ||
+            (byte_order == '>' && native_byte_order() != 2);
+        fortran_order = dict_value(header, "fortran_order")
+            .compare(0, 4, "True") == 0;
+        // Shape like (3, 4)
+        std::string shape_text = dict_value(header, "shape");
+        std::vector<Index> shape;
+        const char* q = shape_text.c_str();
+        if (*q != '(') {
+            throw FormatError("Bad npy shape.");
+        }
+        ++q;
+        while (true) {
+            while (*q == ' ' || *q == ',') {
+                ++q;
+            }
+            if (*q == ')' || *q == '\0') {
+                break;
+            }
+            char* next;
+            shape.push_back(std::strtoll(q, &next, 10));
+            if (next == q || shape.back() < 0) {
+                throw FormatError("Bad npy shape.");
+            }
+            q = next;
+            if (*q == 'L') {
+                ++q;
+            }
+        }
+        this->file.seekg(start + prefix.size() + length);
+        return shape;
+    }
+    // Text following 'key': in the header dictionary
+    static std::string dict_value(const std::string& header, 
+        const std::string& key) {
+        std::size_t k = header.find("'" + key + "'");
+        if (k == std::string::npos) {
+            throw FormatError("Missing " + key + " in npy header.");
+        }
+        k = header.find(':', k);
+        k = header.find_first_not_of(' ', k + 1);
+        if (k == std::string::npos) {
+            throw FormatError("Bad npy header.");
+        }
+        return header.substr(k);
+    }
+    // Magic string, version 1.0 and a header padded to 64 bytes
+    void write_header(const std::string& shape, bool fortran) {
+        std::string descr;
+        if (sizeof(T) == 1) {
+            descr = "|i1";
+        } else {
+            descr = (native_byte_order() == 1 ? "<" : ">") + 
+                std::string(1, npy_kind<T>()) + std::to_string(sizeof(T));
+        }
+        std::string header = "{'descr': '" + descr + 
+            "', 'fortran_order': " + (fortran ? "True" : "False") +
+            ", 'shape': " + shape + ", }";
+        std::size_t total = 10 + header.size() + 1;
+        header.append((64 - total % 64) % 64, ' ');
+        header += '\n';
+        std::string prefix("\x93NUMPY\x01\x00", 8);
+        std::uint16_t length = header.size();
+        prefix += char(length & 0xff);
+        prefix += char(length >> 8);
+        this->file.write(prefix.data(), prefix.size());
+        this->file.write(header.data(), header.size());
+        if (this->file.fail()) {
+            throw FileError("Couldn't write file.");
+        }
+    }
+    std::vector<char> read_at(std::size_t offset, std::size_t count) {
+        std::vector<char> bytes(count);
+        this->file.seekg(offset);
+        this->file.read(bytes.data(), count);
+        if (this->file.fail()) {
+            throw FileError("Couldn't read file.");
+        }
+        return bytes;
+    }
+    bool fortran_order = false;
+};
+
+// Tiled format, version 1. Fields use the writer's byte order.
+//   0  magic                 6 bytes
+//   6  version               uint8
+//   7  byte order            uint8 (1 little endian, 2 big endian)
+//   8  element type          uint8 (DataType)
+//   9  reserved              2 bytes
+//  11  element size          uint8
+//  12  reserved              4 bytes
+//  16  dimensions            2 x int64
+//  32  tile dimensions       2 x int64
+//  48  tile index offset     uint64
+//  56  reserved up to binary_header_size
+// The index holds the byte offset of each tile, in row major order of
+// tiles. Each tile is stored in row major order. Tiles in the last row
+// and column of tiles are cut to fit the matrix.
+const char tiled_magic[6] = {'\x93', 'N', 'U', 'M', 'T', 'L'};
+const std::uint8_t tiled_version = 1;
+const Index default_tile_size = 256;
+
+// Matrix stored as tiles, so any subarray can be read through just
+// the tiles it intersects
+template <class T>
+class TiledFile : public BinaryFile<T> {
+public:
+    TiledFile() {}
+    TiledFile(const std::string& filename, 
+        ios_base::openmode mode = ios_base::in | ios_base::out) :
+        BinaryFile<T>(filename, mode) {}
+    Matrix<T> read_matrix(bool row_major = true) {
+        read_header();
+        return read_subarray(0, 0, rows, cols, row_major);
+    }
+    // Reads rows [start_row, end_row) and columns [start_col, end_col)
+    Matrix<T> read_subarray(Index start_row, Index start_col,
+        Index end_row, Index end_col, bool row_major = true) {
+        read_header();
+        if (start_row < 0 || start_col < 0 || start_row > end_row || 
+            start_col > end_col || end_row > rows || end_col > cols) {
+            throw FormatError("Subarray isn't inside the stored matrix.");
+        }
+        Matrix<T> read(end_row - start_row, end_col - start_col, 
+            row_major, uninitialized);
+        if (read.get_rows() == 0 || read.get_cols() == 0) {
+            return read;
+        }
+        Index tiles_across = (cols + tile_cols - 1) / tile_cols;
+        for (Index ti = start_row / tile_rows; 
+            ti * tile_rows < end_row; ++ti) {
+            for (Index tj = start_col / tile_cols; 
+                tj * tile_cols < end_col; ++tj) {
+                // Part of the tile inside the subarray
+                Index tile_top = ti * tile_rows, tile_left = tj * tile_cols;
+                Index width = std::min(tile_cols, cols - tile_left);
+                Index r0 = std::max(start_row, tile_top);
+                Index r1 = std::min(end_row, tile_top + tile_rows);
+                Index c0 = std::max(start_col, tile_left);
+                Index c1 = std::min(end_col, tile_left + tile_cols);
+                T* p = read.pointer() + read.get_inc_row() * (r0 - start_row)
+                    + read.get_inc_col() * (c0 - start_col);
+                this->read_runs(p, read.get_inc_row(), read.get_inc_col(),
+                    tile_offsets[ti * tiles_across + tj], width,
+                    r0 - tile_top, r1 - r0, c0 - tile_left, c1 - c0);
+            }
+        }
+        return read;
+    }
+    // Tile sizes of 0 or less use default_tile_size
+    void write_matrix(const Matrix<T>& mat, 
+        Index tile_height = default_tile_size, 
+        Index tile_width = default_tile_size) {
+        rows = mat.get_rows();
+        cols = mat.get_cols();
+        tile_rows = tile_height > 0 ? tile_height : default_tile_size;
+        tile_cols = tile_width > 0 ? tile_width : default_tile_size;
+        Index tiles_down = (rows + tile_rows - 1) / tile_rows;
+        Index tiles_across = (cols + tile_cols - 1) / tile_cols;
+        // Tiles follow the index, each after the one before
+        tile_offsets.assign(tiles_down * tiles_across, 0);
+        std::uint64_t offset = binary_header_size + 
+            sizeof(std::uint64_t) * tile_offsets.size();
+        for (Index ti = 0; ti < tiles_down; ++ti) {
+            for (Index tj = 0; tj < tiles_across; ++tj) {
+                tile_offsets[ti * tiles_across + tj] = offset;
+                offset += sizeof(T) * 
+                    std::min(tile_rows, rows - ti * tile_rows) *
+                    std::min(tile_cols, cols - tj * tile_cols);
+            }
+        }
+        write_header();
+        for (Index ti = 0; ti < tiles_down; ++ti) {
+            for (Index tj = 0; tj < tiles_across; ++tj) {
+                Index top = ti * tile_rows, left = tj * tile_cols;
+                Matrix<T> tile = mat.subarray(top, left, 
+                    std::min(rows, top + tile_rows), 
+                    std::min(cols, left + tile_cols));
+                this->write_rows(tile.pointer(), tile.get_inc_row(),
+                    tile.get_inc_col(), tile.get_rows(), tile.get_cols());
+            }
+        }
+    }
+private:
+    void write_header() {
+        char bytes[binary_header_size] = {};
+        std::memcpy(bytes, tiled_magic, sizeof(tiled_magic));
+        bytes[6] = tiled_version;
+        bytes[7] = native_byte_order();
+        bytes[8] = TypeCode<T>::value;
+        bytes[11] = sizeof(T);
+        std::int64_t dims[4] = {rows, cols, tile_rows, tile_cols};
+        std::memcpy(bytes + 16, dims, sizeof(dims));
+        std::uint64_t offset = binary_header_size;
+        std::memcpy(bytes + 48, &offset, sizeof(offset));
+        this->file.write(bytes, binary_header_size);
+        this->file.write((const char*) tile_offsets.data(), 
+            sizeof(std::uint64_t) * tile_offsets.size());
+        if (this->file.fail()) {
+            throw FileError("Couldn't write file.");
+        }
+    }
+    // Reads the header and tile index, once
+    void read_header() {
+        if (tile_rows > 0) {
+            return;
+        }
+        char bytes[binary_header_size];
+        this->file.seekg(0);
+        this->file.read(bytes, binary_header_size);
+        if (this->file.fail()) {
+            throw FormatError("File is too short.");
+        }
+        if (std::memcmp(bytes, tiled_magic, sizeof(tiled_magic)) != 0) {
+            throw FormatError("Not a tiled file.");
+        }
+        if (std::uint8_t(bytes[6]) != tiled_version) {
+            throw FormatError("Unsupported tiled format version.");
+        }
+        if (bytes[8] != TypeCode<T>::value || bytes[11] != sizeof(T)) {
+            throw FormatError("File holds a different element type.");
+        }
+        bool swapped = bytes[7] != native_byte_order();
+        std::int64_t dims[4];
+        std::uint64_t offset;
+        std::memcpy(dims, bytes + 16, sizeof(dims));
+        std::memcpy(&offset, bytes + 48, sizeof(offset));
+        if (swapped) {
+            swap_bytes((char*) dims, sizeof(dims), sizeof(dims[0]));
+            swap_bytes((char*) &offset, sizeof(offset), sizeof(offset));
+        }
+        if (dims[0] < 0 || dims[1] < 0 || dims[2] <= 0 || dims[3] <= 0) {
+            throw FormatError("Bad dimensions.");
+        }
+        // The index and the tiles must fit in the file
+        Index tiles_down = dims[0] == 0 ? 0 : (dims[0] - 1) / dims[2] + 1;
+        Index tiles_across = dims[1] == 0 ? 0 : (dims[1] - 1) / dims[3] + 1;
+        std::uint64_t size = this->file_size();
+        if (offset > size || !fits_in(tiles_down, tiles_across, 
+            sizeof(std::uint64_t), size - offset) ||
+            !fits_in(dims[0], dims[1], sizeof(T), size)) {
+            throw FormatError("File is too short for its dimensions.");
+        }
+        Index tiles = tiles_down * tiles_across;
+        tile_offsets.resize(tiles);
+        this->file.seekg(offset);
+        this->file.read((char*) tile_offsets.data(), 
+            sizeof(std::uint64_t) * tiles);
+        if (this->file.fail()) {
+            throw FormatError("File is too short.");
+        }
+        if (swapped) {
+            swap_bytes((char*) tile_offsets.data(), 
+                sizeof(std::uint64_t) * tiles, sizeof(std::uint64_t));
+        }
+        for (Index ti = 0; ti < tiles_down; ++ti) {
+            for (Index tj = 0; tj < tiles_across; ++tj) {
+                std::uint64_t start = tile_offsets[ti * tiles_across + tj];
+                Index height = std::min(dims[2], dims[0] - ti * dims[2]);
+                Index width = std::min(dims[3], dims[1] - tj * dims[3]);
+                if (start > size || 
+                    !fits_in(height, width, sizeof(T), size - start)) {
+                    throw FormatError("Tile is outside the file.");
+                }
+            }
+        }
+        this->swapped = swapped;
+        rows = dims[0];
+        cols = dims[1];
+        tile_rows = dims[2];
+        tile_cols = dims[3];
+    }
+    Index rows = 0, cols = 0;
+    Index tile_rows = 0, tile_cols = 0;
+    std::vector<std::uint64_t> tile_offsets;
+};
+
+// How an archive is opened
+enum ArchiveMode {
+    READ_ARCHIVE = 0,
+    WRITE_ARCHIVE = 1, // Replaces any existing file
+    APPEND_ARCHIVE = 2 // Adds entries to an existing archive
+};
+
+// Archive format, version 1. Fields use the writer's byte order.
+//   0  magic                 6 bytes
+//   6  version               uint8
+//   7  byte order            uint8 (1 little endian, 2 big endian)
+//   8  number of entries     uint64
+//  16  directory offset      uint64
+//  24  reserved up to binary_header_size
+// Each entry's data is stored in its storage order, aligned for mapping.
+// The directory follows the data, with a record for each entry:
+//   0  data offset           uint64
+//   8  dimensions            2 x int64
+//  24  element type          uint8 (DataType)
+//  25  element size          uint8
+//  26  number of dimensions  uint8 (1 or 2)
+//  27  storage order         uint8 (MatrixOrder)
+//  28  name length           uint32
+//  32  name
+// Appending leaves the existing data and directory in place and writes
+// new data and a new directory after them, so an interrupted append
+// leaves the old archive readable. Replaced entries and old directories
+// stay in the file as dead space.
+const char archive_magic[6] = {'\x93', 'N', 'U', 'M', 'A', 'C'};
+const std::uint8_t archive_version = 1;
+
+// Single file holding named vectors and matrices of any element type.
+// The directory is read when opening, so entries are found by name
+// without reading the others.
+class Archive {
+public:
+    Archive(const std::string& filename, ArchiveMode mode) : name(filename) {
+        std::ifstream exists(filename);
+        if (mode == APPEND_ARCHIVE && !exists.is_open()) {
+            mode = WRITE_ARCHIVE;
+        }
+        ios_base::openmode flags = ios_base::in | ios_base::binary;
+        if (mode == WRITE_ARCHIVE) {
+            flags |= ios_base::out | ios_base::trunc;
+        } else if (mode == APPEND_ARCHIVE) {
+            flags |= ios_base::out;
+        }
+        file.open(filename, flags);
+        if (!file.is_open()) {
+            throw FileError("Couldn't open " + filename);
+        }
+        writable = (mode != READ_ARCHIVE);
+        if (mode == WRITE_ARCHIVE) {
+            end = binary_header_size;
+            write_header(0, end);
+        } else {
+            read_directory();
+        }
+    }
+    ~Archive() {
+        try {
+            close();
+        } catch (...) {}
+    }
+    Archive(const Archive&) = delete;
+    Archive& operator=(const Archive&) = delete;
+    // Writes the directory of a writable archive
+    void close() {
+        if (!file.is_open()) {
+            return;
+        }
+        if (writable && changed) {
+            write_directory();
+        }
+        file.close();
+    }
+    bool contains(const std::string& entry) const {
+        return entries.count(entry) > 0;
+    }
+    // Adding an entry with an existing name replaces it
+    template <class T>
+    void put(const std::string& entry, const Vector<T>& v) {
+        Entry& e = add<T>(entry, 1, v.get_n(), 1, ROW_MAJOR_ORDER);
+        write_data(v.pointer(), v.get_inc(), Index(1), e.rows, Index(1));
+    }
+    // Column major matrices are stored in column major order
+    template <class T>
+    void put(const std::string& entry, const Matrix<T>& mat) {
+        Index inc_row = mat.get_inc_row();
+        Index inc_col = mat.get_inc_col();
+        bool col_major = (inc_row == 1 && inc_col != 1);
+        Entry& e = add<T>(entry, 2, mat.get_rows(), mat.get_cols(),
+            col_major ? COL_MAJOR_ORDER : ROW_MAJOR_ORDER);
+        if (col_major) {
+            write_data(mat.pointer(), inc_col, inc_row, e.cols, e.rows);
+        } else {
+            write_data(mat.pointer(), inc_row, inc_col, e.rows, e.cols);
+        }
+    }
+    template <class T>
+    Vector<T> get_vector(const std::string& entry) {
+        const Entry& e = find<T>(entry, 1);
+        Vector<T> read(e.rows, uninitialized);
+        read_data(read.pointer(), e.offset, e.rows);
+        return read;
+    }
+    // The matrix has the order it was stored in
+    template <class T>
+    Matrix<T> get_matrix(const std::string& entry) {
+        const Entry& e = find<T>(entry, 2);
+        Matrix<T> read(e.rows, e.cols, e.order == ROW_MAJOR_ORDER, 
+            uninitialized);
+        read_data(read.pointer(), e.offset, e.rows * e.cols);
+        return read;
+    }
+    // Maps the entry's data into memory instead of reading it
+    template <class T>
+    Vector<T> map_vector(const std::string& entry, 
+        MapMode mode = READ_ONLY_MAP) {
+        const Entry& e = mappable<T>(entry, 1);
+        return Vector<T>(mapped_array<T>(name, mode, e.offset, e.rows), 
+            0, 1, e.rows);
+    }
+    template <class T>
+    Matrix<T> map_matrix(const std::string& entry, 
+        MapMode mode = READ_ONLY_MAP) {
+        const Entry& e = mappable<T>(entry, 2);
+        ArrayPtr<T> data = mapped_array<T>(name, mode, e.offset, 
+            e.rows, e.cols);
+        if (e.order == COL_MAJOR_ORDER) {
+            return Matrix<T>(data, 0, 1, e.rows, e.rows, e.cols);
+        }
+        return Matrix<T>(data, 0, e.cols, 1, e.rows, e.cols);
+    }
+private:
+    struct Entry {
+        std::uint64_t offset = 0;
+        Index rows = 0, cols = 1;
+        std::uint8_t dtype = 0, size = 0, ndim = 1;
+        MatrixOrder order = ROW_MAJOR_ORDER;
+    };
+    static const std::size_t record_size = 32;
+    // Directory entry for new data at the end of the file
+    template <class T>
+    Entry& add(const std::string& entry, int ndim, Index rows, Index cols,
+        MatrixOrder order) {
+        if (!writable) {
+            throw FileError("Archive isn't open for writing.");
+        }
+        // Align the data for mapping
+        end += (NAR_ALIGNMENT - end % NAR_ALIGNMENT) % NAR_ALIGNMENT;
+        changed = true;
+        Entry& e = entries[entry];
+        e.offset = end;
+        e.rows = rows;
+        e.cols = cols;
+        e.dtype = TypeCode<T>::value;
+        e.size = sizeof(T);
+        e.ndim = ndim;
+        e.order = order;
+        file.seekp(end);
+        end += sizeof(T) * rows * cols;
+        return e;
+    }
+    template <class T>
+    const Entry& find(const std::string& entry, int ndim) const {
+        auto it = entries.find(entry);
+        if (it == entries.end()) {
+            throw FormatError("No entry named " + entry + " in archive.");
+        }
+        const Entry& e = it->second;
+        if (e.dtype != TypeCode<T>::value || e.size != sizeof(T)) {
+            throw FormatError("Entry holds a different element type.");
+        }
+        if (e.ndim != ndim) {
+            throw FormatError("Entry holds a different number of dimensions.");
+        }
+        return e;
+    }
+    template <class T>
+    const Entry& mappable(const std::string& entry, int ndim) {
+        if (swapped) {
+            throw FormatError("Can't map a file with the other byte order.");
+        }
+        if (writable) {
+            file.flush(); // Mapping sees what's been written
+        }
+        return find<T>(entry, ndim);
+    }
+    // Writes rows x cols elements in row major order
+    template <class T>
+    void write_data(const T* p, Index inc_row, Index inc_col, 
+        Index rows, Index cols) {
+        if (rows == 0 || cols == 0) {
+            return;
+        }
+        if (inc_col == 1 && (inc_row == cols || rows == 1)) {
+            file.write((const char*) p, sizeof(T) * rows * cols);
+        } else {
+            // Through a staging buffer of about staging_bytes
+            Index block = std::max<Index>(1, staging_bytes / sizeof(T) / cols);
+            std::vector<T> staging(std::min(block, rows) * cols);
+            for (Index i = 0; i < rows; i += block) {
+                Index n = std::min(block, rows - i);
+                strided_copy_2d(staging.data(), cols, Index(1),
+                    p + inc_row * i, inc_row, inc_col, n, cols);
+                file.write((const char*) staging.data(), 
+                    sizeof(T) * n * cols);
+            }
+        }
+        if (file.fail()) {
+            throw FileError("Couldn't write file.");
+        }
+    }
+    template <class T>
+    void read_data(T* p, std::uint64_t offset, Index count) {
+        file.seekg(offset);
+        file.read((char*) p, sizeof(T) * count);
+        if (file.fail()) {
+            throw FileError("Couldn't read file.");
+        }
+        if (swapped) {
+            swap_bytes((char*) p, sizeof(T) * count, ScalarSize<T>::value);
+        }
+    }
+    void write_header(std::uint64_t count, std::uint64_t directory) {
+        char bytes[binary_header_size] = {};
+        std::memcpy(bytes, archive_magic, sizeof(archive_magic));
+        bytes[6] = archive_version;
+        bytes[7] = native_byte_order();
+        std::memcpy(bytes + 8, &count, sizeof(count));
+        std::memcpy(bytes + 16, &directory, sizeof(directory));
+        file.seekp(0);
+        file.write(bytes, binary_header_size);
+        if (file.fail()) {
+            throw FileError("Couldn't write file.");
+        }
+    }
+    // Writes the directory after the data, then points the header at it
+    // once the directory is in the file.
+    // Appended archives are written in native byte order.
+    void write_directory() {
+        std::string directory;
+        for (const auto& item : entries) {
+            const Entry& e = item.second;
+            char record[record_size] = {};
+            std::uint64_t offset = e.offset;
+            std::int64_t dims[2] = {e.rows, e.cols};
+            std::uint32_t length = item.first.size();
+            std::memcpy(record, &offset, sizeof(offset));
+            std::memcpy(record + 8, dims, sizeof(dims));
+            record[24] = e.dtype;
+            record[25] = e.size;
+            record[26] = e.ndim;
+            record[27] = e.order;
+            std::memcpy(record + 28, &length, sizeof(length));
+            directory.append(record, record_size);
+            directory += item.first;
+        }
+        file.seekp(end);
+        file.write(directory.data(), directory.size());
+        file.flush();
+        if (file.fail()) {
+            throw FileError("Couldn't write file.");
+        }
+        write_header(entries.size(), end);
+        file.flush();
+    }
+    void read_directory() {
+        char bytes[binary_header_size];
+        file.seekg(0);
+        file.read(bytes, binary_header_size);
+        if (file.fail() || 
+            std::memcmp(bytes, archive_magic, sizeof(archive_magic)) != 0) {
+            throw FormatError("Not an archive.");
+        }
+        if (std::uint8_t(bytes[6]) != archive_version) {
+            throw FormatError("Unsupported archive format version.");
+        }
+        swapped = bytes[7] != native_byte_order();
+        if (swapped && writable) {
+            throw FormatError("Can't append to a file with the other byte order.");
+        }
+        std::uint64_t count, directory;
+        std::memcpy(&count, bytes + 8, sizeof(count));
+        std::memcpy(&directory, bytes + 16, sizeof(directory));
+        if (swapped) {
+            swap_bytes((char*) &count, sizeof(count), sizeof(count));
+            swap_bytes((char*) &directory, sizeof(directory), 
+                sizeof(directory));
+        }
+        // Records, names and data must all be inside the file
+        file.seekg(0, file.end);
+        std::uint64_t size = file.tellg();
+        if (directory > size || (size - directory) / record_size < count) {
+            throw FormatError("Bad archive directory.");
+        }
+        file.seekg(directory);
+        for (std::uint64_t k = 0; k < count; ++k) {
+            char record[record_size];
+            file.read(record, record_size);
+            Entry e;
+            std::int64_t dims[2];
+            std::uint32_t length;
+            std::memcpy(&e.offset, record, sizeof(e.offset));
+            std::memcpy(dims, record + 8, sizeof(dims));
+            std::memcpy(&length, record + 28, sizeof(length));
+            if (swapped) {
+                swap_bytes((char*) &e.offset, sizeof(e.offset), 
+                    sizeof(e.offset));
+                swap_bytes((char*) dims, sizeof(dims), sizeof(dims[0]));
+                swap_bytes((char*) &length, sizeof(length), sizeof(length));
+            }
+            std::uint64_t position = file.tellg();
+            if (file.fail() || length > size - position || 
+                e.offset > size || std::uint8_t(record[25]) == 0 ||
+                !fits_in(dims[0], dims[1], std::uint8_t(record[25]), 
+                    size - e.offset)) {
+                throw FormatError("Bad archive directory.");
+            }
+            e.rows = dims[0];
+            e.cols = dims[1];
+            e.dtype = record[24];
+            e.size = record[25];
+            e.ndim = record[26];
+            e.order = (record[27] == COL_MAJOR_ORDER) ? 
+                COL_MAJOR_ORDER : ROW_MAJOR_ORDER;
+            std::string entry(length, '\0');
+            file.read(&entry[0], length);
+            if (file.fail()) {
+                throw FormatError("Bad archive directory.");
+            }
+            entries[entry] = e;
+        }
+        // New entries go after everything in the file, so the old
+        // directory stays valid until the header points past it
+        file.seekg(0, file.end);
+        end = file.tellg();
+    }
+    static const Index staging_bytes = Index(1) << 20;
+    std::fstream file;
+    std::string name;
+    bool writable = false;
+    bool swapped = false; // Data has the other byte order
+    bool changed = false; // Entries were added since opening
+    std::uint64_t end = 0; // Where the next entry's data goes
+    std::map<std::string, Entry> entries;
 };
 
 // Convenience functions
@@ -272,7 +2505,7 @@ void write_matrix(const Matrix<T>& mat, const std::string& filename, const std::
 
 template <class T>
 std::string display_string(const Vector<T>& v, bool header=true) {
-    int n = v.get_n();
+    Index n = v.get_n();
     std::stringstream out;
     if (header) {
         out << "Vector of " << typeid(T).name() << 
@@ -280,16 +2513,16 @@ std::string display_string(const Vector<T>& v, bool header=true) {
     }
     if (n >= 10) {
         // First 3 entries
-        for (int i = 0; i < 3; ++i) {
+        for (Index i = 0; i < 3; ++i) {
             out << v[i] << " ";
         }
         out << "... ";
         // Last 3 entries
-        for (int i = n-3; i < n; ++i) {
+        for (Index i = n-3; i < n; ++i) {
             out << v[i] << " ";
         }
     } else {
-        for (int i = 0; i < n; ++i) {
+        for (Index i = 0; i < n; ++i) {
             out << v[i] << " ";
         }
     }
@@ -299,21 +2532,21 @@ std::string display_string(const Vector<T>& v, bool header=true) {
 
 template <class T>
 std::string display_string(const Matrix<T>& mat) {
-    int rows = mat.get_rows();
-    int cols = mat.get_cols();
+    Index rows = mat.get_rows();
+    Index cols = mat.get_cols();
     std::stringstream out;
     out << "Matrix of " << typeid(T).name() <<
         " (size " << rows << " x " << cols << ")" << std::endl;
     if (rows >= 10) {
-        for (int i = 0; i < 3; ++i) {
+        for (Index i = 0; i < 3; ++i) {
             out << display_string(mat.row(i), false);
         }
         out << "..." << std::endl;
-        for (int i = rows-3; i < rows; ++i) {
+        for (Index i = rows-3; i < rows; ++i) {
             out << display_string(mat.row(i), false);
         }
     } else {
-        for (int i = 0; i < rows; ++i) {
+        for (Index i = 0; i < rows; ++i) {
             out << display_string(mat.row(i), false);
         }
     }
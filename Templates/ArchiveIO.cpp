@@ -0,0 +1,90 @@
+
+// Adds vector to archive under name, replacing any entry with that name.
+int nar_`'VECTORTYPE`'_archive_put(nar_archive archive, const char* name, nar_`'VECTORTYPE`' v) {
+    try {
+        archive->put(name, *v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads the named vector from archive.
+// If there's an error, puts error code in err.
+nar_`'VECTORTYPE`' nar_`'VECTORTYPE`'_archive_get(nar_archive archive, const char* name, int* err) {
+    try {
+        nar_`'VECTORTYPE`' v = new Vector<`'TTYPE`'>(
+            archive->get_vector<`'TTYPE`'>(name));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps the named vector from archive into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_`'VECTORTYPE`' nar_`'VECTORTYPE`'_archive_map(nar_archive archive, const char* name, enum nar_map_mode mode, int* err) {
+    try {
+        nar_`'VECTORTYPE`' v = new Vector<`'TTYPE`'>(
+            archive->map_vector<`'TTYPE`'>(name, (MapMode) mode));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Adds matrix to archive under name, replacing any entry with that name.
+int nar_`'MATRIXTYPE`'_archive_put(nar_archive archive, const char* name, nar_`'MATRIXTYPE`' mat) {
+    try {
+        archive->put(name, *mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads the named matrix from archive, in the order it was stored in.
+// If there's an error, puts error code in err.
+nar_`'MATRIXTYPE`' nar_`'MATRIXTYPE`'_archive_get(nar_archive archive, const char* name, int* err) {
+    try {
+        nar_`'MATRIXTYPE`' mat = new Matrix<`'TTYPE`'>(
+            archive->get_matrix<`'TTYPE`'>(name));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps the named matrix from archive into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_`'MATRIXTYPE`' nar_`'MATRIXTYPE`'_archive_map(nar_archive archive, const char* name, enum nar_map_mode mode, int* err) {
+    try {
+        nar_`'MATRIXTYPE`' mat = new Matrix<`'TTYPE`'>(
+            archive->map_matrix<`'TTYPE`'>(name, (MapMode) mode));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
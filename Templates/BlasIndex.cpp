@@ -0,0 +1,6 @@
+
+// Index of the first element of largest magnitude (|Re| + |Im| for
+// complex numbers), or -1 if x is empty. The first NaN counts as largest.
+`'INDEXTYPE`' nar_`'VECTORTYPE`'_iamax`'INDEXTAG`'(nar_`'VECTORTYPE`' x) {
+    return iamax(*x);
+}
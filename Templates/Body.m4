@@ -1,18 +1,44 @@
+define(`indexpart',
+`define(`INDEXTYPE', $1)dnl
+define(`INDEXTAG', $2)dnl
+include(`VectorMatrix.cpp')dnl
+ifelse(TTYPE, COMPLEXPART, `include(`RealGetterSetter.cpp')',
+`include(`ComplexGetterSetter.cpp')')dnl
+include(`RangeGetterSetter.cpp')dnl
+include(`SubarrayIO.cpp')dnl
+ifelse(HASBLAS, `yes', `include(`BlasIndex.cpp')')dnl
+include(`StreamIndex.cpp')dnl
+')dnl
 define(`bodypart',
 `define(`TTYPE', $1)dnl
 define(`VECTORTYPE', $2`v')dnl
 define(`MATRIXTYPE', $2`m')dnl
 define(`COMPLEXPART', $3)dnl
-include(`VectorMatrix.cpp')dnl
-ifelse(TTYPE, COMPLEXPART, `include(`RealGetterSetter.cpp')',
-`include(`ComplexGetterSetter.cpp')')dnl
+define(`HASBLAS', ifelse($2, `x', `no', $2, `p', `no', `yes'))dnl
+define(`HASGEMM', ifelse($2, `s', `yes', $2, `d', `yes', $2, `c', `yes', $2, `z', `yes', `no'))dnl
+define(`NORMTYPE', ifelse(TTYPE, `int', `double', TTYPE, `long', `double', COMPLEXPART))dnl
+define(`ASUMTYPE', ifelse(TTYPE, `int', `uint64_t', TTYPE, `long', `uint64_t', COMPLEXPART))dnl
+include(`Handles.cpp')dnl
+indexpart(`int', `')dnl
+indexpart(`int64_t', `_64')dnl
 dnl
 define(`BINARYTAG',`')dnl
 define(`ISBINARY',`')dnl
-include(`FileIO.cpp')
+include(`FileIO.cpp')dnl
+include(`TextIO.cpp')
 define(`BINARYTAG',`_binary')dnl
 define(`ISBINARY',`Binary')dnl
-include(`FileIO.cpp')
+include(`FileIO.cpp')dnl
+include(`MappedIO.cpp')dnl
+include(`CompressedIO.cpp')dnl
+include(`NpyIO.cpp')dnl
+include(`StreamIO.cpp')dnl
+include(`TiledIO.cpp')dnl
+include(`ArchiveIO.cpp')dnl
+ifelse(HASBLAS, `yes', `ifelse(TTYPE, COMPLEXPART, `include(`RealBlas.cpp')',
+`include(`ComplexBlas.cpp')')')dnl
+ifelse(HASGEMM, `yes', `ifelse(TTYPE, COMPLEXPART, `include(`RealProducts.cpp')',
+`include(`ComplexProducts.cpp')')')
 ')dnl
 
 #include <complex>
@@ -28,7 +54,80 @@ bodypart(`std::complex<double>', `z', `double')
 bodypart(`char', `x', `char')
 bodypart(`void*', `p', `void*')
 
+// Threads used by the parallel file routines. 0 means one per core.
+// Asynchronous reads and writes pick up changes when next started.
+void nar_set_io_threads(int threads) {
+    io_threads() = threads;
+}
+
+int nar_get_io_threads(void) {
+    return io_threads();
+}
+
+// Threads used by matrix products and expression evaluation. Work too
+// small to gain from more threads runs on fewer. 0 means one per core.
+void nar_set_num_threads(int threads) {
+    compute_threads() = threads;
+}
+
+int nar_get_num_threads(void) {
+    return compute_threads();
+}
+
+// Whether an asynchronous read or write has finished
+int nar_future_poll(nar_future future) {
+    return future->ready();
+}
+
+// Waits for an asynchronous read or write and frees the future.
+// Returns what was read (null for writes) and puts the error code
+// or write status in err. The code is 3 if it failed some other way,
+// such as running out of memory.
+void* nar_future_wait(nar_future future, int* err) {
+    Future::Result result(nullptr, async_error);
+    try {
+        result = future->get();
+    } catch (...) {}
+    delete future;
+    if (err) *err = result.second;
+    return result.first;
+}
+
+// Opens an archive of named vectors and matrices.
+// If there's an error, puts error code in err.
+nar_archive nar_archive_open(const char* filename, enum nar_archive_mode mode, int* err) {
+    try {
+        nar_archive archive = new Archive(filename, (ArchiveMode) mode);
+        if (err) *err = 0;
+        return archive;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes the directory of a writable archive and frees it.
+// Returns 1 if the directory couldn't be written.
+int nar_archive_close(nar_archive archive) {
+    int status = 0;
+    try {
+        archive->close();
+    } catch (const FileError& e) {
+        status = 1;
+    }
+    delete archive;
+    return status;
+}
+
+int nar_archive_contains(nar_archive archive, const char* name) {
+    return archive->contains(name);
+}
+
 // Need this to delete strings outputted from this library
 void nar_string_free(char* s) {
     delete[] s;
 }
+include(`Expressions.cpp')dnl
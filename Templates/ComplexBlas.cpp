@@ -0,0 +1,52 @@
+
+// BLAS level 1 for complex numbers in the form a + bI.
+// Functions of two vectors return 1 if their lengths differ.
+
+// y += (a + bI) x
+int nar_`'VECTORTYPE`'_axpy(`'COMPLEXPART`' a, `'COMPLEXPART`' b, nar_`'VECTORTYPE`' x, nar_`'VECTORTYPE`' y) {
+    try {
+        axpy(`'TTYPE`'(a,b), *x, *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// Puts the dot product of x and y in a + bI
+int nar_`'VECTORTYPE`'_dot(`'COMPLEXPART`'* a, `'COMPLEXPART`'* b, nar_`'VECTORTYPE`' x, nar_`'VECTORTYPE`' y) {
+    try {
+        `'TTYPE`' z = dot(*x, *y);
+        *a = z.real();
+        *b = z.imag();
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// Puts the dot product of conjugated x and y in a + bI
+int nar_`'VECTORTYPE`'_dotc(`'COMPLEXPART`'* a, `'COMPLEXPART`'* b, nar_`'VECTORTYPE`' x, nar_`'VECTORTYPE`' y) {
+    try {
+        `'TTYPE`' z = dotc(*x, *y);
+        *a = z.real();
+        *b = z.imag();
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// x *= a + bI
+void nar_`'VECTORTYPE`'_scal(`'COMPLEXPART`' a, `'COMPLEXPART`' b, nar_`'VECTORTYPE`' x) {
+    scal(`'TTYPE`'(a,b), *x);
+}
+
+// Euclidean norm
+`'COMPLEXPART`' nar_`'VECTORTYPE`'_nrm2(nar_`'VECTORTYPE`' x) {
+    return nrm2(*x);
+}
+
+// Sum of |Re x[i]| + |Im x[i]|
+`'COMPLEXPART`' nar_`'VECTORTYPE`'_asum(nar_`'VECTORTYPE`' x) {
+    return asum(*x);
+}
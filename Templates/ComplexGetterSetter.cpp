@@ -1,27 +1,27 @@
 // No bounds checking
 // For complex numbers in the form a + bI
-void nar_`'VECTORTYPE`'_get(`'COMPLEXPART`'* a, `'COMPLEXPART`'* b, nar_`'VECTORTYPE`' v, int i) {
+void nar_`'VECTORTYPE`'_get`'INDEXTAG`'(`'COMPLEXPART`'* a, `'COMPLEXPART`'* b, nar_`'VECTORTYPE`' v, `'INDEXTYPE`' i) {
     `'TTYPE`' z = (*v)[i];
     *a = z.real();
     *b = z.imag();
 }
 
-void nar_`'VECTORTYPE`'_set(nar_`'VECTORTYPE`' v, int i, `'COMPLEXPART`' a, `'COMPLEXPART`' b) {
+void nar_`'VECTORTYPE`'_set`'INDEXTAG`'(nar_`'VECTORTYPE`' v, `'INDEXTYPE`' i, `'COMPLEXPART`' a, `'COMPLEXPART`' b) {
     (*v)[i] = `'TTYPE`'(a,b);
 }
 
-void nar_`'MATRIXTYPE`'_get(`'COMPLEXPART`'* a, `'COMPLEXPART`'* b, nar_`'MATRIXTYPE`' mat, int i, int j) {
+void nar_`'MATRIXTYPE`'_get`'INDEXTAG`'(`'COMPLEXPART`'* a, `'COMPLEXPART`'* b, nar_`'MATRIXTYPE`' mat, `'INDEXTYPE`' i, `'INDEXTYPE`' j) {
     `'TTYPE`' z = (*mat)(i,j);
     *a = z.real();
     *b = z.imag();
 }
 
-void nar_`'MATRIXTYPE`'_set(nar_`'MATRIXTYPE`' mat, int i, int j, `'COMPLEXPART`' a, `'COMPLEXPART`' b) {
+void nar_`'MATRIXTYPE`'_set`'INDEXTAG`'(nar_`'MATRIXTYPE`' mat, `'INDEXTYPE`' i, `'INDEXTYPE`' j, `'COMPLEXPART`' a, `'COMPLEXPART`' b) {
     mat->operator()(i,j) = `'TTYPE`'(a,b);
 }
 
 // Bounds-checked versions
-int nar_`'VECTORTYPE`'_get_safe(`'COMPLEXPART`'* a, `'COMPLEXPART`'* b, nar_`'VECTORTYPE`' v, int i) {
+int nar_`'VECTORTYPE`'_get_safe`'INDEXTAG`'(`'COMPLEXPART`'* a, `'COMPLEXPART`'* b, nar_`'VECTORTYPE`' v, `'INDEXTYPE`' i) {
     try {
         `'TTYPE`' z = v->at(i);
         *a = z.real();
@@ -32,7 +32,7 @@ int nar_`'VECTORTYPE`'_get_safe(`'COMPLEXPART`'* a, `'COMPLEXPART`'* b, nar_`'VE
     }
 }
 
-int nar_`'VECTORTYPE`'_set_safe(nar_`'VECTORTYPE`' v, int i, `'COMPLEXPART`' a, `'COMPLEXPART`' b) {
+int nar_`'VECTORTYPE`'_set_safe`'INDEXTAG`'(nar_`'VECTORTYPE`' v, `'INDEXTYPE`' i, `'COMPLEXPART`' a, `'COMPLEXPART`' b) {
     try {
         v->at(i) = `'TTYPE`'(a,b);
         return 0;
@@ -41,7 +41,7 @@ int nar_`'VECTORTYPE`'_set_safe(nar_`'VECTORTYPE`' v, int i, `'COMPLEXPART`' a,
     }
 }
 
-int nar_`'MATRIXTYPE`'_get_safe(`'COMPLEXPART`'* a, `'COMPLEXPART`'* b, nar_`'MATRIXTYPE`' mat, int i, int j) {
+int nar_`'MATRIXTYPE`'_get_safe`'INDEXTAG`'(`'COMPLEXPART`'* a, `'COMPLEXPART`'* b, nar_`'MATRIXTYPE`' mat, `'INDEXTYPE`' i, `'INDEXTYPE`' j) {
     try {
         `'TTYPE`' z = mat->at(i,j);
         *a = z.real();
@@ -52,7 +52,7 @@ int nar_`'MATRIXTYPE`'_get_safe(`'COMPLEXPART`'* a, `'COMPLEXPART`'* b, nar_`'MA
     }
 }
 
-int nar_`'MATRIXTYPE`'_set_safe(nar_`'MATRIXTYPE`' mat, int i, int j, `'COMPLEXPART`' a, `'COMPLEXPART`' b) {
+int nar_`'MATRIXTYPE`'_set_safe`'INDEXTAG`'(nar_`'MATRIXTYPE`' mat, `'INDEXTYPE`' i, `'INDEXTYPE`' j, `'COMPLEXPART`' a, `'COMPLEXPART`' b) {
     try {
         mat->at(i,j) = `'TTYPE`'(a,b);
         return 0;
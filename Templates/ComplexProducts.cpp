@@ -0,0 +1,24 @@
+
+// C = alpha op(A) op(B) + beta C, where op is set by trans_a and trans_b,
+// alpha = alpha_re + alpha_im I and beta = beta_re + beta_im I.
+// C must not overlap A or B. Returns 1 if the dimensions don't match.
+int nar_`'MATRIXTYPE`'_gemm(`'COMPLEXPART`' alpha_re, `'COMPLEXPART`' alpha_im, nar_`'MATRIXTYPE`' a, enum nar_transpose trans_a, nar_`'MATRIXTYPE`' b, enum nar_transpose trans_b, `'COMPLEXPART`' beta_re, `'COMPLEXPART`' beta_im, nar_`'MATRIXTYPE`' c) {
+    try {
+        gemm(`'TTYPE`'(alpha_re,alpha_im), *a, (Transpose) trans_a, *b, (Transpose) trans_b, `'TTYPE`'(beta_re,beta_im), *c);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// y = alpha op(A) x + beta y, where op is set by trans,
+// alpha = alpha_re + alpha_im I and beta = beta_re + beta_im I.
+// y must not overlap A or x. Returns 1 if the dimensions don't match.
+int nar_`'MATRIXTYPE`'_gemv(`'COMPLEXPART`' alpha_re, `'COMPLEXPART`' alpha_im, nar_`'MATRIXTYPE`' a, enum nar_transpose trans, nar_`'VECTORTYPE`' x, `'COMPLEXPART`' beta_re, `'COMPLEXPART`' beta_im, nar_`'VECTORTYPE`' y) {
+    try {
+        gemv(`'TTYPE`'(alpha_re,alpha_im), *a, (Transpose) trans, *x, `'TTYPE`'(beta_re,beta_im), *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
@@ -0,0 +1,26 @@
+
+// Writes vector to a binary file, compressed in chunks.
+// nar_`'VECTORTYPE`'_read_binary reads it back.
+int nar_`'VECTORTYPE`'_write_binary_compressed(nar_`'VECTORTYPE`' v, const char* filename) {
+    try {
+        BinaryFile<`'TTYPE`'> f(filename, ios_base::out);
+        f.set_compressed(true);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Writes matrix to a binary file, compressed in chunks.
+// nar_`'MATRIXTYPE`'_read_binary reads it back.
+int nar_`'MATRIXTYPE`'_write_binary_compressed(nar_`'MATRIXTYPE`' mat, const char* filename) {
+    try {
+        BinaryFile<`'TTYPE`'> f(filename, ios_base::out);
+        f.set_compressed(true);
+        f.write_matrix(*mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
@@ -0,0 +1,66 @@
+
+// Elementwise expressions over double vectors and matrices, evaluated
+// in one fused pass by nar_expr_eval_into. Building an expression
+// doesn't consume its operands; free every nar_expr with nar_expr_free.
+
+nar_expr nar_expr_var(nar_dv v) {
+    return new RuntimeExpression(RuntimeExpression::variable(*v));
+}
+
+nar_expr nar_expr_var_matrix(nar_dm mat) {
+    return new RuntimeExpression(RuntimeExpression::variable(*mat));
+}
+
+// A scalar, which takes the shape of whatever it's combined with
+nar_expr nar_expr_const(double x) {
+    return new RuntimeExpression(RuntimeExpression::constant(x));
+}
+
+define(`expr_binary', `nar_expr nar_expr_$1(nar_expr a, nar_expr b) {
+    return new RuntimeExpression(RuntimeExpression::binary($2, *a, *b));
+}
+')dnl
+define(`expr_unary', `nar_expr nar_expr_$1(nar_expr a) {
+    return new RuntimeExpression(RuntimeExpression::unary($2, *a));
+}
+')dnl
+expr_binary(`add', `ADD_EXPR')
+expr_binary(`sub', `SUBTRACT_EXPR')
+expr_binary(`mul', `MULTIPLY_EXPR')
+expr_binary(`div', `DIVIDE_EXPR')
+expr_binary(`pow', `POW_EXPR')
+// Minimum and maximum as fmin and fmax, which ignore NaN
+expr_binary(`min', `MIN_EXPR')
+expr_binary(`max', `MAX_EXPR')
+expr_unary(`neg', `NEGATE_EXPR')
+expr_unary(`abs', `ABS_EXPR')
+expr_unary(`exp', `EXP_EXPR')
+expr_unary(`log', `LOG_EXPR')
+expr_unary(`sqrt', `SQRT_EXPR')
+expr_unary(`sin', `SIN_EXPR')
+expr_unary(`cos', `COS_EXPR')
+expr_unary(`tanh', `TANH_EXPR')
+// Overwrites the elements of dest with the value of e. Variables may be
+// dest itself, but not other views that overlap it. Returns 1 if the
+// dimensions don't match.
+int nar_expr_eval_into(nar_expr e, nar_dv dest) {
+    try {
+        e->evaluate_into(*dest);
+        return 0;
+    } catch (const DimensionError& err) {
+        return 1;
+    }
+}
+
+int nar_expr_eval_into_matrix(nar_expr e, nar_dm dest) {
+    try {
+        e->evaluate_into(*dest);
+        return 0;
+    } catch (const DimensionError& err) {
+        return 1;
+    }
+}
+
+void nar_expr_free(nar_expr e) {
+    delete e;
+}
@@ -55,3 +55,75 @@ int nar_`'MATRIXTYPE`'_write`'BINARYTAG`'(nar_`'MATRIXTYPE`' v, const char* file
     }
 }
 
+
+// Reads vector from file into dest, reusing its memory. The file must
+// hold a vector of dest's length. Returns the error code.
+int nar_`'VECTORTYPE`'_read`'BINARYTAG`'_into(nar_`'VECTORTYPE`' dest, const char* filename) {
+    try {
+        `'ISBINARY`'File<`'TTYPE`'> f(filename, ios_base::in);
+        f.read_vector_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Reads matrix from file into dest, reusing its memory. The file must
+// hold a matrix of dest's dimensions. Returns the error code.
+int nar_`'MATRIXTYPE`'_read`'BINARYTAG`'_into(nar_`'MATRIXTYPE`' dest, const char* filename) {
+    try {
+        `'ISBINARY`'File<`'TTYPE`'> f(filename, ios_base::in);
+        f.read_matrix_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Starts reading vector from file on the I/O threads.
+// nar_future_wait returns the vector and error code.
+nar_future nar_`'VECTORTYPE`'_read`'BINARYTAG`'_async(const char* filename) {
+    std::string name(filename);
+    return start_async([name]() {
+        int err;
+        void* v = nar_`'VECTORTYPE`'_read`'BINARYTAG`'(name.c_str(), &err);
+        return Future::Result(v, err);
+    });
+}
+
+// Starts writing vector to file on the I/O threads. v mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_`'VECTORTYPE`'_write`'BINARYTAG`'_async(nar_`'VECTORTYPE`' v, const char* filename`'SEP_PARAM) {
+    std::string name(filename);
+    ifelse(ISBINARY,`',`std::string separator(sep);
+    ')return start_async([=]() {
+        int status = nar_`'VECTORTYPE`'_write`'BINARYTAG`'(v, name.c_str()`'ifelse(ISBINARY,`',`, separator.c_str()'));
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Starts reading matrix from file on the I/O threads.
+// nar_future_wait returns the matrix and error code.
+nar_future nar_`'MATRIXTYPE`'_read`'BINARYTAG`'_async(const char* filename, int row_major) {
+    std::string name(filename);
+    return start_async([name, row_major]() {
+        int err;
+        void* mat = nar_`'MATRIXTYPE`'_read`'BINARYTAG`'(name.c_str(), row_major, &err);
+        return Future::Result(mat, err);
+    });
+}
+
+// Starts writing matrix to file on the I/O threads. mat mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_`'MATRIXTYPE`'_write`'BINARYTAG`'_async(nar_`'MATRIXTYPE`' mat, const char* filename`'SEP_PARAM) {
+    std::string name(filename);
+    ifelse(ISBINARY,`',`std::string separator(sep);
+    ')return start_async([=]() {
+        int status = nar_`'MATRIXTYPE`'_write`'BINARYTAG`'(mat, name.c_str()`'ifelse(ISBINARY,`',`, separator.c_str()'));
+        return Future::Result(nullptr, status);
+    });
+}
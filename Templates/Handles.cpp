@@ -0,0 +1,90 @@
+// Routines for vectors and matrices of the given type
+// that don't depend on the index type
+
+void nar_`'VECTORTYPE`'_free(nar_`'VECTORTYPE`' v) {
+    delete v;
+}
+
+nar_`'VECTORTYPE`' nar_`'VECTORTYPE`'_copy(nar_`'VECTORTYPE`' v) {
+    return new Vector<`'TTYPE`'>(v->copy());
+}
+
+`'COMPLEXPART`'* nar_`'VECTORTYPE`'_pointer(nar_`'VECTORTYPE`' v) {
+    return (`'COMPLEXPART`'*) v->pointer();
+}
+
+// Fills out with the data pointer, dimensions and strides of v
+void nar_`'VECTORTYPE`'_describe(nar_`'VECTORTYPE`' v, struct nar_view* out) {
+    out->data = v->pointer();
+    out->n = v->get_n();
+    out->rows = v->get_n();
+    out->cols = 1;
+    out->inc = v->get_inc();
+    out->inc_row = v->get_inc();
+    out->inc_col = 0;
+    out->dtype = TypeCode<`'TTYPE`'>::value;
+}
+
+int nar_`'VECTORTYPE`'_eq(nar_`'VECTORTYPE`' v1, nar_`'VECTORTYPE`' v2) {
+    return (*v1) == (*v2);
+}
+
+int nar_`'VECTORTYPE`'_assign(nar_`'VECTORTYPE`' v1, nar_`'VECTORTYPE`' v2) {
+    try {
+        v1->assign(*v2);
+        return 0;
+    } catch (const std::out_of_range& e) {
+        return 1;
+    }
+}
+
+void nar_`'MATRIXTYPE`'_free(nar_`'MATRIXTYPE`' mat) {
+    delete mat;
+}
+
+nar_`'MATRIXTYPE`' nar_`'MATRIXTYPE`'_copy(nar_`'MATRIXTYPE`' mat) {
+    return new Matrix<`'TTYPE`'>(mat->copy());
+}
+
+enum nar_order nar_`'MATRIXTYPE`'_order(nar_`'MATRIXTYPE`' mat) {
+    return (nar_order) mat->get_order();
+}
+
+`'COMPLEXPART`'* nar_`'MATRIXTYPE`'_pointer(nar_`'MATRIXTYPE`' mat) {
+    return (`'COMPLEXPART`'*) mat->pointer();
+}
+
+// Fills out with the data pointer, dimensions and strides of mat
+void nar_`'MATRIXTYPE`'_describe(nar_`'MATRIXTYPE`' mat, struct nar_view* out) {
+    out->data = mat->pointer();
+    out->n = mat->get_rows() * mat->get_cols();
+    out->rows = mat->get_rows();
+    out->cols = mat->get_cols();
+    out->inc = 0;
+    out->inc_row = mat->get_inc_row();
+    out->inc_col = mat->get_inc_col();
+    out->dtype = TypeCode<`'TTYPE`'>::value;
+}
+
+int nar_`'MATRIXTYPE`'_eq(nar_`'MATRIXTYPE`' mat1, nar_`'MATRIXTYPE`' mat2) {
+    return (*mat1) == (*mat2);
+}
+
+int nar_`'MATRIXTYPE`'_assign(nar_`'MATRIXTYPE`' mat1, nar_`'MATRIXTYPE`' mat2) {
+    try {
+        mat1->assign(*mat2);
+        return 0;
+    } catch (const std::out_of_range& e) {
+        return 1;
+    }
+}
+
+// Display strings
+char* nar_`'MATRIXTYPE`'_display_string(nar_`'MATRIXTYPE`' mat) {
+    return string_to_char(display_string(*mat));
+}
+
+char* nar_`'VECTORTYPE`'_display_string(nar_`'VECTORTYPE`' v) {
+    return string_to_char(display_string(*v));
+}
+
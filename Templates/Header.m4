@@ -1,6 +1,11 @@
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 #include "Arrays.hpp"
 #include "IO.hpp"
+#include "Blas.hpp"
+#include "Expression.hpp"
 
 extern "C" {
 #endif
@@ -10,12 +15,14 @@ define(`cpp_decl',
 define(`VECTORTYPE', $2`v')dnl
 define(`MATRIXTYPE', $2`m')dnl
 typedef Vector<`'TTYPE`'>* nar_`'VECTORTYPE`';
-typedef Matrix<`'TTYPE`'>* nar_`'MATRIXTYPE`';')dnl
+typedef Matrix<`'TTYPE`'>* nar_`'MATRIXTYPE`';
+typedef MatrixReader<`'TTYPE`'>* nar_`'MATRIXTYPE`'_reader;')dnl
 define(`c_decl', 
 `define(`VECTORTYPE', $1`v')dnl
 define(`MATRIXTYPE', $1`m')dnl
 typedef void* nar_`'VECTORTYPE`';
-typedef void* nar_`'MATRIXTYPE`';')dnl
+typedef void* nar_`'MATRIXTYPE`';
+typedef void* nar_`'MATRIXTYPE`'_reader;')dnl
 
 #ifdef __cplusplus
 // C++ type definitions
@@ -27,6 +34,9 @@ cpp_decl(`std::complex<float>', `c')
 cpp_decl(`std::complex<double>', `z')
 cpp_decl(`char', `x')
 cpp_decl(`void*', `p')
+typedef Archive* nar_archive;
+typedef Future* nar_future;
+typedef RuntimeExpression* nar_expr;
 #else
 // C type definitions
 c_decl(`i')
@@ -37,6 +47,9 @@ c_decl(`c')
 c_decl(`z')
 c_decl(`x')
 c_decl(`p')
+typedef void* nar_archive;
+typedef void* nar_future;
+typedef void* nar_expr;
 #endif
 
 enum nar_order {
@@ -45,6 +58,93 @@ enum nar_order {
     nar_unknown = 2
 };
 
+/* How nar_*_mmap maps a binary file. Matrices keep the order they
+   were stored in. */
+enum nar_map_mode {
+    nar_map_read_only = 0, /* writing to the array crashes */
+    nar_map_shared = 1, /* writes go to the file */
+    nar_map_private = 2 /* writes stay private (copy on write) */
+};
+
+/* How an archive is opened */
+enum nar_archive_mode {
+    nar_archive_read = 0,
+    nar_archive_write = 1, /* replaces any existing file */
+    nar_archive_append = 2 /* adds entries to an existing archive */
+};
+/* Appending writes after the existing data, so replaced entries leave
+   dead space in the file. */
+
+/* How nar_*_gemm uses a matrix operand */
+enum nar_transpose {
+    nar_no_trans = 0,
+    nar_trans = 1,
+    nar_conj_trans = 2 /* conjugate transpose */
+};
+
+/* Element types */
+enum nar_dtype {
+    nar_int = 0,
+    nar_long = 1,
+    nar_float = 2,
+    nar_double = 3,
+    nar_complex_float = 4,
+    nar_complex_double = 5,
+    nar_char = 6,
+    nar_pointer = 7
+};
+
+/* Plain description of a vector or matrix view filled by nar_*_describe.
+   Element (i,j) is at ((T*) data)[i*inc_row + j*inc_col].
+   Vectors are described as n x 1 with inc_row = inc.
+   For matrices n = rows*cols and inc = 0. */
+struct nar_view {
+    void* data; /* first element */
+    int64_t n;
+    int64_t rows, cols;
+    int64_t inc;
+    int64_t inc_row, inc_col;
+    int dtype; /* enum nar_dtype */
+};
+
+/* Size in bytes of one element */
+static inline size_t nar_dtype_size(int dtype) {
+    switch (dtype) {
+        case nar_int: return sizeof(int);
+        case nar_long: return sizeof(long);
+        case nar_float: return sizeof(float);
+        case nar_double: return sizeof(double);
+        case nar_complex_float: return 2*sizeof(float);
+        case nar_complex_double: return 2*sizeof(double);
+        case nar_char: return sizeof(char);
+        case nar_pointer: return sizeof(void*);
+        default: return 0;
+    }
+}
+
+/* Address of element i of a vector view */
+static inline void* nar_view_elem(const struct nar_view* v, int64_t i) {
+    return (char*) v->data + i*v->inc*(int64_t) nar_dtype_size(v->dtype);
+}
+
+/* Address of element (i,j) of a matrix view */
+static inline void* nar_view_elem2(const struct nar_view* v, 
+    int64_t i, int64_t j) {
+    return (char*) v->data + 
+        (i*v->inc_row + j*v->inc_col)*(int64_t) nar_dtype_size(v->dtype);
+}
+
+/* Typed element access for tight loops, e.g. NAR_VIEW_AT(double, v, i) */
+#define NAR_VIEW_AT(type, v, i) (((type*) (v).data)[(i)*(v).inc])
+#define NAR_VIEW_AT2(type, v, i, j) \
+    (((type*) (v).data)[(i)*(v).inc_row + (j)*(v).inc_col])
+
+/* Precision for writing the fewest digits that read back exactly */
+#define NAR_PRECISION_SHORTEST (-1)
+
+/* Called when the last view over wrapped memory is freed */
+typedef void (*nar_release_fn)(void* ptr, void* ctx);
+
 /* Insert prototypes here */
 include(`numarray_part.h')
 
@@ -0,0 +1,37 @@
+
+// Maps a binary file written by nar_`'VECTORTYPE`'_write_binary into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_`'VECTORTYPE`' nar_`'VECTORTYPE`'_mmap(const char* filename, enum nar_map_mode mode, int* err) {
+    try {
+        BinaryFile<`'TTYPE`'> f(filename, ios_base::in);
+        nar_`'VECTORTYPE`' v = new Vector<`'TTYPE`'>(f.map_vector((MapMode) mode));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps a binary file written by nar_`'MATRIXTYPE`'_write_binary into memory.
+// The matrix has the order it was stored in, so column major matrices
+// map as column major. The file stays mapped until the last view of it
+// is freed. If there's an error, puts error code in err.
+nar_`'MATRIXTYPE`' nar_`'MATRIXTYPE`'_mmap(const char* filename, enum nar_map_mode mode, int* err) {
+    try {
+        BinaryFile<`'TTYPE`'> f(filename, ios_base::in);
+        nar_`'MATRIXTYPE`' mat = new Matrix<`'TTYPE`'>(f.map_matrix((MapMode) mode));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
@@ -0,0 +1,93 @@
+
+// Reads a 1D array from a NumPy .npy file.
+// If there's an error, puts error code in err.
+nar_`'VECTORTYPE`' nar_`'VECTORTYPE`'_read_npy(const char* filename, int* err) {
+    try {
+        NpyFile<`'TTYPE`'> f(filename, ios_base::in);
+        nar_`'VECTORTYPE`' v = new Vector<`'TTYPE`'>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads the named 1D array from an uncompressed NumPy .npz archive.
+// If there's an error, puts error code in err.
+nar_`'VECTORTYPE`' nar_`'VECTORTYPE`'_read_npz(const char* filename, const char* name, int* err) {
+    try {
+        NpyFile<`'TTYPE`'> f(filename, ios_base::in);
+        nar_`'VECTORTYPE`' v = new Vector<`'TTYPE`'>(
+            f.read_vector(f.find_entry(name)));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to a NumPy .npy file.
+int nar_`'VECTORTYPE`'_write_npy(nar_`'VECTORTYPE`' v, const char* filename) {
+    try {
+        NpyFile<`'TTYPE`'> f(filename, ios_base::out);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads a 2D array from a NumPy .npy file. Fortran order arrays become
+// column major matrices. If there's an error, puts error code in err.
+nar_`'MATRIXTYPE`' nar_`'MATRIXTYPE`'_read_npy(const char* filename, int* err) {
+    try {
+        NpyFile<`'TTYPE`'> f(filename, ios_base::in);
+        nar_`'MATRIXTYPE`' mat = new Matrix<`'TTYPE`'>(f.read_matrix());
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads the named 2D array from an uncompressed NumPy .npz archive.
+// If there's an error, puts error code in err.
+nar_`'MATRIXTYPE`' nar_`'MATRIXTYPE`'_read_npz(const char* filename, const char* name, int* err) {
+    try {
+        NpyFile<`'TTYPE`'> f(filename, ios_base::in);
+        nar_`'MATRIXTYPE`' mat = new Matrix<`'TTYPE`'>(
+            f.read_matrix(f.find_entry(name)));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes matrix to a NumPy .npy file. Column major matrices
+// are written in Fortran order.
+int nar_`'MATRIXTYPE`'_write_npy(nar_`'MATRIXTYPE`' mat, const char* filename) {
+    try {
+        NpyFile<`'TTYPE`'> f(filename, ios_base::out);
+        f.write_matrix(*mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
@@ -0,0 +1,111 @@
+// Batched element access through caller buffers.
+// These are bounds-checked and return 1 if anything is out of range.
+// Ranges with start > end are out of range; empty ones do nothing.
+
+// Copies elements [start, end) to out
+int nar_`'VECTORTYPE`'_get_range`'INDEXTAG`'(`'COMPLEXPART`'* out, nar_`'VECTORTYPE`' v,
+    `'INDEXTYPE`' start, `'INDEXTYPE`' end) {
+    try {
+        Vector<`'TTYPE`'> part = v->slice<true>(start, end);
+        strided_copy((`'TTYPE`'*) out, 1, 
+            part.pointer(), part.get_inc(), part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites elements [start, end) with the contents of in
+int nar_`'VECTORTYPE`'_set_range`'INDEXTAG`'(nar_`'VECTORTYPE`' v, `'INDEXTYPE`' start, `'INDEXTYPE`' end,
+    `'COMPLEXPART`' const* in) {
+    try {
+        Vector<`'TTYPE`'> part = v->slice<true>(start, end);
+        strided_copy(part.pointer(), part.get_inc(), 
+            (`'TTYPE`' const*) in, 1, part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at idx[0..count) to out
+int nar_`'VECTORTYPE`'_gather`'INDEXTAG`'(`'COMPLEXPART`'* out, nar_`'VECTORTYPE`' v,
+    const `'INDEXTYPE`'* idx, `'INDEXTYPE`' count) {
+    try {
+        v->gather<true>((`'TTYPE`'*) out, idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[0..count) to the elements at idx[0..count)
+int nar_`'VECTORTYPE`'_scatter`'INDEXTAG`'(nar_`'VECTORTYPE`' v, const `'INDEXTYPE`'* idx,
+    `'INDEXTYPE`' count, `'COMPLEXPART`' const* in) {
+    try {
+        v->scatter<true>(idx, count, (`'TTYPE`' const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies [start_row, end_row) x [start_col, end_col) to out,
+// which is packed in row major or column major order
+int nar_`'MATRIXTYPE`'_get_block`'INDEXTAG`'(`'COMPLEXPART`'* out, nar_`'MATRIXTYPE`' mat,
+    `'INDEXTYPE`' start_row, `'INDEXTYPE`' start_col, `'INDEXTYPE`' end_row, `'INDEXTYPE`' end_col,
+    int row_major) {
+    try {
+        Matrix<`'TTYPE`'> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d((`'TTYPE`'*) out, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites [start_row, end_row) x [start_col, end_col) with in,
+// which is packed in row major or column major order
+int nar_`'MATRIXTYPE`'_set_block`'INDEXTAG`'(nar_`'MATRIXTYPE`' mat,
+    `'INDEXTYPE`' start_row, `'INDEXTYPE`' start_col, `'INDEXTYPE`' end_row, `'INDEXTYPE`' end_col,
+    `'COMPLEXPART`' const* in, int row_major) {
+    try {
+        Matrix<`'TTYPE`'> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d(part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            (`'TTYPE`' const*) in, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at (rows_idx[k], cols_idx[k]) to out[k]
+int nar_`'MATRIXTYPE`'_gather`'INDEXTAG`'(`'COMPLEXPART`'* out, nar_`'MATRIXTYPE`' mat,
+    const `'INDEXTYPE`'* rows_idx, const `'INDEXTYPE`'* cols_idx, `'INDEXTYPE`' count) {
+    try {
+        mat->gather<true>((`'TTYPE`'*) out, rows_idx, cols_idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[k] to the elements at (rows_idx[k], cols_idx[k])
+int nar_`'MATRIXTYPE`'_scatter`'INDEXTAG`'(nar_`'MATRIXTYPE`' mat, const `'INDEXTYPE`'* rows_idx,
+    const `'INDEXTYPE`'* cols_idx, `'INDEXTYPE`' count, `'COMPLEXPART`' const* in) {
+    try {
+        mat->scatter<true>(rows_idx, cols_idx, count, (`'TTYPE`' const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
@@ -0,0 +1,38 @@
+
+// BLAS level 1. Functions of two vectors return 1 if their lengths differ.
+
+// y += alpha x
+int nar_`'VECTORTYPE`'_axpy(`'TTYPE`' alpha, nar_`'VECTORTYPE`' x, nar_`'VECTORTYPE`' y) {
+    try {
+        axpy(alpha, *x, *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// Puts the dot product of x and y in result
+int nar_`'VECTORTYPE`'_dot(`'TTYPE`'* result, nar_`'VECTORTYPE`' x, nar_`'VECTORTYPE`' y) {
+    try {
+        *result = dot(*x, *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// x *= alpha
+void nar_`'VECTORTYPE`'_scal(`'TTYPE`' alpha, nar_`'VECTORTYPE`' x) {
+    scal(alpha, *x);
+}
+
+// Euclidean norm
+`'NORMTYPE`' nar_`'VECTORTYPE`'_nrm2(nar_`'VECTORTYPE`' x) {
+    return nrm2(*x);
+}
+
+// Sum of absolute values. Integer sums are unsigned 64 bit, so they only
+// wrap around past 2^64.
+`'ASUMTYPE`' nar_`'VECTORTYPE`'_asum(nar_`'VECTORTYPE`' x) {
+    return asum(*x);
+}
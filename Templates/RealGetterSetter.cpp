@@ -1,22 +1,22 @@
 // No bounds checking
-`'TTYPE`' nar_`'VECTORTYPE`'_get(nar_`'VECTORTYPE`' v, int i) {
+`'TTYPE`' nar_`'VECTORTYPE`'_get`'INDEXTAG`'(nar_`'VECTORTYPE`' v, `'INDEXTYPE`' i) {
     return (*v)[i];
 }
 
-void nar_`'VECTORTYPE`'_set(nar_`'VECTORTYPE`' v, int i, `'TTYPE`' x) {
+void nar_`'VECTORTYPE`'_set`'INDEXTAG`'(nar_`'VECTORTYPE`' v, `'INDEXTYPE`' i, `'TTYPE`' x) {
     (*v)[i] = x;
 }
 
-`'TTYPE`' nar_`'MATRIXTYPE`'_get(nar_`'MATRIXTYPE`' mat, int i, int j) {
+`'TTYPE`' nar_`'MATRIXTYPE`'_get`'INDEXTAG`'(nar_`'MATRIXTYPE`' mat, `'INDEXTYPE`' i, `'INDEXTYPE`' j) {
     return (*mat)(i,j);
 }
 
-void nar_`'MATRIXTYPE`'_set(nar_`'MATRIXTYPE`' mat, int i, int j, `'TTYPE`' x) {
+void nar_`'MATRIXTYPE`'_set`'INDEXTAG`'(nar_`'MATRIXTYPE`' mat, `'INDEXTYPE`' i, `'INDEXTYPE`' j, `'TTYPE`' x) {
     (*mat)(i,j) = x;
 }
 
 // Bounds-checked versions
-int nar_`'VECTORTYPE`'_get_safe(`'TTYPE`'* x, nar_`'VECTORTYPE`' v, int i) {
+int nar_`'VECTORTYPE`'_get_safe`'INDEXTAG`'(`'TTYPE`'* x, nar_`'VECTORTYPE`' v, `'INDEXTYPE`' i) {
     try {
         *x = v->at(i);
         return 0;
@@ -25,7 +25,7 @@ int nar_`'VECTORTYPE`'_get_safe(`'TTYPE`'* x, nar_`'VECTORTYPE`' v, int i) {
     }
 }
 
-int nar_`'VECTORTYPE`'_set_safe(nar_`'VECTORTYPE`' v, int i, `'TTYPE`' x) {
+int nar_`'VECTORTYPE`'_set_safe`'INDEXTAG`'(nar_`'VECTORTYPE`' v, `'INDEXTYPE`' i, `'TTYPE`' x) {
     try {
         v->at(i) = x;
         return 0;
@@ -34,7 +34,7 @@ int nar_`'VECTORTYPE`'_set_safe(nar_`'VECTORTYPE`' v, int i, `'TTYPE`' x) {
     }
 }
 
-int nar_`'MATRIXTYPE`'_get_safe(`'TTYPE`'* x, nar_`'MATRIXTYPE`' mat, int i, int j) {
+int nar_`'MATRIXTYPE`'_get_safe`'INDEXTAG`'(`'TTYPE`'* x, nar_`'MATRIXTYPE`' mat, `'INDEXTYPE`' i, `'INDEXTYPE`' j) {
     try {
         *x = mat->at(i,j);
         return 0;
@@ -43,7 +43,7 @@ int nar_`'MATRIXTYPE`'_get_safe(`'TTYPE`'* x, nar_`'MATRIXTYPE`' mat, int i, int
     }
 }
 
-int nar_`'MATRIXTYPE`'_set_safe(nar_`'MATRIXTYPE`' mat, int i, int j, `'TTYPE`' x) {
+int nar_`'MATRIXTYPE`'_set_safe`'INDEXTAG`'(nar_`'MATRIXTYPE`' mat, `'INDEXTYPE`' i, `'INDEXTYPE`' j, `'TTYPE`' x) {
     try {
         mat->at(i,j) = x;
         return 0;
@@ -0,0 +1,22 @@
+
+// C = alpha op(A) op(B) + beta C, where op is set by trans_a and trans_b.
+// C must not overlap A or B. Returns 1 if the dimensions don't match.
+int nar_`'MATRIXTYPE`'_gemm(`'TTYPE`' alpha, nar_`'MATRIXTYPE`' a, enum nar_transpose trans_a, nar_`'MATRIXTYPE`' b, enum nar_transpose trans_b, `'TTYPE`' beta, nar_`'MATRIXTYPE`' c) {
+    try {
+        gemm(alpha, *a, (Transpose) trans_a, *b, (Transpose) trans_b, beta, *c);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// y = alpha op(A) x + beta y, where op is set by trans.
+// y must not overlap A or x. Returns 1 if the dimensions don't match.
+int nar_`'MATRIXTYPE`'_gemv(`'TTYPE`' alpha, nar_`'MATRIXTYPE`' a, enum nar_transpose trans, nar_`'VECTORTYPE`' x, `'TTYPE`' beta, nar_`'VECTORTYPE`' y) {
+    try {
+        gemv(alpha, *a, (Transpose) trans, *x, beta, *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
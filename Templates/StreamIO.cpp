@@ -0,0 +1,47 @@
+
+// Opens a text matrix file for reading a block of rows at a time.
+// If there's an error, puts error code in err: 1 if the file can't be
+// read, 2 if it's malformed and 3 for anything else, such as running
+// out of memory.
+nar_`'MATRIXTYPE`'_reader nar_`'MATRIXTYPE`'_reader_open(const char* filename, int* err) {
+    try {
+        nar_`'MATRIXTYPE`'_reader reader = 
+            new MatrixReader<`'TTYPE`'>(filename, false);
+        if (err) *err = 0;
+        return reader;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+// Opens a binary matrix file for reading a block of rows at a time.
+// If there's an error, puts error code in err, as for
+// nar_`'MATRIXTYPE`'_reader_open.
+nar_`'MATRIXTYPE`'_reader nar_`'MATRIXTYPE`'_reader_open_binary(const char* filename, int* err) {
+    try {
+        nar_`'MATRIXTYPE`'_reader reader = 
+            new MatrixReader<`'TTYPE`'>(filename, true);
+        if (err) *err = 0;
+        return reader;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+void nar_`'MATRIXTYPE`'_reader_close(nar_`'MATRIXTYPE`'_reader reader) {
+    delete reader;
+}
@@ -0,0 +1,25 @@
+// Reads up to max_rows more rows, into a new view to free with
+// nar_`'MATRIXTYPE`'_free. The view shares the reader's buffer, so the next
+// call overwrites its elements. Returns null at the end of the file, or
+// if there's an error, when it also puts the error code in err, as for
+// nar_`'MATRIXTYPE`'_reader_open.
+nar_`'MATRIXTYPE`' nar_`'MATRIXTYPE`'_reader_next`'INDEXTAG`'(nar_`'MATRIXTYPE`'_reader reader, `'INDEXTYPE`' max_rows, int* err) {
+    try {
+        const Matrix<`'TTYPE`'>& block = reader->next(
+            std::max<Index>(max_rows, 0));
+        if (err) *err = 0;
+        if (block.get_rows() == 0 && max_rows > 0) {
+            return nullptr;
+        }
+        return new Matrix<`'TTYPE`'>(block);
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
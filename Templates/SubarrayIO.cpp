@@ -0,0 +1,42 @@
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// binary matrix file without reading the rest of it.
+// If there's an error, puts error code in err.
+nar_`'MATRIXTYPE`' nar_`'MATRIXTYPE`'_read_binary_subarray`'INDEXTAG`'(const char* filename, 
+    `'INDEXTYPE`' start_row, `'INDEXTYPE`' start_col, `'INDEXTYPE`' end_row, `'INDEXTYPE`' end_col,
+    int row_major, int* err) {
+    try {
+        BinaryFile<`'TTYPE`'> f(filename, ios_base::in);
+        nar_`'MATRIXTYPE`' mat = new Matrix<`'TTYPE`'>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// tiled matrix file, reading only the tiles they intersect.
+// If there's an error, puts error code in err.
+nar_`'MATRIXTYPE`' nar_`'MATRIXTYPE`'_read_tiled_subarray`'INDEXTAG`'(const char* filename, 
+    `'INDEXTYPE`' start_row, `'INDEXTYPE`' start_col, `'INDEXTYPE`' end_row, `'INDEXTYPE`' end_col,
+    int row_major, int* err) {
+    try {
+        TiledFile<`'TTYPE`'> f(filename, ios_base::in);
+        nar_`'MATRIXTYPE`' mat = new Matrix<`'TTYPE`'>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
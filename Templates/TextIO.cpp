@@ -0,0 +1,26 @@
+
+// Writes vector to file with precision significant digits for floating
+// point values, or NAR_PRECISION_SHORTEST for the fewest that read back
+// exactly.
+int nar_`'VECTORTYPE`'_write_precision(nar_`'VECTORTYPE`' v, const char* filename, const char* sep, int precision) {
+    try {
+        File<`'TTYPE`'> f(filename, ios_base::out);
+        f.write_vector(*v, sep, precision);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Writes matrix to file with precision significant digits for floating
+// point values, or NAR_PRECISION_SHORTEST for the fewest that read back
+// exactly.
+int nar_`'MATRIXTYPE`'_write_precision(nar_`'MATRIXTYPE`' v, const char* filename, const char* sep, int precision) {
+    try {
+        File<`'TTYPE`'> f(filename, ios_base::out);
+        f.write_matrix(*v, sep, precision);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
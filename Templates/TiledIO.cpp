@@ -0,0 +1,28 @@
+
+// Reads a matrix from a tiled file. If there's an error, puts error code in err.
+nar_`'MATRIXTYPE`' nar_`'MATRIXTYPE`'_read_tiled(const char* filename, int row_major, int* err) {
+    try {
+        TiledFile<`'TTYPE`'> f(filename, ios_base::in);
+        nar_`'MATRIXTYPE`' mat = new Matrix<`'TTYPE`'>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes matrix to a file as tiles of tile_rows x tile_cols elements.
+// Tile sizes of 0 use the default of 256.
+int nar_`'MATRIXTYPE`'_write_tiled(nar_`'MATRIXTYPE`' mat, const char* filename, int tile_rows, int tile_cols) {
+    try {
+        TiledFile<`'TTYPE`'> f(filename, ios_base::out);
+        f.write_matrix(*mat, tile_rows, tile_cols);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
@@ -1,26 +1,32 @@
 // Main routines for vectors and matrices of the given type
+// with INDEXTYPE sizes, indices and strides
 
-nar_`'VECTORTYPE`' nar_`'VECTORTYPE`'_alloc(int n) {
+nar_`'VECTORTYPE`' nar_`'VECTORTYPE`'_alloc`'INDEXTAG`'(`'INDEXTYPE`' n) {
     return new Vector<`'TTYPE`'>(n);
 }
 
-void nar_`'VECTORTYPE`'_free(nar_`'VECTORTYPE`' v) {
-    delete v;
+// Contents are unspecified until written
+nar_`'VECTORTYPE`' nar_`'VECTORTYPE`'_alloc_uninit`'INDEXTAG`'(`'INDEXTYPE`' n) {
+    return new Vector<`'TTYPE`'>(n, uninitialized);
 }
 
-nar_`'VECTORTYPE`' nar_`'VECTORTYPE`'_copy(nar_`'VECTORTYPE`' v) {
-    return new Vector<`'TTYPE`'>(v->copy());
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_`'VECTORTYPE`' nar_`'VECTORTYPE`'_wrap`'INDEXTAG`'(`'COMPLEXPART`'* ptr, `'INDEXTYPE`' n, `'INDEXTYPE`' inc,
+    nar_release_fn release, void* ctx) {
+    return new Vector<`'TTYPE`'>(wrap_vector((`'TTYPE`'*) ptr, n, inc,
+        [release, ctx](`'TTYPE`'* p) { if (release) release(p, ctx); }));
 }
 
-int nar_`'VECTORTYPE`'_valid(nar_`'VECTORTYPE`' v, int i) {
+int nar_`'VECTORTYPE`'_valid`'INDEXTAG`'(nar_`'VECTORTYPE`' v, `'INDEXTYPE`' i) {
     return v->in_range(i);
 }
 
-nar_`'VECTORTYPE`' nar_`'VECTORTYPE`'_slice(nar_`'VECTORTYPE`' v, int start, int end) {
+nar_`'VECTORTYPE`' nar_`'VECTORTYPE`'_slice`'INDEXTAG`'(nar_`'VECTORTYPE`' v, `'INDEXTYPE`' start, `'INDEXTYPE`' end) {
     return new Vector<`'TTYPE`'>(v->slice(start, end));
 }
 
-int nar_`'VECTORTYPE`'_slice_safe(nar_`'VECTORTYPE`'* out, nar_`'VECTORTYPE`' v, int start, int end) {
+int nar_`'VECTORTYPE`'_slice_safe`'INDEXTAG`'(nar_`'VECTORTYPE`'* out, nar_`'VECTORTYPE`' v, `'INDEXTYPE`' start, `'INDEXTYPE`' end) {
     try {
         *out = new Vector<`'TTYPE`'>(v->slice<true>(start, end));
         return 0;
@@ -29,69 +35,54 @@ int nar_`'VECTORTYPE`'_slice_safe(nar_`'VECTORTYPE`'* out, nar_`'VECTORTYPE`' v,
     }
 }
 
-`'COMPLEXPART`'* nar_`'VECTORTYPE`'_pointer(nar_`'VECTORTYPE`' v) {
-    return (`'COMPLEXPART`'*) v->pointer();
-}
-
-int nar_`'VECTORTYPE`'_inc(nar_`'VECTORTYPE`' v) {
+`'INDEXTYPE`' nar_`'VECTORTYPE`'_inc`'INDEXTAG`'(nar_`'VECTORTYPE`' v) {
     return v->get_inc();
 }
 
-int nar_`'VECTORTYPE`'_n(nar_`'VECTORTYPE`' v) {
+`'INDEXTYPE`' nar_`'VECTORTYPE`'_n`'INDEXTAG`'(nar_`'VECTORTYPE`' v) {
     return v->get_n();
 }
 
-int nar_`'VECTORTYPE`'_eq(nar_`'VECTORTYPE`' v1, nar_`'VECTORTYPE`' v2) {
-    return (*v1) == (*v2);
-}
-
-int nar_`'VECTORTYPE`'_assign(nar_`'VECTORTYPE`' v1, nar_`'VECTORTYPE`' v2) {
-    try {
-        v1->assign(*v2);
-        return 0;
-    } catch (const std::out_of_range& e) {
-        return 1;
-    }
-}
-
 // For matrices
 
-nar_`'MATRIXTYPE`' nar_`'MATRIXTYPE`'_alloc(int rows, int cols, int row_major) {
+nar_`'MATRIXTYPE`' nar_`'MATRIXTYPE`'_alloc`'INDEXTAG`'(`'INDEXTYPE`' rows, `'INDEXTYPE`' cols, int row_major) {
     return new Matrix<`'TTYPE`'>(rows, cols, row_major);
 }
 
-void nar_`'MATRIXTYPE`'_free(nar_`'MATRIXTYPE`' mat) {
-    delete mat;
+// Contents are unspecified until written
+nar_`'MATRIXTYPE`' nar_`'MATRIXTYPE`'_alloc_uninit`'INDEXTAG`'(`'INDEXTYPE`' rows, `'INDEXTYPE`' cols, int row_major) {
+    return new Matrix<`'TTYPE`'>(rows, cols, row_major, uninitialized);
 }
 
-nar_`'MATRIXTYPE`' nar_`'MATRIXTYPE`'_copy(nar_`'MATRIXTYPE`' mat) {
-    return new Matrix<`'TTYPE`'>(mat->copy());
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_`'MATRIXTYPE`' nar_`'MATRIXTYPE`'_wrap`'INDEXTAG`'(`'COMPLEXPART`'* ptr, `'INDEXTYPE`' rows, `'INDEXTYPE`' cols,
+    `'INDEXTYPE`' inc_row, `'INDEXTYPE`' inc_col, nar_release_fn release, void* ctx) {
+    return new Matrix<`'TTYPE`'>(wrap_matrix((`'TTYPE`'*) ptr, rows, cols,
+        inc_row, inc_col,
+        [release, ctx](`'TTYPE`'* p) { if (release) release(p, ctx); }));
 }
 
-int nar_`'MATRIXTYPE`'_valid(nar_`'MATRIXTYPE`' mat, int i, int j) {
+int nar_`'MATRIXTYPE`'_valid`'INDEXTAG`'(nar_`'MATRIXTYPE`' mat, `'INDEXTYPE`' i, `'INDEXTYPE`' j) {
     return mat->in_range(i,j);
 }
 
-enum nar_order nar_`'MATRIXTYPE`'_order(nar_`'MATRIXTYPE`' mat) {
-    return (nar_order) mat->get_order();
-}
-
 // Slicing parts of matrix
-nar_`'VECTORTYPE`' nar_`'MATRIXTYPE`'_row(nar_`'MATRIXTYPE`' mat, int i) {
+nar_`'VECTORTYPE`' nar_`'MATRIXTYPE`'_row`'INDEXTAG`'(nar_`'MATRIXTYPE`' mat, `'INDEXTYPE`' i) {
     return new Vector<`'TTYPE`'>(mat->row(i));
 }
 
-nar_`'VECTORTYPE`' nar_`'MATRIXTYPE`'_col(nar_`'MATRIXTYPE`' mat, int j) {
+nar_`'VECTORTYPE`' nar_`'MATRIXTYPE`'_col`'INDEXTAG`'(nar_`'MATRIXTYPE`' mat, `'INDEXTYPE`' j) {
     return new Vector<`'TTYPE`'>(mat->col(j));
 }
 
-nar_`'MATRIXTYPE`' nar_`'MATRIXTYPE`'_subarray(nar_`'MATRIXTYPE`' mat, int start_row,
-    int start_col, int end_row, int end_col) {
+nar_`'MATRIXTYPE`' nar_`'MATRIXTYPE`'_subarray`'INDEXTAG`'(nar_`'MATRIXTYPE`' mat, `'INDEXTYPE`' start_row,
+    `'INDEXTYPE`' start_col, `'INDEXTYPE`' end_row, `'INDEXTYPE`' end_col) {
     return new Matrix<`'TTYPE`'>(mat->subarray(
         start_row, start_col, end_row, end_col));
 }
 
-int nar_`'MATRIXTYPE`'_row_safe(nar_`'VECTORTYPE`'* x, nar_`'MATRIXTYPE`' mat, int i) {
+int nar_`'MATRIXTYPE`'_row_safe`'INDEXTAG`'(nar_`'VECTORTYPE`'* x, nar_`'MATRIXTYPE`' mat, `'INDEXTYPE`' i) {
     try {
         *x = new Vector<`'TTYPE`'>(mat->row<true>(i));
         return 0;
@@ -100,7 +91,7 @@ int nar_`'MATRIXTYPE`'_row_safe(nar_`'VECTORTYPE`'* x, nar_`'MATRIXTYPE`' mat, i
     }
 }
 
-int nar_`'MATRIXTYPE`'_col_safe(nar_`'VECTORTYPE`'* x, nar_`'MATRIXTYPE`' mat, int j) {
+int nar_`'MATRIXTYPE`'_col_safe`'INDEXTAG`'(nar_`'VECTORTYPE`'* x, nar_`'MATRIXTYPE`' mat, `'INDEXTYPE`' j) {
     try {
         *x = new Vector<`'TTYPE`'>(mat->col<true>(j));
         return 0;
@@ -109,8 +100,8 @@ int nar_`'MATRIXTYPE`'_col_safe(nar_`'VECTORTYPE`'* x, nar_`'MATRIXTYPE`' mat, i
     }
 }
 
-int nar_`'MATRIXTYPE`'_subarray_safe(nar_`'MATRIXTYPE`'* x, nar_`'MATRIXTYPE`' mat, int start_row,
-    int start_col, int end_row, int end_col) {
+int nar_`'MATRIXTYPE`'_subarray_safe`'INDEXTAG`'(nar_`'MATRIXTYPE`'* x, nar_`'MATRIXTYPE`' mat, `'INDEXTYPE`' start_row,
+    `'INDEXTYPE`' start_col, `'INDEXTYPE`' end_row, `'INDEXTYPE`' end_col) {
     try {
         *x = new Matrix<`'TTYPE`'>(mat->subarray<true>(
             start_row, start_col, end_row, end_col));
@@ -120,12 +111,7 @@ int nar_`'MATRIXTYPE`'_subarray_safe(nar_`'MATRIXTYPE`'* x, nar_`'MATRIXTYPE`' m
     }
 }
 
-// Matrix attributes and dimensions
-`'COMPLEXPART`'* nar_`'MATRIXTYPE`'_pointer(nar_`'MATRIXTYPE`' mat) {
-    return (`'COMPLEXPART`'*) mat->pointer();
-}
-
-int nar_`'MATRIXTYPE`'_get_ld(nar_`'MATRIXTYPE`' mat) {
+`'INDEXTYPE`' nar_`'MATRIXTYPE`'_get_ld`'INDEXTAG`'(nar_`'MATRIXTYPE`' mat) {
     try {
         return mat->get_ld();
     } catch (...) {
@@ -133,33 +119,18 @@ int nar_`'MATRIXTYPE`'_get_ld(nar_`'MATRIXTYPE`' mat) {
     }
 }
 
-int nar_`'MATRIXTYPE`'_get_rows(nar_`'MATRIXTYPE`' mat) {
-    return mat->get_rows();
-}
-
-int nar_`'MATRIXTYPE`'_get_cols(nar_`'MATRIXTYPE`' mat) {
-    return mat->get_cols();
+`'INDEXTYPE`' nar_`'MATRIXTYPE`'_inc_row`'INDEXTAG`'(nar_`'MATRIXTYPE`' mat) {
+    return mat->get_inc_row();
 }
 
-int nar_`'MATRIXTYPE`'_eq(nar_`'MATRIXTYPE`' mat1, nar_`'MATRIXTYPE`' mat2) {
-    return (*mat1) == (*mat2);
+`'INDEXTYPE`' nar_`'MATRIXTYPE`'_inc_col`'INDEXTAG`'(nar_`'MATRIXTYPE`' mat) {
+    return mat->get_inc_col();
 }
 
-int nar_`'MATRIXTYPE`'_assign(nar_`'MATRIXTYPE`' mat1, nar_`'MATRIXTYPE`' mat2) {
-    try {
-        mat1->assign(*mat2);
-        return 0;
-    } catch (const std::out_of_range& e) {
-        return 1;
-    }
-}
-
-
-// Display strings
-char* nar_`'MATRIXTYPE`'_display_string(nar_`'MATRIXTYPE`' mat) {
-    return string_to_char(display_string(*mat));
+`'INDEXTYPE`' nar_`'MATRIXTYPE`'_get_rows`'INDEXTAG`'(nar_`'MATRIXTYPE`' mat) {
+    return mat->get_rows();
 }
 
-char* nar_`'VECTORTYPE`'_display_string(nar_`'VECTORTYPE`' v) {
-    return string_to_char(display_string(*v));
+`'INDEXTYPE`' nar_`'MATRIXTYPE`'_get_cols`'INDEXTAG`'(nar_`'MATRIXTYPE`' mat) {
+    return mat->get_cols();
 }
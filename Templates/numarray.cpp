@@ -3,18 +3,114 @@
 #include "numarray.h"
 #include "Conversion.hpp"
 
+// Routines for vectors and matrices of the given type
+// that don't depend on the index type
+
+void nar_iv_free(nar_iv v) {
+    delete v;
+}
+
+nar_iv nar_iv_copy(nar_iv v) {
+    return new Vector<int>(v->copy());
+}
+
+int* nar_iv_pointer(nar_iv v) {
+    return (int*) v->pointer();
+}
+
+// Fills out with the data pointer, dimensions and strides of v
+void nar_iv_describe(nar_iv v, struct nar_view* out) {
+    out->data = v->pointer();
+    out->n = v->get_n();
+    out->rows = v->get_n();
+    out->cols = 1;
+    out->inc = v->get_inc();
+    out->inc_row = v->get_inc();
+    out->inc_col = 0;
+    out->dtype = TypeCode<int>::value;
+}
+
+int nar_iv_eq(nar_iv v1, nar_iv v2) {
+    return (*v1) == (*v2);
+}
+
+int nar_iv_assign(nar_iv v1, nar_iv v2) {
+    try {
+        v1->assign(*v2);
+        return 0;
+    } catch (const std::out_of_range& e) {
+        return 1;
+    }
+}
+
+void nar_im_free(nar_im mat) {
+    delete mat;
+}
+
+nar_im nar_im_copy(nar_im mat) {
+    return new Matrix<int>(mat->copy());
+}
+
+enum nar_order nar_im_order(nar_im mat) {
+    return (nar_order) mat->get_order();
+}
+
+int* nar_im_pointer(nar_im mat) {
+    return (int*) mat->pointer();
+}
+
+// Fills out with the data pointer, dimensions and strides of mat
+void nar_im_describe(nar_im mat, struct nar_view* out) {
+    out->data = mat->pointer();
+    out->n = mat->get_rows() * mat->get_cols();
+    out->rows = mat->get_rows();
+    out->cols = mat->get_cols();
+    out->inc = 0;
+    out->inc_row = mat->get_inc_row();
+    out->inc_col = mat->get_inc_col();
+    out->dtype = TypeCode<int>::value;
+}
+
+int nar_im_eq(nar_im mat1, nar_im mat2) {
+    return (*mat1) == (*mat2);
+}
+
+int nar_im_assign(nar_im mat1, nar_im mat2) {
+    try {
+        mat1->assign(*mat2);
+        return 0;
+    } catch (const std::out_of_range& e) {
+        return 1;
+    }
+}
+
+// Display strings
+char* nar_im_display_string(nar_im mat) {
+    return string_to_char(display_string(*mat));
+}
+
+char* nar_iv_display_string(nar_iv v) {
+    return string_to_char(display_string(*v));
+}
+
 // Main routines for vectors and matrices of the given type
+// with int sizes, indices and strides
 
 nar_iv nar_iv_alloc(int n) {
     return new Vector<int>(n);
 }
 
-void nar_iv_free(nar_iv v) {
-    delete v;
+// Contents are unspecified until written
+nar_iv nar_iv_alloc_uninit(int n) {
+    return new Vector<int>(n, uninitialized);
 }
 
-nar_iv nar_iv_copy(nar_iv v) {
-    return new Vector<int>(v->copy());
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_iv nar_iv_wrap(int* ptr, int n, int inc,
+    nar_release_fn release, void* ctx) {
+    return new Vector<int>(wrap_vector((int*) ptr, n, inc,
+        [release, ctx](int* p) { if (release) release(p, ctx); }));
 }
 
 int nar_iv_valid(nar_iv v, int i) {
@@ -34,10 +130,6 @@ int nar_iv_slice_safe(nar_iv* out, nar_iv v, int start, int end) {
     }
 }
 
-int* nar_iv_pointer(nar_iv v) {
-    return (int*) v->pointer();
-}
-
 int nar_iv_inc(nar_iv v) {
     return v->get_inc();
 }
@@ -46,41 +138,30 @@ int nar_iv_n(nar_iv v) {
     return v->get_n();
 }
 
-int nar_iv_eq(nar_iv v1, nar_iv v2) {
-    return (*v1) == (*v2);
-}
-
-int nar_iv_assign(nar_iv v1, nar_iv v2) {
-    try {
-        v1->assign(*v2);
-        return 0;
-    } catch (const std::out_of_range& e) {
-        return 1;
-    }
-}
-
 // For matrices
 
 nar_im nar_im_alloc(int rows, int cols, int row_major) {
     return new Matrix<int>(rows, cols, row_major);
 }
 
-void nar_im_free(nar_im mat) {
-    delete mat;
+// Contents are unspecified until written
+nar_im nar_im_alloc_uninit(int rows, int cols, int row_major) {
+    return new Matrix<int>(rows, cols, row_major, uninitialized);
 }
 
-nar_im nar_im_copy(nar_im mat) {
-    return new Matrix<int>(mat->copy());
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_im nar_im_wrap(int* ptr, int rows, int cols,
+    int inc_row, int inc_col, nar_release_fn release, void* ctx) {
+    return new Matrix<int>(wrap_matrix((int*) ptr, rows, cols,
+        inc_row, inc_col,
+        [release, ctx](int* p) { if (release) release(p, ctx); }));
 }
 
 int nar_im_valid(nar_im mat, int i, int j) {
     return mat->in_range(i,j);
 }
 
-enum nar_order nar_im_order(nar_im mat) {
-    return (nar_order) mat->get_order();
-}
-
 // Slicing parts of matrix
 nar_iv nar_im_row(nar_im mat, int i) {
     return new Vector<int>(mat->row(i));
@@ -125,11 +206,6 @@ int nar_im_subarray_safe(nar_im* x, nar_im mat, int start_row,
     }
 }
 
-// Matrix attributes and dimensions
-int* nar_im_pointer(nar_im mat) {
-    return (int*) mat->pointer();
-}
-
 int nar_im_get_ld(nar_im mat) {
     try {
         return mat->get_ld();
@@ -138,35 +214,20 @@ int nar_im_get_ld(nar_im mat) {
     }
 }
 
-int nar_im_get_rows(nar_im mat) {
-    return mat->get_rows();
-}
-
-int nar_im_get_cols(nar_im mat) {
-    return mat->get_cols();
-}
-
-int nar_im_eq(nar_im mat1, nar_im mat2) {
-    return (*mat1) == (*mat2);
+int nar_im_inc_row(nar_im mat) {
+    return mat->get_inc_row();
 }
 
-int nar_im_assign(nar_im mat1, nar_im mat2) {
-    try {
-        mat1->assign(*mat2);
-        return 0;
-    } catch (const std::out_of_range& e) {
-        return 1;
-    }
+int nar_im_inc_col(nar_im mat) {
+    return mat->get_inc_col();
 }
 
-
-// Display strings
-char* nar_im_display_string(nar_im mat) {
-    return string_to_char(display_string(*mat));
+int nar_im_get_rows(nar_im mat) {
+    return mat->get_rows();
 }
 
-char* nar_iv_display_string(nar_iv v) {
-    return string_to_char(display_string(*v));
+int nar_im_get_cols(nar_im mat) {
+    return mat->get_cols();
 }
 // No bounds checking
 int nar_iv_get(nar_iv v, int i) {
@@ -221,97 +282,130 @@ int nar_im_set_safe(nar_im mat, int i, int j, int x) {
         return 1;
     }
 }
+// Batched element access through caller buffers.
+// These are bounds-checked and return 1 if anything is out of range.
+// Ranges with start > end are out of range; empty ones do nothing.
 
-// Reads vector from file. If there's an error, puts error code in err.
-nar_iv nar_iv_read(const char* filename, int* err) {
+// Copies elements [start, end) to out
+int nar_iv_get_range(int* out, nar_iv v,
+    int start, int end) {
     try {
-        File<int> f(filename, ios_base::in);
-        nar_iv v = new Vector<int>(f.read_vector());
-        if (err) *err = 0;
-        return v;
-    } catch (const FileError& e) {
-        if (err) *err = 1;
-        return nullptr;
-    } catch (const FormatError& e) {
-        if (err) *err = 2;
-        return nullptr;
+        Vector<int> part = v->slice<true>(start, end);
+        strided_copy((int*) out, 1, 
+            part.pointer(), part.get_inc(), part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
     }
 }
 
-// Writes vector to file.
-int nar_iv_write(nar_iv v, const char* filename, const char* sep) {
+// Overwrites elements [start, end) with the contents of in
+int nar_iv_set_range(nar_iv v, int start, int end,
+    int const* in) {
     try {
-        File<int> f(filename, ios_base::out);
-        f.write_vector(*v, sep);
+        Vector<int> part = v->slice<true>(start, end);
+        strided_copy(part.pointer(), part.get_inc(), 
+            (int const*) in, 1, part.get_n());
         return 0;
-    } catch (const FileError& e) {
+    } catch (...) {
         return 1;
     }
 }
 
-// Reads MATRIX from file. If there's an error, puts error code in err.
-nar_im nar_im_read(const char* filename, int row_major, int* err) {
+// Copies the elements at idx[0..count) to out
+int nar_iv_gather(int* out, nar_iv v,
+    const int* idx, int count) {
     try {
-        File<int> f(filename, ios_base::in);
-        nar_im v = new Matrix<int>(f.read_matrix(row_major));
-        if (err) *err = 0;
-        return v;
-    } catch (const FileError& e) {
-        if (err) *err = 1;
-        return nullptr;
-    } catch (const FormatError& e) {
-        if (err) *err = 2;
-        return nullptr;
+        v->gather<true>((int*) out, idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
     }
 }
 
-// Writes MATRIX to file.
-int nar_im_write(nar_im v, const char* filename, const char* sep) {
+// Writes in[0..count) to the elements at idx[0..count)
+int nar_iv_scatter(nar_iv v, const int* idx,
+    int count, int const* in) {
     try {
-        File<int> f(filename, ios_base::out);
-        f.write_matrix(*v, sep);
+        v->scatter<true>(idx, count, (int const*) in);
         return 0;
-    } catch (const FileError& e) {
+    } catch (...) {
         return 1;
     }
 }
 
+// Copies [start_row, end_row) x [start_col, end_col) to out,
+// which is packed in row major or column major order
+int nar_im_get_block(int* out, nar_im mat,
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major) {
+    try {
+        Matrix<int> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d((int*) out, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
 
+// Overwrites [start_row, end_row) x [start_col, end_col) with in,
+// which is packed in row major or column major order
+int nar_im_set_block(nar_im mat,
+    int start_row, int start_col, int end_row, int end_col,
+    int const* in, int row_major) {
+    try {
+        Matrix<int> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d(part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            (int const*) in, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
 
-// Reads vector from file. If there's an error, puts error code in err.
-nar_iv nar_iv_read_binary(const char* filename, int* err) {
+// Copies the elements at (rows_idx[k], cols_idx[k]) to out[k]
+int nar_im_gather(int* out, nar_im mat,
+    const int* rows_idx, const int* cols_idx, int count) {
     try {
-        BinaryFile<int> f(filename, ios_base::in);
-        nar_iv v = new Vector<int>(f.read_vector());
-        if (err) *err = 0;
-        return v;
-    } catch (const FileError& e) {
-        if (err) *err = 1;
-        return nullptr;
-    } catch (const FormatError& e) {
-        if (err) *err = 2;
-        return nullptr;
+        mat->gather<true>((int*) out, rows_idx, cols_idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
     }
 }
 
-// Writes vector to file.
-int nar_iv_write_binary(nar_iv v, const char* filename) {
+// Writes in[k] to the elements at (rows_idx[k], cols_idx[k])
+int nar_im_scatter(nar_im mat, const int* rows_idx,
+    const int* cols_idx, int count, int const* in) {
     try {
-        BinaryFile<int> f(filename, ios_base::out);
-        f.write_vector(*v);
+        mat->scatter<true>(rows_idx, cols_idx, count, (int const*) in);
         return 0;
-    } catch (const FileError& e) {
+    } catch (...) {
         return 1;
     }
 }
 
-// Reads MATRIX from file. If there's an error, puts error code in err.
-nar_im nar_im_read_binary(const char* filename, int row_major, int* err) {
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// binary matrix file without reading the rest of it.
+// If there's an error, puts error code in err.
+nar_im nar_im_read_binary_subarray(const char* filename, 
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major, int* err) {
     try {
         BinaryFile<int> f(filename, ios_base::in);
-        nar_im v = new Matrix<int>(f.read_matrix(row_major));
+        nar_im mat = new Matrix<int>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
         if (err) *err = 0;
-        return v;
+        return mat;
     } catch (const FileError& e) {
         if (err) *err = 1;
         return nullptr;
@@ -321,134 +415,163 @@ nar_im nar_im_read_binary(const char* filename, int row_major, int* err) {
     }
 }
 
-// Writes MATRIX to file.
-int nar_im_write_binary(nar_im v, const char* filename) {
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// tiled matrix file, reading only the tiles they intersect.
+// If there's an error, puts error code in err.
+nar_im nar_im_read_tiled_subarray(const char* filename, 
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major, int* err) {
     try {
-        BinaryFile<int> f(filename, ios_base::out);
-        f.write_matrix(*v);
-        return 0;
+        TiledFile<int> f(filename, ios_base::in);
+        nar_im mat = new Matrix<int>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
     } catch (const FileError& e) {
-        return 1;
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
     }
 }
 
-
-
+// Index of the first element of largest magnitude (|Re| + |Im| for
+// complex numbers), or -1 if x is empty. The first NaN counts as largest.
+int nar_iv_iamax(nar_iv x) {
+    return iamax(*x);
+}
+// Reads up to max_rows more rows, into a new view to free with
+// nar_im_free. The view shares the reader's buffer, so the next
+// call overwrites its elements. Returns null at the end of the file, or
+// if there's an error, when it also puts the error code in err, as for
+// nar_im_reader_open.
+nar_im nar_im_reader_next(nar_im_reader reader, int max_rows, int* err) {
+    try {
+        const Matrix<int>& block = reader->next(
+            std::max<Index>(max_rows, 0));
+        if (err) *err = 0;
+        if (block.get_rows() == 0 && max_rows > 0) {
+            return nullptr;
+        }
+        return new Matrix<int>(block);
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
 // Main routines for vectors and matrices of the given type
+// with int64_t sizes, indices and strides
 
-nar_lv nar_lv_alloc(int n) {
-    return new Vector<long>(n);
+nar_iv nar_iv_alloc_64(int64_t n) {
+    return new Vector<int>(n);
 }
 
-void nar_lv_free(nar_lv v) {
-    delete v;
+// Contents are unspecified until written
+nar_iv nar_iv_alloc_uninit_64(int64_t n) {
+    return new Vector<int>(n, uninitialized);
 }
 
-nar_lv nar_lv_copy(nar_lv v) {
-    return new Vector<long>(v->copy());
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_iv nar_iv_wrap_64(int* ptr, int64_t n, int64_t inc,
+    nar_release_fn release, void* ctx) {
+    return new Vector<int>(wrap_vector((int*) ptr, n, inc,
+        [release, ctx](int* p) { if (release) release(p, ctx); }));
 }
 
-int nar_lv_valid(nar_lv v, int i) {
+int nar_iv_valid_64(nar_iv v, int64_t i) {
     return v->in_range(i);
 }
 
-nar_lv nar_lv_slice(nar_lv v, int start, int end) {
-    return new Vector<long>(v->slice(start, end));
+nar_iv nar_iv_slice_64(nar_iv v, int64_t start, int64_t end) {
+    return new Vector<int>(v->slice(start, end));
 }
 
-int nar_lv_slice_safe(nar_lv* out, nar_lv v, int start, int end) {
+int nar_iv_slice_safe_64(nar_iv* out, nar_iv v, int64_t start, int64_t end) {
     try {
-        *out = new Vector<long>(v->slice<true>(start, end));
+        *out = new Vector<int>(v->slice<true>(start, end));
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-long* nar_lv_pointer(nar_lv v) {
-    return (long*) v->pointer();
-}
-
-int nar_lv_inc(nar_lv v) {
+int64_t nar_iv_inc_64(nar_iv v) {
     return v->get_inc();
 }
 
-int nar_lv_n(nar_lv v) {
+int64_t nar_iv_n_64(nar_iv v) {
     return v->get_n();
 }
 
-int nar_lv_eq(nar_lv v1, nar_lv v2) {
-    return (*v1) == (*v2);
-}
-
-int nar_lv_assign(nar_lv v1, nar_lv v2) {
-    try {
-        v1->assign(*v2);
-        return 0;
-    } catch (const std::out_of_range& e) {
-        return 1;
-    }
-}
-
 // For matrices
 
-nar_lm nar_lm_alloc(int rows, int cols, int row_major) {
-    return new Matrix<long>(rows, cols, row_major);
+nar_im nar_im_alloc_64(int64_t rows, int64_t cols, int row_major) {
+    return new Matrix<int>(rows, cols, row_major);
 }
 
-void nar_lm_free(nar_lm mat) {
-    delete mat;
+// Contents are unspecified until written
+nar_im nar_im_alloc_uninit_64(int64_t rows, int64_t cols, int row_major) {
+    return new Matrix<int>(rows, cols, row_major, uninitialized);
 }
 
-nar_lm nar_lm_copy(nar_lm mat) {
-    return new Matrix<long>(mat->copy());
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_im nar_im_wrap_64(int* ptr, int64_t rows, int64_t cols,
+    int64_t inc_row, int64_t inc_col, nar_release_fn release, void* ctx) {
+    return new Matrix<int>(wrap_matrix((int*) ptr, rows, cols,
+        inc_row, inc_col,
+        [release, ctx](int* p) { if (release) release(p, ctx); }));
 }
 
-int nar_lm_valid(nar_lm mat, int i, int j) {
+int nar_im_valid_64(nar_im mat, int64_t i, int64_t j) {
     return mat->in_range(i,j);
 }
 
-enum nar_order nar_lm_order(nar_lm mat) {
-    return (nar_order) mat->get_order();
-}
-
 // Slicing parts of matrix
-nar_lv nar_lm_row(nar_lm mat, int i) {
-    return new Vector<long>(mat->row(i));
+nar_iv nar_im_row_64(nar_im mat, int64_t i) {
+    return new Vector<int>(mat->row(i));
 }
 
-nar_lv nar_lm_col(nar_lm mat, int j) {
-    return new Vector<long>(mat->col(j));
+nar_iv nar_im_col_64(nar_im mat, int64_t j) {
+    return new Vector<int>(mat->col(j));
 }
 
-nar_lm nar_lm_subarray(nar_lm mat, int start_row,
-    int start_col, int end_row, int end_col) {
-    return new Matrix<long>(mat->subarray(
+nar_im nar_im_subarray_64(nar_im mat, int64_t start_row,
+    int64_t start_col, int64_t end_row, int64_t end_col) {
+    return new Matrix<int>(mat->subarray(
         start_row, start_col, end_row, end_col));
 }
 
-int nar_lm_row_safe(nar_lv* x, nar_lm mat, int i) {
+int nar_im_row_safe_64(nar_iv* x, nar_im mat, int64_t i) {
     try {
-        *x = new Vector<long>(mat->row<true>(i));
+        *x = new Vector<int>(mat->row<true>(i));
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_lm_col_safe(nar_lv* x, nar_lm mat, int j) {
+int nar_im_col_safe_64(nar_iv* x, nar_im mat, int64_t j) {
     try {
-        *x = new Vector<long>(mat->col<true>(j));
+        *x = new Vector<int>(mat->col<true>(j));
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_lm_subarray_safe(nar_lm* x, nar_lm mat, int start_row,
-    int start_col, int end_row, int end_col) {
+int nar_im_subarray_safe_64(nar_im* x, nar_im mat, int64_t start_row,
+    int64_t start_col, int64_t end_row, int64_t end_col) {
     try {
-        *x = new Matrix<long>(mat->subarray<true>(
+        *x = new Matrix<int>(mat->subarray<true>(
             start_row, start_col, end_row, end_col));
         return 0;
     } catch (...) {
@@ -456,12 +579,7 @@ int nar_lm_subarray_safe(nar_lm* x, nar_lm mat, int start_row,
     }
 }
 
-// Matrix attributes and dimensions
-long* nar_lm_pointer(nar_lm mat) {
-    return (long*) mat->pointer();
-}
-
-int nar_lm_get_ld(nar_lm mat) {
+int64_t nar_im_get_ld_64(nar_im mat) {
     try {
         return mat->get_ld();
     } catch (...) {
@@ -469,95 +587,264 @@ int nar_lm_get_ld(nar_lm mat) {
     }
 }
 
-int nar_lm_get_rows(nar_lm mat) {
+int64_t nar_im_inc_row_64(nar_im mat) {
+    return mat->get_inc_row();
+}
+
+int64_t nar_im_inc_col_64(nar_im mat) {
+    return mat->get_inc_col();
+}
+
+int64_t nar_im_get_rows_64(nar_im mat) {
     return mat->get_rows();
 }
 
-int nar_lm_get_cols(nar_lm mat) {
+int64_t nar_im_get_cols_64(nar_im mat) {
     return mat->get_cols();
 }
+// No bounds checking
+int nar_iv_get_64(nar_iv v, int64_t i) {
+    return (*v)[i];
+}
 
-int nar_lm_eq(nar_lm mat1, nar_lm mat2) {
-    return (*mat1) == (*mat2);
+void nar_iv_set_64(nar_iv v, int64_t i, int x) {
+    (*v)[i] = x;
 }
 
-int nar_lm_assign(nar_lm mat1, nar_lm mat2) {
+int nar_im_get_64(nar_im mat, int64_t i, int64_t j) {
+    return (*mat)(i,j);
+}
+
+void nar_im_set_64(nar_im mat, int64_t i, int64_t j, int x) {
+    (*mat)(i,j) = x;
+}
+
+// Bounds-checked versions
+int nar_iv_get_safe_64(int* x, nar_iv v, int64_t i) {
     try {
-        mat1->assign(*mat2);
+        *x = v->at(i);
         return 0;
-    } catch (const std::out_of_range& e) {
+    } catch (...) {
         return 1;
     }
 }
 
+int nar_iv_set_safe_64(nar_iv v, int64_t i, int x) {
+    try {
+        v->at(i) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
 
-// Display strings
-char* nar_lm_display_string(nar_lm mat) {
-    return string_to_char(display_string(*mat));
+int nar_im_get_safe_64(int* x, nar_im mat, int64_t i, int64_t j) {
+    try {
+        *x = mat->at(i,j);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
 
-char* nar_lv_display_string(nar_lv v) {
-    return string_to_char(display_string(*v));
+int nar_im_set_safe_64(nar_im mat, int64_t i, int64_t j, int x) {
+    try {
+        mat->at(i,j) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
-// No bounds checking
-long nar_lv_get(nar_lv v, int i) {
-    return (*v)[i];
+// Batched element access through caller buffers.
+// These are bounds-checked and return 1 if anything is out of range.
+// Ranges with start > end are out of range; empty ones do nothing.
+
+// Copies elements [start, end) to out
+int nar_iv_get_range_64(int* out, nar_iv v,
+    int64_t start, int64_t end) {
+    try {
+        Vector<int> part = v->slice<true>(start, end);
+        strided_copy((int*) out, 1, 
+            part.pointer(), part.get_inc(), part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
 
-void nar_lv_set(nar_lv v, int i, long x) {
-    (*v)[i] = x;
+// Overwrites elements [start, end) with the contents of in
+int nar_iv_set_range_64(nar_iv v, int64_t start, int64_t end,
+    int const* in) {
+    try {
+        Vector<int> part = v->slice<true>(start, end);
+        strided_copy(part.pointer(), part.get_inc(), 
+            (int const*) in, 1, part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
 
-long nar_lm_get(nar_lm mat, int i, int j) {
-    return (*mat)(i,j);
+// Copies the elements at idx[0..count) to out
+int nar_iv_gather_64(int* out, nar_iv v,
+    const int64_t* idx, int64_t count) {
+    try {
+        v->gather<true>((int*) out, idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
 
-void nar_lm_set(nar_lm mat, int i, int j, long x) {
-    (*mat)(i,j) = x;
+// Writes in[0..count) to the elements at idx[0..count)
+int nar_iv_scatter_64(nar_iv v, const int64_t* idx,
+    int64_t count, int const* in) {
+    try {
+        v->scatter<true>(idx, count, (int const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
 
-// Bounds-checked versions
-int nar_lv_get_safe(long* x, nar_lv v, int i) {
+// Copies [start_row, end_row) x [start_col, end_col) to out,
+// which is packed in row major or column major order
+int nar_im_get_block_64(int* out, nar_im mat,
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major) {
     try {
-        *x = v->at(i);
+        Matrix<int> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d((int*) out, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            rows, cols);
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_lv_set_safe(nar_lv v, int i, long x) {
+// Overwrites [start_row, end_row) x [start_col, end_col) with in,
+// which is packed in row major or column major order
+int nar_im_set_block_64(nar_im mat,
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int const* in, int row_major) {
     try {
-        v->at(i) = x;
+        Matrix<int> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d(part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            (int const*) in, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            rows, cols);
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_lm_get_safe(long* x, nar_lm mat, int i, int j) {
+// Copies the elements at (rows_idx[k], cols_idx[k]) to out[k]
+int nar_im_gather_64(int* out, nar_im mat,
+    const int64_t* rows_idx, const int64_t* cols_idx, int64_t count) {
     try {
-        *x = mat->at(i,j);
+        mat->gather<true>((int*) out, rows_idx, cols_idx, count);
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_lm_set_safe(nar_lm mat, int i, int j, long x) {
+// Writes in[k] to the elements at (rows_idx[k], cols_idx[k])
+int nar_im_scatter_64(nar_im mat, const int64_t* rows_idx,
+    const int64_t* cols_idx, int64_t count, int const* in) {
     try {
-        mat->at(i,j) = x;
+        mat->scatter<true>(rows_idx, cols_idx, count, (int const*) in);
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// binary matrix file without reading the rest of it.
+// If there's an error, puts error code in err.
+nar_im nar_im_read_binary_subarray_64(const char* filename, 
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major, int* err) {
+    try {
+        BinaryFile<int> f(filename, ios_base::in);
+        nar_im mat = new Matrix<int>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// tiled matrix file, reading only the tiles they intersect.
+// If there's an error, puts error code in err.
+nar_im nar_im_read_tiled_subarray_64(const char* filename, 
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major, int* err) {
+    try {
+        TiledFile<int> f(filename, ios_base::in);
+        nar_im mat = new Matrix<int>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Index of the first element of largest magnitude (|Re| + |Im| for
+// complex numbers), or -1 if x is empty. The first NaN counts as largest.
+int64_t nar_iv_iamax_64(nar_iv x) {
+    return iamax(*x);
+}
+// Reads up to max_rows more rows, into a new view to free with
+// nar_im_free. The view shares the reader's buffer, so the next
+// call overwrites its elements. Returns null at the end of the file, or
+// if there's an error, when it also puts the error code in err, as for
+// nar_im_reader_open.
+nar_im nar_im_reader_next_64(nar_im_reader reader, int64_t max_rows, int* err) {
+    try {
+        const Matrix<int>& block = reader->next(
+            std::max<Index>(max_rows, 0));
+        if (err) *err = 0;
+        if (block.get_rows() == 0 && max_rows > 0) {
+            return nullptr;
+        }
+        return new Matrix<int>(block);
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
 // Reads vector from file. If there's an error, puts error code in err.
-nar_lv nar_lv_read(const char* filename, int* err) {
+nar_iv nar_iv_read(const char* filename, int* err) {
     try {
-        File<long> f(filename, ios_base::in);
-        nar_lv v = new Vector<long>(f.read_vector());
+        File<int> f(filename, ios_base::in);
+        nar_iv v = new Vector<int>(f.read_vector());
         if (err) *err = 0;
         return v;
     } catch (const FileError& e) {
@@ -570,9 +857,9 @@ nar_lv nar_lv_read(const char* filename, int* err) {
 }
 
 // Writes vector to file.
-int nar_lv_write(nar_lv v, const char* filename, const char* sep) {
+int nar_iv_write(nar_iv v, const char* filename, const char* sep) {
     try {
-        File<long> f(filename, ios_base::out);
+        File<int> f(filename, ios_base::out);
         f.write_vector(*v, sep);
         return 0;
     } catch (const FileError& e) {
@@ -581,10 +868,10 @@ int nar_lv_write(nar_lv v, const char* filename, const char* sep) {
 }
 
 // Reads MATRIX from file. If there's an error, puts error code in err.
-nar_lm nar_lm_read(const char* filename, int row_major, int* err) {
+nar_im nar_im_read(const char* filename, int row_major, int* err) {
     try {
-        File<long> f(filename, ios_base::in);
-        nar_lm v = new Matrix<long>(f.read_matrix(row_major));
+        File<int> f(filename, ios_base::in);
+        nar_im v = new Matrix<int>(f.read_matrix(row_major));
         if (err) *err = 0;
         return v;
     } catch (const FileError& e) {
@@ -597,9 +884,9 @@ nar_lm nar_lm_read(const char* filename, int row_major, int* err) {
 }
 
 // Writes MATRIX to file.
-int nar_lm_write(nar_lm v, const char* filename, const char* sep) {
+int nar_im_write(nar_im v, const char* filename, const char* sep) {
     try {
-        File<long> f(filename, ios_base::out);
+        File<int> f(filename, ios_base::out);
         f.write_matrix(*v, sep);
         return 0;
     } catch (const FileError& e) {
@@ -608,12 +895,110 @@ int nar_lm_write(nar_lm v, const char* filename, const char* sep) {
 }
 
 
+// Reads vector from file into dest, reusing its memory. The file must
+// hold a vector of dest's length. Returns the error code.
+int nar_iv_read_into(nar_iv dest, const char* filename) {
+    try {
+        File<int> f(filename, ios_base::in);
+        f.read_vector_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Reads matrix from file into dest, reusing its memory. The file must
+// hold a matrix of dest's dimensions. Returns the error code.
+int nar_im_read_into(nar_im dest, const char* filename) {
+    try {
+        File<int> f(filename, ios_base::in);
+        f.read_matrix_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Starts reading vector from file on the I/O threads.
+// nar_future_wait returns the vector and error code.
+nar_future nar_iv_read_async(const char* filename) {
+    std::string name(filename);
+    return start_async([name]() {
+        int err;
+        void* v = nar_iv_read(name.c_str(), &err);
+        return Future::Result(v, err);
+    });
+}
+
+// Starts writing vector to file on the I/O threads. v mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_iv_write_async(nar_iv v, const char* filename, const char* sep) {
+    std::string name(filename);
+    std::string separator(sep);
+    return start_async([=]() {
+        int status = nar_iv_write(v, name.c_str(), separator.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Starts reading matrix from file on the I/O threads.
+// nar_future_wait returns the matrix and error code.
+nar_future nar_im_read_async(const char* filename, int row_major) {
+    std::string name(filename);
+    return start_async([name, row_major]() {
+        int err;
+        void* mat = nar_im_read(name.c_str(), row_major, &err);
+        return Future::Result(mat, err);
+    });
+}
+
+// Starts writing matrix to file on the I/O threads. mat mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_im_write_async(nar_im mat, const char* filename, const char* sep) {
+    std::string name(filename);
+    std::string separator(sep);
+    return start_async([=]() {
+        int status = nar_im_write(mat, name.c_str(), separator.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Writes vector to file with precision significant digits for floating
+// point values, or NAR_PRECISION_SHORTEST for the fewest that read back
+// exactly.
+int nar_iv_write_precision(nar_iv v, const char* filename, const char* sep, int precision) {
+    try {
+        File<int> f(filename, ios_base::out);
+        f.write_vector(*v, sep, precision);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Writes matrix to file with precision significant digits for floating
+// point values, or NAR_PRECISION_SHORTEST for the fewest that read back
+// exactly.
+int nar_im_write_precision(nar_im v, const char* filename, const char* sep, int precision) {
+    try {
+        File<int> f(filename, ios_base::out);
+        f.write_matrix(*v, sep, precision);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
 
 // Reads vector from file. If there's an error, puts error code in err.
-nar_lv nar_lv_read_binary(const char* filename, int* err) {
+nar_iv nar_iv_read_binary(const char* filename, int* err) {
     try {
-        BinaryFile<long> f(filename, ios_base::in);
-        nar_lv v = new Vector<long>(f.read_vector());
+        BinaryFile<int> f(filename, ios_base::in);
+        nar_iv v = new Vector<int>(f.read_vector());
         if (err) *err = 0;
         return v;
     } catch (const FileError& e) {
@@ -626,9 +1011,9 @@ nar_lv nar_lv_read_binary(const char* filename, int* err) {
 }
 
 // Writes vector to file.
-int nar_lv_write_binary(nar_lv v, const char* filename) {
+int nar_iv_write_binary(nar_iv v, const char* filename) {
     try {
-        BinaryFile<long> f(filename, ios_base::out);
+        BinaryFile<int> f(filename, ios_base::out);
         f.write_vector(*v);
         return 0;
     } catch (const FileError& e) {
@@ -637,10 +1022,10 @@ int nar_lv_write_binary(nar_lv v, const char* filename) {
 }
 
 // Reads MATRIX from file. If there's an error, puts error code in err.
-nar_lm nar_lm_read_binary(const char* filename, int row_major, int* err) {
+nar_im nar_im_read_binary(const char* filename, int row_major, int* err) {
     try {
-        BinaryFile<long> f(filename, ios_base::in);
-        nar_lm v = new Matrix<long>(f.read_matrix(row_major));
+        BinaryFile<int> f(filename, ios_base::in);
+        nar_im v = new Matrix<int>(f.read_matrix(row_major));
         if (err) *err = 0;
         return v;
     } catch (const FileError& e) {
@@ -653,9 +1038,9 @@ nar_lm nar_lm_read_binary(const char* filename, int row_major, int* err) {
 }
 
 // Writes MATRIX to file.
-int nar_lm_write_binary(nar_lm v, const char* filename) {
+int nar_im_write_binary(nar_im v, const char* filename) {
     try {
-        BinaryFile<long> f(filename, ios_base::out);
+        BinaryFile<int> f(filename, ios_base::out);
         f.write_matrix(*v);
         return 0;
     } catch (const FileError& e) {
@@ -664,122 +1049,8168 @@ int nar_lm_write_binary(nar_lm v, const char* filename) {
 }
 
 
-
-// Main routines for vectors and matrices of the given type
-
-nar_sv nar_sv_alloc(int n) {
-    return new Vector<float>(n);
+// Reads vector from file into dest, reusing its memory. The file must
+// hold a vector of dest's length. Returns the error code.
+int nar_iv_read_binary_into(nar_iv dest, const char* filename) {
+    try {
+        BinaryFile<int> f(filename, ios_base::in);
+        f.read_vector_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
 }
 
-void nar_sv_free(nar_sv v) {
+// Reads matrix from file into dest, reusing its memory. The file must
+// hold a matrix of dest's dimensions. Returns the error code.
+int nar_im_read_binary_into(nar_im dest, const char* filename) {
+    try {
+        BinaryFile<int> f(filename, ios_base::in);
+        f.read_matrix_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Starts reading vector from file on the I/O threads.
+// nar_future_wait returns the vector and error code.
+nar_future nar_iv_read_binary_async(const char* filename) {
+    std::string name(filename);
+    return start_async([name]() {
+        int err;
+        void* v = nar_iv_read_binary(name.c_str(), &err);
+        return Future::Result(v, err);
+    });
+}
+
+// Starts writing vector to file on the I/O threads. v mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_iv_write_binary_async(nar_iv v, const char* filename) {
+    std::string name(filename);
+    return start_async([=]() {
+        int status = nar_iv_write_binary(v, name.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Starts reading matrix from file on the I/O threads.
+// nar_future_wait returns the matrix and error code.
+nar_future nar_im_read_binary_async(const char* filename, int row_major) {
+    std::string name(filename);
+    return start_async([name, row_major]() {
+        int err;
+        void* mat = nar_im_read_binary(name.c_str(), row_major, &err);
+        return Future::Result(mat, err);
+    });
+}
+
+// Starts writing matrix to file on the I/O threads. mat mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_im_write_binary_async(nar_im mat, const char* filename) {
+    std::string name(filename);
+    return start_async([=]() {
+        int status = nar_im_write_binary(mat, name.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Maps a binary file written by nar_iv_write_binary into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_iv nar_iv_mmap(const char* filename, enum nar_map_mode mode, int* err) {
+    try {
+        BinaryFile<int> f(filename, ios_base::in);
+        nar_iv v = new Vector<int>(f.map_vector((MapMode) mode));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps a binary file written by nar_im_write_binary into memory.
+// The matrix has the order it was stored in, so column major matrices
+// map as column major. The file stays mapped until the last view of it
+// is freed. If there's an error, puts error code in err.
+nar_im nar_im_mmap(const char* filename, enum nar_map_mode mode, int* err) {
+    try {
+        BinaryFile<int> f(filename, ios_base::in);
+        nar_im mat = new Matrix<int>(f.map_matrix((MapMode) mode));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to a binary file, compressed in chunks.
+// nar_iv_read_binary reads it back.
+int nar_iv_write_binary_compressed(nar_iv v, const char* filename) {
+    try {
+        BinaryFile<int> f(filename, ios_base::out);
+        f.set_compressed(true);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Writes matrix to a binary file, compressed in chunks.
+// nar_im_read_binary reads it back.
+int nar_im_write_binary_compressed(nar_im mat, const char* filename) {
+    try {
+        BinaryFile<int> f(filename, ios_base::out);
+        f.set_compressed(true);
+        f.write_matrix(*mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads a 1D array from a NumPy .npy file.
+// If there's an error, puts error code in err.
+nar_iv nar_iv_read_npy(const char* filename, int* err) {
+    try {
+        NpyFile<int> f(filename, ios_base::in);
+        nar_iv v = new Vector<int>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads the named 1D array from an uncompressed NumPy .npz archive.
+// If there's an error, puts error code in err.
+nar_iv nar_iv_read_npz(const char* filename, const char* name, int* err) {
+    try {
+        NpyFile<int> f(filename, ios_base::in);
+        nar_iv v = new Vector<int>(
+            f.read_vector(f.find_entry(name)));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to a NumPy .npy file.
+int nar_iv_write_npy(nar_iv v, const char* filename) {
+    try {
+        NpyFile<int> f(filename, ios_base::out);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads a 2D array from a NumPy .npy file. Fortran order arrays become
+// column major matrices. If there's an error, puts error code in err.
+nar_im nar_im_read_npy(const char* filename, int* err) {
+    try {
+        NpyFile<int> f(filename, ios_base::in);
+        nar_im mat = new Matrix<int>(f.read_matrix());
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads the named 2D array from an uncompressed NumPy .npz archive.
+// If there's an error, puts error code in err.
+nar_im nar_im_read_npz(const char* filename, const char* name, int* err) {
+    try {
+        NpyFile<int> f(filename, ios_base::in);
+        nar_im mat = new Matrix<int>(
+            f.read_matrix(f.find_entry(name)));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes matrix to a NumPy .npy file. Column major matrices
+// are written in Fortran order.
+int nar_im_write_npy(nar_im mat, const char* filename) {
+    try {
+        NpyFile<int> f(filename, ios_base::out);
+        f.write_matrix(*mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Opens a text matrix file for reading a block of rows at a time.
+// If there's an error, puts error code in err: 1 if the file can't be
+// read, 2 if it's malformed and 3 for anything else, such as running
+// out of memory.
+nar_im_reader nar_im_reader_open(const char* filename, int* err) {
+    try {
+        nar_im_reader reader = 
+            new MatrixReader<int>(filename, false);
+        if (err) *err = 0;
+        return reader;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+// Opens a binary matrix file for reading a block of rows at a time.
+// If there's an error, puts error code in err, as for
+// nar_im_reader_open.
+nar_im_reader nar_im_reader_open_binary(const char* filename, int* err) {
+    try {
+        nar_im_reader reader = 
+            new MatrixReader<int>(filename, true);
+        if (err) *err = 0;
+        return reader;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+void nar_im_reader_close(nar_im_reader reader) {
+    delete reader;
+}
+
+// Reads a matrix from a tiled file. If there's an error, puts error code in err.
+nar_im nar_im_read_tiled(const char* filename, int row_major, int* err) {
+    try {
+        TiledFile<int> f(filename, ios_base::in);
+        nar_im mat = new Matrix<int>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes matrix to a file as tiles of tile_rows x tile_cols elements.
+// Tile sizes of 0 use the default of 256.
+int nar_im_write_tiled(nar_im mat, const char* filename, int tile_rows, int tile_cols) {
+    try {
+        TiledFile<int> f(filename, ios_base::out);
+        f.write_matrix(*mat, tile_rows, tile_cols);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Adds vector to archive under name, replacing any entry with that name.
+int nar_iv_archive_put(nar_archive archive, const char* name, nar_iv v) {
+    try {
+        archive->put(name, *v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads the named vector from archive.
+// If there's an error, puts error code in err.
+nar_iv nar_iv_archive_get(nar_archive archive, const char* name, int* err) {
+    try {
+        nar_iv v = new Vector<int>(
+            archive->get_vector<int>(name));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps the named vector from archive into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_iv nar_iv_archive_map(nar_archive archive, const char* name, enum nar_map_mode mode, int* err) {
+    try {
+        nar_iv v = new Vector<int>(
+            archive->map_vector<int>(name, (MapMode) mode));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Adds matrix to archive under name, replacing any entry with that name.
+int nar_im_archive_put(nar_archive archive, const char* name, nar_im mat) {
+    try {
+        archive->put(name, *mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads the named matrix from archive, in the order it was stored in.
+// If there's an error, puts error code in err.
+nar_im nar_im_archive_get(nar_archive archive, const char* name, int* err) {
+    try {
+        nar_im mat = new Matrix<int>(
+            archive->get_matrix<int>(name));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps the named matrix from archive into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_im nar_im_archive_map(nar_archive archive, const char* name, enum nar_map_mode mode, int* err) {
+    try {
+        nar_im mat = new Matrix<int>(
+            archive->map_matrix<int>(name, (MapMode) mode));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// BLAS level 1. Functions of two vectors return 1 if their lengths differ.
+
+// y += alpha x
+int nar_iv_axpy(int alpha, nar_iv x, nar_iv y) {
+    try {
+        axpy(alpha, *x, *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// Puts the dot product of x and y in result
+int nar_iv_dot(int* result, nar_iv x, nar_iv y) {
+    try {
+        *result = dot(*x, *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// x *= alpha
+void nar_iv_scal(int alpha, nar_iv x) {
+    scal(alpha, *x);
+}
+
+// Euclidean norm
+double nar_iv_nrm2(nar_iv x) {
+    return nrm2(*x);
+}
+
+// Sum of absolute values. Integer sums are unsigned 64 bit, so they only
+// wrap around past 2^64.
+uint64_t nar_iv_asum(nar_iv x) {
+    return asum(*x);
+}
+
+
+// Routines for vectors and matrices of the given type
+// that don't depend on the index type
+
+void nar_lv_free(nar_lv v) {
+    delete v;
+}
+
+nar_lv nar_lv_copy(nar_lv v) {
+    return new Vector<long>(v->copy());
+}
+
+long* nar_lv_pointer(nar_lv v) {
+    return (long*) v->pointer();
+}
+
+// Fills out with the data pointer, dimensions and strides of v
+void nar_lv_describe(nar_lv v, struct nar_view* out) {
+    out->data = v->pointer();
+    out->n = v->get_n();
+    out->rows = v->get_n();
+    out->cols = 1;
+    out->inc = v->get_inc();
+    out->inc_row = v->get_inc();
+    out->inc_col = 0;
+    out->dtype = TypeCode<long>::value;
+}
+
+int nar_lv_eq(nar_lv v1, nar_lv v2) {
+    return (*v1) == (*v2);
+}
+
+int nar_lv_assign(nar_lv v1, nar_lv v2) {
+    try {
+        v1->assign(*v2);
+        return 0;
+    } catch (const std::out_of_range& e) {
+        return 1;
+    }
+}
+
+void nar_lm_free(nar_lm mat) {
+    delete mat;
+}
+
+nar_lm nar_lm_copy(nar_lm mat) {
+    return new Matrix<long>(mat->copy());
+}
+
+enum nar_order nar_lm_order(nar_lm mat) {
+    return (nar_order) mat->get_order();
+}
+
+long* nar_lm_pointer(nar_lm mat) {
+    return (long*) mat->pointer();
+}
+
+// Fills out with the data pointer, dimensions and strides of mat
+void nar_lm_describe(nar_lm mat, struct nar_view* out) {
+    out->data = mat->pointer();
+    out->n = mat->get_rows() * mat->get_cols();
+    out->rows = mat->get_rows();
+    out->cols = mat->get_cols();
+    out->inc = 0;
+    out->inc_row = mat->get_inc_row();
+    out->inc_col = mat->get_inc_col();
+    out->dtype = TypeCode<long>::value;
+}
+
+int nar_lm_eq(nar_lm mat1, nar_lm mat2) {
+    return (*mat1) == (*mat2);
+}
+
+int nar_lm_assign(nar_lm mat1, nar_lm mat2) {
+    try {
+        mat1->assign(*mat2);
+        return 0;
+    } catch (const std::out_of_range& e) {
+        return 1;
+    }
+}
+
+// Display strings
+char* nar_lm_display_string(nar_lm mat) {
+    return string_to_char(display_string(*mat));
+}
+
+char* nar_lv_display_string(nar_lv v) {
+    return string_to_char(display_string(*v));
+}
+
+// Main routines for vectors and matrices of the given type
+// with int sizes, indices and strides
+
+nar_lv nar_lv_alloc(int n) {
+    return new Vector<long>(n);
+}
+
+// Contents are unspecified until written
+nar_lv nar_lv_alloc_uninit(int n) {
+    return new Vector<long>(n, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_lv nar_lv_wrap(long* ptr, int n, int inc,
+    nar_release_fn release, void* ctx) {
+    return new Vector<long>(wrap_vector((long*) ptr, n, inc,
+        [release, ctx](long* p) { if (release) release(p, ctx); }));
+}
+
+int nar_lv_valid(nar_lv v, int i) {
+    return v->in_range(i);
+}
+
+nar_lv nar_lv_slice(nar_lv v, int start, int end) {
+    return new Vector<long>(v->slice(start, end));
+}
+
+int nar_lv_slice_safe(nar_lv* out, nar_lv v, int start, int end) {
+    try {
+        *out = new Vector<long>(v->slice<true>(start, end));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_lv_inc(nar_lv v) {
+    return v->get_inc();
+}
+
+int nar_lv_n(nar_lv v) {
+    return v->get_n();
+}
+
+// For matrices
+
+nar_lm nar_lm_alloc(int rows, int cols, int row_major) {
+    return new Matrix<long>(rows, cols, row_major);
+}
+
+// Contents are unspecified until written
+nar_lm nar_lm_alloc_uninit(int rows, int cols, int row_major) {
+    return new Matrix<long>(rows, cols, row_major, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_lm nar_lm_wrap(long* ptr, int rows, int cols,
+    int inc_row, int inc_col, nar_release_fn release, void* ctx) {
+    return new Matrix<long>(wrap_matrix((long*) ptr, rows, cols,
+        inc_row, inc_col,
+        [release, ctx](long* p) { if (release) release(p, ctx); }));
+}
+
+int nar_lm_valid(nar_lm mat, int i, int j) {
+    return mat->in_range(i,j);
+}
+
+// Slicing parts of matrix
+nar_lv nar_lm_row(nar_lm mat, int i) {
+    return new Vector<long>(mat->row(i));
+}
+
+nar_lv nar_lm_col(nar_lm mat, int j) {
+    return new Vector<long>(mat->col(j));
+}
+
+nar_lm nar_lm_subarray(nar_lm mat, int start_row,
+    int start_col, int end_row, int end_col) {
+    return new Matrix<long>(mat->subarray(
+        start_row, start_col, end_row, end_col));
+}
+
+int nar_lm_row_safe(nar_lv* x, nar_lm mat, int i) {
+    try {
+        *x = new Vector<long>(mat->row<true>(i));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_lm_col_safe(nar_lv* x, nar_lm mat, int j) {
+    try {
+        *x = new Vector<long>(mat->col<true>(j));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_lm_subarray_safe(nar_lm* x, nar_lm mat, int start_row,
+    int start_col, int end_row, int end_col) {
+    try {
+        *x = new Matrix<long>(mat->subarray<true>(
+            start_row, start_col, end_row, end_col));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_lm_get_ld(nar_lm mat) {
+    try {
+        return mat->get_ld();
+    } catch (...) {
+        return -1; // Not contiguously ordered
+    }
+}
+
+int nar_lm_inc_row(nar_lm mat) {
+    return mat->get_inc_row();
+}
+
+int nar_lm_inc_col(nar_lm mat) {
+    return mat->get_inc_col();
+}
+
+int nar_lm_get_rows(nar_lm mat) {
+    return mat->get_rows();
+}
+
+int nar_lm_get_cols(nar_lm mat) {
+    return mat->get_cols();
+}
+// No bounds checking
+long nar_lv_get(nar_lv v, int i) {
+    return (*v)[i];
+}
+
+void nar_lv_set(nar_lv v, int i, long x) {
+    (*v)[i] = x;
+}
+
+long nar_lm_get(nar_lm mat, int i, int j) {
+    return (*mat)(i,j);
+}
+
+void nar_lm_set(nar_lm mat, int i, int j, long x) {
+    (*mat)(i,j) = x;
+}
+
+// Bounds-checked versions
+int nar_lv_get_safe(long* x, nar_lv v, int i) {
+    try {
+        *x = v->at(i);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_lv_set_safe(nar_lv v, int i, long x) {
+    try {
+        v->at(i) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_lm_get_safe(long* x, nar_lm mat, int i, int j) {
+    try {
+        *x = mat->at(i,j);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_lm_set_safe(nar_lm mat, int i, int j, long x) {
+    try {
+        mat->at(i,j) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+// Batched element access through caller buffers.
+// These are bounds-checked and return 1 if anything is out of range.
+// Ranges with start > end are out of range; empty ones do nothing.
+
+// Copies elements [start, end) to out
+int nar_lv_get_range(long* out, nar_lv v,
+    int start, int end) {
+    try {
+        Vector<long> part = v->slice<true>(start, end);
+        strided_copy((long*) out, 1, 
+            part.pointer(), part.get_inc(), part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites elements [start, end) with the contents of in
+int nar_lv_set_range(nar_lv v, int start, int end,
+    long const* in) {
+    try {
+        Vector<long> part = v->slice<true>(start, end);
+        strided_copy(part.pointer(), part.get_inc(), 
+            (long const*) in, 1, part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at idx[0..count) to out
+int nar_lv_gather(long* out, nar_lv v,
+    const int* idx, int count) {
+    try {
+        v->gather<true>((long*) out, idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[0..count) to the elements at idx[0..count)
+int nar_lv_scatter(nar_lv v, const int* idx,
+    int count, long const* in) {
+    try {
+        v->scatter<true>(idx, count, (long const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies [start_row, end_row) x [start_col, end_col) to out,
+// which is packed in row major or column major order
+int nar_lm_get_block(long* out, nar_lm mat,
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major) {
+    try {
+        Matrix<long> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d((long*) out, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites [start_row, end_row) x [start_col, end_col) with in,
+// which is packed in row major or column major order
+int nar_lm_set_block(nar_lm mat,
+    int start_row, int start_col, int end_row, int end_col,
+    long const* in, int row_major) {
+    try {
+        Matrix<long> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d(part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            (long const*) in, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at (rows_idx[k], cols_idx[k]) to out[k]
+int nar_lm_gather(long* out, nar_lm mat,
+    const int* rows_idx, const int* cols_idx, int count) {
+    try {
+        mat->gather<true>((long*) out, rows_idx, cols_idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[k] to the elements at (rows_idx[k], cols_idx[k])
+int nar_lm_scatter(nar_lm mat, const int* rows_idx,
+    const int* cols_idx, int count, long const* in) {
+    try {
+        mat->scatter<true>(rows_idx, cols_idx, count, (long const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// binary matrix file without reading the rest of it.
+// If there's an error, puts error code in err.
+nar_lm nar_lm_read_binary_subarray(const char* filename, 
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major, int* err) {
+    try {
+        BinaryFile<long> f(filename, ios_base::in);
+        nar_lm mat = new Matrix<long>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// tiled matrix file, reading only the tiles they intersect.
+// If there's an error, puts error code in err.
+nar_lm nar_lm_read_tiled_subarray(const char* filename, 
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major, int* err) {
+    try {
+        TiledFile<long> f(filename, ios_base::in);
+        nar_lm mat = new Matrix<long>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Index of the first element of largest magnitude (|Re| + |Im| for
+// complex numbers), or -1 if x is empty. The first NaN counts as largest.
+int nar_lv_iamax(nar_lv x) {
+    return iamax(*x);
+}
+// Reads up to max_rows more rows, into a new view to free with
+// nar_lm_free. The view shares the reader's buffer, so the next
+// call overwrites its elements. Returns null at the end of the file, or
+// if there's an error, when it also puts the error code in err, as for
+// nar_lm_reader_open.
+nar_lm nar_lm_reader_next(nar_lm_reader reader, int max_rows, int* err) {
+    try {
+        const Matrix<long>& block = reader->next(
+            std::max<Index>(max_rows, 0));
+        if (err) *err = 0;
+        if (block.get_rows() == 0 && max_rows > 0) {
+            return nullptr;
+        }
+        return new Matrix<long>(block);
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+// Main routines for vectors and matrices of the given type
+// with int64_t sizes, indices and strides
+
+nar_lv nar_lv_alloc_64(int64_t n) {
+    return new Vector<long>(n);
+}
+
+// Contents are unspecified until written
+nar_lv nar_lv_alloc_uninit_64(int64_t n) {
+    return new Vector<long>(n, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_lv nar_lv_wrap_64(long* ptr, int64_t n, int64_t inc,
+    nar_release_fn release, void* ctx) {
+    return new Vector<long>(wrap_vector((long*) ptr, n, inc,
+        [release, ctx](long* p) { if (release) release(p, ctx); }));
+}
+
+int nar_lv_valid_64(nar_lv v, int64_t i) {
+    return v->in_range(i);
+}
+
+nar_lv nar_lv_slice_64(nar_lv v, int64_t start, int64_t end) {
+    return new Vector<long>(v->slice(start, end));
+}
+
+int nar_lv_slice_safe_64(nar_lv* out, nar_lv v, int64_t start, int64_t end) {
+    try {
+        *out = new Vector<long>(v->slice<true>(start, end));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int64_t nar_lv_inc_64(nar_lv v) {
+    return v->get_inc();
+}
+
+int64_t nar_lv_n_64(nar_lv v) {
+    return v->get_n();
+}
+
+// For matrices
+
+nar_lm nar_lm_alloc_64(int64_t rows, int64_t cols, int row_major) {
+    return new Matrix<long>(rows, cols, row_major);
+}
+
+// Contents are unspecified until written
+nar_lm nar_lm_alloc_uninit_64(int64_t rows, int64_t cols, int row_major) {
+    return new Matrix<long>(rows, cols, row_major, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_lm nar_lm_wrap_64(long* ptr, int64_t rows, int64_t cols,
+    int64_t inc_row, int64_t inc_col, nar_release_fn release, void* ctx) {
+    return new Matrix<long>(wrap_matrix((long*) ptr, rows, cols,
+        inc_row, inc_col,
+        [release, ctx](long* p) { if (release) release(p, ctx); }));
+}
+
+int nar_lm_valid_64(nar_lm mat, int64_t i, int64_t j) {
+    return mat->in_range(i,j);
+}
+
+// Slicing parts of matrix
+nar_lv nar_lm_row_64(nar_lm mat, int64_t i) {
+    return new Vector<long>(mat->row(i));
+}
+
+nar_lv nar_lm_col_64(nar_lm mat, int64_t j) {
+    return new Vector<long>(mat->col(j));
+}
+
+nar_lm nar_lm_subarray_64(nar_lm mat, int64_t start_row,
+    int64_t start_col, int64_t end_row, int64_t end_col) {
+    return new Matrix<long>(mat->subarray(
+        start_row, start_col, end_row, end_col));
+}
+
+int nar_lm_row_safe_64(nar_lv* x, nar_lm mat, int64_t i) {
+    try {
+        *x = new Vector<long>(mat->row<true>(i));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_lm_col_safe_64(nar_lv* x, nar_lm mat, int64_t j) {
+    try {
+        *x = new Vector<long>(mat->col<true>(j));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_lm_subarray_safe_64(nar_lm* x, nar_lm mat, int64_t start_row,
+    int64_t start_col, int64_t end_row, int64_t end_col) {
+    try {
+        *x = new Matrix<long>(mat->subarray<true>(
+            start_row, start_col, end_row, end_col));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int64_t nar_lm_get_ld_64(nar_lm mat) {
+    try {
+        return mat->get_ld();
+    } catch (...) {
+        return -1; // Not contiguously ordered
+    }
+}
+
+int64_t nar_lm_inc_row_64(nar_lm mat) {
+    return mat->get_inc_row();
+}
+
+int64_t nar_lm_inc_col_64(nar_lm mat) {
+    return mat->get_inc_col();
+}
+
+int64_t nar_lm_get_rows_64(nar_lm mat) {
+    return mat->get_rows();
+}
+
+int64_t nar_lm_get_cols_64(nar_lm mat) {
+    return mat->get_cols();
+}
+// No bounds checking
+long nar_lv_get_64(nar_lv v, int64_t i) {
+    return (*v)[i];
+}
+
+void nar_lv_set_64(nar_lv v, int64_t i, long x) {
+    (*v)[i] = x;
+}
+
+long nar_lm_get_64(nar_lm mat, int64_t i, int64_t j) {
+    return (*mat)(i,j);
+}
+
+void nar_lm_set_64(nar_lm mat, int64_t i, int64_t j, long x) {
+    (*mat)(i,j) = x;
+}
+
+// Bounds-checked versions
+int nar_lv_get_safe_64(long* x, nar_lv v, int64_t i) {
+    try {
+        *x = v->at(i);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_lv_set_safe_64(nar_lv v, int64_t i, long x) {
+    try {
+        v->at(i) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_lm_get_safe_64(long* x, nar_lm mat, int64_t i, int64_t j) {
+    try {
+        *x = mat->at(i,j);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_lm_set_safe_64(nar_lm mat, int64_t i, int64_t j, long x) {
+    try {
+        mat->at(i,j) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+// Batched element access through caller buffers.
+// These are bounds-checked and return 1 if anything is out of range.
+// Ranges with start > end are out of range; empty ones do nothing.
+
+// Copies elements [start, end) to out
+int nar_lv_get_range_64(long* out, nar_lv v,
+    int64_t start, int64_t end) {
+    try {
+        Vector<long> part = v->slice<true>(start, end);
+        strided_copy((long*) out, 1, 
+            part.pointer(), part.get_inc(), part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites elements [start, end) with the contents of in
+int nar_lv_set_range_64(nar_lv v, int64_t start, int64_t end,
+    long const* in) {
+    try {
+        Vector<long> part = v->slice<true>(start, end);
+        strided_copy(part.pointer(), part.get_inc(), 
+            (long const*) in, 1, part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at idx[0..count) to out
+int nar_lv_gather_64(long* out, nar_lv v,
+    const int64_t* idx, int64_t count) {
+    try {
+        v->gather<true>((long*) out, idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[0..count) to the elements at idx[0..count)
+int nar_lv_scatter_64(nar_lv v, const int64_t* idx,
+    int64_t count, long const* in) {
+    try {
+        v->scatter<true>(idx, count, (long const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies [start_row, end_row) x [start_col, end_col) to out,
+// which is packed in row major or column major order
+int nar_lm_get_block_64(long* out, nar_lm mat,
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major) {
+    try {
+        Matrix<long> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d((long*) out, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites [start_row, end_row) x [start_col, end_col) with in,
+// which is packed in row major or column major order
+int nar_lm_set_block_64(nar_lm mat,
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    long const* in, int row_major) {
+    try {
+        Matrix<long> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d(part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            (long const*) in, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at (rows_idx[k], cols_idx[k]) to out[k]
+int nar_lm_gather_64(long* out, nar_lm mat,
+    const int64_t* rows_idx, const int64_t* cols_idx, int64_t count) {
+    try {
+        mat->gather<true>((long*) out, rows_idx, cols_idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[k] to the elements at (rows_idx[k], cols_idx[k])
+int nar_lm_scatter_64(nar_lm mat, const int64_t* rows_idx,
+    const int64_t* cols_idx, int64_t count, long const* in) {
+    try {
+        mat->scatter<true>(rows_idx, cols_idx, count, (long const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// binary matrix file without reading the rest of it.
+// If there's an error, puts error code in err.
+nar_lm nar_lm_read_binary_subarray_64(const char* filename, 
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major, int* err) {
+    try {
+        BinaryFile<long> f(filename, ios_base::in);
+        nar_lm mat = new Matrix<long>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// tiled matrix file, reading only the tiles they intersect.
+// If there's an error, puts error code in err.
+nar_lm nar_lm_read_tiled_subarray_64(const char* filename, 
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major, int* err) {
+    try {
+        TiledFile<long> f(filename, ios_base::in);
+        nar_lm mat = new Matrix<long>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Index of the first element of largest magnitude (|Re| + |Im| for
+// complex numbers), or -1 if x is empty. The first NaN counts as largest.
+int64_t nar_lv_iamax_64(nar_lv x) {
+    return iamax(*x);
+}
+// Reads up to max_rows more rows, into a new view to free with
+// nar_lm_free. The view shares the reader's buffer, so the next
+// call overwrites its elements. Returns null at the end of the file, or
+// if there's an error, when it also puts the error code in err, as for
+// nar_lm_reader_open.
+nar_lm nar_lm_reader_next_64(nar_lm_reader reader, int64_t max_rows, int* err) {
+    try {
+        const Matrix<long>& block = reader->next(
+            std::max<Index>(max_rows, 0));
+        if (err) *err = 0;
+        if (block.get_rows() == 0 && max_rows > 0) {
+            return nullptr;
+        }
+        return new Matrix<long>(block);
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+// Reads vector from file. If there's an error, puts error code in err.
+nar_lv nar_lv_read(const char* filename, int* err) {
+    try {
+        File<long> f(filename, ios_base::in);
+        nar_lv v = new Vector<long>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to file.
+int nar_lv_write(nar_lv v, const char* filename, const char* sep) {
+    try {
+        File<long> f(filename, ios_base::out);
+        f.write_vector(*v, sep);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads MATRIX from file. If there's an error, puts error code in err.
+nar_lm nar_lm_read(const char* filename, int row_major, int* err) {
+    try {
+        File<long> f(filename, ios_base::in);
+        nar_lm v = new Matrix<long>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes MATRIX to file.
+int nar_lm_write(nar_lm v, const char* filename, const char* sep) {
+    try {
+        File<long> f(filename, ios_base::out);
+        f.write_matrix(*v, sep);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+
+// Reads vector from file into dest, reusing its memory. The file must
+// hold a vector of dest's length. Returns the error code.
+int nar_lv_read_into(nar_lv dest, const char* filename) {
+    try {
+        File<long> f(filename, ios_base::in);
+        f.read_vector_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Reads matrix from file into dest, reusing its memory. The file must
+// hold a matrix of dest's dimensions. Returns the error code.
+int nar_lm_read_into(nar_lm dest, const char* filename) {
+    try {
+        File<long> f(filename, ios_base::in);
+        f.read_matrix_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Starts reading vector from file on the I/O threads.
+// nar_future_wait returns the vector and error code.
+nar_future nar_lv_read_async(const char* filename) {
+    std::string name(filename);
+    return start_async([name]() {
+        int err;
+        void* v = nar_lv_read(name.c_str(), &err);
+        return Future::Result(v, err);
+    });
+}
+
+// Starts writing vector to file on the I/O threads. v mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_lv_write_async(nar_lv v, const char* filename, const char* sep) {
+    std::string name(filename);
+    std::string separator(sep);
+    return start_async([=]() {
+        int status = nar_lv_write(v, name.c_str(), separator.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Starts reading matrix from file on the I/O threads.
+// nar_future_wait returns the matrix and error code.
+nar_future nar_lm_read_async(const char* filename, int row_major) {
+    std::string name(filename);
+    return start_async([name, row_major]() {
+        int err;
+        void* mat = nar_lm_read(name.c_str(), row_major, &err);
+        return Future::Result(mat, err);
+    });
+}
+
+// Starts writing matrix to file on the I/O threads. mat mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_lm_write_async(nar_lm mat, const char* filename, const char* sep) {
+    std::string name(filename);
+    std::string separator(sep);
+    return start_async([=]() {
+        int status = nar_lm_write(mat, name.c_str(), separator.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Writes vector to file with precision significant digits for floating
+// point values, or NAR_PRECISION_SHORTEST for the fewest that read back
+// exactly.
+int nar_lv_write_precision(nar_lv v, const char* filename, const char* sep, int precision) {
+    try {
+        File<long> f(filename, ios_base::out);
+        f.write_vector(*v, sep, precision);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Writes matrix to file with precision significant digits for floating
+// point values, or NAR_PRECISION_SHORTEST for the fewest that read back
+// exactly.
+int nar_lm_write_precision(nar_lm v, const char* filename, const char* sep, int precision) {
+    try {
+        File<long> f(filename, ios_base::out);
+        f.write_matrix(*v, sep, precision);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+
+// Reads vector from file. If there's an error, puts error code in err.
+nar_lv nar_lv_read_binary(const char* filename, int* err) {
+    try {
+        BinaryFile<long> f(filename, ios_base::in);
+        nar_lv v = new Vector<long>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to file.
+int nar_lv_write_binary(nar_lv v, const char* filename) {
+    try {
+        BinaryFile<long> f(filename, ios_base::out);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads MATRIX from file. If there's an error, puts error code in err.
+nar_lm nar_lm_read_binary(const char* filename, int row_major, int* err) {
+    try {
+        BinaryFile<long> f(filename, ios_base::in);
+        nar_lm v = new Matrix<long>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes MATRIX to file.
+int nar_lm_write_binary(nar_lm v, const char* filename) {
+    try {
+        BinaryFile<long> f(filename, ios_base::out);
+        f.write_matrix(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+
+// Reads vector from file into dest, reusing its memory. The file must
+// hold a vector of dest's length. Returns the error code.
+int nar_lv_read_binary_into(nar_lv dest, const char* filename) {
+    try {
+        BinaryFile<long> f(filename, ios_base::in);
+        f.read_vector_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Reads matrix from file into dest, reusing its memory. The file must
+// hold a matrix of dest's dimensions. Returns the error code.
+int nar_lm_read_binary_into(nar_lm dest, const char* filename) {
+    try {
+        BinaryFile<long> f(filename, ios_base::in);
+        f.read_matrix_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Starts reading vector from file on the I/O threads.
+// nar_future_wait returns the vector and error code.
+nar_future nar_lv_read_binary_async(const char* filename) {
+    std::string name(filename);
+    return start_async([name]() {
+        int err;
+        void* v = nar_lv_read_binary(name.c_str(), &err);
+        return Future::Result(v, err);
+    });
+}
+
+// Starts writing vector to file on the I/O threads. v mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_lv_write_binary_async(nar_lv v, const char* filename) {
+    std::string name(filename);
+    return start_async([=]() {
+        int status = nar_lv_write_binary(v, name.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Starts reading matrix from file on the I/O threads.
+// nar_future_wait returns the matrix and error code.
+nar_future nar_lm_read_binary_async(const char* filename, int row_major) {
+    std::string name(filename);
+    return start_async([name, row_major]() {
+        int err;
+        void* mat = nar_lm_read_binary(name.c_str(), row_major, &err);
+        return Future::Result(mat, err);
+    });
+}
+
+// Starts writing matrix to file on the I/O threads. mat mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_lm_write_binary_async(nar_lm mat, const char* filename) {
+    std::string name(filename);
+    return start_async([=]() {
+        int status = nar_lm_write_binary(mat, name.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Maps a binary file written by nar_lv_write_binary into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_lv nar_lv_mmap(const char* filename, enum nar_map_mode mode, int* err) {
+    try {
+        BinaryFile<long> f(filename, ios_base::in);
+        nar_lv v = new Vector<long>(f.map_vector((MapMode) mode));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps a binary file written by nar_lm_write_binary into memory.
+// The matrix has the order it was stored in, so column major matrices
+// map as column major. The file stays mapped until the last view of it
+// is freed. If there's an error, puts error code in err.
+nar_lm nar_lm_mmap(const char* filename, enum nar_map_mode mode, int* err) {
+    try {
+        BinaryFile<long> f(filename, ios_base::in);
+        nar_lm mat = new Matrix<long>(f.map_matrix((MapMode) mode));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to a binary file, compressed in chunks.
+// nar_lv_read_binary reads it back.
+int nar_lv_write_binary_compressed(nar_lv v, const char* filename) {
+    try {
+        BinaryFile<long> f(filename, ios_base::out);
+        f.set_compressed(true);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Writes matrix to a binary file, compressed in chunks.
+// nar_lm_read_binary reads it back.
+int nar_lm_write_binary_compressed(nar_lm mat, const char* filename) {
+    try {
+        BinaryFile<long> f(filename, ios_base::out);
+        f.set_compressed(true);
+        f.write_matrix(*mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads a 1D array from a NumPy .npy file.
+// If there's an error, puts error code in err.
+nar_lv nar_lv_read_npy(const char* filename, int* err) {
+    try {
+        NpyFile<long> f(filename, ios_base::in);
+        nar_lv v = new Vector<long>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads the named 1D array from an uncompressed NumPy .npz archive.
+// If there's an error, puts error code in err.
+nar_lv nar_lv_read_npz(const char* filename, const char* name, int* err) {
+    try {
+        NpyFile<long> f(filename, ios_base::in);
+        nar_lv v = new Vector<long>(
+            f.read_vector(f.find_entry(name)));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to a NumPy .npy file.
+int nar_lv_write_npy(nar_lv v, const char* filename) {
+    try {
+        NpyFile<long> f(filename, ios_base::out);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads a 2D array from a NumPy .npy file. Fortran order arrays become
+// column major matrices. If there's an error, puts error code in err.
+nar_lm nar_lm_read_npy(const char* filename, int* err) {
+    try {
+        NpyFile<long> f(filename, ios_base::in);
+        nar_lm mat = new Matrix<long>(f.read_matrix());
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads the named 2D array from an uncompressed NumPy .npz archive.
+// If there's an error, puts error code in err.
+nar_lm nar_lm_read_npz(const char* filename, const char* name, int* err) {
+    try {
+        NpyFile<long> f(filename, ios_base::in);
+        nar_lm mat = new Matrix<long>(
+            f.read_matrix(f.find_entry(name)));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes matrix to a NumPy .npy file. Column major matrices
+// are written in Fortran order.
+int nar_lm_write_npy(nar_lm mat, const char* filename) {
+    try {
+        NpyFile<long> f(filename, ios_base::out);
+        f.write_matrix(*mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Opens a text matrix file for reading a block of rows at a time.
+// If there's an error, puts error code in err: 1 if the file can't be
+// read, 2 if it's malformed and 3 for anything else, such as running
+// out of memory.
+nar_lm_reader nar_lm_reader_open(const char* filename, int* err) {
+    try {
+        nar_lm_reader reader = 
+            new MatrixReader<long>(filename, false);
+        if (err) *err = 0;
+        return reader;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+// Opens a binary matrix file for reading a block of rows at a time.
+// If there's an error, puts error code in err, as for
+// nar_lm_reader_open.
+nar_lm_reader nar_lm_reader_open_binary(const char* filename, int* err) {
+    try {
+        nar_lm_reader reader = 
+            new MatrixReader<long>(filename, true);
+        if (err) *err = 0;
+        return reader;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+void nar_lm_reader_close(nar_lm_reader reader) {
+    delete reader;
+}
+
+// Reads a matrix from a tiled file. If there's an error, puts error code in err.
+nar_lm nar_lm_read_tiled(const char* filename, int row_major, int* err) {
+    try {
+        TiledFile<long> f(filename, ios_base::in);
+        nar_lm mat = new Matrix<long>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes matrix to a file as tiles of tile_rows x tile_cols elements.
+// Tile sizes of 0 use the default of 256.
+int nar_lm_write_tiled(nar_lm mat, const char* filename, int tile_rows, int tile_cols) {
+    try {
+        TiledFile<long> f(filename, ios_base::out);
+        f.write_matrix(*mat, tile_rows, tile_cols);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Adds vector to archive under name, replacing any entry with that name.
+int nar_lv_archive_put(nar_archive archive, const char* name, nar_lv v) {
+    try {
+        archive->put(name, *v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads the named vector from archive.
+// If there's an error, puts error code in err.
+nar_lv nar_lv_archive_get(nar_archive archive, const char* name, int* err) {
+    try {
+        nar_lv v = new Vector<long>(
+            archive->get_vector<long>(name));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps the named vector from archive into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_lv nar_lv_archive_map(nar_archive archive, const char* name, enum nar_map_mode mode, int* err) {
+    try {
+        nar_lv v = new Vector<long>(
+            archive->map_vector<long>(name, (MapMode) mode));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Adds matrix to archive under name, replacing any entry with that name.
+int nar_lm_archive_put(nar_archive archive, const char* name, nar_lm mat) {
+    try {
+        archive->put(name, *mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads the named matrix from archive, in the order it was stored in.
+// If there's an error, puts error code in err.
+nar_lm nar_lm_archive_get(nar_archive archive, const char* name, int* err) {
+    try {
+        nar_lm mat = new Matrix<long>(
+            archive->get_matrix<long>(name));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps the named matrix from archive into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_lm nar_lm_archive_map(nar_archive archive, const char* name, enum nar_map_mode mode, int* err) {
+    try {
+        nar_lm mat = new Matrix<long>(
+            archive->map_matrix<long>(name, (MapMode) mode));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// BLAS level 1. Functions of two vectors return 1 if their lengths differ.
+
+// y += alpha x
+int nar_lv_axpy(long alpha, nar_lv x, nar_lv y) {
+    try {
+        axpy(alpha, *x, *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// Puts the dot product of x and y in result
+int nar_lv_dot(long* result, nar_lv x, nar_lv y) {
+    try {
+        *result = dot(*x, *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// x *= alpha
+void nar_lv_scal(long alpha, nar_lv x) {
+    scal(alpha, *x);
+}
+
+// Euclidean norm
+double nar_lv_nrm2(nar_lv x) {
+    return nrm2(*x);
+}
+
+// Sum of absolute values. Integer sums are unsigned 64 bit, so they only
+// wrap around past 2^64.
+uint64_t nar_lv_asum(nar_lv x) {
+    return asum(*x);
+}
+
+
+// Routines for vectors and matrices of the given type
+// that don't depend on the index type
+
+void nar_sv_free(nar_sv v) {
+    delete v;
+}
+
+nar_sv nar_sv_copy(nar_sv v) {
+    return new Vector<float>(v->copy());
+}
+
+float* nar_sv_pointer(nar_sv v) {
+    return (float*) v->pointer();
+}
+
+// Fills out with the data pointer, dimensions and strides of v
+void nar_sv_describe(nar_sv v, struct nar_view* out) {
+    out->data = v->pointer();
+    out->n = v->get_n();
+    out->rows = v->get_n();
+    out->cols = 1;
+    out->inc = v->get_inc();
+    out->inc_row = v->get_inc();
+    out->inc_col = 0;
+    out->dtype = TypeCode<float>::value;
+}
+
+int nar_sv_eq(nar_sv v1, nar_sv v2) {
+    return (*v1) == (*v2);
+}
+
+int nar_sv_assign(nar_sv v1, nar_sv v2) {
+    try {
+        v1->assign(*v2);
+        return 0;
+    } catch (const std::out_of_range& e) {
+        return 1;
+    }
+}
+
+void nar_sm_free(nar_sm mat) {
+    delete mat;
+}
+
+nar_sm nar_sm_copy(nar_sm mat) {
+    return new Matrix<float>(mat->copy());
+}
+
+enum nar_order nar_sm_order(nar_sm mat) {
+    return (nar_order) mat->get_order();
+}
+
+float* nar_sm_pointer(nar_sm mat) {
+    return (float*) mat->pointer();
+}
+
+// Fills out with the data pointer, dimensions and strides of mat
+void nar_sm_describe(nar_sm mat, struct nar_view* out) {
+    out->data = mat->pointer();
+    out->n = mat->get_rows() * mat->get_cols();
+    out->rows = mat->get_rows();
+    out->cols = mat->get_cols();
+    out->inc = 0;
+    out->inc_row = mat->get_inc_row();
+    out->inc_col = mat->get_inc_col();
+    out->dtype = TypeCode<float>::value;
+}
+
+int nar_sm_eq(nar_sm mat1, nar_sm mat2) {
+    return (*mat1) == (*mat2);
+}
+
+int nar_sm_assign(nar_sm mat1, nar_sm mat2) {
+    try {
+        mat1->assign(*mat2);
+        return 0;
+    } catch (const std::out_of_range& e) {
+        return 1;
+    }
+}
+
+// Display strings
+char* nar_sm_display_string(nar_sm mat) {
+    return string_to_char(display_string(*mat));
+}
+
+char* nar_sv_display_string(nar_sv v) {
+    return string_to_char(display_string(*v));
+}
+
+// Main routines for vectors and matrices of the given type
+// with int sizes, indices and strides
+
+nar_sv nar_sv_alloc(int n) {
+    return new Vector<float>(n);
+}
+
+// Contents are unspecified until written
+nar_sv nar_sv_alloc_uninit(int n) {
+    return new Vector<float>(n, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_sv nar_sv_wrap(float* ptr, int n, int inc,
+    nar_release_fn release, void* ctx) {
+    return new Vector<float>(wrap_vector((float*) ptr, n, inc,
+        [release, ctx](float* p) { if (release) release(p, ctx); }));
+}
+
+int nar_sv_valid(nar_sv v, int i) {
+    return v->in_range(i);
+}
+
+nar_sv nar_sv_slice(nar_sv v, int start, int end) {
+    return new Vector<float>(v->slice(start, end));
+}
+
+int nar_sv_slice_safe(nar_sv* out, nar_sv v, int start, int end) {
+    try {
+        *out = new Vector<float>(v->slice<true>(start, end));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_sv_inc(nar_sv v) {
+    return v->get_inc();
+}
+
+int nar_sv_n(nar_sv v) {
+    return v->get_n();
+}
+
+// For matrices
+
+nar_sm nar_sm_alloc(int rows, int cols, int row_major) {
+    return new Matrix<float>(rows, cols, row_major);
+}
+
+// Contents are unspecified until written
+nar_sm nar_sm_alloc_uninit(int rows, int cols, int row_major) {
+    return new Matrix<float>(rows, cols, row_major, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_sm nar_sm_wrap(float* ptr, int rows, int cols,
+    int inc_row, int inc_col, nar_release_fn release, void* ctx) {
+    return new Matrix<float>(wrap_matrix((float*) ptr, rows, cols,
+        inc_row, inc_col,
+        [release, ctx](float* p) { if (release) release(p, ctx); }));
+}
+
+int nar_sm_valid(nar_sm mat, int i, int j) {
+    return mat->in_range(i,j);
+}
+
+// Slicing parts of matrix
+nar_sv nar_sm_row(nar_sm mat, int i) {
+    return new Vector<float>(mat->row(i));
+}
+
+nar_sv nar_sm_col(nar_sm mat, int j) {
+    return new Vector<float>(mat->col(j));
+}
+
+nar_sm nar_sm_subarray(nar_sm mat, int start_row,
+    int start_col, int end_row, int end_col) {
+    return new Matrix<float>(mat->subarray(
+        start_row, start_col, end_row, end_col));
+}
+
+int nar_sm_row_safe(nar_sv* x, nar_sm mat, int i) {
+    try {
+        *x = new Vector<float>(mat->row<true>(i));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_sm_col_safe(nar_sv* x, nar_sm mat, int j) {
+    try {
+        *x = new Vector<float>(mat->col<true>(j));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_sm_subarray_safe(nar_sm* x, nar_sm mat, int start_row,
+    int start_col, int end_row, int end_col) {
+    try {
+        *x = new Matrix<float>(mat->subarray<true>(
+            start_row, start_col, end_row, end_col));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_sm_get_ld(nar_sm mat) {
+    try {
+        return mat->get_ld();
+    } catch (...) {
+        return -1; // Not contiguously ordered
+    }
+}
+
+int nar_sm_inc_row(nar_sm mat) {
+    return mat->get_inc_row();
+}
+
+int nar_sm_inc_col(nar_sm mat) {
+    return mat->get_inc_col();
+}
+
+int nar_sm_get_rows(nar_sm mat) {
+    return mat->get_rows();
+}
+
+int nar_sm_get_cols(nar_sm mat) {
+    return mat->get_cols();
+}
+// No bounds checking
+float nar_sv_get(nar_sv v, int i) {
+    return (*v)[i];
+}
+
+void nar_sv_set(nar_sv v, int i, float x) {
+    (*v)[i] = x;
+}
+
+float nar_sm_get(nar_sm mat, int i, int j) {
+    return (*mat)(i,j);
+}
+
+void nar_sm_set(nar_sm mat, int i, int j, float x) {
+    (*mat)(i,j) = x;
+}
+
+// Bounds-checked versions
+int nar_sv_get_safe(float* x, nar_sv v, int i) {
+    try {
+        *x = v->at(i);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_sv_set_safe(nar_sv v, int i, float x) {
+    try {
+        v->at(i) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_sm_get_safe(float* x, nar_sm mat, int i, int j) {
+    try {
+        *x = mat->at(i,j);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_sm_set_safe(nar_sm mat, int i, int j, float x) {
+    try {
+        mat->at(i,j) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+// Batched element access through caller buffers.
+// These are bounds-checked and return 1 if anything is out of range.
+// Ranges with start > end are out of range; empty ones do nothing.
+
+// Copies elements [start, end) to out
+int nar_sv_get_range(float* out, nar_sv v,
+    int start, int end) {
+    try {
+        Vector<float> part = v->slice<true>(start, end);
+        strided_copy((float*) out, 1, 
+            part.pointer(), part.get_inc(), part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites elements [start, end) with the contents of in
+int nar_sv_set_range(nar_sv v, int start, int end,
+    float const* in) {
+    try {
+        Vector<float> part = v->slice<true>(start, end);
+        strided_copy(part.pointer(), part.get_inc(), 
+            (float const*) in, 1, part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at idx[0..count) to out
+int nar_sv_gather(float* out, nar_sv v,
+    const int* idx, int count) {
+    try {
+        v->gather<true>((float*) out, idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[0..count) to the elements at idx[0..count)
+int nar_sv_scatter(nar_sv v, const int* idx,
+    int count, float const* in) {
+    try {
+        v->scatter<true>(idx, count, (float const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies [start_row, end_row) x [start_col, end_col) to out,
+// which is packed in row major or column major order
+int nar_sm_get_block(float* out, nar_sm mat,
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major) {
+    try {
+        Matrix<float> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d((float*) out, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites [start_row, end_row) x [start_col, end_col) with in,
+// which is packed in row major or column major order
+int nar_sm_set_block(nar_sm mat,
+    int start_row, int start_col, int end_row, int end_col,
+    float const* in, int row_major) {
+    try {
+        Matrix<float> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d(part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            (float const*) in, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at (rows_idx[k], cols_idx[k]) to out[k]
+int nar_sm_gather(float* out, nar_sm mat,
+    const int* rows_idx, const int* cols_idx, int count) {
+    try {
+        mat->gather<true>((float*) out, rows_idx, cols_idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[k] to the elements at (rows_idx[k], cols_idx[k])
+int nar_sm_scatter(nar_sm mat, const int* rows_idx,
+    const int* cols_idx, int count, float const* in) {
+    try {
+        mat->scatter<true>(rows_idx, cols_idx, count, (float const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// binary matrix file without reading the rest of it.
+// If there's an error, puts error code in err.
+nar_sm nar_sm_read_binary_subarray(const char* filename, 
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major, int* err) {
+    try {
+        BinaryFile<float> f(filename, ios_base::in);
+        nar_sm mat = new Matrix<float>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// tiled matrix file, reading only the tiles they intersect.
+// If there's an error, puts error code in err.
+nar_sm nar_sm_read_tiled_subarray(const char* filename, 
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major, int* err) {
+    try {
+        TiledFile<float> f(filename, ios_base::in);
+        nar_sm mat = new Matrix<float>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Index of the first element of largest magnitude (|Re| + |Im| for
+// complex numbers), or -1 if x is empty. The first NaN counts as largest.
+int nar_sv_iamax(nar_sv x) {
+    return iamax(*x);
+}
+// Reads up to max_rows more rows, into a new view to free with
+// nar_sm_free. The view shares the reader's buffer, so the next
+// call overwrites its elements. Returns null at the end of the file, or
+// if there's an error, when it also puts the error code in err, as for
+// nar_sm_reader_open.
+nar_sm nar_sm_reader_next(nar_sm_reader reader, int max_rows, int* err) {
+    try {
+        const Matrix<float>& block = reader->next(
+            std::max<Index>(max_rows, 0));
+        if (err) *err = 0;
+        if (block.get_rows() == 0 && max_rows > 0) {
+            return nullptr;
+        }
+        return new Matrix<float>(block);
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+// Main routines for vectors and matrices of the given type
+// with int64_t sizes, indices and strides
+
+nar_sv nar_sv_alloc_64(int64_t n) {
+    return new Vector<float>(n);
+}
+
+// Contents are unspecified until written
+nar_sv nar_sv_alloc_uninit_64(int64_t n) {
+    return new Vector<float>(n, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_sv nar_sv_wrap_64(float* ptr, int64_t n, int64_t inc,
+    nar_release_fn release, void* ctx) {
+    return new Vector<float>(wrap_vector((float*) ptr, n, inc,
+        [release, ctx](float* p) { if (release) release(p, ctx); }));
+}
+
+int nar_sv_valid_64(nar_sv v, int64_t i) {
+    return v->in_range(i);
+}
+
+nar_sv nar_sv_slice_64(nar_sv v, int64_t start, int64_t end) {
+    return new Vector<float>(v->slice(start, end));
+}
+
+int nar_sv_slice_safe_64(nar_sv* out, nar_sv v, int64_t start, int64_t end) {
+    try {
+        *out = new Vector<float>(v->slice<true>(start, end));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int64_t nar_sv_inc_64(nar_sv v) {
+    return v->get_inc();
+}
+
+int64_t nar_sv_n_64(nar_sv v) {
+    return v->get_n();
+}
+
+// For matrices
+
+nar_sm nar_sm_alloc_64(int64_t rows, int64_t cols, int row_major) {
+    return new Matrix<float>(rows, cols, row_major);
+}
+
+// Contents are unspecified until written
+nar_sm nar_sm_alloc_uninit_64(int64_t rows, int64_t cols, int row_major) {
+    return new Matrix<float>(rows, cols, row_major, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_sm nar_sm_wrap_64(float* ptr, int64_t rows, int64_t cols,
+    int64_t inc_row, int64_t inc_col, nar_release_fn release, void* ctx) {
+    return new Matrix<float>(wrap_matrix((float*) ptr, rows, cols,
+        inc_row, inc_col,
+        [release, ctx](float* p) { if (release) release(p, ctx); }));
+}
+
+int nar_sm_valid_64(nar_sm mat, int64_t i, int64_t j) {
+    return mat->in_range(i,j);
+}
+
+// Slicing parts of matrix
+nar_sv nar_sm_row_64(nar_sm mat, int64_t i) {
+    return new Vector<float>(mat->row(i));
+}
+
+nar_sv nar_sm_col_64(nar_sm mat, int64_t j) {
+    return new Vector<float>(mat->col(j));
+}
+
+nar_sm nar_sm_subarray_64(nar_sm mat, int64_t start_row,
+    int64_t start_col, int64_t end_row, int64_t end_col) {
+    return new Matrix<float>(mat->subarray(
+        start_row, start_col, end_row, end_col));
+}
+
+int nar_sm_row_safe_64(nar_sv* x, nar_sm mat, int64_t i) {
+    try {
+        *x = new Vector<float>(mat->row<true>(i));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_sm_col_safe_64(nar_sv* x, nar_sm mat, int64_t j) {
+    try {
+        *x = new Vector<float>(mat->col<true>(j));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_sm_subarray_safe_64(nar_sm* x, nar_sm mat, int64_t start_row,
+    int64_t start_col, int64_t end_row, int64_t end_col) {
+    try {
+        *x = new Matrix<float>(mat->subarray<true>(
+            start_row, start_col, end_row, end_col));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int64_t nar_sm_get_ld_64(nar_sm mat) {
+    try {
+        return mat->get_ld();
+    } catch (...) {
+        return -1; // Not contiguously ordered
+    }
+}
+
+int64_t nar_sm_inc_row_64(nar_sm mat) {
+    return mat->get_inc_row();
+}
+
+int64_t nar_sm_inc_col_64(nar_sm mat) {
+    return mat->get_inc_col();
+}
+
+int64_t nar_sm_get_rows_64(nar_sm mat) {
+    return mat->get_rows();
+}
+
+int64_t nar_sm_get_cols_64(nar_sm mat) {
+    return mat->get_cols();
+}
+// No bounds checking
+float nar_sv_get_64(nar_sv v, int64_t i) {
+    return (*v)[i];
+}
+
+void nar_sv_set_64(nar_sv v, int64_t i, float x) {
+    (*v)[i] = x;
+}
+
+float nar_sm_get_64(nar_sm mat, int64_t i, int64_t j) {
+    return (*mat)(i,j);
+}
+
+void nar_sm_set_64(nar_sm mat, int64_t i, int64_t j, float x) {
+    (*mat)(i,j) = x;
+}
+
+// Bounds-checked versions
+int nar_sv_get_safe_64(float* x, nar_sv v, int64_t i) {
+    try {
+        *x = v->at(i);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_sv_set_safe_64(nar_sv v, int64_t i, float x) {
+    try {
+        v->at(i) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_sm_get_safe_64(float* x, nar_sm mat, int64_t i, int64_t j) {
+    try {
+        *x = mat->at(i,j);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_sm_set_safe_64(nar_sm mat, int64_t i, int64_t j, float x) {
+    try {
+        mat->at(i,j) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+// Batched element access through caller buffers.
+// These are bounds-checked and return 1 if anything is out of range.
+// Ranges with start > end are out of range; empty ones do nothing.
+
+// Copies elements [start, end) to out
+int nar_sv_get_range_64(float* out, nar_sv v,
+    int64_t start, int64_t end) {
+    try {
+        Vector<float> part = v->slice<true>(start, end);
+        strided_copy((float*) out, 1, 
+            part.pointer(), part.get_inc(), part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites elements [start, end) with the contents of in
+int nar_sv_set_range_64(nar_sv v, int64_t start, int64_t end,
+    float const* in) {
+    try {
+        Vector<float> part = v->slice<true>(start, end);
+        strided_copy(part.pointer(), part.get_inc(), 
+            (float const*) in, 1, part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at idx[0..count) to out
+int nar_sv_gather_64(float* out, nar_sv v,
+    const int64_t* idx, int64_t count) {
+    try {
+        v->gather<true>((float*) out, idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[0..count) to the elements at idx[0..count)
+int nar_sv_scatter_64(nar_sv v, const int64_t* idx,
+    int64_t count, float const* in) {
+    try {
+        v->scatter<true>(idx, count, (float const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies [start_row, end_row) x [start_col, end_col) to out,
+// which is packed in row major or column major order
+int nar_sm_get_block_64(float* out, nar_sm mat,
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major) {
+    try {
+        Matrix<float> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d((float*) out, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites [start_row, end_row) x [start_col, end_col) with in,
+// which is packed in row major or column major order
+int nar_sm_set_block_64(nar_sm mat,
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    float const* in, int row_major) {
+    try {
+        Matrix<float> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d(part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            (float const*) in, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at (rows_idx[k], cols_idx[k]) to out[k]
+int nar_sm_gather_64(float* out, nar_sm mat,
+    const int64_t* rows_idx, const int64_t* cols_idx, int64_t count) {
+    try {
+        mat->gather<true>((float*) out, rows_idx, cols_idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[k] to the elements at (rows_idx[k], cols_idx[k])
+int nar_sm_scatter_64(nar_sm mat, const int64_t* rows_idx,
+    const int64_t* cols_idx, int64_t count, float const* in) {
+    try {
+        mat->scatter<true>(rows_idx, cols_idx, count, (float const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// binary matrix file without reading the rest of it.
+// If there's an error, puts error code in err.
+nar_sm nar_sm_read_binary_subarray_64(const char* filename, 
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major, int* err) {
+    try {
+        BinaryFile<float> f(filename, ios_base::in);
+        nar_sm mat = new Matrix<float>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// tiled matrix file, reading only the tiles they intersect.
+// If there's an error, puts error code in err.
+nar_sm nar_sm_read_tiled_subarray_64(const char* filename, 
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major, int* err) {
+    try {
+        TiledFile<float> f(filename, ios_base::in);
+        nar_sm mat = new Matrix<float>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Index of the first element of largest magnitude (|Re| + |Im| for
+// complex numbers), or -1 if x is empty. The first NaN counts as largest.
+int64_t nar_sv_iamax_64(nar_sv x) {
+    return iamax(*x);
+}
+// Reads up to max_rows more rows, into a new view to free with
+// nar_sm_free. The view shares the reader's buffer, so the next
+// call overwrites its elements. Returns null at the end of the file, or
+// if there's an error, when it also puts the error code in err, as for
+// nar_sm_reader_open.
+nar_sm nar_sm_reader_next_64(nar_sm_reader reader, int64_t max_rows, int* err) {
+    try {
+        const Matrix<float>& block = reader->next(
+            std::max<Index>(max_rows, 0));
+        if (err) *err = 0;
+        if (block.get_rows() == 0 && max_rows > 0) {
+            return nullptr;
+        }
+        return new Matrix<float>(block);
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+// Reads vector from file. If there's an error, puts error code in err.
+nar_sv nar_sv_read(const char* filename, int* err) {
+    try {
+        File<float> f(filename, ios_base::in);
+        nar_sv v = new Vector<float>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to file.
+int nar_sv_write(nar_sv v, const char* filename, const char* sep) {
+    try {
+        File<float> f(filename, ios_base::out);
+        f.write_vector(*v, sep);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads MATRIX from file. If there's an error, puts error code in err.
+nar_sm nar_sm_read(const char* filename, int row_major, int* err) {
+    try {
+        File<float> f(filename, ios_base::in);
+        nar_sm v = new Matrix<float>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes MATRIX to file.
+int nar_sm_write(nar_sm v, const char* filename, const char* sep) {
+    try {
+        File<float> f(filename, ios_base::out);
+        f.write_matrix(*v, sep);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+
+// Reads vector from file into dest, reusing its memory. The file must
+// hold a vector of dest's length. Returns the error code.
+int nar_sv_read_into(nar_sv dest, const char* filename) {
+    try {
+        File<float> f(filename, ios_base::in);
+        f.read_vector_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Reads matrix from file into dest, reusing its memory. The file must
+// hold a matrix of dest's dimensions. Returns the error code.
+int nar_sm_read_into(nar_sm dest, const char* filename) {
+    try {
+        File<float> f(filename, ios_base::in);
+        f.read_matrix_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Starts reading vector from file on the I/O threads.
+// nar_future_wait returns the vector and error code.
+nar_future nar_sv_read_async(const char* filename) {
+    std::string name(filename);
+    return start_async([name]() {
+        int err;
+        void* v = nar_sv_read(name.c_str(), &err);
+        return Future::Result(v, err);
+    });
+}
+
+// Starts writing vector to file on the I/O threads. v mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_sv_write_async(nar_sv v, const char* filename, const char* sep) {
+    std::string name(filename);
+    std::string separator(sep);
+    return start_async([=]() {
+        int status = nar_sv_write(v, name.c_str(), separator.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Starts reading matrix from file on the I/O threads.
+// nar_future_wait returns the matrix and error code.
+nar_future nar_sm_read_async(const char* filename, int row_major) {
+    std::string name(filename);
+    return start_async([name, row_major]() {
+        int err;
+        void* mat = nar_sm_read(name.c_str(), row_major, &err);
+        return Future::Result(mat, err);
+    });
+}
+
+// Starts writing matrix to file on the I/O threads. mat mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_sm_write_async(nar_sm mat, const char* filename, const char* sep) {
+    std::string name(filename);
+    std::string separator(sep);
+    return start_async([=]() {
+        int status = nar_sm_write(mat, name.c_str(), separator.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Writes vector to file with precision significant digits for floating
+// point values, or NAR_PRECISION_SHORTEST for the fewest that read back
+// exactly.
+int nar_sv_write_precision(nar_sv v, const char* filename, const char* sep, int precision) {
+    try {
+        File<float> f(filename, ios_base::out);
+        f.write_vector(*v, sep, precision);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Writes matrix to file with precision significant digits for floating
+// point values, or NAR_PRECISION_SHORTEST for the fewest that read back
+// exactly.
+int nar_sm_write_precision(nar_sm v, const char* filename, const char* sep, int precision) {
+    try {
+        File<float> f(filename, ios_base::out);
+        f.write_matrix(*v, sep, precision);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+
+// Reads vector from file. If there's an error, puts error code in err.
+nar_sv nar_sv_read_binary(const char* filename, int* err) {
+    try {
+        BinaryFile<float> f(filename, ios_base::in);
+        nar_sv v = new Vector<float>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to file.
+int nar_sv_write_binary(nar_sv v, const char* filename) {
+    try {
+        BinaryFile<float> f(filename, ios_base::out);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads MATRIX from file. If there's an error, puts error code in err.
+nar_sm nar_sm_read_binary(const char* filename, int row_major, int* err) {
+    try {
+        BinaryFile<float> f(filename, ios_base::in);
+        nar_sm v = new Matrix<float>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes MATRIX to file.
+int nar_sm_write_binary(nar_sm v, const char* filename) {
+    try {
+        BinaryFile<float> f(filename, ios_base::out);
+        f.write_matrix(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+
+// Reads vector from file into dest, reusing its memory. The file must
+// hold a vector of dest's length. Returns the error code.
+int nar_sv_read_binary_into(nar_sv dest, const char* filename) {
+    try {
+        BinaryFile<float> f(filename, ios_base::in);
+        f.read_vector_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Reads matrix from file into dest, reusing its memory. The file must
+// hold a matrix of dest's dimensions. Returns the error code.
+int nar_sm_read_binary_into(nar_sm dest, const char* filename) {
+    try {
+        BinaryFile<float> f(filename, ios_base::in);
+        f.read_matrix_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Starts reading vector from file on the I/O threads.
+// nar_future_wait returns the vector and error code.
+nar_future nar_sv_read_binary_async(const char* filename) {
+    std::string name(filename);
+    return start_async([name]() {
+        int err;
+        void* v = nar_sv_read_binary(name.c_str(), &err);
+        return Future::Result(v, err);
+    });
+}
+
+// Starts writing vector to file on the I/O threads. v mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_sv_write_binary_async(nar_sv v, const char* filename) {
+    std::string name(filename);
+    return start_async([=]() {
+        int status = nar_sv_write_binary(v, name.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Starts reading matrix from file on the I/O threads.
+// nar_future_wait returns the matrix and error code.
+nar_future nar_sm_read_binary_async(const char* filename, int row_major) {
+    std::string name(filename);
+    return start_async([name, row_major]() {
+        int err;
+        void* mat = nar_sm_read_binary(name.c_str(), row_major, &err);
+        return Future::Result(mat, err);
+    });
+}
+
+// Starts writing matrix to file on the I/O threads. mat mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_sm_write_binary_async(nar_sm mat, const char* filename) {
+    std::string name(filename);
+    return start_async([=]() {
+        int status = nar_sm_write_binary(mat, name.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Maps a binary file written by nar_sv_write_binary into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_sv nar_sv_mmap(const char* filename, enum nar_map_mode mode, int* err) {
+    try {
+        BinaryFile<float> f(filename, ios_base::in);
+        nar_sv v = new Vector<float>(f.map_vector((MapMode) mode));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps a binary file written by nar_sm_write_binary into memory.
+// The matrix has the order it was stored in, so column major matrices
+// map as column major. The file stays mapped until the last view of it
+// is freed. If there's an error, puts error code in err.
+nar_sm nar_sm_mmap(const char* filename, enum nar_map_mode mode, int* err) {
+    try {
+        BinaryFile<float> f(filename, ios_base::in);
+        nar_sm mat = new Matrix<float>(f.map_matrix((MapMode) mode));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to a binary file, compressed in chunks.
+// nar_sv_read_binary reads it back.
+int nar_sv_write_binary_compressed(nar_sv v, const char* filename) {
+    try {
+        BinaryFile<float> f(filename, ios_base::out);
+        f.set_compressed(true);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Writes matrix to a binary file, compressed in chunks.
+// nar_sm_read_binary reads it back.
+int nar_sm_write_binary_compressed(nar_sm mat, const char* filename) {
+    try {
+        BinaryFile<float> f(filename, ios_base::out);
+        f.set_compressed(true);
+        f.write_matrix(*mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads a 1D array from a NumPy .npy file.
+// If there's an error, puts error code in err.
+nar_sv nar_sv_read_npy(const char* filename, int* err) {
+    try {
+        NpyFile<float> f(filename, ios_base::in);
+        nar_sv v = new Vector<float>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads the named 1D array from an uncompressed NumPy .npz archive.
+// If there's an error, puts error code in err.
+nar_sv nar_sv_read_npz(const char* filename, const char* name, int* err) {
+    try {
+        NpyFile<float> f(filename, ios_base::in);
+        nar_sv v = new Vector<float>(
+            f.read_vector(f.find_entry(name)));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to a NumPy .npy file.
+int nar_sv_write_npy(nar_sv v, const char* filename) {
+    try {
+        NpyFile<float> f(filename, ios_base::out);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads a 2D array from a NumPy .npy file. Fortran order arrays become
+// column major matrices. If there's an error, puts error code in err.
+nar_sm nar_sm_read_npy(const char* filename, int* err) {
+    try {
+        NpyFile<float> f(filename, ios_base::in);
+        nar_sm mat = new Matrix<float>(f.read_matrix());
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads the named 2D array from an uncompressed NumPy .npz archive.
+// If there's an error, puts error code in err.
+nar_sm nar_sm_read_npz(const char* filename, const char* name, int* err) {
+    try {
+        NpyFile<float> f(filename, ios_base::in);
+        nar_sm mat = new Matrix<float>(
+            f.read_matrix(f.find_entry(name)));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes matrix to a NumPy .npy file. Column major matrices
+// are written in Fortran order.
+int nar_sm_write_npy(nar_sm mat, const char* filename) {
+    try {
+        NpyFile<float> f(filename, ios_base::out);
+        f.write_matrix(*mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Opens a text matrix file for reading a block of rows at a time.
+// If there's an error, puts error code in err: 1 if the file can't be
+// read, 2 if it's malformed and 3 for anything else, such as running
+// out of memory.
+nar_sm_reader nar_sm_reader_open(const char* filename, int* err) {
+    try {
+        nar_sm_reader reader = 
+            new MatrixReader<float>(filename, false);
+        if (err) *err = 0;
+        return reader;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+// Opens a binary matrix file for reading a block of rows at a time.
+// If there's an error, puts error code in err, as for
+// nar_sm_reader_open.
+nar_sm_reader nar_sm_reader_open_binary(const char* filename, int* err) {
+    try {
+        nar_sm_reader reader = 
+            new MatrixReader<float>(filename, true);
+        if (err) *err = 0;
+        return reader;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+void nar_sm_reader_close(nar_sm_reader reader) {
+    delete reader;
+}
+
+// Reads a matrix from a tiled file. If there's an error, puts error code in err.
+nar_sm nar_sm_read_tiled(const char* filename, int row_major, int* err) {
+    try {
+        TiledFile<float> f(filename, ios_base::in);
+        nar_sm mat = new Matrix<float>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes matrix to a file as tiles of tile_rows x tile_cols elements.
+// Tile sizes of 0 use the default of 256.
+int nar_sm_write_tiled(nar_sm mat, const char* filename, int tile_rows, int tile_cols) {
+    try {
+        TiledFile<float> f(filename, ios_base::out);
+        f.write_matrix(*mat, tile_rows, tile_cols);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Adds vector to archive under name, replacing any entry with that name.
+int nar_sv_archive_put(nar_archive archive, const char* name, nar_sv v) {
+    try {
+        archive->put(name, *v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads the named vector from archive.
+// If there's an error, puts error code in err.
+nar_sv nar_sv_archive_get(nar_archive archive, const char* name, int* err) {
+    try {
+        nar_sv v = new Vector<float>(
+            archive->get_vector<float>(name));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps the named vector from archive into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_sv nar_sv_archive_map(nar_archive archive, const char* name, enum nar_map_mode mode, int* err) {
+    try {
+        nar_sv v = new Vector<float>(
+            archive->map_vector<float>(name, (MapMode) mode));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Adds matrix to archive under name, replacing any entry with that name.
+int nar_sm_archive_put(nar_archive archive, const char* name, nar_sm mat) {
+    try {
+        archive->put(name, *mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads the named matrix from archive, in the order it was stored in.
+// If there's an error, puts error code in err.
+nar_sm nar_sm_archive_get(nar_archive archive, const char* name, int* err) {
+    try {
+        nar_sm mat = new Matrix<float>(
+            archive->get_matrix<float>(name));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps the named matrix from archive into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_sm nar_sm_archive_map(nar_archive archive, const char* name, enum nar_map_mode mode, int* err) {
+    try {
+        nar_sm mat = new Matrix<float>(
+            archive->map_matrix<float>(name, (MapMode) mode));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// BLAS level 1. Functions of two vectors return 1 if their lengths differ.
+
+// y += alpha x
+int nar_sv_axpy(float alpha, nar_sv x, nar_sv y) {
+    try {
+        axpy(alpha, *x, *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// Puts the dot product of x and y in result
+int nar_sv_dot(float* result, nar_sv x, nar_sv y) {
+    try {
+        *result = dot(*x, *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// x *= alpha
+void nar_sv_scal(float alpha, nar_sv x) {
+    scal(alpha, *x);
+}
+
+// Euclidean norm
+float nar_sv_nrm2(nar_sv x) {
+    return nrm2(*x);
+}
+
+// Sum of absolute values. Integer sums are unsigned 64 bit, so they only
+// wrap around past 2^64.
+float nar_sv_asum(nar_sv x) {
+    return asum(*x);
+}
+
+// C = alpha op(A) op(B) + beta C, where op is set by trans_a and trans_b.
+// C must not overlap A or B. Returns 1 if the dimensions don't match.
+int nar_sm_gemm(float alpha, nar_sm a, enum nar_transpose trans_a, nar_sm b, enum nar_transpose trans_b, float beta, nar_sm c) {
+    try {
+        gemm(alpha, *a, (Transpose) trans_a, *b, (Transpose) trans_b, beta, *c);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// y = alpha op(A) x + beta y, where op is set by trans.
+// y must not overlap A or x. Returns 1 if the dimensions don't match.
+int nar_sm_gemv(float alpha, nar_sm a, enum nar_transpose trans, nar_sv x, float beta, nar_sv y) {
+    try {
+        gemv(alpha, *a, (Transpose) trans, *x, beta, *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+
+// Routines for vectors and matrices of the given type
+// that don't depend on the index type
+
+void nar_dv_free(nar_dv v) {
+    delete v;
+}
+
+nar_dv nar_dv_copy(nar_dv v) {
+    return new Vector<double>(v->copy());
+}
+
+double* nar_dv_pointer(nar_dv v) {
+    return (double*) v->pointer();
+}
+
+// Fills out with the data pointer, dimensions and strides of v
+void nar_dv_describe(nar_dv v, struct nar_view* out) {
+    out->data = v->pointer();
+    out->n = v->get_n();
+    out->rows = v->get_n();
+    out->cols = 1;
+    out->inc = v->get_inc();
+    out->inc_row = v->get_inc();
+    out->inc_col = 0;
+    out->dtype = TypeCode<double>::value;
+}
+
+int nar_dv_eq(nar_dv v1, nar_dv v2) {
+    return (*v1) == (*v2);
+}
+
+int nar_dv_assign(nar_dv v1, nar_dv v2) {
+    try {
+        v1->assign(*v2);
+        return 0;
+    } catch (const std::out_of_range& e) {
+        return 1;
+    }
+}
+
+void nar_dm_free(nar_dm mat) {
+    delete mat;
+}
+
+nar_dm nar_dm_copy(nar_dm mat) {
+    return new Matrix<double>(mat->copy());
+}
+
+enum nar_order nar_dm_order(nar_dm mat) {
+    return (nar_order) mat->get_order();
+}
+
+double* nar_dm_pointer(nar_dm mat) {
+    return (double*) mat->pointer();
+}
+
+// Fills out with the data pointer, dimensions and strides of mat
+void nar_dm_describe(nar_dm mat, struct nar_view* out) {
+    out->data = mat->pointer();
+    out->n = mat->get_rows() * mat->get_cols();
+    out->rows = mat->get_rows();
+    out->cols = mat->get_cols();
+    out->inc = 0;
+    out->inc_row = mat->get_inc_row();
+    out->inc_col = mat->get_inc_col();
+    out->dtype = TypeCode<double>::value;
+}
+
+int nar_dm_eq(nar_dm mat1, nar_dm mat2) {
+    return (*mat1) == (*mat2);
+}
+
+int nar_dm_assign(nar_dm mat1, nar_dm mat2) {
+    try {
+        mat1->assign(*mat2);
+        return 0;
+    } catch (const std::out_of_range& e) {
+        return 1;
+    }
+}
+
+// Display strings
+char* nar_dm_display_string(nar_dm mat) {
+    return string_to_char(display_string(*mat));
+}
+
+char* nar_dv_display_string(nar_dv v) {
+    return string_to_char(display_string(*v));
+}
+
+// Main routines for vectors and matrices of the given type
+// with int sizes, indices and strides
+
+nar_dv nar_dv_alloc(int n) {
+    return new Vector<double>(n);
+}
+
+// Contents are unspecified until written
+nar_dv nar_dv_alloc_uninit(int n) {
+    return new Vector<double>(n, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_dv nar_dv_wrap(double* ptr, int n, int inc,
+    nar_release_fn release, void* ctx) {
+    return new Vector<double>(wrap_vector((double*) ptr, n, inc,
+        [release, ctx](double* p) { if (release) release(p, ctx); }));
+}
+
+int nar_dv_valid(nar_dv v, int i) {
+    return v->in_range(i);
+}
+
+nar_dv nar_dv_slice(nar_dv v, int start, int end) {
+    return new Vector<double>(v->slice(start, end));
+}
+
+int nar_dv_slice_safe(nar_dv* out, nar_dv v, int start, int end) {
+    try {
+        *out = new Vector<double>(v->slice<true>(start, end));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_dv_inc(nar_dv v) {
+    return v->get_inc();
+}
+
+int nar_dv_n(nar_dv v) {
+    return v->get_n();
+}
+
+// For matrices
+
+nar_dm nar_dm_alloc(int rows, int cols, int row_major) {
+    return new Matrix<double>(rows, cols, row_major);
+}
+
+// Contents are unspecified until written
+nar_dm nar_dm_alloc_uninit(int rows, int cols, int row_major) {
+    return new Matrix<double>(rows, cols, row_major, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_dm nar_dm_wrap(double* ptr, int rows, int cols,
+    int inc_row, int inc_col, nar_release_fn release, void* ctx) {
+    return new Matrix<double>(wrap_matrix((double*) ptr, rows, cols,
+        inc_row, inc_col,
+        [release, ctx](double* p) { if (release) release(p, ctx); }));
+}
+
+int nar_dm_valid(nar_dm mat, int i, int j) {
+    return mat->in_range(i,j);
+}
+
+// Slicing parts of matrix
+nar_dv nar_dm_row(nar_dm mat, int i) {
+    return new Vector<double>(mat->row(i));
+}
+
+nar_dv nar_dm_col(nar_dm mat, int j) {
+    return new Vector<double>(mat->col(j));
+}
+
+nar_dm nar_dm_subarray(nar_dm mat, int start_row,
+    int start_col, int end_row, int end_col) {
+    return new Matrix<double>(mat->subarray(
+        start_row, start_col, end_row, end_col));
+}
+
+int nar_dm_row_safe(nar_dv* x, nar_dm mat, int i) {
+    try {
+        *x = new Vector<double>(mat->row<true>(i));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_dm_col_safe(nar_dv* x, nar_dm mat, int j) {
+    try {
+        *x = new Vector<double>(mat->col<true>(j));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_dm_subarray_safe(nar_dm* x, nar_dm mat, int start_row,
+    int start_col, int end_row, int end_col) {
+    try {
+        *x = new Matrix<double>(mat->subarray<true>(
+            start_row, start_col, end_row, end_col));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_dm_get_ld(nar_dm mat) {
+    try {
+        return mat->get_ld();
+    } catch (...) {
+        return -1; // Not contiguously ordered
+    }
+}
+
+int nar_dm_inc_row(nar_dm mat) {
+    return mat->get_inc_row();
+}
+
+int nar_dm_inc_col(nar_dm mat) {
+    return mat->get_inc_col();
+}
+
+int nar_dm_get_rows(nar_dm mat) {
+    return mat->get_rows();
+}
+
+int nar_dm_get_cols(nar_dm mat) {
+    return mat->get_cols();
+}
+// No bounds checking
+double nar_dv_get(nar_dv v, int i) {
+    return (*v)[i];
+}
+
+void nar_dv_set(nar_dv v, int i, double x) {
+    (*v)[i] = x;
+}
+
+double nar_dm_get(nar_dm mat, int i, int j) {
+    return (*mat)(i,j);
+}
+
+void nar_dm_set(nar_dm mat, int i, int j, double x) {
+    (*mat)(i,j) = x;
+}
+
+// Bounds-checked versions
+int nar_dv_get_safe(double* x, nar_dv v, int i) {
+    try {
+        *x = v->at(i);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_dv_set_safe(nar_dv v, int i, double x) {
+    try {
+        v->at(i) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_dm_get_safe(double* x, nar_dm mat, int i, int j) {
+    try {
+        *x = mat->at(i,j);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_dm_set_safe(nar_dm mat, int i, int j, double x) {
+    try {
+        mat->at(i,j) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+// Batched element access through caller buffers.
+// These are bounds-checked and return 1 if anything is out of range.
+// Ranges with start > end are out of range; empty ones do nothing.
+
+// Copies elements [start, end) to out
+int nar_dv_get_range(double* out, nar_dv v,
+    int start, int end) {
+    try {
+        Vector<double> part = v->slice<true>(start, end);
+        strided_copy((double*) out, 1, 
+            part.pointer(), part.get_inc(), part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites elements [start, end) with the contents of in
+int nar_dv_set_range(nar_dv v, int start, int end,
+    double const* in) {
+    try {
+        Vector<double> part = v->slice<true>(start, end);
+        strided_copy(part.pointer(), part.get_inc(), 
+            (double const*) in, 1, part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at idx[0..count) to out
+int nar_dv_gather(double* out, nar_dv v,
+    const int* idx, int count) {
+    try {
+        v->gather<true>((double*) out, idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[0..count) to the elements at idx[0..count)
+int nar_dv_scatter(nar_dv v, const int* idx,
+    int count, double const* in) {
+    try {
+        v->scatter<true>(idx, count, (double const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies [start_row, end_row) x [start_col, end_col) to out,
+// which is packed in row major or column major order
+int nar_dm_get_block(double* out, nar_dm mat,
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major) {
+    try {
+        Matrix<double> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d((double*) out, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites [start_row, end_row) x [start_col, end_col) with in,
+// which is packed in row major or column major order
+int nar_dm_set_block(nar_dm mat,
+    int start_row, int start_col, int end_row, int end_col,
+    double const* in, int row_major) {
+    try {
+        Matrix<double> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d(part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            (double const*) in, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at (rows_idx[k], cols_idx[k]) to out[k]
+int nar_dm_gather(double* out, nar_dm mat,
+    const int* rows_idx, const int* cols_idx, int count) {
+    try {
+        mat->gather<true>((double*) out, rows_idx, cols_idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[k] to the elements at (rows_idx[k], cols_idx[k])
+int nar_dm_scatter(nar_dm mat, const int* rows_idx,
+    const int* cols_idx, int count, double const* in) {
+    try {
+        mat->scatter<true>(rows_idx, cols_idx, count, (double const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// binary matrix file without reading the rest of it.
+// If there's an error, puts error code in err.
+nar_dm nar_dm_read_binary_subarray(const char* filename, 
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major, int* err) {
+    try {
+        BinaryFile<double> f(filename, ios_base::in);
+        nar_dm mat = new Matrix<double>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// tiled matrix file, reading only the tiles they intersect.
+// If there's an error, puts error code in err.
+nar_dm nar_dm_read_tiled_subarray(const char* filename, 
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major, int* err) {
+    try {
+        TiledFile<double> f(filename, ios_base::in);
+        nar_dm mat = new Matrix<double>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Index of the first element of largest magnitude (|Re| + |Im| for
+// complex numbers), or -1 if x is empty. The first NaN counts as largest.
+int nar_dv_iamax(nar_dv x) {
+    return iamax(*x);
+}
+// Reads up to max_rows more rows, into a new view to free with
+// nar_dm_free. The view shares the reader's buffer, so the next
+// call overwrites its elements. Returns null at the end of the file, or
+// if there's an error, when it also puts the error code in err, as for
+// nar_dm_reader_open.
+nar_dm nar_dm_reader_next(nar_dm_reader reader, int max_rows, int* err) {
+    try {
+        const Matrix<double>& block = reader->next(
+            std::max<Index>(max_rows, 0));
+        if (err) *err = 0;
+        if (block.get_rows() == 0 && max_rows > 0) {
+            return nullptr;
+        }
+        return new Matrix<double>(block);
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+// Main routines for vectors and matrices of the given type
+// with int64_t sizes, indices and strides
+
+nar_dv nar_dv_alloc_64(int64_t n) {
+    return new Vector<double>(n);
+}
+
+// Contents are unspecified until written
+nar_dv nar_dv_alloc_uninit_64(int64_t n) {
+    return new Vector<double>(n, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_dv nar_dv_wrap_64(double* ptr, int64_t n, int64_t inc,
+    nar_release_fn release, void* ctx) {
+    return new Vector<double>(wrap_vector((double*) ptr, n, inc,
+        [release, ctx](double* p) { if (release) release(p, ctx); }));
+}
+
+int nar_dv_valid_64(nar_dv v, int64_t i) {
+    return v->in_range(i);
+}
+
+nar_dv nar_dv_slice_64(nar_dv v, int64_t start, int64_t end) {
+    return new Vector<double>(v->slice(start, end));
+}
+
+int nar_dv_slice_safe_64(nar_dv* out, nar_dv v, int64_t start, int64_t end) {
+    try {
+        *out = new Vector<double>(v->slice<true>(start, end));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int64_t nar_dv_inc_64(nar_dv v) {
+    return v->get_inc();
+}
+
+int64_t nar_dv_n_64(nar_dv v) {
+    return v->get_n();
+}
+
+// For matrices
+
+nar_dm nar_dm_alloc_64(int64_t rows, int64_t cols, int row_major) {
+    return new Matrix<double>(rows, cols, row_major);
+}
+
+// Contents are unspecified until written
+nar_dm nar_dm_alloc_uninit_64(int64_t rows, int64_t cols, int row_major) {
+    return new Matrix<double>(rows, cols, row_major, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_dm nar_dm_wrap_64(double* ptr, int64_t rows, int64_t cols,
+    int64_t inc_row, int64_t inc_col, nar_release_fn release, void* ctx) {
+    return new Matrix<double>(wrap_matrix((double*) ptr, rows, cols,
+        inc_row, inc_col,
+        [release, ctx](double* p) { if (release) release(p, ctx); }));
+}
+
+int nar_dm_valid_64(nar_dm mat, int64_t i, int64_t j) {
+    return mat->in_range(i,j);
+}
+
+// Slicing parts of matrix
+nar_dv nar_dm_row_64(nar_dm mat, int64_t i) {
+    return new Vector<double>(mat->row(i));
+}
+
+nar_dv nar_dm_col_64(nar_dm mat, int64_t j) {
+    return new Vector<double>(mat->col(j));
+}
+
+nar_dm nar_dm_subarray_64(nar_dm mat, int64_t start_row,
+    int64_t start_col, int64_t end_row, int64_t end_col) {
+    return new Matrix<double>(mat->subarray(
+        start_row, start_col, end_row, end_col));
+}
+
+int nar_dm_row_safe_64(nar_dv* x, nar_dm mat, int64_t i) {
+    try {
+        *x = new Vector<double>(mat->row<true>(i));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_dm_col_safe_64(nar_dv* x, nar_dm mat, int64_t j) {
+    try {
+        *x = new Vector<double>(mat->col<true>(j));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_dm_subarray_safe_64(nar_dm* x, nar_dm mat, int64_t start_row,
+    int64_t start_col, int64_t end_row, int64_t end_col) {
+    try {
+        *x = new Matrix<double>(mat->subarray<true>(
+            start_row, start_col, end_row, end_col));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int64_t nar_dm_get_ld_64(nar_dm mat) {
+    try {
+        return mat->get_ld();
+    } catch (...) {
+        return -1; // Not contiguously ordered
+    }
+}
+
+int64_t nar_dm_inc_row_64(nar_dm mat) {
+    return mat->get_inc_row();
+}
+
+int64_t nar_dm_inc_col_64(nar_dm mat) {
+    return mat->get_inc_col();
+}
+
+int64_t nar_dm_get_rows_64(nar_dm mat) {
+    return mat->get_rows();
+}
+
+int64_t nar_dm_get_cols_64(nar_dm mat) {
+    return mat->get_cols();
+}
+// No bounds checking
+double nar_dv_get_64(nar_dv v, int64_t i) {
+    return (*v)[i];
+}
+
+void nar_dv_set_64(nar_dv v, int64_t i, double x) {
+    (*v)[i] = x;
+}
+
+double nar_dm_get_64(nar_dm mat, int64_t i, int64_t j) {
+    return (*mat)(i,j);
+}
+
+void nar_dm_set_64(nar_dm mat, int64_t i, int64_t j, double x) {
+    (*mat)(i,j) = x;
+}
+
+// Bounds-checked versions
+int nar_dv_get_safe_64(double* x, nar_dv v, int64_t i) {
+    try {
+        *x = v->at(i);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_dv_set_safe_64(nar_dv v, int64_t i, double x) {
+    try {
+        v->at(i) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_dm_get_safe_64(double* x, nar_dm mat, int64_t i, int64_t j) {
+    try {
+        *x = mat->at(i,j);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_dm_set_safe_64(nar_dm mat, int64_t i, int64_t j, double x) {
+    try {
+        mat->at(i,j) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+// Batched element access through caller buffers.
+// These are bounds-checked and return 1 if anything is out of range.
+// Ranges with start > end are out of range; empty ones do nothing.
+
+// Copies elements [start, end) to out
+int nar_dv_get_range_64(double* out, nar_dv v,
+    int64_t start, int64_t end) {
+    try {
+        Vector<double> part = v->slice<true>(start, end);
+        strided_copy((double*) out, 1, 
+            part.pointer(), part.get_inc(), part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites elements [start, end) with the contents of in
+int nar_dv_set_range_64(nar_dv v, int64_t start, int64_t end,
+    double const* in) {
+    try {
+        Vector<double> part = v->slice<true>(start, end);
+        strided_copy(part.pointer(), part.get_inc(), 
+            (double const*) in, 1, part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at idx[0..count) to out
+int nar_dv_gather_64(double* out, nar_dv v,
+    const int64_t* idx, int64_t count) {
+    try {
+        v->gather<true>((double*) out, idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[0..count) to the elements at idx[0..count)
+int nar_dv_scatter_64(nar_dv v, const int64_t* idx,
+    int64_t count, double const* in) {
+    try {
+        v->scatter<true>(idx, count, (double const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies [start_row, end_row) x [start_col, end_col) to out,
+// which is packed in row major or column major order
+int nar_dm_get_block_64(double* out, nar_dm mat,
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major) {
+    try {
+        Matrix<double> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d((double*) out, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites [start_row, end_row) x [start_col, end_col) with in,
+// which is packed in row major or column major order
+int nar_dm_set_block_64(nar_dm mat,
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    double const* in, int row_major) {
+    try {
+        Matrix<double> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d(part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            (double const*) in, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at (rows_idx[k], cols_idx[k]) to out[k]
+int nar_dm_gather_64(double* out, nar_dm mat,
+    const int64_t* rows_idx, const int64_t* cols_idx, int64_t count) {
+    try {
+        mat->gather<true>((double*) out, rows_idx, cols_idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[k] to the elements at (rows_idx[k], cols_idx[k])
+int nar_dm_scatter_64(nar_dm mat, const int64_t* rows_idx,
+    const int64_t* cols_idx, int64_t count, double const* in) {
+    try {
+        mat->scatter<true>(rows_idx, cols_idx, count, (double const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// binary matrix file without reading the rest of it.
+// If there's an error, puts error code in err.
+nar_dm nar_dm_read_binary_subarray_64(const char* filename, 
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major, int* err) {
+    try {
+        BinaryFile<double> f(filename, ios_base::in);
+        nar_dm mat = new Matrix<double>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// tiled matrix file, reading only the tiles they intersect.
+// If there's an error, puts error code in err.
+nar_dm nar_dm_read_tiled_subarray_64(const char* filename, 
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major, int* err) {
+    try {
+        TiledFile<double> f(filename, ios_base::in);
+        nar_dm mat = new Matrix<double>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Index of the first element of largest magnitude (|Re| + |Im| for
+// complex numbers), or -1 if x is empty. The first NaN counts as largest.
+int64_t nar_dv_iamax_64(nar_dv x) {
+    return iamax(*x);
+}
+// Reads up to max_rows more rows, into a new view to free with
+// nar_dm_free. The view shares the reader's buffer, so the next
+// call overwrites its elements. Returns null at the end of the file, or
+// if there's an error, when it also puts the error code in err, as for
+// nar_dm_reader_open.
+nar_dm nar_dm_reader_next_64(nar_dm_reader reader, int64_t max_rows, int* err) {
+    try {
+        const Matrix<double>& block = reader->next(
+            std::max<Index>(max_rows, 0));
+        if (err) *err = 0;
+        if (block.get_rows() == 0 && max_rows > 0) {
+            return nullptr;
+        }
+        return new Matrix<double>(block);
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+// Reads vector from file. If there's an error, puts error code in err.
+nar_dv nar_dv_read(const char* filename, int* err) {
+    try {
+        File<double> f(filename, ios_base::in);
+        nar_dv v = new Vector<double>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to file.
+int nar_dv_write(nar_dv v, const char* filename, const char* sep) {
+    try {
+        File<double> f(filename, ios_base::out);
+        f.write_vector(*v, sep);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads MATRIX from file. If there's an error, puts error code in err.
+nar_dm nar_dm_read(const char* filename, int row_major, int* err) {
+    try {
+        File<double> f(filename, ios_base::in);
+        nar_dm v = new Matrix<double>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes MATRIX to file.
+int nar_dm_write(nar_dm v, const char* filename, const char* sep) {
+    try {
+        File<double> f(filename, ios_base::out);
+        f.write_matrix(*v, sep);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+
+// Reads vector from file into dest, reusing its memory. The file must
+// hold a vector of dest's length. Returns the error code.
+int nar_dv_read_into(nar_dv dest, const char* filename) {
+    try {
+        File<double> f(filename, ios_base::in);
+        f.read_vector_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Reads matrix from file into dest, reusing its memory. The file must
+// hold a matrix of dest's dimensions. Returns the error code.
+int nar_dm_read_into(nar_dm dest, const char* filename) {
+    try {
+        File<double> f(filename, ios_base::in);
+        f.read_matrix_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Starts reading vector from file on the I/O threads.
+// nar_future_wait returns the vector and error code.
+nar_future nar_dv_read_async(const char* filename) {
+    std::string name(filename);
+    return start_async([name]() {
+        int err;
+        void* v = nar_dv_read(name.c_str(), &err);
+        return Future::Result(v, err);
+    });
+}
+
+// Starts writing vector to file on the I/O threads. v mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_dv_write_async(nar_dv v, const char* filename, const char* sep) {
+    std::string name(filename);
+    std::string separator(sep);
+    return start_async([=]() {
+        int status = nar_dv_write(v, name.c_str(), separator.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Starts reading matrix from file on the I/O threads.
+// nar_future_wait returns the matrix and error code.
+nar_future nar_dm_read_async(const char* filename, int row_major) {
+    std::string name(filename);
+    return start_async([name, row_major]() {
+        int err;
+        void* mat = nar_dm_read(name.c_str(), row_major, &err);
+        return Future::Result(mat, err);
+    });
+}
+
+// Starts writing matrix to file on the I/O threads. mat mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_dm_write_async(nar_dm mat, const char* filename, const char* sep) {
+    std::string name(filename);
+    std::string separator(sep);
+    return start_async([=]() {
+        int status = nar_dm_write(mat, name.c_str(), separator.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Writes vector to file with precision significant digits for floating
+// point values, or NAR_PRECISION_SHORTEST for the fewest that read back
+// exactly.
+int nar_dv_write_precision(nar_dv v, const char* filename, const char* sep, int precision) {
+    try {
+        File<double> f(filename, ios_base::out);
+        f.write_vector(*v, sep, precision);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Writes matrix to file with precision significant digits for floating
+// point values, or NAR_PRECISION_SHORTEST for the fewest that read back
+// exactly.
+int nar_dm_write_precision(nar_dm v, const char* filename, const char* sep, int precision) {
+    try {
+        File<double> f(filename, ios_base::out);
+        f.write_matrix(*v, sep, precision);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+
+// Reads vector from file. If there's an error, puts error code in err.
+nar_dv nar_dv_read_binary(const char* filename, int* err) {
+    try {
+        BinaryFile<double> f(filename, ios_base::in);
+        nar_dv v = new Vector<double>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to file.
+int nar_dv_write_binary(nar_dv v, const char* filename) {
+    try {
+        BinaryFile<double> f(filename, ios_base::out);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads MATRIX from file. If there's an error, puts error code in err.
+nar_dm nar_dm_read_binary(const char* filename, int row_major, int* err) {
+    try {
+        BinaryFile<double> f(filename, ios_base::in);
+        nar_dm v = new Matrix<double>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes MATRIX to file.
+int nar_dm_write_binary(nar_dm v, const char* filename) {
+    try {
+        BinaryFile<double> f(filename, ios_base::out);
+        f.write_matrix(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+
+// Reads vector from file into dest, reusing its memory. The file must
+// hold a vector of dest's length. Returns the error code.
+int nar_dv_read_binary_into(nar_dv dest, const char* filename) {
+    try {
+        BinaryFile<double> f(filename, ios_base::in);
+        f.read_vector_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Reads matrix from file into dest, reusing its memory. The file must
+// hold a matrix of dest's dimensions. Returns the error code.
+int nar_dm_read_binary_into(nar_dm dest, const char* filename) {
+    try {
+        BinaryFile<double> f(filename, ios_base::in);
+        f.read_matrix_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Starts reading vector from file on the I/O threads.
+// nar_future_wait returns the vector and error code.
+nar_future nar_dv_read_binary_async(const char* filename) {
+    std::string name(filename);
+    return start_async([name]() {
+        int err;
+        void* v = nar_dv_read_binary(name.c_str(), &err);
+        return Future::Result(v, err);
+    });
+}
+
+// Starts writing vector to file on the I/O threads. v mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_dv_write_binary_async(nar_dv v, const char* filename) {
+    std::string name(filename);
+    return start_async([=]() {
+        int status = nar_dv_write_binary(v, name.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Starts reading matrix from file on the I/O threads.
+// nar_future_wait returns the matrix and error code.
+nar_future nar_dm_read_binary_async(const char* filename, int row_major) {
+    std::string name(filename);
+    return start_async([name, row_major]() {
+        int err;
+        void* mat = nar_dm_read_binary(name.c_str(), row_major, &err);
+        return Future::Result(mat, err);
+    });
+}
+
+// Starts writing matrix to file on the I/O threads. mat mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_dm_write_binary_async(nar_dm mat, const char* filename) {
+    std::string name(filename);
+    return start_async([=]() {
+        int status = nar_dm_write_binary(mat, name.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Maps a binary file written by nar_dv_write_binary into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_dv nar_dv_mmap(const char* filename, enum nar_map_mode mode, int* err) {
+    try {
+        BinaryFile<double> f(filename, ios_base::in);
+        nar_dv v = new Vector<double>(f.map_vector((MapMode) mode));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps a binary file written by nar_dm_write_binary into memory.
+// The matrix has the order it was stored in, so column major matrices
+// map as column major. The file stays mapped until the last view of it
+// is freed. If there's an error, puts error code in err.
+nar_dm nar_dm_mmap(const char* filename, enum nar_map_mode mode, int* err) {
+    try {
+        BinaryFile<double> f(filename, ios_base::in);
+        nar_dm mat = new Matrix<double>(f.map_matrix((MapMode) mode));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to a binary file, compressed in chunks.
+// nar_dv_read_binary reads it back.
+int nar_dv_write_binary_compressed(nar_dv v, const char* filename) {
+    try {
+        BinaryFile<double> f(filename, ios_base::out);
+        f.set_compressed(true);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Writes matrix to a binary file, compressed in chunks.
+// nar_dm_read_binary reads it back.
+int nar_dm_write_binary_compressed(nar_dm mat, const char* filename) {
+    try {
+        BinaryFile<double> f(filename, ios_base::out);
+        f.set_compressed(true);
+        f.write_matrix(*mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads a 1D array from a NumPy .npy file.
+// If there's an error, puts error code in err.
+nar_dv nar_dv_read_npy(const char* filename, int* err) {
+    try {
+        NpyFile<double> f(filename, ios_base::in);
+        nar_dv v = new Vector<double>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads the named 1D array from an uncompressed NumPy .npz archive.
+// If there's an error, puts error code in err.
+nar_dv nar_dv_read_npz(const char* filename, const char* name, int* err) {
+    try {
+        NpyFile<double> f(filename, ios_base::in);
+        nar_dv v = new Vector<double>(
+            f.read_vector(f.find_entry(name)));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to a NumPy .npy file.
+int nar_dv_write_npy(nar_dv v, const char* filename) {
+    try {
+        NpyFile<double> f(filename, ios_base::out);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads a 2D array from a NumPy .npy file. Fortran order arrays become
+// column major matrices. If there's an error, puts error code in err.
+nar_dm nar_dm_read_npy(const char* filename, int* err) {
+    try {
+        NpyFile<double> f(filename, ios_base::in);
+        nar_dm mat = new Matrix<double>(f.read_matrix());
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads the named 2D array from an uncompressed NumPy .npz archive.
+// If there's an error, puts error code in err.
+nar_dm nar_dm_read_npz(const char* filename, const char* name, int* err) {
+    try {
+        NpyFile<double> f(filename, ios_base::in);
+        nar_dm mat = new Matrix<double>(
+            f.read_matrix(f.find_entry(name)));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes matrix to a NumPy .npy file. Column major matrices
+// are written in Fortran order.
+int nar_dm_write_npy(nar_dm mat, const char* filename) {
+    try {
+        NpyFile<double> f(filename, ios_base::out);
+        f.write_matrix(*mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Opens a text matrix file for reading a block of rows at a time.
+// If there's an error, puts error code in err: 1 if the file can't be
+// read, 2 if it's malformed and 3 for anything else, such as running
+// out of memory.
+nar_dm_reader nar_dm_reader_open(const char* filename, int* err) {
+    try {
+        nar_dm_reader reader = 
+            new MatrixReader<double>(filename, false);
+        if (err) *err = 0;
+        return reader;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+// Opens a binary matrix file for reading a block of rows at a time.
+// If there's an error, puts error code in err, as for
+// nar_dm_reader_open.
+nar_dm_reader nar_dm_reader_open_binary(const char* filename, int* err) {
+    try {
+        nar_dm_reader reader = 
+            new MatrixReader<double>(filename, true);
+        if (err) *err = 0;
+        return reader;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+void nar_dm_reader_close(nar_dm_reader reader) {
+    delete reader;
+}
+
+// Reads a matrix from a tiled file. If there's an error, puts error code in err.
+nar_dm nar_dm_read_tiled(const char* filename, int row_major, int* err) {
+    try {
+        TiledFile<double> f(filename, ios_base::in);
+        nar_dm mat = new Matrix<double>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes matrix to a file as tiles of tile_rows x tile_cols elements.
+// Tile sizes of 0 use the default of 256.
+int nar_dm_write_tiled(nar_dm mat, const char* filename, int tile_rows, int tile_cols) {
+    try {
+        TiledFile<double> f(filename, ios_base::out);
+        f.write_matrix(*mat, tile_rows, tile_cols);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Adds vector to archive under name, replacing any entry with that name.
+int nar_dv_archive_put(nar_archive archive, const char* name, nar_dv v) {
+    try {
+        archive->put(name, *v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads the named vector from archive.
+// If there's an error, puts error code in err.
+nar_dv nar_dv_archive_get(nar_archive archive, const char* name, int* err) {
+    try {
+        nar_dv v = new Vector<double>(
+            archive->get_vector<double>(name));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps the named vector from archive into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_dv nar_dv_archive_map(nar_archive archive, const char* name, enum nar_map_mode mode, int* err) {
+    try {
+        nar_dv v = new Vector<double>(
+            archive->map_vector<double>(name, (MapMode) mode));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Adds matrix to archive under name, replacing any entry with that name.
+int nar_dm_archive_put(nar_archive archive, const char* name, nar_dm mat) {
+    try {
+        archive->put(name, *mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads the named matrix from archive, in the order it was stored in.
+// If there's an error, puts error code in err.
+nar_dm nar_dm_archive_get(nar_archive archive, const char* name, int* err) {
+    try {
+        nar_dm mat = new Matrix<double>(
+            archive->get_matrix<double>(name));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps the named matrix from archive into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_dm nar_dm_archive_map(nar_archive archive, const char* name, enum nar_map_mode mode, int* err) {
+    try {
+        nar_dm mat = new Matrix<double>(
+            archive->map_matrix<double>(name, (MapMode) mode));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// BLAS level 1. Functions of two vectors return 1 if their lengths differ.
+
+// y += alpha x
+int nar_dv_axpy(double alpha, nar_dv x, nar_dv y) {
+    try {
+        axpy(alpha, *x, *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// Puts the dot product of x and y in result
+int nar_dv_dot(double* result, nar_dv x, nar_dv y) {
+    try {
+        *result = dot(*x, *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// x *= alpha
+void nar_dv_scal(double alpha, nar_dv x) {
+    scal(alpha, *x);
+}
+
+// Euclidean norm
+double nar_dv_nrm2(nar_dv x) {
+    return nrm2(*x);
+}
+
+// Sum of absolute values. Integer sums are unsigned 64 bit, so they only
+// wrap around past 2^64.
+double nar_dv_asum(nar_dv x) {
+    return asum(*x);
+}
+
+// C = alpha op(A) op(B) + beta C, where op is set by trans_a and trans_b.
+// C must not overlap A or B. Returns 1 if the dimensions don't match.
+int nar_dm_gemm(double alpha, nar_dm a, enum nar_transpose trans_a, nar_dm b, enum nar_transpose trans_b, double beta, nar_dm c) {
+    try {
+        gemm(alpha, *a, (Transpose) trans_a, *b, (Transpose) trans_b, beta, *c);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// y = alpha op(A) x + beta y, where op is set by trans.
+// y must not overlap A or x. Returns 1 if the dimensions don't match.
+int nar_dm_gemv(double alpha, nar_dm a, enum nar_transpose trans, nar_dv x, double beta, nar_dv y) {
+    try {
+        gemv(alpha, *a, (Transpose) trans, *x, beta, *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+
+// Routines for vectors and matrices of the given type
+// that don't depend on the index type
+
+void nar_cv_free(nar_cv v) {
+    delete v;
+}
+
+nar_cv nar_cv_copy(nar_cv v) {
+    return new Vector<std::complex<float>>(v->copy());
+}
+
+float* nar_cv_pointer(nar_cv v) {
+    return (float*) v->pointer();
+}
+
+// Fills out with the data pointer, dimensions and strides of v
+void nar_cv_describe(nar_cv v, struct nar_view* out) {
+    out->data = v->pointer();
+    out->n = v->get_n();
+    out->rows = v->get_n();
+    out->cols = 1;
+    out->inc = v->get_inc();
+    out->inc_row = v->get_inc();
+    out->inc_col = 0;
+    out->dtype = TypeCode<std::complex<float>>::value;
+}
+
+int nar_cv_eq(nar_cv v1, nar_cv v2) {
+    return (*v1) == (*v2);
+}
+
+int nar_cv_assign(nar_cv v1, nar_cv v2) {
+    try {
+        v1->assign(*v2);
+        return 0;
+    } catch (const std::out_of_range& e) {
+        return 1;
+    }
+}
+
+void nar_cm_free(nar_cm mat) {
+    delete mat;
+}
+
+nar_cm nar_cm_copy(nar_cm mat) {
+    return new Matrix<std::complex<float>>(mat->copy());
+}
+
+enum nar_order nar_cm_order(nar_cm mat) {
+    return (nar_order) mat->get_order();
+}
+
+float* nar_cm_pointer(nar_cm mat) {
+    return (float*) mat->pointer();
+}
+
+// Fills out with the data pointer, dimensions and strides of mat
+void nar_cm_describe(nar_cm mat, struct nar_view* out) {
+    out->data = mat->pointer();
+    out->n = mat->get_rows() * mat->get_cols();
+    out->rows = mat->get_rows();
+    out->cols = mat->get_cols();
+    out->inc = 0;
+    out->inc_row = mat->get_inc_row();
+    out->inc_col = mat->get_inc_col();
+    out->dtype = TypeCode<std::complex<float>>::value;
+}
+
+int nar_cm_eq(nar_cm mat1, nar_cm mat2) {
+    return (*mat1) == (*mat2);
+}
+
+int nar_cm_assign(nar_cm mat1, nar_cm mat2) {
+    try {
+        mat1->assign(*mat2);
+        return 0;
+    } catch (const std::out_of_range& e) {
+        return 1;
+    }
+}
+
+// Display strings
+char* nar_cm_display_string(nar_cm mat) {
+    return string_to_char(display_string(*mat));
+}
+
+char* nar_cv_display_string(nar_cv v) {
+    return string_to_char(display_string(*v));
+}
+
+// Main routines for vectors and matrices of the given type
+// with int sizes, indices and strides
+
+nar_cv nar_cv_alloc(int n) {
+    return new Vector<std::complex<float>>(n);
+}
+
+// Contents are unspecified until written
+nar_cv nar_cv_alloc_uninit(int n) {
+    return new Vector<std::complex<float>>(n, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_cv nar_cv_wrap(float* ptr, int n, int inc,
+    nar_release_fn release, void* ctx) {
+    return new Vector<std::complex<float>>(wrap_vector((std::complex<float>*) ptr, n, inc,
+        [release, ctx](std::complex<float>* p) { if (release) release(p, ctx); }));
+}
+
+int nar_cv_valid(nar_cv v, int i) {
+    return v->in_range(i);
+}
+
+nar_cv nar_cv_slice(nar_cv v, int start, int end) {
+    return new Vector<std::complex<float>>(v->slice(start, end));
+}
+
+int nar_cv_slice_safe(nar_cv* out, nar_cv v, int start, int end) {
+    try {
+        *out = new Vector<std::complex<float>>(v->slice<true>(start, end));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_cv_inc(nar_cv v) {
+    return v->get_inc();
+}
+
+int nar_cv_n(nar_cv v) {
+    return v->get_n();
+}
+
+// For matrices
+
+nar_cm nar_cm_alloc(int rows, int cols, int row_major) {
+    return new Matrix<std::complex<float>>(rows, cols, row_major);
+}
+
+// Contents are unspecified until written
+nar_cm nar_cm_alloc_uninit(int rows, int cols, int row_major) {
+    return new Matrix<std::complex<float>>(rows, cols, row_major, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_cm nar_cm_wrap(float* ptr, int rows, int cols,
+    int inc_row, int inc_col, nar_release_fn release, void* ctx) {
+    return new Matrix<std::complex<float>>(wrap_matrix((std::complex<float>*) ptr, rows, cols,
+        inc_row, inc_col,
+        [release, ctx](std::complex<float>* p) { if (release) release(p, ctx); }));
+}
+
+int nar_cm_valid(nar_cm mat, int i, int j) {
+    return mat->in_range(i,j);
+}
+
+// Slicing parts of matrix
+nar_cv nar_cm_row(nar_cm mat, int i) {
+    return new Vector<std::complex<float>>(mat->row(i));
+}
+
+nar_cv nar_cm_col(nar_cm mat, int j) {
+    return new Vector<std::complex<float>>(mat->col(j));
+}
+
+nar_cm nar_cm_subarray(nar_cm mat, int start_row,
+    int start_col, int end_row, int end_col) {
+    return new Matrix<std::complex<float>>(mat->subarray(
+        start_row, start_col, end_row, end_col));
+}
+
+int nar_cm_row_safe(nar_cv* x, nar_cm mat, int i) {
+    try {
+        *x = new Vector<std::complex<float>>(mat->row<true>(i));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_cm_col_safe(nar_cv* x, nar_cm mat, int j) {
+    try {
+        *x = new Vector<std::complex<float>>(mat->col<true>(j));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_cm_subarray_safe(nar_cm* x, nar_cm mat, int start_row,
+    int start_col, int end_row, int end_col) {
+    try {
+        *x = new Matrix<std::complex<float>>(mat->subarray<true>(
+            start_row, start_col, end_row, end_col));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_cm_get_ld(nar_cm mat) {
+    try {
+        return mat->get_ld();
+    } catch (...) {
+        return -1; // Not contiguously ordered
+    }
+}
+
+int nar_cm_inc_row(nar_cm mat) {
+    return mat->get_inc_row();
+}
+
+int nar_cm_inc_col(nar_cm mat) {
+    return mat->get_inc_col();
+}
+
+int nar_cm_get_rows(nar_cm mat) {
+    return mat->get_rows();
+}
+
+int nar_cm_get_cols(nar_cm mat) {
+    return mat->get_cols();
+}
+// No bounds checking
+// For complex numbers in the form a + bI
+void nar_cv_get(float* a, float* b, nar_cv v, int i) {
+    std::complex<float> z = (*v)[i];
+    *a = z.real();
+    *b = z.imag();
+}
+
+void nar_cv_set(nar_cv v, int i, float a, float b) {
+    (*v)[i] = std::complex<float>(a,b);
+}
+
+void nar_cm_get(float* a, float* b, nar_cm mat, int i, int j) {
+    std::complex<float> z = (*mat)(i,j);
+    *a = z.real();
+    *b = z.imag();
+}
+
+void nar_cm_set(nar_cm mat, int i, int j, float a, float b) {
+    mat->operator()(i,j) = std::complex<float>(a,b);
+}
+
+// Bounds-checked versions
+int nar_cv_get_safe(float* a, float* b, nar_cv v, int i) {
+    try {
+        std::complex<float> z = v->at(i);
+        *a = z.real();
+        *b = z.imag();
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_cv_set_safe(nar_cv v, int i, float a, float b) {
+    try {
+        v->at(i) = std::complex<float>(a,b);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_cm_get_safe(float* a, float* b, nar_cm mat, int i, int j) {
+    try {
+        std::complex<float> z = mat->at(i,j);
+        *a = z.real();
+        *b = z.imag();
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_cm_set_safe(nar_cm mat, int i, int j, float a, float b) {
+    try {
+        mat->at(i,j) = std::complex<float>(a,b);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+// Batched element access through caller buffers.
+// These are bounds-checked and return 1 if anything is out of range.
+// Ranges with start > end are out of range; empty ones do nothing.
+
+// Copies elements [start, end) to out
+int nar_cv_get_range(float* out, nar_cv v,
+    int start, int end) {
+    try {
+        Vector<std::complex<float>> part = v->slice<true>(start, end);
+        strided_copy((std::complex<float>*) out, 1, 
+            part.pointer(), part.get_inc(), part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites elements [start, end) with the contents of in
+int nar_cv_set_range(nar_cv v, int start, int end,
+    float const* in) {
+    try {
+        Vector<std::complex<float>> part = v->slice<true>(start, end);
+        strided_copy(part.pointer(), part.get_inc(), 
+            (std::complex<float> const*) in, 1, part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at idx[0..count) to out
+int nar_cv_gather(float* out, nar_cv v,
+    const int* idx, int count) {
+    try {
+        v->gather<true>((std::complex<float>*) out, idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[0..count) to the elements at idx[0..count)
+int nar_cv_scatter(nar_cv v, const int* idx,
+    int count, float const* in) {
+    try {
+        v->scatter<true>(idx, count, (std::complex<float> const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies [start_row, end_row) x [start_col, end_col) to out,
+// which is packed in row major or column major order
+int nar_cm_get_block(float* out, nar_cm mat,
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major) {
+    try {
+        Matrix<std::complex<float>> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d((std::complex<float>*) out, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites [start_row, end_row) x [start_col, end_col) with in,
+// which is packed in row major or column major order
+int nar_cm_set_block(nar_cm mat,
+    int start_row, int start_col, int end_row, int end_col,
+    float const* in, int row_major) {
+    try {
+        Matrix<std::complex<float>> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d(part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            (std::complex<float> const*) in, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at (rows_idx[k], cols_idx[k]) to out[k]
+int nar_cm_gather(float* out, nar_cm mat,
+    const int* rows_idx, const int* cols_idx, int count) {
+    try {
+        mat->gather<true>((std::complex<float>*) out, rows_idx, cols_idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[k] to the elements at (rows_idx[k], cols_idx[k])
+int nar_cm_scatter(nar_cm mat, const int* rows_idx,
+    const int* cols_idx, int count, float const* in) {
+    try {
+        mat->scatter<true>(rows_idx, cols_idx, count, (std::complex<float> const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// binary matrix file without reading the rest of it.
+// If there's an error, puts error code in err.
+nar_cm nar_cm_read_binary_subarray(const char* filename, 
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major, int* err) {
+    try {
+        BinaryFile<std::complex<float>> f(filename, ios_base::in);
+        nar_cm mat = new Matrix<std::complex<float>>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// tiled matrix file, reading only the tiles they intersect.
+// If there's an error, puts error code in err.
+nar_cm nar_cm_read_tiled_subarray(const char* filename, 
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major, int* err) {
+    try {
+        TiledFile<std::complex<float>> f(filename, ios_base::in);
+        nar_cm mat = new Matrix<std::complex<float>>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Index of the first element of largest magnitude (|Re| + |Im| for
+// complex numbers), or -1 if x is empty. The first NaN counts as largest.
+int nar_cv_iamax(nar_cv x) {
+    return iamax(*x);
+}
+// Reads up to max_rows more rows, into a new view to free with
+// nar_cm_free. The view shares the reader's buffer, so the next
+// call overwrites its elements. Returns null at the end of the file, or
+// if there's an error, when it also puts the error code in err, as for
+// nar_cm_reader_open.
+nar_cm nar_cm_reader_next(nar_cm_reader reader, int max_rows, int* err) {
+    try {
+        const Matrix<std::complex<float>>& block = reader->next(
+            std::max<Index>(max_rows, 0));
+        if (err) *err = 0;
+        if (block.get_rows() == 0 && max_rows > 0) {
+            return nullptr;
+        }
+        return new Matrix<std::complex<float>>(block);
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+// Main routines for vectors and matrices of the given type
+// with int64_t sizes, indices and strides
+
+nar_cv nar_cv_alloc_64(int64_t n) {
+    return new Vector<std::complex<float>>(n);
+}
+
+// Contents are unspecified until written
+nar_cv nar_cv_alloc_uninit_64(int64_t n) {
+    return new Vector<std::complex<float>>(n, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_cv nar_cv_wrap_64(float* ptr, int64_t n, int64_t inc,
+    nar_release_fn release, void* ctx) {
+    return new Vector<std::complex<float>>(wrap_vector((std::complex<float>*) ptr, n, inc,
+        [release, ctx](std::complex<float>* p) { if (release) release(p, ctx); }));
+}
+
+int nar_cv_valid_64(nar_cv v, int64_t i) {
+    return v->in_range(i);
+}
+
+nar_cv nar_cv_slice_64(nar_cv v, int64_t start, int64_t end) {
+    return new Vector<std::complex<float>>(v->slice(start, end));
+}
+
+int nar_cv_slice_safe_64(nar_cv* out, nar_cv v, int64_t start, int64_t end) {
+    try {
+        *out = new Vector<std::complex<float>>(v->slice<true>(start, end));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int64_t nar_cv_inc_64(nar_cv v) {
+    return v->get_inc();
+}
+
+int64_t nar_cv_n_64(nar_cv v) {
+    return v->get_n();
+}
+
+// For matrices
+
+nar_cm nar_cm_alloc_64(int64_t rows, int64_t cols, int row_major) {
+    return new Matrix<std::complex<float>>(rows, cols, row_major);
+}
+
+// Contents are unspecified until written
+nar_cm nar_cm_alloc_uninit_64(int64_t rows, int64_t cols, int row_major) {
+    return new Matrix<std::complex<float>>(rows, cols, row_major, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_cm nar_cm_wrap_64(float* ptr, int64_t rows, int64_t cols,
+    int64_t inc_row, int64_t inc_col, nar_release_fn release, void* ctx) {
+    return new Matrix<std::complex<float>>(wrap_matrix((std::complex<float>*) ptr, rows, cols,
+        inc_row, inc_col,
+        [release, ctx](std::complex<float>* p) { if (release) release(p, ctx); }));
+}
+
+int nar_cm_valid_64(nar_cm mat, int64_t i, int64_t j) {
+    return mat->in_range(i,j);
+}
+
+// Slicing parts of matrix
+nar_cv nar_cm_row_64(nar_cm mat, int64_t i) {
+    return new Vector<std::complex<float>>(mat->row(i));
+}
+
+nar_cv nar_cm_col_64(nar_cm mat, int64_t j) {
+    return new Vector<std::complex<float>>(mat->col(j));
+}
+
+nar_cm nar_cm_subarray_64(nar_cm mat, int64_t start_row,
+    int64_t start_col, int64_t end_row, int64_t end_col) {
+    return new Matrix<std::complex<float>>(mat->subarray(
+        start_row, start_col, end_row, end_col));
+}
+
+int nar_cm_row_safe_64(nar_cv* x, nar_cm mat, int64_t i) {
+    try {
+        *x = new Vector<std::complex<float>>(mat->row<true>(i));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_cm_col_safe_64(nar_cv* x, nar_cm mat, int64_t j) {
+    try {
+        *x = new Vector<std::complex<float>>(mat->col<true>(j));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_cm_subarray_safe_64(nar_cm* x, nar_cm mat, int64_t start_row,
+    int64_t start_col, int64_t end_row, int64_t end_col) {
+    try {
+        *x = new Matrix<std::complex<float>>(mat->subarray<true>(
+            start_row, start_col, end_row, end_col));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int64_t nar_cm_get_ld_64(nar_cm mat) {
+    try {
+        return mat->get_ld();
+    } catch (...) {
+        return -1; // Not contiguously ordered
+    }
+}
+
+int64_t nar_cm_inc_row_64(nar_cm mat) {
+    return mat->get_inc_row();
+}
+
+int64_t nar_cm_inc_col_64(nar_cm mat) {
+    return mat->get_inc_col();
+}
+
+int64_t nar_cm_get_rows_64(nar_cm mat) {
+    return mat->get_rows();
+}
+
+int64_t nar_cm_get_cols_64(nar_cm mat) {
+    return mat->get_cols();
+}
+// No bounds checking
+// For complex numbers in the form a + bI
+void nar_cv_get_64(float* a, float* b, nar_cv v, int64_t i) {
+    std::complex<float> z = (*v)[i];
+    *a = z.real();
+    *b = z.imag();
+}
+
+void nar_cv_set_64(nar_cv v, int64_t i, float a, float b) {
+    (*v)[i] = std::complex<float>(a,b);
+}
+
+void nar_cm_get_64(float* a, float* b, nar_cm mat, int64_t i, int64_t j) {
+    std::complex<float> z = (*mat)(i,j);
+    *a = z.real();
+    *b = z.imag();
+}
+
+void nar_cm_set_64(nar_cm mat, int64_t i, int64_t j, float a, float b) {
+    mat->operator()(i,j) = std::complex<float>(a,b);
+}
+
+// Bounds-checked versions
+int nar_cv_get_safe_64(float* a, float* b, nar_cv v, int64_t i) {
+    try {
+        std::complex<float> z = v->at(i);
+        *a = z.real();
+        *b = z.imag();
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_cv_set_safe_64(nar_cv v, int64_t i, float a, float b) {
+    try {
+        v->at(i) = std::complex<float>(a,b);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_cm_get_safe_64(float* a, float* b, nar_cm mat, int64_t i, int64_t j) {
+    try {
+        std::complex<float> z = mat->at(i,j);
+        *a = z.real();
+        *b = z.imag();
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_cm_set_safe_64(nar_cm mat, int64_t i, int64_t j, float a, float b) {
+    try {
+        mat->at(i,j) = std::complex<float>(a,b);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+// Batched element access through caller buffers.
+// These are bounds-checked and return 1 if anything is out of range.
+// Ranges with start > end are out of range; empty ones do nothing.
+
+// Copies elements [start, end) to out
+int nar_cv_get_range_64(float* out, nar_cv v,
+    int64_t start, int64_t end) {
+    try {
+        Vector<std::complex<float>> part = v->slice<true>(start, end);
+        strided_copy((std::complex<float>*) out, 1, 
+            part.pointer(), part.get_inc(), part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites elements [start, end) with the contents of in
+int nar_cv_set_range_64(nar_cv v, int64_t start, int64_t end,
+    float const* in) {
+    try {
+        Vector<std::complex<float>> part = v->slice<true>(start, end);
+        strided_copy(part.pointer(), part.get_inc(), 
+            (std::complex<float> const*) in, 1, part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at idx[0..count) to out
+int nar_cv_gather_64(float* out, nar_cv v,
+    const int64_t* idx, int64_t count) {
+    try {
+        v->gather<true>((std::complex<float>*) out, idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[0..count) to the elements at idx[0..count)
+int nar_cv_scatter_64(nar_cv v, const int64_t* idx,
+    int64_t count, float const* in) {
+    try {
+        v->scatter<true>(idx, count, (std::complex<float> const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies [start_row, end_row) x [start_col, end_col) to out,
+// which is packed in row major or column major order
+int nar_cm_get_block_64(float* out, nar_cm mat,
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major) {
+    try {
+        Matrix<std::complex<float>> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d((std::complex<float>*) out, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites [start_row, end_row) x [start_col, end_col) with in,
+// which is packed in row major or column major order
+int nar_cm_set_block_64(nar_cm mat,
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    float const* in, int row_major) {
+    try {
+        Matrix<std::complex<float>> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d(part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            (std::complex<float> const*) in, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at (rows_idx[k], cols_idx[k]) to out[k]
+int nar_cm_gather_64(float* out, nar_cm mat,
+    const int64_t* rows_idx, const int64_t* cols_idx, int64_t count) {
+    try {
+        mat->gather<true>((std::complex<float>*) out, rows_idx, cols_idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[k] to the elements at (rows_idx[k], cols_idx[k])
+int nar_cm_scatter_64(nar_cm mat, const int64_t* rows_idx,
+    const int64_t* cols_idx, int64_t count, float const* in) {
+    try {
+        mat->scatter<true>(rows_idx, cols_idx, count, (std::complex<float> const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// binary matrix file without reading the rest of it.
+// If there's an error, puts error code in err.
+nar_cm nar_cm_read_binary_subarray_64(const char* filename, 
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major, int* err) {
+    try {
+        BinaryFile<std::complex<float>> f(filename, ios_base::in);
+        nar_cm mat = new Matrix<std::complex<float>>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// tiled matrix file, reading only the tiles they intersect.
+// If there's an error, puts error code in err.
+nar_cm nar_cm_read_tiled_subarray_64(const char* filename, 
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major, int* err) {
+    try {
+        TiledFile<std::complex<float>> f(filename, ios_base::in);
+        nar_cm mat = new Matrix<std::complex<float>>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Index of the first element of largest magnitude (|Re| + |Im| for
+// complex numbers), or -1 if x is empty. The first NaN counts as largest.
+int64_t nar_cv_iamax_64(nar_cv x) {
+    return iamax(*x);
+}
+// Reads up to max_rows more rows, into a new view to free with
+// nar_cm_free. The view shares the reader's buffer, so the next
+// call overwrites its elements. Returns null at the end of the file, or
+// if there's an error, when it also puts the error code in err, as for
+// nar_cm_reader_open.
+nar_cm nar_cm_reader_next_64(nar_cm_reader reader, int64_t max_rows, int* err) {
+    try {
+        const Matrix<std::complex<float>>& block = reader->next(
+            std::max<Index>(max_rows, 0));
+        if (err) *err = 0;
+        if (block.get_rows() == 0 && max_rows > 0) {
+            return nullptr;
+        }
+        return new Matrix<std::complex<float>>(block);
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+// Reads vector from file. If there's an error, puts error code in err.
+nar_cv nar_cv_read(const char* filename, int* err) {
+    try {
+        File<std::complex<float>> f(filename, ios_base::in);
+        nar_cv v = new Vector<std::complex<float>>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to file.
+int nar_cv_write(nar_cv v, const char* filename, const char* sep) {
+    try {
+        File<std::complex<float>> f(filename, ios_base::out);
+        f.write_vector(*v, sep);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads MATRIX from file. If there's an error, puts error code in err.
+nar_cm nar_cm_read(const char* filename, int row_major, int* err) {
+    try {
+        File<std::complex<float>> f(filename, ios_base::in);
+        nar_cm v = new Matrix<std::complex<float>>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes MATRIX to file.
+int nar_cm_write(nar_cm v, const char* filename, const char* sep) {
+    try {
+        File<std::complex<float>> f(filename, ios_base::out);
+        f.write_matrix(*v, sep);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+
+// Reads vector from file into dest, reusing its memory. The file must
+// hold a vector of dest's length. Returns the error code.
+int nar_cv_read_into(nar_cv dest, const char* filename) {
+    try {
+        File<std::complex<float>> f(filename, ios_base::in);
+        f.read_vector_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Reads matrix from file into dest, reusing its memory. The file must
+// hold a matrix of dest's dimensions. Returns the error code.
+int nar_cm_read_into(nar_cm dest, const char* filename) {
+    try {
+        File<std::complex<float>> f(filename, ios_base::in);
+        f.read_matrix_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Starts reading vector from file on the I/O threads.
+// nar_future_wait returns the vector and error code.
+nar_future nar_cv_read_async(const char* filename) {
+    std::string name(filename);
+    return start_async([name]() {
+        int err;
+        void* v = nar_cv_read(name.c_str(), &err);
+        return Future::Result(v, err);
+    });
+}
+
+// Starts writing vector to file on the I/O threads. v mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_cv_write_async(nar_cv v, const char* filename, const char* sep) {
+    std::string name(filename);
+    std::string separator(sep);
+    return start_async([=]() {
+        int status = nar_cv_write(v, name.c_str(), separator.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Starts reading matrix from file on the I/O threads.
+// nar_future_wait returns the matrix and error code.
+nar_future nar_cm_read_async(const char* filename, int row_major) {
+    std::string name(filename);
+    return start_async([name, row_major]() {
+        int err;
+        void* mat = nar_cm_read(name.c_str(), row_major, &err);
+        return Future::Result(mat, err);
+    });
+}
+
+// Starts writing matrix to file on the I/O threads. mat mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_cm_write_async(nar_cm mat, const char* filename, const char* sep) {
+    std::string name(filename);
+    std::string separator(sep);
+    return start_async([=]() {
+        int status = nar_cm_write(mat, name.c_str(), separator.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Writes vector to file with precision significant digits for floating
+// point values, or NAR_PRECISION_SHORTEST for the fewest that read back
+// exactly.
+int nar_cv_write_precision(nar_cv v, const char* filename, const char* sep, int precision) {
+    try {
+        File<std::complex<float>> f(filename, ios_base::out);
+        f.write_vector(*v, sep, precision);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Writes matrix to file with precision significant digits for floating
+// point values, or NAR_PRECISION_SHORTEST for the fewest that read back
+// exactly.
+int nar_cm_write_precision(nar_cm v, const char* filename, const char* sep, int precision) {
+    try {
+        File<std::complex<float>> f(filename, ios_base::out);
+        f.write_matrix(*v, sep, precision);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+
+// Reads vector from file. If there's an error, puts error code in err.
+nar_cv nar_cv_read_binary(const char* filename, int* err) {
+    try {
+        BinaryFile<std::complex<float>> f(filename, ios_base::in);
+        nar_cv v = new Vector<std::complex<float>>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to file.
+int nar_cv_write_binary(nar_cv v, const char* filename) {
+    try {
+        BinaryFile<std::complex<float>> f(filename, ios_base::out);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads MATRIX from file. If there's an error, puts error code in err.
+nar_cm nar_cm_read_binary(const char* filename, int row_major, int* err) {
+    try {
+        BinaryFile<std::complex<float>> f(filename, ios_base::in);
+        nar_cm v = new Matrix<std::complex<float>>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes MATRIX to file.
+int nar_cm_write_binary(nar_cm v, const char* filename) {
+    try {
+        BinaryFile<std::complex<float>> f(filename, ios_base::out);
+        f.write_matrix(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+
+// Reads vector from file into dest, reusing its memory. The file must
+// hold a vector of dest's length. Returns the error code.
+int nar_cv_read_binary_into(nar_cv dest, const char* filename) {
+    try {
+        BinaryFile<std::complex<float>> f(filename, ios_base::in);
+        f.read_vector_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Reads matrix from file into dest, reusing its memory. The file must
+// hold a matrix of dest's dimensions. Returns the error code.
+int nar_cm_read_binary_into(nar_cm dest, const char* filename) {
+    try {
+        BinaryFile<std::complex<float>> f(filename, ios_base::in);
+        f.read_matrix_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Starts reading vector from file on the I/O threads.
+// nar_future_wait returns the vector and error code.
+nar_future nar_cv_read_binary_async(const char* filename) {
+    std::string name(filename);
+    return start_async([name]() {
+        int err;
+        void* v = nar_cv_read_binary(name.c_str(), &err);
+        return Future::Result(v, err);
+    });
+}
+
+// Starts writing vector to file on the I/O threads. v mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_cv_write_binary_async(nar_cv v, const char* filename) {
+    std::string name(filename);
+    return start_async([=]() {
+        int status = nar_cv_write_binary(v, name.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Starts reading matrix from file on the I/O threads.
+// nar_future_wait returns the matrix and error code.
+nar_future nar_cm_read_binary_async(const char* filename, int row_major) {
+    std::string name(filename);
+    return start_async([name, row_major]() {
+        int err;
+        void* mat = nar_cm_read_binary(name.c_str(), row_major, &err);
+        return Future::Result(mat, err);
+    });
+}
+
+// Starts writing matrix to file on the I/O threads. mat mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_cm_write_binary_async(nar_cm mat, const char* filename) {
+    std::string name(filename);
+    return start_async([=]() {
+        int status = nar_cm_write_binary(mat, name.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Maps a binary file written by nar_cv_write_binary into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_cv nar_cv_mmap(const char* filename, enum nar_map_mode mode, int* err) {
+    try {
+        BinaryFile<std::complex<float>> f(filename, ios_base::in);
+        nar_cv v = new Vector<std::complex<float>>(f.map_vector((MapMode) mode));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps a binary file written by nar_cm_write_binary into memory.
+// The matrix has the order it was stored in, so column major matrices
+// map as column major. The file stays mapped until the last view of it
+// is freed. If there's an error, puts error code in err.
+nar_cm nar_cm_mmap(const char* filename, enum nar_map_mode mode, int* err) {
+    try {
+        BinaryFile<std::complex<float>> f(filename, ios_base::in);
+        nar_cm mat = new Matrix<std::complex<float>>(f.map_matrix((MapMode) mode));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to a binary file, compressed in chunks.
+// nar_cv_read_binary reads it back.
+int nar_cv_write_binary_compressed(nar_cv v, const char* filename) {
+    try {
+        BinaryFile<std::complex<float>> f(filename, ios_base::out);
+        f.set_compressed(true);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Writes matrix to a binary file, compressed in chunks.
+// nar_cm_read_binary reads it back.
+int nar_cm_write_binary_compressed(nar_cm mat, const char* filename) {
+    try {
+        BinaryFile<std::complex<float>> f(filename, ios_base::out);
+        f.set_compressed(true);
+        f.write_matrix(*mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads a 1D array from a NumPy .npy file.
+// If there's an error, puts error code in err.
+nar_cv nar_cv_read_npy(const char* filename, int* err) {
+    try {
+        NpyFile<std::complex<float>> f(filename, ios_base::in);
+        nar_cv v = new Vector<std::complex<float>>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads the named 1D array from an uncompressed NumPy .npz archive.
+// If there's an error, puts error code in err.
+nar_cv nar_cv_read_npz(const char* filename, const char* name, int* err) {
+    try {
+        NpyFile<std::complex<float>> f(filename, ios_base::in);
+        nar_cv v = new Vector<std::complex<float>>(
+            f.read_vector(f.find_entry(name)));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to a NumPy .npy file.
+int nar_cv_write_npy(nar_cv v, const char* filename) {
+    try {
+        NpyFile<std::complex<float>> f(filename, ios_base::out);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads a 2D array from a NumPy .npy file. Fortran order arrays become
+// column major matrices. If there's an error, puts error code in err.
+nar_cm nar_cm_read_npy(const char* filename, int* err) {
+    try {
+        NpyFile<std::complex<float>> f(filename, ios_base::in);
+        nar_cm mat = new Matrix<std::complex<float>>(f.read_matrix());
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads the named 2D array from an uncompressed NumPy .npz archive.
+// If there's an error, puts error code in err.
+nar_cm nar_cm_read_npz(const char* filename, const char* name, int* err) {
+    try {
+        NpyFile<std::complex<float>> f(filename, ios_base::in);
+        nar_cm mat = new Matrix<std::complex<float>>(
+            f.read_matrix(f.find_entry(name)));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes matrix to a NumPy .npy file. Column major matrices
+// are written in Fortran order.
+int nar_cm_write_npy(nar_cm mat, const char* filename) {
+    try {
+        NpyFile<std::complex<float>> f(filename, ios_base::out);
+        f.write_matrix(*mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Opens a text matrix file for reading a block of rows at a time.
+// If there's an error, puts error code in err: 1 if the file can't be
+// read, 2 if it's malformed and 3 for anything else, such as running
+// out of memory.
+nar_cm_reader nar_cm_reader_open(const char* filename, int* err) {
+    try {
+        nar_cm_reader reader = 
+            new MatrixReader<std::complex<float>>(filename, false);
+        if (err) *err = 0;
+        return reader;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+// Opens a binary matrix file for reading a block of rows at a time.
+// If there's an error, puts error code in err, as for
+// nar_cm_reader_open.
+nar_cm_reader nar_cm_reader_open_binary(const char* filename, int* err) {
+    try {
+        nar_cm_reader reader = 
+            new MatrixReader<std::complex<float>>(filename, true);
+        if (err) *err = 0;
+        return reader;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+void nar_cm_reader_close(nar_cm_reader reader) {
+    delete reader;
+}
+
+// Reads a matrix from a tiled file. If there's an error, puts error code in err.
+nar_cm nar_cm_read_tiled(const char* filename, int row_major, int* err) {
+    try {
+        TiledFile<std::complex<float>> f(filename, ios_base::in);
+        nar_cm mat = new Matrix<std::complex<float>>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes matrix to a file as tiles of tile_rows x tile_cols elements.
+// Tile sizes of 0 use the default of 256.
+int nar_cm_write_tiled(nar_cm mat, const char* filename, int tile_rows, int tile_cols) {
+    try {
+        TiledFile<std::complex<float>> f(filename, ios_base::out);
+        f.write_matrix(*mat, tile_rows, tile_cols);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Adds vector to archive under name, replacing any entry with that name.
+int nar_cv_archive_put(nar_archive archive, const char* name, nar_cv v) {
+    try {
+        archive->put(name, *v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads the named vector from archive.
+// If there's an error, puts error code in err.
+nar_cv nar_cv_archive_get(nar_archive archive, const char* name, int* err) {
+    try {
+        nar_cv v = new Vector<std::complex<float>>(
+            archive->get_vector<std::complex<float>>(name));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps the named vector from archive into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_cv nar_cv_archive_map(nar_archive archive, const char* name, enum nar_map_mode mode, int* err) {
+    try {
+        nar_cv v = new Vector<std::complex<float>>(
+            archive->map_vector<std::complex<float>>(name, (MapMode) mode));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Adds matrix to archive under name, replacing any entry with that name.
+int nar_cm_archive_put(nar_archive archive, const char* name, nar_cm mat) {
+    try {
+        archive->put(name, *mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads the named matrix from archive, in the order it was stored in.
+// If there's an error, puts error code in err.
+nar_cm nar_cm_archive_get(nar_archive archive, const char* name, int* err) {
+    try {
+        nar_cm mat = new Matrix<std::complex<float>>(
+            archive->get_matrix<std::complex<float>>(name));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps the named matrix from archive into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_cm nar_cm_archive_map(nar_archive archive, const char* name, enum nar_map_mode mode, int* err) {
+    try {
+        nar_cm mat = new Matrix<std::complex<float>>(
+            archive->map_matrix<std::complex<float>>(name, (MapMode) mode));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// BLAS level 1 for complex numbers in the form a + bI.
+// Functions of two vectors return 1 if their lengths differ.
+
+// y += (a + bI) x
+int nar_cv_axpy(float a, float b, nar_cv x, nar_cv y) {
+    try {
+        axpy(std::complex<float>(a,b), *x, *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// Puts the dot product of x and y in a + bI
+int nar_cv_dot(float* a, float* b, nar_cv x, nar_cv y) {
+    try {
+        std::complex<float> z = dot(*x, *y);
+        *a = z.real();
+        *b = z.imag();
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// Puts the dot product of conjugated x and y in a + bI
+int nar_cv_dotc(float* a, float* b, nar_cv x, nar_cv y) {
+    try {
+        std::complex<float> z = dotc(*x, *y);
+        *a = z.real();
+        *b = z.imag();
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// x *= a + bI
+void nar_cv_scal(float a, float b, nar_cv x) {
+    scal(std::complex<float>(a,b), *x);
+}
+
+// Euclidean norm
+float nar_cv_nrm2(nar_cv x) {
+    return nrm2(*x);
+}
+
+// Sum of |Re x[i]| + |Im x[i]|
+float nar_cv_asum(nar_cv x) {
+    return asum(*x);
+}
+
+// C = alpha op(A) op(B) + beta C, where op is set by trans_a and trans_b,
+// alpha = alpha_re + alpha_im I and beta = beta_re + beta_im I.
+// C must not overlap A or B. Returns 1 if the dimensions don't match.
+int nar_cm_gemm(float alpha_re, float alpha_im, nar_cm a, enum nar_transpose trans_a, nar_cm b, enum nar_transpose trans_b, float beta_re, float beta_im, nar_cm c) {
+    try {
+        gemm(std::complex<float>(alpha_re,alpha_im), *a, (Transpose) trans_a, *b, (Transpose) trans_b, std::complex<float>(beta_re,beta_im), *c);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// y = alpha op(A) x + beta y, where op is set by trans,
+// alpha = alpha_re + alpha_im I and beta = beta_re + beta_im I.
+// y must not overlap A or x. Returns 1 if the dimensions don't match.
+int nar_cm_gemv(float alpha_re, float alpha_im, nar_cm a, enum nar_transpose trans, nar_cv x, float beta_re, float beta_im, nar_cv y) {
+    try {
+        gemv(std::complex<float>(alpha_re,alpha_im), *a, (Transpose) trans, *x, std::complex<float>(beta_re,beta_im), *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+
+// Routines for vectors and matrices of the given type
+// that don't depend on the index type
+
+void nar_zv_free(nar_zv v) {
+    delete v;
+}
+
+nar_zv nar_zv_copy(nar_zv v) {
+    return new Vector<std::complex<double>>(v->copy());
+}
+
+double* nar_zv_pointer(nar_zv v) {
+    return (double*) v->pointer();
+}
+
+// Fills out with the data pointer, dimensions and strides of v
+void nar_zv_describe(nar_zv v, struct nar_view* out) {
+    out->data = v->pointer();
+    out->n = v->get_n();
+    out->rows = v->get_n();
+    out->cols = 1;
+    out->inc = v->get_inc();
+    out->inc_row = v->get_inc();
+    out->inc_col = 0;
+    out->dtype = TypeCode<std::complex<double>>::value;
+}
+
+int nar_zv_eq(nar_zv v1, nar_zv v2) {
+    return (*v1) == (*v2);
+}
+
+int nar_zv_assign(nar_zv v1, nar_zv v2) {
+    try {
+        v1->assign(*v2);
+        return 0;
+    } catch (const std::out_of_range& e) {
+        return 1;
+    }
+}
+
+void nar_zm_free(nar_zm mat) {
+    delete mat;
+}
+
+nar_zm nar_zm_copy(nar_zm mat) {
+    return new Matrix<std::complex<double>>(mat->copy());
+}
+
+enum nar_order nar_zm_order(nar_zm mat) {
+    return (nar_order) mat->get_order();
+}
+
+double* nar_zm_pointer(nar_zm mat) {
+    return (double*) mat->pointer();
+}
+
+// Fills out with the data pointer, dimensions and strides of mat
+void nar_zm_describe(nar_zm mat, struct nar_view* out) {
+    out->data = mat->pointer();
+    out->n = mat->get_rows() * mat->get_cols();
+    out->rows = mat->get_rows();
+    out->cols = mat->get_cols();
+    out->inc = 0;
+    out->inc_row = mat->get_inc_row();
+    out->inc_col = mat->get_inc_col();
+    out->dtype = TypeCode<std::complex<double>>::value;
+}
+
+int nar_zm_eq(nar_zm mat1, nar_zm mat2) {
+    return (*mat1) == (*mat2);
+}
+
+int nar_zm_assign(nar_zm mat1, nar_zm mat2) {
+    try {
+        mat1->assign(*mat2);
+        return 0;
+    } catch (const std::out_of_range& e) {
+        return 1;
+    }
+}
+
+// Display strings
+char* nar_zm_display_string(nar_zm mat) {
+    return string_to_char(display_string(*mat));
+}
+
+char* nar_zv_display_string(nar_zv v) {
+    return string_to_char(display_string(*v));
+}
+
+// Main routines for vectors and matrices of the given type
+// with int sizes, indices and strides
+
+nar_zv nar_zv_alloc(int n) {
+    return new Vector<std::complex<double>>(n);
+}
+
+// Contents are unspecified until written
+nar_zv nar_zv_alloc_uninit(int n) {
+    return new Vector<std::complex<double>>(n, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_zv nar_zv_wrap(double* ptr, int n, int inc,
+    nar_release_fn release, void* ctx) {
+    return new Vector<std::complex<double>>(wrap_vector((std::complex<double>*) ptr, n, inc,
+        [release, ctx](std::complex<double>* p) { if (release) release(p, ctx); }));
+}
+
+int nar_zv_valid(nar_zv v, int i) {
+    return v->in_range(i);
+}
+
+nar_zv nar_zv_slice(nar_zv v, int start, int end) {
+    return new Vector<std::complex<double>>(v->slice(start, end));
+}
+
+int nar_zv_slice_safe(nar_zv* out, nar_zv v, int start, int end) {
+    try {
+        *out = new Vector<std::complex<double>>(v->slice<true>(start, end));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_zv_inc(nar_zv v) {
+    return v->get_inc();
+}
+
+int nar_zv_n(nar_zv v) {
+    return v->get_n();
+}
+
+// For matrices
+
+nar_zm nar_zm_alloc(int rows, int cols, int row_major) {
+    return new Matrix<std::complex<double>>(rows, cols, row_major);
+}
+
+// Contents are unspecified until written
+nar_zm nar_zm_alloc_uninit(int rows, int cols, int row_major) {
+    return new Matrix<std::complex<double>>(rows, cols, row_major, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_zm nar_zm_wrap(double* ptr, int rows, int cols,
+    int inc_row, int inc_col, nar_release_fn release, void* ctx) {
+    return new Matrix<std::complex<double>>(wrap_matrix((std::complex<double>*) ptr, rows, cols,
+        inc_row, inc_col,
+        [release, ctx](std::complex<double>* p) { if (release) release(p, ctx); }));
+}
+
+int nar_zm_valid(nar_zm mat, int i, int j) {
+    return mat->in_range(i,j);
+}
+
+// Slicing parts of matrix
+nar_zv nar_zm_row(nar_zm mat, int i) {
+    return new Vector<std::complex<double>>(mat->row(i));
+}
+
+nar_zv nar_zm_col(nar_zm mat, int j) {
+    return new Vector<std::complex<double>>(mat->col(j));
+}
+
+nar_zm nar_zm_subarray(nar_zm mat, int start_row,
+    int start_col, int end_row, int end_col) {
+    return new Matrix<std::complex<double>>(mat->subarray(
+        start_row, start_col, end_row, end_col));
+}
+
+int nar_zm_row_safe(nar_zv* x, nar_zm mat, int i) {
+    try {
+        *x = new Vector<std::complex<double>>(mat->row<true>(i));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_zm_col_safe(nar_zv* x, nar_zm mat, int j) {
+    try {
+        *x = new Vector<std::complex<double>>(mat->col<true>(j));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_zm_subarray_safe(nar_zm* x, nar_zm mat, int start_row,
+    int start_col, int end_row, int end_col) {
+    try {
+        *x = new Matrix<std::complex<double>>(mat->subarray<true>(
+            start_row, start_col, end_row, end_col));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_zm_get_ld(nar_zm mat) {
+    try {
+        return mat->get_ld();
+    } catch (...) {
+        return -1; // Not contiguously ordered
+    }
+}
+
+int nar_zm_inc_row(nar_zm mat) {
+    return mat->get_inc_row();
+}
+
+int nar_zm_inc_col(nar_zm mat) {
+    return mat->get_inc_col();
+}
+
+int nar_zm_get_rows(nar_zm mat) {
+    return mat->get_rows();
+}
+
+int nar_zm_get_cols(nar_zm mat) {
+    return mat->get_cols();
+}
+// No bounds checking
+// For complex numbers in the form a + bI
+void nar_zv_get(double* a, double* b, nar_zv v, int i) {
+    std::complex<double> z = (*v)[i];
+    *a = z.real();
+    *b = z.imag();
+}
+
+void nar_zv_set(nar_zv v, int i, double a, double b) {
+    (*v)[i] = std::complex<double>(a,b);
+}
+
+void nar_zm_get(double* a, double* b, nar_zm mat, int i, int j) {
+    std::complex<double> z = (*mat)(i,j);
+    *a = z.real();
+    *b = z.imag();
+}
+
+void nar_zm_set(nar_zm mat, int i, int j, double a, double b) {
+    mat->operator()(i,j) = std::complex<double>(a,b);
+}
+
+// Bounds-checked versions
+int nar_zv_get_safe(double* a, double* b, nar_zv v, int i) {
+    try {
+        std::complex<double> z = v->at(i);
+        *a = z.real();
+        *b = z.imag();
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_zv_set_safe(nar_zv v, int i, double a, double b) {
+    try {
+        v->at(i) = std::complex<double>(a,b);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_zm_get_safe(double* a, double* b, nar_zm mat, int i, int j) {
+    try {
+        std::complex<double> z = mat->at(i,j);
+        *a = z.real();
+        *b = z.imag();
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_zm_set_safe(nar_zm mat, int i, int j, double a, double b) {
+    try {
+        mat->at(i,j) = std::complex<double>(a,b);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+// Batched element access through caller buffers.
+// These are bounds-checked and return 1 if anything is out of range.
+// Ranges with start > end are out of range; empty ones do nothing.
+
+// Copies elements [start, end) to out
+int nar_zv_get_range(double* out, nar_zv v,
+    int start, int end) {
+    try {
+        Vector<std::complex<double>> part = v->slice<true>(start, end);
+        strided_copy((std::complex<double>*) out, 1, 
+            part.pointer(), part.get_inc(), part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites elements [start, end) with the contents of in
+int nar_zv_set_range(nar_zv v, int start, int end,
+    double const* in) {
+    try {
+        Vector<std::complex<double>> part = v->slice<true>(start, end);
+        strided_copy(part.pointer(), part.get_inc(), 
+            (std::complex<double> const*) in, 1, part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at idx[0..count) to out
+int nar_zv_gather(double* out, nar_zv v,
+    const int* idx, int count) {
+    try {
+        v->gather<true>((std::complex<double>*) out, idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[0..count) to the elements at idx[0..count)
+int nar_zv_scatter(nar_zv v, const int* idx,
+    int count, double const* in) {
+    try {
+        v->scatter<true>(idx, count, (std::complex<double> const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies [start_row, end_row) x [start_col, end_col) to out,
+// which is packed in row major or column major order
+int nar_zm_get_block(double* out, nar_zm mat,
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major) {
+    try {
+        Matrix<std::complex<double>> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d((std::complex<double>*) out, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites [start_row, end_row) x [start_col, end_col) with in,
+// which is packed in row major or column major order
+int nar_zm_set_block(nar_zm mat,
+    int start_row, int start_col, int end_row, int end_col,
+    double const* in, int row_major) {
+    try {
+        Matrix<std::complex<double>> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d(part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            (std::complex<double> const*) in, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at (rows_idx[k], cols_idx[k]) to out[k]
+int nar_zm_gather(double* out, nar_zm mat,
+    const int* rows_idx, const int* cols_idx, int count) {
+    try {
+        mat->gather<true>((std::complex<double>*) out, rows_idx, cols_idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[k] to the elements at (rows_idx[k], cols_idx[k])
+int nar_zm_scatter(nar_zm mat, const int* rows_idx,
+    const int* cols_idx, int count, double const* in) {
+    try {
+        mat->scatter<true>(rows_idx, cols_idx, count, (std::complex<double> const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// binary matrix file without reading the rest of it.
+// If there's an error, puts error code in err.
+nar_zm nar_zm_read_binary_subarray(const char* filename, 
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major, int* err) {
+    try {
+        BinaryFile<std::complex<double>> f(filename, ios_base::in);
+        nar_zm mat = new Matrix<std::complex<double>>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// tiled matrix file, reading only the tiles they intersect.
+// If there's an error, puts error code in err.
+nar_zm nar_zm_read_tiled_subarray(const char* filename, 
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major, int* err) {
+    try {
+        TiledFile<std::complex<double>> f(filename, ios_base::in);
+        nar_zm mat = new Matrix<std::complex<double>>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Index of the first element of largest magnitude (|Re| + |Im| for
+// complex numbers), or -1 if x is empty. The first NaN counts as largest.
+int nar_zv_iamax(nar_zv x) {
+    return iamax(*x);
+}
+// Reads up to max_rows more rows, into a new view to free with
+// nar_zm_free. The view shares the reader's buffer, so the next
+// call overwrites its elements. Returns null at the end of the file, or
+// if there's an error, when it also puts the error code in err, as for
+// nar_zm_reader_open.
+nar_zm nar_zm_reader_next(nar_zm_reader reader, int max_rows, int* err) {
+    try {
+        const Matrix<std::complex<double>>& block = reader->next(
+            std::max<Index>(max_rows, 0));
+        if (err) *err = 0;
+        if (block.get_rows() == 0 && max_rows > 0) {
+            return nullptr;
+        }
+        return new Matrix<std::complex<double>>(block);
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+// Main routines for vectors and matrices of the given type
+// with int64_t sizes, indices and strides
+
+nar_zv nar_zv_alloc_64(int64_t n) {
+    return new Vector<std::complex<double>>(n);
+}
+
+// Contents are unspecified until written
+nar_zv nar_zv_alloc_uninit_64(int64_t n) {
+    return new Vector<std::complex<double>>(n, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_zv nar_zv_wrap_64(double* ptr, int64_t n, int64_t inc,
+    nar_release_fn release, void* ctx) {
+    return new Vector<std::complex<double>>(wrap_vector((std::complex<double>*) ptr, n, inc,
+        [release, ctx](std::complex<double>* p) { if (release) release(p, ctx); }));
+}
+
+int nar_zv_valid_64(nar_zv v, int64_t i) {
+    return v->in_range(i);
+}
+
+nar_zv nar_zv_slice_64(nar_zv v, int64_t start, int64_t end) {
+    return new Vector<std::complex<double>>(v->slice(start, end));
+}
+
+int nar_zv_slice_safe_64(nar_zv* out, nar_zv v, int64_t start, int64_t end) {
+    try {
+        *out = new Vector<std::complex<double>>(v->slice<true>(start, end));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int64_t nar_zv_inc_64(nar_zv v) {
+    return v->get_inc();
+}
+
+int64_t nar_zv_n_64(nar_zv v) {
+    return v->get_n();
+}
+
+// For matrices
+
+nar_zm nar_zm_alloc_64(int64_t rows, int64_t cols, int row_major) {
+    return new Matrix<std::complex<double>>(rows, cols, row_major);
+}
+
+// Contents are unspecified until written
+nar_zm nar_zm_alloc_uninit_64(int64_t rows, int64_t cols, int row_major) {
+    return new Matrix<std::complex<double>>(rows, cols, row_major, uninitialized);
+}
+
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_zm nar_zm_wrap_64(double* ptr, int64_t rows, int64_t cols,
+    int64_t inc_row, int64_t inc_col, nar_release_fn release, void* ctx) {
+    return new Matrix<std::complex<double>>(wrap_matrix((std::complex<double>*) ptr, rows, cols,
+        inc_row, inc_col,
+        [release, ctx](std::complex<double>* p) { if (release) release(p, ctx); }));
+}
+
+int nar_zm_valid_64(nar_zm mat, int64_t i, int64_t j) {
+    return mat->in_range(i,j);
+}
+
+// Slicing parts of matrix
+nar_zv nar_zm_row_64(nar_zm mat, int64_t i) {
+    return new Vector<std::complex<double>>(mat->row(i));
+}
+
+nar_zv nar_zm_col_64(nar_zm mat, int64_t j) {
+    return new Vector<std::complex<double>>(mat->col(j));
+}
+
+nar_zm nar_zm_subarray_64(nar_zm mat, int64_t start_row,
+    int64_t start_col, int64_t end_row, int64_t end_col) {
+    return new Matrix<std::complex<double>>(mat->subarray(
+        start_row, start_col, end_row, end_col));
+}
+
+int nar_zm_row_safe_64(nar_zv* x, nar_zm mat, int64_t i) {
+    try {
+        *x = new Vector<std::complex<double>>(mat->row<true>(i));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_zm_col_safe_64(nar_zv* x, nar_zm mat, int64_t j) {
+    try {
+        *x = new Vector<std::complex<double>>(mat->col<true>(j));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_zm_subarray_safe_64(nar_zm* x, nar_zm mat, int64_t start_row,
+    int64_t start_col, int64_t end_row, int64_t end_col) {
+    try {
+        *x = new Matrix<std::complex<double>>(mat->subarray<true>(
+            start_row, start_col, end_row, end_col));
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int64_t nar_zm_get_ld_64(nar_zm mat) {
+    try {
+        return mat->get_ld();
+    } catch (...) {
+        return -1; // Not contiguously ordered
+    }
+}
+
+int64_t nar_zm_inc_row_64(nar_zm mat) {
+    return mat->get_inc_row();
+}
+
+int64_t nar_zm_inc_col_64(nar_zm mat) {
+    return mat->get_inc_col();
+}
+
+int64_t nar_zm_get_rows_64(nar_zm mat) {
+    return mat->get_rows();
+}
+
+int64_t nar_zm_get_cols_64(nar_zm mat) {
+    return mat->get_cols();
+}
+// No bounds checking
+// For complex numbers in the form a + bI
+void nar_zv_get_64(double* a, double* b, nar_zv v, int64_t i) {
+    std::complex<double> z = (*v)[i];
+    *a = z.real();
+    *b = z.imag();
+}
+
+void nar_zv_set_64(nar_zv v, int64_t i, double a, double b) {
+    (*v)[i] = std::complex<double>(a,b);
+}
+
+void nar_zm_get_64(double* a, double* b, nar_zm mat, int64_t i, int64_t j) {
+    std::complex<double> z = (*mat)(i,j);
+    *a = z.real();
+    *b = z.imag();
+}
+
+void nar_zm_set_64(nar_zm mat, int64_t i, int64_t j, double a, double b) {
+    mat->operator()(i,j) = std::complex<double>(a,b);
+}
+
+// Bounds-checked versions
+int nar_zv_get_safe_64(double* a, double* b, nar_zv v, int64_t i) {
+    try {
+        std::complex<double> z = v->at(i);
+        *a = z.real();
+        *b = z.imag();
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_zv_set_safe_64(nar_zv v, int64_t i, double a, double b) {
+    try {
+        v->at(i) = std::complex<double>(a,b);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_zm_get_safe_64(double* a, double* b, nar_zm mat, int64_t i, int64_t j) {
+    try {
+        std::complex<double> z = mat->at(i,j);
+        *a = z.real();
+        *b = z.imag();
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int nar_zm_set_safe_64(nar_zm mat, int64_t i, int64_t j, double a, double b) {
+    try {
+        mat->at(i,j) = std::complex<double>(a,b);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+// Batched element access through caller buffers.
+// These are bounds-checked and return 1 if anything is out of range.
+// Ranges with start > end are out of range; empty ones do nothing.
+
+// Copies elements [start, end) to out
+int nar_zv_get_range_64(double* out, nar_zv v,
+    int64_t start, int64_t end) {
+    try {
+        Vector<std::complex<double>> part = v->slice<true>(start, end);
+        strided_copy((std::complex<double>*) out, 1, 
+            part.pointer(), part.get_inc(), part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites elements [start, end) with the contents of in
+int nar_zv_set_range_64(nar_zv v, int64_t start, int64_t end,
+    double const* in) {
+    try {
+        Vector<std::complex<double>> part = v->slice<true>(start, end);
+        strided_copy(part.pointer(), part.get_inc(), 
+            (std::complex<double> const*) in, 1, part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at idx[0..count) to out
+int nar_zv_gather_64(double* out, nar_zv v,
+    const int64_t* idx, int64_t count) {
+    try {
+        v->gather<true>((std::complex<double>*) out, idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[0..count) to the elements at idx[0..count)
+int nar_zv_scatter_64(nar_zv v, const int64_t* idx,
+    int64_t count, double const* in) {
+    try {
+        v->scatter<true>(idx, count, (std::complex<double> const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies [start_row, end_row) x [start_col, end_col) to out,
+// which is packed in row major or column major order
+int nar_zm_get_block_64(double* out, nar_zm mat,
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major) {
+    try {
+        Matrix<std::complex<double>> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d((std::complex<double>*) out, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Overwrites [start_row, end_row) x [start_col, end_col) with in,
+// which is packed in row major or column major order
+int nar_zm_set_block_64(nar_zm mat,
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    double const* in, int row_major) {
+    try {
+        Matrix<std::complex<double>> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d(part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            (std::complex<double> const*) in, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Copies the elements at (rows_idx[k], cols_idx[k]) to out[k]
+int nar_zm_gather_64(double* out, nar_zm mat,
+    const int64_t* rows_idx, const int64_t* cols_idx, int64_t count) {
+    try {
+        mat->gather<true>((std::complex<double>*) out, rows_idx, cols_idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[k] to the elements at (rows_idx[k], cols_idx[k])
+int nar_zm_scatter_64(nar_zm mat, const int64_t* rows_idx,
+    const int64_t* cols_idx, int64_t count, double const* in) {
+    try {
+        mat->scatter<true>(rows_idx, cols_idx, count, (std::complex<double> const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// binary matrix file without reading the rest of it.
+// If there's an error, puts error code in err.
+nar_zm nar_zm_read_binary_subarray_64(const char* filename, 
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major, int* err) {
+    try {
+        BinaryFile<std::complex<double>> f(filename, ios_base::in);
+        nar_zm mat = new Matrix<std::complex<double>>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// tiled matrix file, reading only the tiles they intersect.
+// If there's an error, puts error code in err.
+nar_zm nar_zm_read_tiled_subarray_64(const char* filename, 
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major, int* err) {
+    try {
+        TiledFile<std::complex<double>> f(filename, ios_base::in);
+        nar_zm mat = new Matrix<std::complex<double>>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Index of the first element of largest magnitude (|Re| + |Im| for
+// complex numbers), or -1 if x is empty. The first NaN counts as largest.
+int64_t nar_zv_iamax_64(nar_zv x) {
+    return iamax(*x);
+}
+// Reads up to max_rows more rows, into a new view to free with
+// nar_zm_free. The view shares the reader's buffer, so the next
+// call overwrites its elements. Returns null at the end of the file, or
+// if there's an error, when it also puts the error code in err, as for
+// nar_zm_reader_open.
+nar_zm nar_zm_reader_next_64(nar_zm_reader reader, int64_t max_rows, int* err) {
+    try {
+        const Matrix<std::complex<double>>& block = reader->next(
+            std::max<Index>(max_rows, 0));
+        if (err) *err = 0;
+        if (block.get_rows() == 0 && max_rows > 0) {
+            return nullptr;
+        }
+        return new Matrix<std::complex<double>>(block);
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+// Reads vector from file. If there's an error, puts error code in err.
+nar_zv nar_zv_read(const char* filename, int* err) {
+    try {
+        File<std::complex<double>> f(filename, ios_base::in);
+        nar_zv v = new Vector<std::complex<double>>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to file.
+int nar_zv_write(nar_zv v, const char* filename, const char* sep) {
+    try {
+        File<std::complex<double>> f(filename, ios_base::out);
+        f.write_vector(*v, sep);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads MATRIX from file. If there's an error, puts error code in err.
+nar_zm nar_zm_read(const char* filename, int row_major, int* err) {
+    try {
+        File<std::complex<double>> f(filename, ios_base::in);
+        nar_zm v = new Matrix<std::complex<double>>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes MATRIX to file.
+int nar_zm_write(nar_zm v, const char* filename, const char* sep) {
+    try {
+        File<std::complex<double>> f(filename, ios_base::out);
+        f.write_matrix(*v, sep);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+
+// Reads vector from file into dest, reusing its memory. The file must
+// hold a vector of dest's length. Returns the error code.
+int nar_zv_read_into(nar_zv dest, const char* filename) {
+    try {
+        File<std::complex<double>> f(filename, ios_base::in);
+        f.read_vector_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Reads matrix from file into dest, reusing its memory. The file must
+// hold a matrix of dest's dimensions. Returns the error code.
+int nar_zm_read_into(nar_zm dest, const char* filename) {
+    try {
+        File<std::complex<double>> f(filename, ios_base::in);
+        f.read_matrix_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Starts reading vector from file on the I/O threads.
+// nar_future_wait returns the vector and error code.
+nar_future nar_zv_read_async(const char* filename) {
+    std::string name(filename);
+    return start_async([name]() {
+        int err;
+        void* v = nar_zv_read(name.c_str(), &err);
+        return Future::Result(v, err);
+    });
+}
+
+// Starts writing vector to file on the I/O threads. v mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_zv_write_async(nar_zv v, const char* filename, const char* sep) {
+    std::string name(filename);
+    std::string separator(sep);
+    return start_async([=]() {
+        int status = nar_zv_write(v, name.c_str(), separator.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Starts reading matrix from file on the I/O threads.
+// nar_future_wait returns the matrix and error code.
+nar_future nar_zm_read_async(const char* filename, int row_major) {
+    std::string name(filename);
+    return start_async([name, row_major]() {
+        int err;
+        void* mat = nar_zm_read(name.c_str(), row_major, &err);
+        return Future::Result(mat, err);
+    });
+}
+
+// Starts writing matrix to file on the I/O threads. mat mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_zm_write_async(nar_zm mat, const char* filename, const char* sep) {
+    std::string name(filename);
+    std::string separator(sep);
+    return start_async([=]() {
+        int status = nar_zm_write(mat, name.c_str(), separator.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Writes vector to file with precision significant digits for floating
+// point values, or NAR_PRECISION_SHORTEST for the fewest that read back
+// exactly.
+int nar_zv_write_precision(nar_zv v, const char* filename, const char* sep, int precision) {
+    try {
+        File<std::complex<double>> f(filename, ios_base::out);
+        f.write_vector(*v, sep, precision);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Writes matrix to file with precision significant digits for floating
+// point values, or NAR_PRECISION_SHORTEST for the fewest that read back
+// exactly.
+int nar_zm_write_precision(nar_zm v, const char* filename, const char* sep, int precision) {
+    try {
+        File<std::complex<double>> f(filename, ios_base::out);
+        f.write_matrix(*v, sep, precision);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+
+// Reads vector from file. If there's an error, puts error code in err.
+nar_zv nar_zv_read_binary(const char* filename, int* err) {
+    try {
+        BinaryFile<std::complex<double>> f(filename, ios_base::in);
+        nar_zv v = new Vector<std::complex<double>>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to file.
+int nar_zv_write_binary(nar_zv v, const char* filename) {
+    try {
+        BinaryFile<std::complex<double>> f(filename, ios_base::out);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads MATRIX from file. If there's an error, puts error code in err.
+nar_zm nar_zm_read_binary(const char* filename, int row_major, int* err) {
+    try {
+        BinaryFile<std::complex<double>> f(filename, ios_base::in);
+        nar_zm v = new Matrix<std::complex<double>>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes MATRIX to file.
+int nar_zm_write_binary(nar_zm v, const char* filename) {
+    try {
+        BinaryFile<std::complex<double>> f(filename, ios_base::out);
+        f.write_matrix(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+
+// Reads vector from file into dest, reusing its memory. The file must
+// hold a vector of dest's length. Returns the error code.
+int nar_zv_read_binary_into(nar_zv dest, const char* filename) {
+    try {
+        BinaryFile<std::complex<double>> f(filename, ios_base::in);
+        f.read_vector_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Reads matrix from file into dest, reusing its memory. The file must
+// hold a matrix of dest's dimensions. Returns the error code.
+int nar_zm_read_binary_into(nar_zm dest, const char* filename) {
+    try {
+        BinaryFile<std::complex<double>> f(filename, ios_base::in);
+        f.read_matrix_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Starts reading vector from file on the I/O threads.
+// nar_future_wait returns the vector and error code.
+nar_future nar_zv_read_binary_async(const char* filename) {
+    std::string name(filename);
+    return start_async([name]() {
+        int err;
+        void* v = nar_zv_read_binary(name.c_str(), &err);
+        return Future::Result(v, err);
+    });
+}
+
+// Starts writing vector to file on the I/O threads. v mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_zv_write_binary_async(nar_zv v, const char* filename) {
+    std::string name(filename);
+    return start_async([=]() {
+        int status = nar_zv_write_binary(v, name.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Starts reading matrix from file on the I/O threads.
+// nar_future_wait returns the matrix and error code.
+nar_future nar_zm_read_binary_async(const char* filename, int row_major) {
+    std::string name(filename);
+    return start_async([name, row_major]() {
+        int err;
+        void* mat = nar_zm_read_binary(name.c_str(), row_major, &err);
+        return Future::Result(mat, err);
+    });
+}
+
+// Starts writing matrix to file on the I/O threads. mat mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_zm_write_binary_async(nar_zm mat, const char* filename) {
+    std::string name(filename);
+    return start_async([=]() {
+        int status = nar_zm_write_binary(mat, name.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Maps a binary file written by nar_zv_write_binary into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_zv nar_zv_mmap(const char* filename, enum nar_map_mode mode, int* err) {
+    try {
+        BinaryFile<std::complex<double>> f(filename, ios_base::in);
+        nar_zv v = new Vector<std::complex<double>>(f.map_vector((MapMode) mode));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps a binary file written by nar_zm_write_binary into memory.
+// The matrix has the order it was stored in, so column major matrices
+// map as column major. The file stays mapped until the last view of it
+// is freed. If there's an error, puts error code in err.
+nar_zm nar_zm_mmap(const char* filename, enum nar_map_mode mode, int* err) {
+    try {
+        BinaryFile<std::complex<double>> f(filename, ios_base::in);
+        nar_zm mat = new Matrix<std::complex<double>>(f.map_matrix((MapMode) mode));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to a binary file, compressed in chunks.
+// nar_zv_read_binary reads it back.
+int nar_zv_write_binary_compressed(nar_zv v, const char* filename) {
+    try {
+        BinaryFile<std::complex<double>> f(filename, ios_base::out);
+        f.set_compressed(true);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Writes matrix to a binary file, compressed in chunks.
+// nar_zm_read_binary reads it back.
+int nar_zm_write_binary_compressed(nar_zm mat, const char* filename) {
+    try {
+        BinaryFile<std::complex<double>> f(filename, ios_base::out);
+        f.set_compressed(true);
+        f.write_matrix(*mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads a 1D array from a NumPy .npy file.
+// If there's an error, puts error code in err.
+nar_zv nar_zv_read_npy(const char* filename, int* err) {
+    try {
+        NpyFile<std::complex<double>> f(filename, ios_base::in);
+        nar_zv v = new Vector<std::complex<double>>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads the named 1D array from an uncompressed NumPy .npz archive.
+// If there's an error, puts error code in err.
+nar_zv nar_zv_read_npz(const char* filename, const char* name, int* err) {
+    try {
+        NpyFile<std::complex<double>> f(filename, ios_base::in);
+        nar_zv v = new Vector<std::complex<double>>(
+            f.read_vector(f.find_entry(name)));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes vector to a NumPy .npy file.
+int nar_zv_write_npy(nar_zv v, const char* filename) {
+    try {
+        NpyFile<std::complex<double>> f(filename, ios_base::out);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads a 2D array from a NumPy .npy file. Fortran order arrays become
+// column major matrices. If there's an error, puts error code in err.
+nar_zm nar_zm_read_npy(const char* filename, int* err) {
+    try {
+        NpyFile<std::complex<double>> f(filename, ios_base::in);
+        nar_zm mat = new Matrix<std::complex<double>>(f.read_matrix());
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads the named 2D array from an uncompressed NumPy .npz archive.
+// If there's an error, puts error code in err.
+nar_zm nar_zm_read_npz(const char* filename, const char* name, int* err) {
+    try {
+        NpyFile<std::complex<double>> f(filename, ios_base::in);
+        nar_zm mat = new Matrix<std::complex<double>>(
+            f.read_matrix(f.find_entry(name)));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes matrix to a NumPy .npy file. Column major matrices
+// are written in Fortran order.
+int nar_zm_write_npy(nar_zm mat, const char* filename) {
+    try {
+        NpyFile<std::complex<double>> f(filename, ios_base::out);
+        f.write_matrix(*mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Opens a text matrix file for reading a block of rows at a time.
+// If there's an error, puts error code in err: 1 if the file can't be
+// read, 2 if it's malformed and 3 for anything else, such as running
+// out of memory.
+nar_zm_reader nar_zm_reader_open(const char* filename, int* err) {
+    try {
+        nar_zm_reader reader = 
+            new MatrixReader<std::complex<double>>(filename, false);
+        if (err) *err = 0;
+        return reader;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+// Opens a binary matrix file for reading a block of rows at a time.
+// If there's an error, puts error code in err, as for
+// nar_zm_reader_open.
+nar_zm_reader nar_zm_reader_open_binary(const char* filename, int* err) {
+    try {
+        nar_zm_reader reader = 
+            new MatrixReader<std::complex<double>>(filename, true);
+        if (err) *err = 0;
+        return reader;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
+void nar_zm_reader_close(nar_zm_reader reader) {
+    delete reader;
+}
+
+// Reads a matrix from a tiled file. If there's an error, puts error code in err.
+nar_zm nar_zm_read_tiled(const char* filename, int row_major, int* err) {
+    try {
+        TiledFile<std::complex<double>> f(filename, ios_base::in);
+        nar_zm mat = new Matrix<std::complex<double>>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Writes matrix to a file as tiles of tile_rows x tile_cols elements.
+// Tile sizes of 0 use the default of 256.
+int nar_zm_write_tiled(nar_zm mat, const char* filename, int tile_rows, int tile_cols) {
+    try {
+        TiledFile<std::complex<double>> f(filename, ios_base::out);
+        f.write_matrix(*mat, tile_rows, tile_cols);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Adds vector to archive under name, replacing any entry with that name.
+int nar_zv_archive_put(nar_archive archive, const char* name, nar_zv v) {
+    try {
+        archive->put(name, *v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads the named vector from archive.
+// If there's an error, puts error code in err.
+nar_zv nar_zv_archive_get(nar_archive archive, const char* name, int* err) {
+    try {
+        nar_zv v = new Vector<std::complex<double>>(
+            archive->get_vector<std::complex<double>>(name));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps the named vector from archive into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_zv nar_zv_archive_map(nar_archive archive, const char* name, enum nar_map_mode mode, int* err) {
+    try {
+        nar_zv v = new Vector<std::complex<double>>(
+            archive->map_vector<std::complex<double>>(name, (MapMode) mode));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Adds matrix to archive under name, replacing any entry with that name.
+int nar_zm_archive_put(nar_archive archive, const char* name, nar_zm mat) {
+    try {
+        archive->put(name, *mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Reads the named matrix from archive, in the order it was stored in.
+// If there's an error, puts error code in err.
+nar_zm nar_zm_archive_get(nar_archive archive, const char* name, int* err) {
+    try {
+        nar_zm mat = new Matrix<std::complex<double>>(
+            archive->get_matrix<std::complex<double>>(name));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Maps the named matrix from archive into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_zm nar_zm_archive_map(nar_archive archive, const char* name, enum nar_map_mode mode, int* err) {
+    try {
+        nar_zm mat = new Matrix<std::complex<double>>(
+            archive->map_matrix<std::complex<double>>(name, (MapMode) mode));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// BLAS level 1 for complex numbers in the form a + bI.
+// Functions of two vectors return 1 if their lengths differ.
+
+// y += (a + bI) x
+int nar_zv_axpy(double a, double b, nar_zv x, nar_zv y) {
+    try {
+        axpy(std::complex<double>(a,b), *x, *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// Puts the dot product of x and y in a + bI
+int nar_zv_dot(double* a, double* b, nar_zv x, nar_zv y) {
+    try {
+        std::complex<double> z = dot(*x, *y);
+        *a = z.real();
+        *b = z.imag();
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// Puts the dot product of conjugated x and y in a + bI
+int nar_zv_dotc(double* a, double* b, nar_zv x, nar_zv y) {
+    try {
+        std::complex<double> z = dotc(*x, *y);
+        *a = z.real();
+        *b = z.imag();
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// x *= a + bI
+void nar_zv_scal(double a, double b, nar_zv x) {
+    scal(std::complex<double>(a,b), *x);
+}
+
+// Euclidean norm
+double nar_zv_nrm2(nar_zv x) {
+    return nrm2(*x);
+}
+
+// Sum of |Re x[i]| + |Im x[i]|
+double nar_zv_asum(nar_zv x) {
+    return asum(*x);
+}
+
+// C = alpha op(A) op(B) + beta C, where op is set by trans_a and trans_b,
+// alpha = alpha_re + alpha_im I and beta = beta_re + beta_im I.
+// C must not overlap A or B. Returns 1 if the dimensions don't match.
+int nar_zm_gemm(double alpha_re, double alpha_im, nar_zm a, enum nar_transpose trans_a, nar_zm b, enum nar_transpose trans_b, double beta_re, double beta_im, nar_zm c) {
+    try {
+        gemm(std::complex<double>(alpha_re,alpha_im), *a, (Transpose) trans_a, *b, (Transpose) trans_b, std::complex<double>(beta_re,beta_im), *c);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+// y = alpha op(A) x + beta y, where op is set by trans,
+// alpha = alpha_re + alpha_im I and beta = beta_re + beta_im I.
+// y must not overlap A or x. Returns 1 if the dimensions don't match.
+int nar_zm_gemv(double alpha_re, double alpha_im, nar_zm a, enum nar_transpose trans, nar_zv x, double beta_re, double beta_im, nar_zv y) {
+    try {
+        gemv(std::complex<double>(alpha_re,alpha_im), *a, (Transpose) trans, *x, std::complex<double>(beta_re,beta_im), *y);
+        return 0;
+    } catch (const DimensionError& e) {
+        return 1;
+    }
+}
+
+
+// Routines for vectors and matrices of the given type
+// that don't depend on the index type
+
+void nar_xv_free(nar_xv v) {
     delete v;
 }
 
-nar_sv nar_sv_copy(nar_sv v) {
-    return new Vector<float>(v->copy());
+nar_xv nar_xv_copy(nar_xv v) {
+    return new Vector<char>(v->copy());
+}
+
+char* nar_xv_pointer(nar_xv v) {
+    return (char*) v->pointer();
+}
+
+// Fills out with the data pointer, dimensions and strides of v
+void nar_xv_describe(nar_xv v, struct nar_view* out) {
+    out->data = v->pointer();
+    out->n = v->get_n();
+    out->rows = v->get_n();
+    out->cols = 1;
+    out->inc = v->get_inc();
+    out->inc_row = v->get_inc();
+    out->inc_col = 0;
+    out->dtype = TypeCode<char>::value;
+}
+
+int nar_xv_eq(nar_xv v1, nar_xv v2) {
+    return (*v1) == (*v2);
+}
+
+int nar_xv_assign(nar_xv v1, nar_xv v2) {
+    try {
+        v1->assign(*v2);
+        return 0;
+    } catch (const std::out_of_range& e) {
+        return 1;
+    }
+}
+
+void nar_xm_free(nar_xm mat) {
+    delete mat;
 }
 
-int nar_sv_valid(nar_sv v, int i) {
-    return v->in_range(i);
+nar_xm nar_xm_copy(nar_xm mat) {
+    return new Matrix<char>(mat->copy());
 }
 
-nar_sv nar_sv_slice(nar_sv v, int start, int end) {
-    return new Vector<float>(v->slice(start, end));
+enum nar_order nar_xm_order(nar_xm mat) {
+    return (nar_order) mat->get_order();
 }
 
-int nar_sv_slice_safe(nar_sv* out, nar_sv v, int start, int end) {
+char* nar_xm_pointer(nar_xm mat) {
+    return (char*) mat->pointer();
+}
+
+// Fills out with the data pointer, dimensions and strides of mat
+void nar_xm_describe(nar_xm mat, struct nar_view* out) {
+    out->data = mat->pointer();
+    out->n = mat->get_rows() * mat->get_cols();
+    out->rows = mat->get_rows();
+    out->cols = mat->get_cols();
+    out->inc = 0;
+    out->inc_row = mat->get_inc_row();
+    out->inc_col = mat->get_inc_col();
+    out->dtype = TypeCode<char>::value;
+}
+
+int nar_xm_eq(nar_xm mat1, nar_xm mat2) {
+    return (*mat1) == (*mat2);
+}
+
+int nar_xm_assign(nar_xm mat1, nar_xm mat2) {
     try {
-        *out = new Vector<float>(v->slice<true>(start, end));
+        mat1->assign(*mat2);
         return 0;
-    } catch (...) {
+    } catch (const std::out_of_range& e) {
         return 1;
     }
 }
 
-float* nar_sv_pointer(nar_sv v) {
-    return (float*) v->pointer();
+// Display strings
+char* nar_xm_display_string(nar_xm mat) {
+    return string_to_char(display_string(*mat));
 }
 
-int nar_sv_inc(nar_sv v) {
-    return v->get_inc();
+char* nar_xv_display_string(nar_xv v) {
+    return string_to_char(display_string(*v));
 }
 
-int nar_sv_n(nar_sv v) {
-    return v->get_n();
+// Main routines for vectors and matrices of the given type
+// with int sizes, indices and strides
+
+nar_xv nar_xv_alloc(int n) {
+    return new Vector<char>(n);
 }
 
-int nar_sv_eq(nar_sv v1, nar_sv v2) {
-    return (*v1) == (*v2);
+// Contents are unspecified until written
+nar_xv nar_xv_alloc_uninit(int n) {
+    return new Vector<char>(n, uninitialized);
 }
 
-int nar_sv_assign(nar_sv v1, nar_sv v2) {
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_xv nar_xv_wrap(char* ptr, int n, int inc,
+    nar_release_fn release, void* ctx) {
+    return new Vector<char>(wrap_vector((char*) ptr, n, inc,
+        [release, ctx](char* p) { if (release) release(p, ctx); }));
+}
+
+int nar_xv_valid(nar_xv v, int i) {
+    return v->in_range(i);
+}
+
+nar_xv nar_xv_slice(nar_xv v, int start, int end) {
+    return new Vector<char>(v->slice(start, end));
+}
+
+int nar_xv_slice_safe(nar_xv* out, nar_xv v, int start, int end) {
     try {
-        v1->assign(*v2);
+        *out = new Vector<char>(v->slice<true>(start, end));
         return 0;
-    } catch (const std::out_of_range& e) {
+    } catch (...) {
         return 1;
     }
 }
 
-// For matrices
+int nar_xv_inc(nar_xv v) {
+    return v->get_inc();
+}
 
-nar_sm nar_sm_alloc(int rows, int cols, int row_major) {
-    return new Matrix<float>(rows, cols, row_major);
+int nar_xv_n(nar_xv v) {
+    return v->get_n();
 }
 
-void nar_sm_free(nar_sm mat) {
-    delete mat;
+// For matrices
+
+nar_xm nar_xm_alloc(int rows, int cols, int row_major) {
+    return new Matrix<char>(rows, cols, row_major);
 }
 
-nar_sm nar_sm_copy(nar_sm mat) {
-    return new Matrix<float>(mat->copy());
+// Contents are unspecified until written
+nar_xm nar_xm_alloc_uninit(int rows, int cols, int row_major) {
+    return new Matrix<char>(rows, cols, row_major, uninitialized);
 }
 
-int nar_sm_valid(nar_sm mat, int i, int j) {
-    return mat->in_range(i,j);
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_xm nar_xm_wrap(char* ptr, int rows, int cols,
+    int inc_row, int inc_col, nar_release_fn release, void* ctx) {
+    return new Matrix<char>(wrap_matrix((char*) ptr, rows, cols,
+        inc_row, inc_col,
+        [release, ctx](char* p) { if (release) release(p, ctx); }));
 }
 
-enum nar_order nar_sm_order(nar_sm mat) {
-    return (nar_order) mat->get_order();
+int nar_xm_valid(nar_xm mat, int i, int j) {
+    return mat->in_range(i,j);
 }
 
 // Slicing parts of matrix
-nar_sv nar_sm_row(nar_sm mat, int i) {
-    return new Vector<float>(mat->row(i));
+nar_xv nar_xm_row(nar_xm mat, int i) {
+    return new Vector<char>(mat->row(i));
 }
 
-nar_sv nar_sm_col(nar_sm mat, int j) {
-    return new Vector<float>(mat->col(j));
+nar_xv nar_xm_col(nar_xm mat, int j) {
+    return new Vector<char>(mat->col(j));
 }
 
-nar_sm nar_sm_subarray(nar_sm mat, int start_row,
+nar_xm nar_xm_subarray(nar_xm mat, int start_row,
     int start_col, int end_row, int end_col) {
-    return new Matrix<float>(mat->subarray(
+    return new Matrix<char>(mat->subarray(
         start_row, start_col, end_row, end_col));
 }
 
-int nar_sm_row_safe(nar_sv* x, nar_sm mat, int i) {
+int nar_xm_row_safe(nar_xv* x, nar_xm mat, int i) {
     try {
-        *x = new Vector<float>(mat->row<true>(i));
+        *x = new Vector<char>(mat->row<true>(i));
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_sm_col_safe(nar_sv* x, nar_sm mat, int j) {
+int nar_xm_col_safe(nar_xv* x, nar_xm mat, int j) {
     try {
-        *x = new Vector<float>(mat->col<true>(j));
+        *x = new Vector<char>(mat->col<true>(j));
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_sm_subarray_safe(nar_sm* x, nar_sm mat, int start_row,
+int nar_xm_subarray_safe(nar_xm* x, nar_xm mat, int start_row,
     int start_col, int end_row, int end_col) {
     try {
-        *x = new Matrix<float>(mat->subarray<true>(
+        *x = new Matrix<char>(mat->subarray<true>(
             start_row, start_col, end_row, end_col));
         return 0;
     } catch (...) {
@@ -787,12 +9218,7 @@ int nar_sm_subarray_safe(nar_sm* x, nar_sm mat, int start_row,
     }
 }
 
-// Matrix attributes and dimensions
-float* nar_sm_pointer(nar_sm mat) {
-    return (float*) mat->pointer();
-}
-
-int nar_sm_get_ld(nar_sm mat) {
+int nar_xm_get_ld(nar_xm mat) {
     try {
         return mat->get_ld();
     } catch (...) {
@@ -800,55 +9226,40 @@ int nar_sm_get_ld(nar_sm mat) {
     }
 }
 
-int nar_sm_get_rows(nar_sm mat) {
-    return mat->get_rows();
-}
-
-int nar_sm_get_cols(nar_sm mat) {
-    return mat->get_cols();
-}
-
-int nar_sm_eq(nar_sm mat1, nar_sm mat2) {
-    return (*mat1) == (*mat2);
+int nar_xm_inc_row(nar_xm mat) {
+    return mat->get_inc_row();
 }
 
-int nar_sm_assign(nar_sm mat1, nar_sm mat2) {
-    try {
-        mat1->assign(*mat2);
-        return 0;
-    } catch (const std::out_of_range& e) {
-        return 1;
-    }
+int nar_xm_inc_col(nar_xm mat) {
+    return mat->get_inc_col();
 }
 
-
-// Display strings
-char* nar_sm_display_string(nar_sm mat) {
-    return string_to_char(display_string(*mat));
+int nar_xm_get_rows(nar_xm mat) {
+    return mat->get_rows();
 }
 
-char* nar_sv_display_string(nar_sv v) {
-    return string_to_char(display_string(*v));
+int nar_xm_get_cols(nar_xm mat) {
+    return mat->get_cols();
 }
 // No bounds checking
-float nar_sv_get(nar_sv v, int i) {
+char nar_xv_get(nar_xv v, int i) {
     return (*v)[i];
 }
 
-void nar_sv_set(nar_sv v, int i, float x) {
+void nar_xv_set(nar_xv v, int i, char x) {
     (*v)[i] = x;
 }
 
-float nar_sm_get(nar_sm mat, int i, int j) {
+char nar_xm_get(nar_xm mat, int i, int j) {
     return (*mat)(i,j);
 }
 
-void nar_sm_set(nar_sm mat, int i, int j, float x) {
+void nar_xm_set(nar_xm mat, int i, int j, char x) {
     (*mat)(i,j) = x;
 }
 
 // Bounds-checked versions
-int nar_sv_get_safe(float* x, nar_sv v, int i) {
+int nar_xv_get_safe(char* x, nar_xv v, int i) {
     try {
         *x = v->at(i);
         return 0;
@@ -857,7 +9268,7 @@ int nar_sv_get_safe(float* x, nar_sv v, int i) {
     }
 }
 
-int nar_sv_set_safe(nar_sv v, int i, float x) {
+int nar_xv_set_safe(nar_xv v, int i, char x) {
     try {
         v->at(i) = x;
         return 0;
@@ -866,7 +9277,7 @@ int nar_sv_set_safe(nar_sv v, int i, float x) {
     }
 }
 
-int nar_sm_get_safe(float* x, nar_sm mat, int i, int j) {
+int nar_xm_get_safe(char* x, nar_xm mat, int i, int j) {
     try {
         *x = mat->at(i,j);
         return 0;
@@ -875,7 +9286,7 @@ int nar_sm_get_safe(float* x, nar_sm mat, int i, int j) {
     }
 }
 
-int nar_sm_set_safe(nar_sm mat, int i, int j, float x) {
+int nar_xm_set_safe(nar_xm mat, int i, int j, char x) {
     try {
         mat->at(i,j) = x;
         return 0;
@@ -883,70 +9294,130 @@ int nar_sm_set_safe(nar_sm mat, int i, int j, float x) {
         return 1;
     }
 }
+// Batched element access through caller buffers.
+// These are bounds-checked and return 1 if anything is out of range.
+// Ranges with start > end are out of range; empty ones do nothing.
 
-// Reads vector from file. If there's an error, puts error code in err.
-nar_sv nar_sv_read(const char* filename, int* err) {
+// Copies elements [start, end) to out
+int nar_xv_get_range(char* out, nar_xv v,
+    int start, int end) {
     try {
-        File<float> f(filename, ios_base::in);
-        nar_sv v = new Vector<float>(f.read_vector());
-        if (err) *err = 0;
-        return v;
-    } catch (const FileError& e) {
-        if (err) *err = 1;
-        return nullptr;
-    } catch (const FormatError& e) {
-        if (err) *err = 2;
-        return nullptr;
+        Vector<char> part = v->slice<true>(start, end);
+        strided_copy((char*) out, 1, 
+            part.pointer(), part.get_inc(), part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
     }
 }
 
-// Writes vector to file.
-int nar_sv_write(nar_sv v, const char* filename, const char* sep) {
+// Overwrites elements [start, end) with the contents of in
+int nar_xv_set_range(nar_xv v, int start, int end,
+    char const* in) {
     try {
-        File<float> f(filename, ios_base::out);
-        f.write_vector(*v, sep);
+        Vector<char> part = v->slice<true>(start, end);
+        strided_copy(part.pointer(), part.get_inc(), 
+            (char const*) in, 1, part.get_n());
         return 0;
-    } catch (const FileError& e) {
+    } catch (...) {
         return 1;
     }
 }
 
-// Reads MATRIX from file. If there's an error, puts error code in err.
-nar_sm nar_sm_read(const char* filename, int row_major, int* err) {
+// Copies the elements at idx[0..count) to out
+int nar_xv_gather(char* out, nar_xv v,
+    const int* idx, int count) {
     try {
-        File<float> f(filename, ios_base::in);
-        nar_sm v = new Matrix<float>(f.read_matrix(row_major));
-        if (err) *err = 0;
-        return v;
-    } catch (const FileError& e) {
-        if (err) *err = 1;
-        return nullptr;
-    } catch (const FormatError& e) {
-        if (err) *err = 2;
-        return nullptr;
+        v->gather<true>((char*) out, idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
     }
 }
 
-// Writes MATRIX to file.
-int nar_sm_write(nar_sm v, const char* filename, const char* sep) {
+// Writes in[0..count) to the elements at idx[0..count)
+int nar_xv_scatter(nar_xv v, const int* idx,
+    int count, char const* in) {
     try {
-        File<float> f(filename, ios_base::out);
-        f.write_matrix(*v, sep);
+        v->scatter<true>(idx, count, (char const*) in);
         return 0;
-    } catch (const FileError& e) {
+    } catch (...) {
         return 1;
     }
 }
 
+// Copies [start_row, end_row) x [start_col, end_col) to out,
+// which is packed in row major or column major order
+int nar_xm_get_block(char* out, nar_xm mat,
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major) {
+    try {
+        Matrix<char> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d((char*) out, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
 
+// Overwrites [start_row, end_row) x [start_col, end_col) with in,
+// which is packed in row major or column major order
+int nar_xm_set_block(nar_xm mat,
+    int start_row, int start_col, int end_row, int end_col,
+    char const* in, int row_major) {
+    try {
+        Matrix<char> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d(part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            (char const*) in, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
 
-// Reads vector from file. If there's an error, puts error code in err.
-nar_sv nar_sv_read_binary(const char* filename, int* err) {
+// Copies the elements at (rows_idx[k], cols_idx[k]) to out[k]
+int nar_xm_gather(char* out, nar_xm mat,
+    const int* rows_idx, const int* cols_idx, int count) {
     try {
-        BinaryFile<float> f(filename, ios_base::in);
-        nar_sv v = new Vector<float>(f.read_vector());
+        mat->gather<true>((char*) out, rows_idx, cols_idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Writes in[k] to the elements at (rows_idx[k], cols_idx[k])
+int nar_xm_scatter(nar_xm mat, const int* rows_idx,
+    const int* cols_idx, int count, char const* in) {
+    try {
+        mat->scatter<true>(rows_idx, cols_idx, count, (char const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// binary matrix file without reading the rest of it.
+// If there's an error, puts error code in err.
+nar_xm nar_xm_read_binary_subarray(const char* filename, 
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major, int* err) {
+    try {
+        BinaryFile<char> f(filename, ios_base::in);
+        nar_xm mat = new Matrix<char>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
         if (err) *err = 0;
-        return v;
+        return mat;
     } catch (const FileError& e) {
         if (err) *err = 1;
         return nullptr;
@@ -956,161 +9427,157 @@ nar_sv nar_sv_read_binary(const char* filename, int* err) {
     }
 }
 
-// Writes vector to file.
-int nar_sv_write_binary(nar_sv v, const char* filename) {
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// tiled matrix file, reading only the tiles they intersect.
+// If there's an error, puts error code in err.
+nar_xm nar_xm_read_tiled_subarray(const char* filename, 
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major, int* err) {
     try {
-        BinaryFile<float> f(filename, ios_base::out);
-        f.write_vector(*v);
-        return 0;
+        TiledFile<char> f(filename, ios_base::in);
+        nar_xm mat = new Matrix<char>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
     } catch (const FileError& e) {
-        return 1;
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
     }
 }
-
-// Reads MATRIX from file. If there's an error, puts error code in err.
-nar_sm nar_sm_read_binary(const char* filename, int row_major, int* err) {
+// Reads up to max_rows more rows, into a new view to free with
+// nar_xm_free. The view shares the reader's buffer, so the next
+// call overwrites its elements. Returns null at the end of the file, or
+// if there's an error, when it also puts the error code in err, as for
+// nar_xm_reader_open.
+nar_xm nar_xm_reader_next(nar_xm_reader reader, int max_rows, int* err) {
     try {
-        BinaryFile<float> f(filename, ios_base::in);
-        nar_sm v = new Matrix<float>(f.read_matrix(row_major));
+        const Matrix<char>& block = reader->next(
+            std::max<Index>(max_rows, 0));
         if (err) *err = 0;
-        return v;
+        if (block.get_rows() == 0 && max_rows > 0) {
+            return nullptr;
+        }
+        return new Matrix<char>(block);
     } catch (const FileError& e) {
         if (err) *err = 1;
         return nullptr;
     } catch (const FormatError& e) {
         if (err) *err = 2;
         return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
     }
 }
-
-// Writes MATRIX to file.
-int nar_sm_write_binary(nar_sm v, const char* filename) {
-    try {
-        BinaryFile<float> f(filename, ios_base::out);
-        f.write_matrix(*v);
-        return 0;
-    } catch (const FileError& e) {
-        return 1;
-    }
-}
-
-
-
 // Main routines for vectors and matrices of the given type
+// with int64_t sizes, indices and strides
 
-nar_dv nar_dv_alloc(int n) {
-    return new Vector<double>(n);
+nar_xv nar_xv_alloc_64(int64_t n) {
+    return new Vector<char>(n);
 }
 
-void nar_dv_free(nar_dv v) {
-    delete v;
+// Contents are unspecified until written
+nar_xv nar_xv_alloc_uninit_64(int64_t n) {
+    return new Vector<char>(n, uninitialized);
 }
 
-nar_dv nar_dv_copy(nar_dv v) {
-    return new Vector<double>(v->copy());
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_xv nar_xv_wrap_64(char* ptr, int64_t n, int64_t inc,
+    nar_release_fn release, void* ctx) {
+    return new Vector<char>(wrap_vector((char*) ptr, n, inc,
+        [release, ctx](char* p) { if (release) release(p, ctx); }));
 }
 
-int nar_dv_valid(nar_dv v, int i) {
+int nar_xv_valid_64(nar_xv v, int64_t i) {
     return v->in_range(i);
 }
 
-nar_dv nar_dv_slice(nar_dv v, int start, int end) {
-    return new Vector<double>(v->slice(start, end));
+nar_xv nar_xv_slice_64(nar_xv v, int64_t start, int64_t end) {
+    return new Vector<char>(v->slice(start, end));
 }
 
-int nar_dv_slice_safe(nar_dv* out, nar_dv v, int start, int end) {
+int nar_xv_slice_safe_64(nar_xv* out, nar_xv v, int64_t start, int64_t end) {
     try {
-        *out = new Vector<double>(v->slice<true>(start, end));
+        *out = new Vector<char>(v->slice<true>(start, end));
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-double* nar_dv_pointer(nar_dv v) {
-    return (double*) v->pointer();
-}
-
-int nar_dv_inc(nar_dv v) {
+int64_t nar_xv_inc_64(nar_xv v) {
     return v->get_inc();
 }
 
-int nar_dv_n(nar_dv v) {
+int64_t nar_xv_n_64(nar_xv v) {
     return v->get_n();
 }
 
-int nar_dv_eq(nar_dv v1, nar_dv v2) {
-    return (*v1) == (*v2);
-}
-
-int nar_dv_assign(nar_dv v1, nar_dv v2) {
-    try {
-        v1->assign(*v2);
-        return 0;
-    } catch (const std::out_of_range& e) {
-        return 1;
-    }
-}
-
 // For matrices
 
-nar_dm nar_dm_alloc(int rows, int cols, int row_major) {
-    return new Matrix<double>(rows, cols, row_major);
+nar_xm nar_xm_alloc_64(int64_t rows, int64_t cols, int row_major) {
+    return new Matrix<char>(rows, cols, row_major);
 }
 
-void nar_dm_free(nar_dm mat) {
-    delete mat;
+// Contents are unspecified until written
+nar_xm nar_xm_alloc_uninit_64(int64_t rows, int64_t cols, int row_major) {
+    return new Matrix<char>(rows, cols, row_major, uninitialized);
 }
 
-nar_dm nar_dm_copy(nar_dm mat) {
-    return new Matrix<double>(mat->copy());
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_xm nar_xm_wrap_64(char* ptr, int64_t rows, int64_t cols,
+    int64_t inc_row, int64_t inc_col, nar_release_fn release, void* ctx) {
+    return new Matrix<char>(wrap_matrix((char*) ptr, rows, cols,
+        inc_row, inc_col,
+        [release, ctx](char* p) { if (release) release(p, ctx); }));
 }
 
-int nar_dm_valid(nar_dm mat, int i, int j) {
+int nar_xm_valid_64(nar_xm mat, int64_t i, int64_t j) {
     return mat->in_range(i,j);
 }
 
-enum nar_order nar_dm_order(nar_dm mat) {
-    return (nar_order) mat->get_order();
-}
-
 // Slicing parts of matrix
-nar_dv nar_dm_row(nar_dm mat, int i) {
-    return new Vector<double>(mat->row(i));
+nar_xv nar_xm_row_64(nar_xm mat, int64_t i) {
+    return new Vector<char>(mat->row(i));
 }
 
-nar_dv nar_dm_col(nar_dm mat, int j) {
-    return new Vector<double>(mat->col(j));
+nar_xv nar_xm_col_64(nar_xm mat, int64_t j) {
+    return new Vector<char>(mat->col(j));
 }
 
-nar_dm nar_dm_subarray(nar_dm mat, int start_row,
-    int start_col, int end_row, int end_col) {
-    return new Matrix<double>(mat->subarray(
+nar_xm nar_xm_subarray_64(nar_xm mat, int64_t start_row,
+    int64_t start_col, int64_t end_row, int64_t end_col) {
+    return new Matrix<char>(mat->subarray(
         start_row, start_col, end_row, end_col));
 }
 
-int nar_dm_row_safe(nar_dv* x, nar_dm mat, int i) {
+int nar_xm_row_safe_64(nar_xv* x, nar_xm mat, int64_t i) {
     try {
-        *x = new Vector<double>(mat->row<true>(i));
+        *x = new Vector<char>(mat->row<true>(i));
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_dm_col_safe(nar_dv* x, nar_dm mat, int j) {
+int nar_xm_col_safe_64(nar_xv* x, nar_xm mat, int64_t j) {
     try {
-        *x = new Vector<double>(mat->col<true>(j));
+        *x = new Vector<char>(mat->col<true>(j));
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_dm_subarray_safe(nar_dm* x, nar_dm mat, int start_row,
-    int start_col, int end_row, int end_col) {
+int nar_xm_subarray_safe_64(nar_xm* x, nar_xm mat, int64_t start_row,
+    int64_t start_col, int64_t end_row, int64_t end_col) {
     try {
-        *x = new Matrix<double>(mat->subarray<true>(
+        *x = new Matrix<char>(mat->subarray<true>(
             start_row, start_col, end_row, end_col));
         return 0;
     } catch (...) {
@@ -1118,12 +9585,7 @@ int nar_dm_subarray_safe(nar_dm* x, nar_dm mat, int start_row,
     }
 }
 
-// Matrix attributes and dimensions
-double* nar_dm_pointer(nar_dm mat) {
-    return (double*) mat->pointer();
-}
-
-int nar_dm_get_ld(nar_dm mat) {
+int64_t nar_xm_get_ld_64(nar_xm mat) {
     try {
         return mat->get_ld();
     } catch (...) {
@@ -1131,95 +9593,258 @@ int nar_dm_get_ld(nar_dm mat) {
     }
 }
 
-int nar_dm_get_rows(nar_dm mat) {
+int64_t nar_xm_inc_row_64(nar_xm mat) {
+    return mat->get_inc_row();
+}
+
+int64_t nar_xm_inc_col_64(nar_xm mat) {
+    return mat->get_inc_col();
+}
+
+int64_t nar_xm_get_rows_64(nar_xm mat) {
     return mat->get_rows();
 }
 
-int nar_dm_get_cols(nar_dm mat) {
+int64_t nar_xm_get_cols_64(nar_xm mat) {
     return mat->get_cols();
 }
+// No bounds checking
+char nar_xv_get_64(nar_xv v, int64_t i) {
+    return (*v)[i];
+}
 
-int nar_dm_eq(nar_dm mat1, nar_dm mat2) {
-    return (*mat1) == (*mat2);
+void nar_xv_set_64(nar_xv v, int64_t i, char x) {
+    (*v)[i] = x;
 }
 
-int nar_dm_assign(nar_dm mat1, nar_dm mat2) {
+char nar_xm_get_64(nar_xm mat, int64_t i, int64_t j) {
+    return (*mat)(i,j);
+}
+
+void nar_xm_set_64(nar_xm mat, int64_t i, int64_t j, char x) {
+    (*mat)(i,j) = x;
+}
+
+// Bounds-checked versions
+int nar_xv_get_safe_64(char* x, nar_xv v, int64_t i) {
     try {
-        mat1->assign(*mat2);
+        *x = v->at(i);
         return 0;
-    } catch (const std::out_of_range& e) {
+    } catch (...) {
         return 1;
     }
 }
 
+int nar_xv_set_safe_64(nar_xv v, int64_t i, char x) {
+    try {
+        v->at(i) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
 
-// Display strings
-char* nar_dm_display_string(nar_dm mat) {
-    return string_to_char(display_string(*mat));
+int nar_xm_get_safe_64(char* x, nar_xm mat, int64_t i, int64_t j) {
+    try {
+        *x = mat->at(i,j);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
 
-char* nar_dv_display_string(nar_dv v) {
-    return string_to_char(display_string(*v));
+int nar_xm_set_safe_64(nar_xm mat, int64_t i, int64_t j, char x) {
+    try {
+        mat->at(i,j) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
-// No bounds checking
-double nar_dv_get(nar_dv v, int i) {
-    return (*v)[i];
+// Batched element access through caller buffers.
+// These are bounds-checked and return 1 if anything is out of range.
+// Ranges with start > end are out of range; empty ones do nothing.
+
+// Copies elements [start, end) to out
+int nar_xv_get_range_64(char* out, nar_xv v,
+    int64_t start, int64_t end) {
+    try {
+        Vector<char> part = v->slice<true>(start, end);
+        strided_copy((char*) out, 1, 
+            part.pointer(), part.get_inc(), part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
 
-void nar_dv_set(nar_dv v, int i, double x) {
-    (*v)[i] = x;
+// Overwrites elements [start, end) with the contents of in
+int nar_xv_set_range_64(nar_xv v, int64_t start, int64_t end,
+    char const* in) {
+    try {
+        Vector<char> part = v->slice<true>(start, end);
+        strided_copy(part.pointer(), part.get_inc(), 
+            (char const*) in, 1, part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
 
-double nar_dm_get(nar_dm mat, int i, int j) {
-    return (*mat)(i,j);
+// Copies the elements at idx[0..count) to out
+int nar_xv_gather_64(char* out, nar_xv v,
+    const int64_t* idx, int64_t count) {
+    try {
+        v->gather<true>((char*) out, idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
 
-void nar_dm_set(nar_dm mat, int i, int j, double x) {
-    (*mat)(i,j) = x;
+// Writes in[0..count) to the elements at idx[0..count)
+int nar_xv_scatter_64(nar_xv v, const int64_t* idx,
+    int64_t count, char const* in) {
+    try {
+        v->scatter<true>(idx, count, (char const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
 
-// Bounds-checked versions
-int nar_dv_get_safe(double* x, nar_dv v, int i) {
+// Copies [start_row, end_row) x [start_col, end_col) to out,
+// which is packed in row major or column major order
+int nar_xm_get_block_64(char* out, nar_xm mat,
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major) {
     try {
-        *x = v->at(i);
+        Matrix<char> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d((char*) out, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            rows, cols);
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_dv_set_safe(nar_dv v, int i, double x) {
+// Overwrites [start_row, end_row) x [start_col, end_col) with in,
+// which is packed in row major or column major order
+int nar_xm_set_block_64(nar_xm mat,
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    char const* in, int row_major) {
     try {
-        v->at(i) = x;
+        Matrix<char> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d(part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            (char const*) in, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            rows, cols);
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_dm_get_safe(double* x, nar_dm mat, int i, int j) {
+// Copies the elements at (rows_idx[k], cols_idx[k]) to out[k]
+int nar_xm_gather_64(char* out, nar_xm mat,
+    const int64_t* rows_idx, const int64_t* cols_idx, int64_t count) {
     try {
-        *x = mat->at(i,j);
+        mat->gather<true>((char*) out, rows_idx, cols_idx, count);
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_dm_set_safe(nar_dm mat, int i, int j, double x) {
+// Writes in[k] to the elements at (rows_idx[k], cols_idx[k])
+int nar_xm_scatter_64(nar_xm mat, const int64_t* rows_idx,
+    const int64_t* cols_idx, int64_t count, char const* in) {
     try {
-        mat->at(i,j) = x;
+        mat->scatter<true>(rows_idx, cols_idx, count, (char const*) in);
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// binary matrix file without reading the rest of it.
+// If there's an error, puts error code in err.
+nar_xm nar_xm_read_binary_subarray_64(const char* filename, 
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major, int* err) {
+    try {
+        BinaryFile<char> f(filename, ios_base::in);
+        nar_xm mat = new Matrix<char>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// tiled matrix file, reading only the tiles they intersect.
+// If there's an error, puts error code in err.
+nar_xm nar_xm_read_tiled_subarray_64(const char* filename, 
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major, int* err) {
+    try {
+        TiledFile<char> f(filename, ios_base::in);
+        nar_xm mat = new Matrix<char>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+// Reads up to max_rows more rows, into a new view to free with
+// nar_xm_free. The view shares the reader's buffer, so the next
+// call overwrites its elements. Returns null at the end of the file, or
+// if there's an error, when it also puts the error code in err, as for
+// nar_xm_reader_open.
+nar_xm nar_xm_reader_next_64(nar_xm_reader reader, int64_t max_rows, int* err) {
+    try {
+        const Matrix<char>& block = reader->next(
+            std::max<Index>(max_rows, 0));
+        if (err) *err = 0;
+        if (block.get_rows() == 0 && max_rows > 0) {
+            return nullptr;
+        }
+        return new Matrix<char>(block);
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
 // Reads vector from file. If there's an error, puts error code in err.
-nar_dv nar_dv_read(const char* filename, int* err) {
+nar_xv nar_xv_read(const char* filename, int* err) {
     try {
-        File<double> f(filename, ios_base::in);
-        nar_dv v = new Vector<double>(f.read_vector());
+        File<char> f(filename, ios_base::in);
+        nar_xv v = new Vector<char>(f.read_vector());
         if (err) *err = 0;
         return v;
     } catch (const FileError& e) {
@@ -1232,9 +9857,9 @@ nar_dv nar_dv_read(const char* filename, int* err) {
 }
 
 // Writes vector to file.
-int nar_dv_write(nar_dv v, const char* filename, const char* sep) {
+int nar_xv_write(nar_xv v, const char* filename, const char* sep) {
     try {
-        File<double> f(filename, ios_base::out);
+        File<char> f(filename, ios_base::out);
         f.write_vector(*v, sep);
         return 0;
     } catch (const FileError& e) {
@@ -1243,10 +9868,10 @@ int nar_dv_write(nar_dv v, const char* filename, const char* sep) {
 }
 
 // Reads MATRIX from file. If there's an error, puts error code in err.
-nar_dm nar_dm_read(const char* filename, int row_major, int* err) {
+nar_xm nar_xm_read(const char* filename, int row_major, int* err) {
     try {
-        File<double> f(filename, ios_base::in);
-        nar_dm v = new Matrix<double>(f.read_matrix(row_major));
+        File<char> f(filename, ios_base::in);
+        nar_xm v = new Matrix<char>(f.read_matrix(row_major));
         if (err) *err = 0;
         return v;
     } catch (const FileError& e) {
@@ -1258,11 +9883,110 @@ nar_dm nar_dm_read(const char* filename, int row_major, int* err) {
     }
 }
 
-// Writes MATRIX to file.
-int nar_dm_write(nar_dm v, const char* filename, const char* sep) {
+// Writes MATRIX to file.
+int nar_xm_write(nar_xm v, const char* filename, const char* sep) {
+    try {
+        File<char> f(filename, ios_base::out);
+        f.write_matrix(*v, sep);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+
+// Reads vector from file into dest, reusing its memory. The file must
+// hold a vector of dest's length. Returns the error code.
+int nar_xv_read_into(nar_xv dest, const char* filename) {
+    try {
+        File<char> f(filename, ios_base::in);
+        f.read_vector_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Reads matrix from file into dest, reusing its memory. The file must
+// hold a matrix of dest's dimensions. Returns the error code.
+int nar_xm_read_into(nar_xm dest, const char* filename) {
+    try {
+        File<char> f(filename, ios_base::in);
+        f.read_matrix_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Starts reading vector from file on the I/O threads.
+// nar_future_wait returns the vector and error code.
+nar_future nar_xv_read_async(const char* filename) {
+    std::string name(filename);
+    return start_async([name]() {
+        int err;
+        void* v = nar_xv_read(name.c_str(), &err);
+        return Future::Result(v, err);
+    });
+}
+
+// Starts writing vector to file on the I/O threads. v mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_xv_write_async(nar_xv v, const char* filename, const char* sep) {
+    std::string name(filename);
+    std::string separator(sep);
+    return start_async([=]() {
+        int status = nar_xv_write(v, name.c_str(), separator.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Starts reading matrix from file on the I/O threads.
+// nar_future_wait returns the matrix and error code.
+nar_future nar_xm_read_async(const char* filename, int row_major) {
+    std::string name(filename);
+    return start_async([name, row_major]() {
+        int err;
+        void* mat = nar_xm_read(name.c_str(), row_major, &err);
+        return Future::Result(mat, err);
+    });
+}
+
+// Starts writing matrix to file on the I/O threads. mat mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_xm_write_async(nar_xm mat, const char* filename, const char* sep) {
+    std::string name(filename);
+    std::string separator(sep);
+    return start_async([=]() {
+        int status = nar_xm_write(mat, name.c_str(), separator.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Writes vector to file with precision significant digits for floating
+// point values, or NAR_PRECISION_SHORTEST for the fewest that read back
+// exactly.
+int nar_xv_write_precision(nar_xv v, const char* filename, const char* sep, int precision) {
+    try {
+        File<char> f(filename, ios_base::out);
+        f.write_vector(*v, sep, precision);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Writes matrix to file with precision significant digits for floating
+// point values, or NAR_PRECISION_SHORTEST for the fewest that read back
+// exactly.
+int nar_xm_write_precision(nar_xm v, const char* filename, const char* sep, int precision) {
     try {
-        File<double> f(filename, ios_base::out);
-        f.write_matrix(*v, sep);
+        File<char> f(filename, ios_base::out);
+        f.write_matrix(*v, sep, precision);
         return 0;
     } catch (const FileError& e) {
         return 1;
@@ -1270,12 +9994,11 @@ int nar_dm_write(nar_dm v, const char* filename, const char* sep) {
 }
 
 
-
 // Reads vector from file. If there's an error, puts error code in err.
-nar_dv nar_dv_read_binary(const char* filename, int* err) {
+nar_xv nar_xv_read_binary(const char* filename, int* err) {
     try {
-        BinaryFile<double> f(filename, ios_base::in);
-        nar_dv v = new Vector<double>(f.read_vector());
+        BinaryFile<char> f(filename, ios_base::in);
+        nar_xv v = new Vector<char>(f.read_vector());
         if (err) *err = 0;
         return v;
     } catch (const FileError& e) {
@@ -1288,9 +10011,9 @@ nar_dv nar_dv_read_binary(const char* filename, int* err) {
 }
 
 // Writes vector to file.
-int nar_dv_write_binary(nar_dv v, const char* filename) {
+int nar_xv_write_binary(nar_xv v, const char* filename) {
     try {
-        BinaryFile<double> f(filename, ios_base::out);
+        BinaryFile<char> f(filename, ios_base::out);
         f.write_vector(*v);
         return 0;
     } catch (const FileError& e) {
@@ -1299,10 +10022,10 @@ int nar_dv_write_binary(nar_dv v, const char* filename) {
 }
 
 // Reads MATRIX from file. If there's an error, puts error code in err.
-nar_dm nar_dm_read_binary(const char* filename, int row_major, int* err) {
+nar_xm nar_xm_read_binary(const char* filename, int row_major, int* err) {
     try {
-        BinaryFile<double> f(filename, ios_base::in);
-        nar_dm v = new Matrix<double>(f.read_matrix(row_major));
+        BinaryFile<char> f(filename, ios_base::in);
+        nar_xm v = new Matrix<char>(f.read_matrix(row_major));
         if (err) *err = 0;
         return v;
     } catch (const FileError& e) {
@@ -1315,9 +10038,9 @@ nar_dm nar_dm_read_binary(const char* filename, int row_major, int* err) {
 }
 
 // Writes MATRIX to file.
-int nar_dm_write_binary(nar_dm v, const char* filename) {
+int nar_xm_write_binary(nar_xm v, const char* filename) {
     try {
-        BinaryFile<double> f(filename, ios_base::out);
+        BinaryFile<char> f(filename, ios_base::out);
         f.write_matrix(*v);
         return 0;
     } catch (const FileError& e) {
@@ -1326,240 +10049,323 @@ int nar_dm_write_binary(nar_dm v, const char* filename) {
 }
 
 
-
-// Main routines for vectors and matrices of the given type
-
-nar_cv nar_cv_alloc(int n) {
-    return new Vector<std::complex<float>>(n);
-}
-
-void nar_cv_free(nar_cv v) {
-    delete v;
-}
-
-nar_cv nar_cv_copy(nar_cv v) {
-    return new Vector<std::complex<float>>(v->copy());
-}
-
-int nar_cv_valid(nar_cv v, int i) {
-    return v->in_range(i);
-}
-
-nar_cv nar_cv_slice(nar_cv v, int start, int end) {
-    return new Vector<std::complex<float>>(v->slice(start, end));
-}
-
-int nar_cv_slice_safe(nar_cv* out, nar_cv v, int start, int end) {
+// Reads vector from file into dest, reusing its memory. The file must
+// hold a vector of dest's length. Returns the error code.
+int nar_xv_read_binary_into(nar_xv dest, const char* filename) {
     try {
-        *out = new Vector<std::complex<float>>(v->slice<true>(start, end));
+        BinaryFile<char> f(filename, ios_base::in);
+        f.read_vector_into(*dest);
         return 0;
-    } catch (...) {
+    } catch (const FileError& e) {
         return 1;
+    } catch (const FormatError& e) {
+        return 2;
     }
 }
 
-float* nar_cv_pointer(nar_cv v) {
-    return (float*) v->pointer();
-}
-
-int nar_cv_inc(nar_cv v) {
-    return v->get_inc();
-}
-
-int nar_cv_n(nar_cv v) {
-    return v->get_n();
-}
-
-int nar_cv_eq(nar_cv v1, nar_cv v2) {
-    return (*v1) == (*v2);
-}
-
-int nar_cv_assign(nar_cv v1, nar_cv v2) {
+// Reads matrix from file into dest, reusing its memory. The file must
+// hold a matrix of dest's dimensions. Returns the error code.
+int nar_xm_read_binary_into(nar_xm dest, const char* filename) {
     try {
-        v1->assign(*v2);
+        BinaryFile<char> f(filename, ios_base::in);
+        f.read_matrix_into(*dest);
         return 0;
-    } catch (const std::out_of_range& e) {
+    } catch (const FileError& e) {
         return 1;
+    } catch (const FormatError& e) {
+        return 2;
     }
 }
 
-// For matrices
-
-nar_cm nar_cm_alloc(int rows, int cols, int row_major) {
-    return new Matrix<std::complex<float>>(rows, cols, row_major);
-}
-
-void nar_cm_free(nar_cm mat) {
-    delete mat;
-}
-
-nar_cm nar_cm_copy(nar_cm mat) {
-    return new Matrix<std::complex<float>>(mat->copy());
-}
-
-int nar_cm_valid(nar_cm mat, int i, int j) {
-    return mat->in_range(i,j);
+// Starts reading vector from file on the I/O threads.
+// nar_future_wait returns the vector and error code.
+nar_future nar_xv_read_binary_async(const char* filename) {
+    std::string name(filename);
+    return start_async([name]() {
+        int err;
+        void* v = nar_xv_read_binary(name.c_str(), &err);
+        return Future::Result(v, err);
+    });
 }
 
-enum nar_order nar_cm_order(nar_cm mat) {
-    return (nar_order) mat->get_order();
+// Starts writing vector to file on the I/O threads. v mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_xv_write_binary_async(nar_xv v, const char* filename) {
+    std::string name(filename);
+    return start_async([=]() {
+        int status = nar_xv_write_binary(v, name.c_str());
+        return Future::Result(nullptr, status);
+    });
 }
 
-// Slicing parts of matrix
-nar_cv nar_cm_row(nar_cm mat, int i) {
-    return new Vector<std::complex<float>>(mat->row(i));
+// Starts reading matrix from file on the I/O threads.
+// nar_future_wait returns the matrix and error code.
+nar_future nar_xm_read_binary_async(const char* filename, int row_major) {
+    std::string name(filename);
+    return start_async([name, row_major]() {
+        int err;
+        void* mat = nar_xm_read_binary(name.c_str(), row_major, &err);
+        return Future::Result(mat, err);
+    });
 }
 
-nar_cv nar_cm_col(nar_cm mat, int j) {
-    return new Vector<std::complex<float>>(mat->col(j));
+// Starts writing matrix to file on the I/O threads. mat mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_xm_write_binary_async(nar_xm mat, const char* filename) {
+    std::string name(filename);
+    return start_async([=]() {
+        int status = nar_xm_write_binary(mat, name.c_str());
+        return Future::Result(nullptr, status);
+    });
 }
 
-nar_cm nar_cm_subarray(nar_cm mat, int start_row,
-    int start_col, int end_row, int end_col) {
-    return new Matrix<std::complex<float>>(mat->subarray(
-        start_row, start_col, end_row, end_col));
+// Maps a binary file written by nar_xv_write_binary into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_xv nar_xv_mmap(const char* filename, enum nar_map_mode mode, int* err) {
+    try {
+        BinaryFile<char> f(filename, ios_base::in);
+        nar_xv v = new Vector<char>(f.map_vector((MapMode) mode));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
 }
 
-int nar_cm_row_safe(nar_cv* x, nar_cm mat, int i) {
+// Maps a binary file written by nar_xm_write_binary into memory.
+// The matrix has the order it was stored in, so column major matrices
+// map as column major. The file stays mapped until the last view of it
+// is freed. If there's an error, puts error code in err.
+nar_xm nar_xm_mmap(const char* filename, enum nar_map_mode mode, int* err) {
     try {
-        *x = new Vector<std::complex<float>>(mat->row<true>(i));
-        return 0;
-    } catch (...) {
-        return 1;
+        BinaryFile<char> f(filename, ios_base::in);
+        nar_xm mat = new Matrix<char>(f.map_matrix((MapMode) mode));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
     }
 }
 
-int nar_cm_col_safe(nar_cv* x, nar_cm mat, int j) {
+// Writes vector to a binary file, compressed in chunks.
+// nar_xv_read_binary reads it back.
+int nar_xv_write_binary_compressed(nar_xv v, const char* filename) {
     try {
-        *x = new Vector<std::complex<float>>(mat->col<true>(j));
+        BinaryFile<char> f(filename, ios_base::out);
+        f.set_compressed(true);
+        f.write_vector(*v);
         return 0;
-    } catch (...) {
+    } catch (const FileError& e) {
         return 1;
     }
 }
 
-int nar_cm_subarray_safe(nar_cm* x, nar_cm mat, int start_row,
-    int start_col, int end_row, int end_col) {
+// Writes matrix to a binary file, compressed in chunks.
+// nar_xm_read_binary reads it back.
+int nar_xm_write_binary_compressed(nar_xm mat, const char* filename) {
     try {
-        *x = new Matrix<std::complex<float>>(mat->subarray<true>(
-            start_row, start_col, end_row, end_col));
+        BinaryFile<char> f(filename, ios_base::out);
+        f.set_compressed(true);
+        f.write_matrix(*mat);
         return 0;
-    } catch (...) {
+    } catch (const FileError& e) {
         return 1;
     }
 }
 
-// Matrix attributes and dimensions
-float* nar_cm_pointer(nar_cm mat) {
-    return (float*) mat->pointer();
-}
-
-int nar_cm_get_ld(nar_cm mat) {
+// Reads a 1D array from a NumPy .npy file.
+// If there's an error, puts error code in err.
+nar_xv nar_xv_read_npy(const char* filename, int* err) {
     try {
-        return mat->get_ld();
-    } catch (...) {
-        return -1; // Not contiguously ordered
+        NpyFile<char> f(filename, ios_base::in);
+        nar_xv v = new Vector<char>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
     }
 }
 
-int nar_cm_get_rows(nar_cm mat) {
-    return mat->get_rows();
-}
-
-int nar_cm_get_cols(nar_cm mat) {
-    return mat->get_cols();
-}
-
-int nar_cm_eq(nar_cm mat1, nar_cm mat2) {
-    return (*mat1) == (*mat2);
+// Reads the named 1D array from an uncompressed NumPy .npz archive.
+// If there's an error, puts error code in err.
+nar_xv nar_xv_read_npz(const char* filename, const char* name, int* err) {
+    try {
+        NpyFile<char> f(filename, ios_base::in);
+        nar_xv v = new Vector<char>(
+            f.read_vector(f.find_entry(name)));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
 }
 
-int nar_cm_assign(nar_cm mat1, nar_cm mat2) {
+// Writes vector to a NumPy .npy file.
+int nar_xv_write_npy(nar_xv v, const char* filename) {
     try {
-        mat1->assign(*mat2);
+        NpyFile<char> f(filename, ios_base::out);
+        f.write_vector(*v);
         return 0;
-    } catch (const std::out_of_range& e) {
+    } catch (const FileError& e) {
         return 1;
     }
 }
 
-
-// Display strings
-char* nar_cm_display_string(nar_cm mat) {
-    return string_to_char(display_string(*mat));
-}
-
-char* nar_cv_display_string(nar_cv v) {
-    return string_to_char(display_string(*v));
-}
-// No bounds checking
-// For complex numbers in the form a + bI
-void nar_cv_get(float* a, float* b, nar_cv v, int i) {
-    std::complex<float> z = (*v)[i];
-    *a = z.real();
-    *b = z.imag();
+// Reads a 2D array from a NumPy .npy file. Fortran order arrays become
+// column major matrices. If there's an error, puts error code in err.
+nar_xm nar_xm_read_npy(const char* filename, int* err) {
+    try {
+        NpyFile<char> f(filename, ios_base::in);
+        nar_xm mat = new Matrix<char>(f.read_matrix());
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
 }
 
-void nar_cv_set(nar_cv v, int i, float a, float b) {
-    (*v)[i] = std::complex<float>(a,b);
+// Reads the named 2D array from an uncompressed NumPy .npz archive.
+// If there's an error, puts error code in err.
+nar_xm nar_xm_read_npz(const char* filename, const char* name, int* err) {
+    try {
+        NpyFile<char> f(filename, ios_base::in);
+        nar_xm mat = new Matrix<char>(
+            f.read_matrix(f.find_entry(name)));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
 }
 
-void nar_cm_get(float* a, float* b, nar_cm mat, int i, int j) {
-    std::complex<float> z = (*mat)(i,j);
-    *a = z.real();
-    *b = z.imag();
+// Writes matrix to a NumPy .npy file. Column major matrices
+// are written in Fortran order.
+int nar_xm_write_npy(nar_xm mat, const char* filename) {
+    try {
+        NpyFile<char> f(filename, ios_base::out);
+        f.write_matrix(*mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
 }
 
-void nar_cm_set(nar_cm mat, int i, int j, float a, float b) {
-    mat->operator()(i,j) = std::complex<float>(a,b);
+// Opens a text matrix file for reading a block of rows at a time.
+// If there's an error, puts error code in err: 1 if the file can't be
+// read, 2 if it's malformed and 3 for anything else, such as running
+// out of memory.
+nar_xm_reader nar_xm_reader_open(const char* filename, int* err) {
+    try {
+        nar_xm_reader reader = 
+            new MatrixReader<char>(filename, false);
+        if (err) *err = 0;
+        return reader;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
 }
 
-// Bounds-checked versions
-int nar_cv_get_safe(float* a, float* b, nar_cv v, int i) {
+// Opens a binary matrix file for reading a block of rows at a time.
+// If there's an error, puts error code in err, as for
+// nar_xm_reader_open.
+nar_xm_reader nar_xm_reader_open_binary(const char* filename, int* err) {
     try {
-        std::complex<float> z = v->at(i);
-        *a = z.real();
-        *b = z.imag();
-        return 0;
+        nar_xm_reader reader = 
+            new MatrixReader<char>(filename, true);
+        if (err) *err = 0;
+        return reader;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
     } catch (...) {
-        return 1;
+        if (err) *err = 3;
+        return nullptr;
     }
 }
 
-int nar_cv_set_safe(nar_cv v, int i, float a, float b) {
+void nar_xm_reader_close(nar_xm_reader reader) {
+    delete reader;
+}
+
+// Reads a matrix from a tiled file. If there's an error, puts error code in err.
+nar_xm nar_xm_read_tiled(const char* filename, int row_major, int* err) {
     try {
-        v->at(i) = std::complex<float>(a,b);
-        return 0;
-    } catch (...) {
-        return 1;
+        TiledFile<char> f(filename, ios_base::in);
+        nar_xm mat = new Matrix<char>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
     }
 }
 
-int nar_cm_get_safe(float* a, float* b, nar_cm mat, int i, int j) {
+// Writes matrix to a file as tiles of tile_rows x tile_cols elements.
+// Tile sizes of 0 use the default of 256.
+int nar_xm_write_tiled(nar_xm mat, const char* filename, int tile_rows, int tile_cols) {
     try {
-        std::complex<float> z = mat->at(i,j);
-        *a = z.real();
-        *b = z.imag();
+        TiledFile<char> f(filename, ios_base::out);
+        f.write_matrix(*mat, tile_rows, tile_cols);
         return 0;
-    } catch (...) {
+    } catch (const FileError& e) {
         return 1;
     }
 }
 
-int nar_cm_set_safe(nar_cm mat, int i, int j, float a, float b) {
+// Adds vector to archive under name, replacing any entry with that name.
+int nar_xv_archive_put(nar_archive archive, const char* name, nar_xv v) {
     try {
-        mat->at(i,j) = std::complex<float>(a,b);
+        archive->put(name, *v);
         return 0;
-    } catch (...) {
+    } catch (const FileError& e) {
         return 1;
     }
 }
 
-// Reads vector from file. If there's an error, puts error code in err.
-nar_cv nar_cv_read(const char* filename, int* err) {
+// Reads the named vector from archive.
+// If there's an error, puts error code in err.
+nar_xv nar_xv_archive_get(nar_archive archive, const char* name, int* err) {
     try {
-        File<std::complex<float>> f(filename, ios_base::in);
-        nar_cv v = new Vector<std::complex<float>>(f.read_vector());
+        nar_xv v = new Vector<char>(
+            archive->get_vector<char>(name));
         if (err) *err = 0;
         return v;
     } catch (const FileError& e) {
@@ -1571,22 +10377,13 @@ nar_cv nar_cv_read(const char* filename, int* err) {
     }
 }
 
-// Writes vector to file.
-int nar_cv_write(nar_cv v, const char* filename, const char* sep) {
-    try {
-        File<std::complex<float>> f(filename, ios_base::out);
-        f.write_vector(*v, sep);
-        return 0;
-    } catch (const FileError& e) {
-        return 1;
-    }
-}
-
-// Reads MATRIX from file. If there's an error, puts error code in err.
-nar_cm nar_cm_read(const char* filename, int row_major, int* err) {
+// Maps the named vector from archive into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_xv nar_xv_archive_map(nar_archive archive, const char* name, enum nar_map_mode mode, int* err) {
     try {
-        File<std::complex<float>> f(filename, ios_base::in);
-        nar_cm v = new Matrix<std::complex<float>>(f.read_matrix(row_major));
+        nar_xv v = new Vector<char>(
+            archive->map_vector<char>(name, (MapMode) mode));
         if (err) *err = 0;
         return v;
     } catch (const FileError& e) {
@@ -1598,26 +10395,24 @@ nar_cm nar_cm_read(const char* filename, int row_major, int* err) {
     }
 }
 
-// Writes MATRIX to file.
-int nar_cm_write(nar_cm v, const char* filename, const char* sep) {
+// Adds matrix to archive under name, replacing any entry with that name.
+int nar_xm_archive_put(nar_archive archive, const char* name, nar_xm mat) {
     try {
-        File<std::complex<float>> f(filename, ios_base::out);
-        f.write_matrix(*v, sep);
+        archive->put(name, *mat);
         return 0;
     } catch (const FileError& e) {
         return 1;
     }
 }
 
-
-
-// Reads vector from file. If there's an error, puts error code in err.
-nar_cv nar_cv_read_binary(const char* filename, int* err) {
+// Reads the named matrix from archive, in the order it was stored in.
+// If there's an error, puts error code in err.
+nar_xm nar_xm_archive_get(nar_archive archive, const char* name, int* err) {
     try {
-        BinaryFile<std::complex<float>> f(filename, ios_base::in);
-        nar_cv v = new Vector<std::complex<float>>(f.read_vector());
+        nar_xm mat = new Matrix<char>(
+            archive->get_matrix<char>(name));
         if (err) *err = 0;
-        return v;
+        return mat;
     } catch (const FileError& e) {
         if (err) *err = 1;
         return nullptr;
@@ -1627,24 +10422,15 @@ nar_cv nar_cv_read_binary(const char* filename, int* err) {
     }
 }
 
-// Writes vector to file.
-int nar_cv_write_binary(nar_cv v, const char* filename) {
-    try {
-        BinaryFile<std::complex<float>> f(filename, ios_base::out);
-        f.write_vector(*v);
-        return 0;
-    } catch (const FileError& e) {
-        return 1;
-    }
-}
-
-// Reads MATRIX from file. If there's an error, puts error code in err.
-nar_cm nar_cm_read_binary(const char* filename, int row_major, int* err) {
+// Maps the named matrix from archive into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_xm nar_xm_archive_map(nar_archive archive, const char* name, enum nar_map_mode mode, int* err) {
     try {
-        BinaryFile<std::complex<float>> f(filename, ios_base::in);
-        nar_cm v = new Matrix<std::complex<float>>(f.read_matrix(row_major));
+        nar_xm mat = new Matrix<char>(
+            archive->map_matrix<char>(name, (MapMode) mode));
         if (err) *err = 0;
-        return v;
+        return mat;
     } catch (const FileError& e) {
         if (err) *err = 1;
         return nullptr;
@@ -1654,134 +10440,203 @@ nar_cm nar_cm_read_binary(const char* filename, int row_major, int* err) {
     }
 }
 
-// Writes MATRIX to file.
-int nar_cm_write_binary(nar_cm v, const char* filename) {
+
+// Routines for vectors and matrices of the given type
+// that don't depend on the index type
+
+void nar_pv_free(nar_pv v) {
+    delete v;
+}
+
+nar_pv nar_pv_copy(nar_pv v) {
+    return new Vector<void*>(v->copy());
+}
+
+void** nar_pv_pointer(nar_pv v) {
+    return (void**) v->pointer();
+}
+
+// Fills out with the data pointer, dimensions and strides of v
+void nar_pv_describe(nar_pv v, struct nar_view* out) {
+    out->data = v->pointer();
+    out->n = v->get_n();
+    out->rows = v->get_n();
+    out->cols = 1;
+    out->inc = v->get_inc();
+    out->inc_row = v->get_inc();
+    out->inc_col = 0;
+    out->dtype = TypeCode<void*>::value;
+}
+
+int nar_pv_eq(nar_pv v1, nar_pv v2) {
+    return (*v1) == (*v2);
+}
+
+int nar_pv_assign(nar_pv v1, nar_pv v2) {
     try {
-        BinaryFile<std::complex<float>> f(filename, ios_base::out);
-        f.write_matrix(*v);
+        v1->assign(*v2);
         return 0;
-    } catch (const FileError& e) {
+    } catch (const std::out_of_range& e) {
         return 1;
     }
 }
 
+void nar_pm_free(nar_pm mat) {
+    delete mat;
+}
 
-
-// Main routines for vectors and matrices of the given type
-
-nar_zv nar_zv_alloc(int n) {
-    return new Vector<std::complex<double>>(n);
+nar_pm nar_pm_copy(nar_pm mat) {
+    return new Matrix<void*>(mat->copy());
 }
 
-void nar_zv_free(nar_zv v) {
-    delete v;
+enum nar_order nar_pm_order(nar_pm mat) {
+    return (nar_order) mat->get_order();
 }
 
-nar_zv nar_zv_copy(nar_zv v) {
-    return new Vector<std::complex<double>>(v->copy());
+void** nar_pm_pointer(nar_pm mat) {
+    return (void**) mat->pointer();
 }
 
-int nar_zv_valid(nar_zv v, int i) {
-    return v->in_range(i);
+// Fills out with the data pointer, dimensions and strides of mat
+void nar_pm_describe(nar_pm mat, struct nar_view* out) {
+    out->data = mat->pointer();
+    out->n = mat->get_rows() * mat->get_cols();
+    out->rows = mat->get_rows();
+    out->cols = mat->get_cols();
+    out->inc = 0;
+    out->inc_row = mat->get_inc_row();
+    out->inc_col = mat->get_inc_col();
+    out->dtype = TypeCode<void*>::value;
 }
 
-nar_zv nar_zv_slice(nar_zv v, int start, int end) {
-    return new Vector<std::complex<double>>(v->slice(start, end));
+int nar_pm_eq(nar_pm mat1, nar_pm mat2) {
+    return (*mat1) == (*mat2);
 }
 
-int nar_zv_slice_safe(nar_zv* out, nar_zv v, int start, int end) {
+int nar_pm_assign(nar_pm mat1, nar_pm mat2) {
     try {
-        *out = new Vector<std::complex<double>>(v->slice<true>(start, end));
+        mat1->assign(*mat2);
         return 0;
-    } catch (...) {
+    } catch (const std::out_of_range& e) {
         return 1;
     }
 }
 
-double* nar_zv_pointer(nar_zv v) {
-    return (double*) v->pointer();
+// Display strings
+char* nar_pm_display_string(nar_pm mat) {
+    return string_to_char(display_string(*mat));
 }
 
-int nar_zv_inc(nar_zv v) {
-    return v->get_inc();
+char* nar_pv_display_string(nar_pv v) {
+    return string_to_char(display_string(*v));
 }
 
-int nar_zv_n(nar_zv v) {
-    return v->get_n();
+// Main routines for vectors and matrices of the given type
+// with int sizes, indices and strides
+
+nar_pv nar_pv_alloc(int n) {
+    return new Vector<void*>(n);
 }
 
-int nar_zv_eq(nar_zv v1, nar_zv v2) {
-    return (*v1) == (*v2);
+// Contents are unspecified until written
+nar_pv nar_pv_alloc_uninit(int n) {
+    return new Vector<void*>(n, uninitialized);
 }
 
-int nar_zv_assign(nar_zv v1, nar_zv v2) {
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_pv nar_pv_wrap(void** ptr, int n, int inc,
+    nar_release_fn release, void* ctx) {
+    return new Vector<void*>(wrap_vector((void**) ptr, n, inc,
+        [release, ctx](void** p) { if (release) release(p, ctx); }));
+}
+
+int nar_pv_valid(nar_pv v, int i) {
+    return v->in_range(i);
+}
+
+nar_pv nar_pv_slice(nar_pv v, int start, int end) {
+    return new Vector<void*>(v->slice(start, end));
+}
+
+int nar_pv_slice_safe(nar_pv* out, nar_pv v, int start, int end) {
     try {
-        v1->assign(*v2);
+        *out = new Vector<void*>(v->slice<true>(start, end));
         return 0;
-    } catch (const std::out_of_range& e) {
+    } catch (...) {
         return 1;
     }
 }
 
-// For matrices
+int nar_pv_inc(nar_pv v) {
+    return v->get_inc();
+}
 
-nar_zm nar_zm_alloc(int rows, int cols, int row_major) {
-    return new Matrix<std::complex<double>>(rows, cols, row_major);
+int nar_pv_n(nar_pv v) {
+    return v->get_n();
 }
 
-void nar_zm_free(nar_zm mat) {
-    delete mat;
+// For matrices
+
+nar_pm nar_pm_alloc(int rows, int cols, int row_major) {
+    return new Matrix<void*>(rows, cols, row_major);
 }
 
-nar_zm nar_zm_copy(nar_zm mat) {
-    return new Matrix<std::complex<double>>(mat->copy());
+// Contents are unspecified until written
+nar_pm nar_pm_alloc_uninit(int rows, int cols, int row_major) {
+    return new Matrix<void*>(rows, cols, row_major, uninitialized);
 }
 
-int nar_zm_valid(nar_zm mat, int i, int j) {
-    return mat->in_range(i,j);
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_pm nar_pm_wrap(void** ptr, int rows, int cols,
+    int inc_row, int inc_col, nar_release_fn release, void* ctx) {
+    return new Matrix<void*>(wrap_matrix((void**) ptr, rows, cols,
+        inc_row, inc_col,
+        [release, ctx](void** p) { if (release) release(p, ctx); }));
 }
 
-enum nar_order nar_zm_order(nar_zm mat) {
-    return (nar_order) mat->get_order();
+int nar_pm_valid(nar_pm mat, int i, int j) {
+    return mat->in_range(i,j);
 }
 
 // Slicing parts of matrix
-nar_zv nar_zm_row(nar_zm mat, int i) {
-    return new Vector<std::complex<double>>(mat->row(i));
+nar_pv nar_pm_row(nar_pm mat, int i) {
+    return new Vector<void*>(mat->row(i));
 }
 
-nar_zv nar_zm_col(nar_zm mat, int j) {
-    return new Vector<std::complex<double>>(mat->col(j));
+nar_pv nar_pm_col(nar_pm mat, int j) {
+    return new Vector<void*>(mat->col(j));
 }
 
-nar_zm nar_zm_subarray(nar_zm mat, int start_row,
+nar_pm nar_pm_subarray(nar_pm mat, int start_row,
     int start_col, int end_row, int end_col) {
-    return new Matrix<std::complex<double>>(mat->subarray(
+    return new Matrix<void*>(mat->subarray(
         start_row, start_col, end_row, end_col));
 }
 
-int nar_zm_row_safe(nar_zv* x, nar_zm mat, int i) {
+int nar_pm_row_safe(nar_pv* x, nar_pm mat, int i) {
     try {
-        *x = new Vector<std::complex<double>>(mat->row<true>(i));
+        *x = new Vector<void*>(mat->row<true>(i));
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_zm_col_safe(nar_zv* x, nar_zm mat, int j) {
+int nar_pm_col_safe(nar_pv* x, nar_pm mat, int j) {
     try {
-        *x = new Vector<std::complex<double>>(mat->col<true>(j));
+        *x = new Vector<void*>(mat->col<true>(j));
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_zm_subarray_safe(nar_zm* x, nar_zm mat, int start_row,
+int nar_pm_subarray_safe(nar_pm* x, nar_pm mat, int start_row,
     int start_col, int end_row, int end_col) {
     try {
-        *x = new Matrix<std::complex<double>>(mat->subarray<true>(
+        *x = new Matrix<void*>(mat->subarray<true>(
             start_row, start_col, end_row, end_col));
         return 0;
     } catch (...) {
@@ -1789,12 +10644,7 @@ int nar_zm_subarray_safe(nar_zm* x, nar_zm mat, int start_row,
     }
 }
 
-// Matrix attributes and dimensions
-double* nar_zm_pointer(nar_zm mat) {
-    return (double*) mat->pointer();
-}
-
-int nar_zm_get_ld(nar_zm mat) {
+int nar_pm_get_ld(nar_pm mat) {
     try {
         return mat->get_ld();
     } catch (...) {
@@ -1802,162 +10652,198 @@ int nar_zm_get_ld(nar_zm mat) {
     }
 }
 
-int nar_zm_get_rows(nar_zm mat) {
-    return mat->get_rows();
+int nar_pm_inc_row(nar_pm mat) {
+    return mat->get_inc_row();
 }
 
-int nar_zm_get_cols(nar_zm mat) {
-    return mat->get_cols();
+int nar_pm_inc_col(nar_pm mat) {
+    return mat->get_inc_col();
 }
 
-int nar_zm_eq(nar_zm mat1, nar_zm mat2) {
-    return (*mat1) == (*mat2);
+int nar_pm_get_rows(nar_pm mat) {
+    return mat->get_rows();
 }
 
-int nar_zm_assign(nar_zm mat1, nar_zm mat2) {
-    try {
-        mat1->assign(*mat2);
-        return 0;
-    } catch (const std::out_of_range& e) {
-        return 1;
-    }
+int nar_pm_get_cols(nar_pm mat) {
+    return mat->get_cols();
 }
-
-
-// Display strings
-char* nar_zm_display_string(nar_zm mat) {
-    return string_to_char(display_string(*mat));
+// No bounds checking
+void* nar_pv_get(nar_pv v, int i) {
+    return (*v)[i];
 }
 
-char* nar_zv_display_string(nar_zv v) {
-    return string_to_char(display_string(*v));
+void nar_pv_set(nar_pv v, int i, void* x) {
+    (*v)[i] = x;
 }
-// No bounds checking
-// For complex numbers in the form a + bI
-void nar_zv_get(double* a, double* b, nar_zv v, int i) {
-    std::complex<double> z = (*v)[i];
-    *a = z.real();
-    *b = z.imag();
+
+void* nar_pm_get(nar_pm mat, int i, int j) {
+    return (*mat)(i,j);
 }
 
-void nar_zv_set(nar_zv v, int i, double a, double b) {
-    (*v)[i] = std::complex<double>(a,b);
+void nar_pm_set(nar_pm mat, int i, int j, void* x) {
+    (*mat)(i,j) = x;
 }
 
-void nar_zm_get(double* a, double* b, nar_zm mat, int i, int j) {
-    std::complex<double> z = (*mat)(i,j);
-    *a = z.real();
-    *b = z.imag();
+// Bounds-checked versions
+int nar_pv_get_safe(void** x, nar_pv v, int i) {
+    try {
+        *x = v->at(i);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
 
-void nar_zm_set(nar_zm mat, int i, int j, double a, double b) {
-    mat->operator()(i,j) = std::complex<double>(a,b);
+int nar_pv_set_safe(nar_pv v, int i, void* x) {
+    try {
+        v->at(i) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
 
-// Bounds-checked versions
-int nar_zv_get_safe(double* a, double* b, nar_zv v, int i) {
+int nar_pm_get_safe(void** x, nar_pm mat, int i, int j) {
     try {
-        std::complex<double> z = v->at(i);
-        *a = z.real();
-        *b = z.imag();
+        *x = mat->at(i,j);
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_zv_set_safe(nar_zv v, int i, double a, double b) {
+int nar_pm_set_safe(nar_pm mat, int i, int j, void* x) {
     try {
-        v->at(i) = std::complex<double>(a,b);
+        mat->at(i,j) = x;
         return 0;
     } catch (...) {
         return 1;
     }
 }
+// Batched element access through caller buffers.
+// These are bounds-checked and return 1 if anything is out of range.
+// Ranges with start > end are out of range; empty ones do nothing.
 
-int nar_zm_get_safe(double* a, double* b, nar_zm mat, int i, int j) {
+// Copies elements [start, end) to out
+int nar_pv_get_range(void** out, nar_pv v,
+    int start, int end) {
     try {
-        std::complex<double> z = mat->at(i,j);
-        *a = z.real();
-        *b = z.imag();
+        Vector<void*> part = v->slice<true>(start, end);
+        strided_copy((void**) out, 1, 
+            part.pointer(), part.get_inc(), part.get_n());
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_zm_set_safe(nar_zm mat, int i, int j, double a, double b) {
+// Overwrites elements [start, end) with the contents of in
+int nar_pv_set_range(nar_pv v, int start, int end,
+    void* const* in) {
     try {
-        mat->at(i,j) = std::complex<double>(a,b);
+        Vector<void*> part = v->slice<true>(start, end);
+        strided_copy(part.pointer(), part.get_inc(), 
+            (void* const*) in, 1, part.get_n());
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-// Reads vector from file. If there's an error, puts error code in err.
-nar_zv nar_zv_read(const char* filename, int* err) {
+// Copies the elements at idx[0..count) to out
+int nar_pv_gather(void** out, nar_pv v,
+    const int* idx, int count) {
     try {
-        File<std::complex<double>> f(filename, ios_base::in);
-        nar_zv v = new Vector<std::complex<double>>(f.read_vector());
-        if (err) *err = 0;
-        return v;
-    } catch (const FileError& e) {
-        if (err) *err = 1;
-        return nullptr;
-    } catch (const FormatError& e) {
-        if (err) *err = 2;
-        return nullptr;
+        v->gather<true>((void**) out, idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
     }
 }
 
-// Writes vector to file.
-int nar_zv_write(nar_zv v, const char* filename, const char* sep) {
+// Writes in[0..count) to the elements at idx[0..count)
+int nar_pv_scatter(nar_pv v, const int* idx,
+    int count, void* const* in) {
     try {
-        File<std::complex<double>> f(filename, ios_base::out);
-        f.write_vector(*v, sep);
+        v->scatter<true>(idx, count, (void* const*) in);
         return 0;
-    } catch (const FileError& e) {
+    } catch (...) {
         return 1;
     }
 }
 
-// Reads MATRIX from file. If there's an error, puts error code in err.
-nar_zm nar_zm_read(const char* filename, int row_major, int* err) {
+// Copies [start_row, end_row) x [start_col, end_col) to out,
+// which is packed in row major or column major order
+int nar_pm_get_block(void** out, nar_pm mat,
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major) {
     try {
-        File<std::complex<double>> f(filename, ios_base::in);
-        nar_zm v = new Matrix<std::complex<double>>(f.read_matrix(row_major));
-        if (err) *err = 0;
-        return v;
-    } catch (const FileError& e) {
-        if (err) *err = 1;
-        return nullptr;
-    } catch (const FormatError& e) {
-        if (err) *err = 2;
-        return nullptr;
+        Matrix<void*> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d((void**) out, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            rows, cols);
+        return 0;
+    } catch (...) {
+        return 1;
     }
 }
 
-// Writes MATRIX to file.
-int nar_zm_write(nar_zm v, const char* filename, const char* sep) {
+// Overwrites [start_row, end_row) x [start_col, end_col) with in,
+// which is packed in row major or column major order
+int nar_pm_set_block(nar_pm mat,
+    int start_row, int start_col, int end_row, int end_col,
+    void* const* in, int row_major) {
     try {
-        File<std::complex<double>> f(filename, ios_base::out);
-        f.write_matrix(*v, sep);
+        Matrix<void*> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d(part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            (void* const*) in, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            rows, cols);
         return 0;
-    } catch (const FileError& e) {
+    } catch (...) {
         return 1;
     }
 }
 
+// Copies the elements at (rows_idx[k], cols_idx[k]) to out[k]
+int nar_pm_gather(void** out, nar_pm mat,
+    const int* rows_idx, const int* cols_idx, int count) {
+    try {
+        mat->gather<true>((void**) out, rows_idx, cols_idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
 
+// Writes in[k] to the elements at (rows_idx[k], cols_idx[k])
+int nar_pm_scatter(nar_pm mat, const int* rows_idx,
+    const int* cols_idx, int count, void* const* in) {
+    try {
+        mat->scatter<true>(rows_idx, cols_idx, count, (void* const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
 
-// Reads vector from file. If there's an error, puts error code in err.
-nar_zv nar_zv_read_binary(const char* filename, int* err) {
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// binary matrix file without reading the rest of it.
+// If there's an error, puts error code in err.
+nar_pm nar_pm_read_binary_subarray(const char* filename, 
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major, int* err) {
     try {
-        BinaryFile<std::complex<double>> f(filename, ios_base::in);
-        nar_zv v = new Vector<std::complex<double>>(f.read_vector());
+        BinaryFile<void*> f(filename, ios_base::in);
+        nar_pm mat = new Matrix<void*>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
         if (err) *err = 0;
-        return v;
+        return mat;
     } catch (const FileError& e) {
         if (err) *err = 1;
         return nullptr;
@@ -1967,24 +10853,18 @@ nar_zv nar_zv_read_binary(const char* filename, int* err) {
     }
 }
 
-// Writes vector to file.
-int nar_zv_write_binary(nar_zv v, const char* filename) {
-    try {
-        BinaryFile<std::complex<double>> f(filename, ios_base::out);
-        f.write_vector(*v);
-        return 0;
-    } catch (const FileError& e) {
-        return 1;
-    }
-}
-
-// Reads MATRIX from file. If there's an error, puts error code in err.
-nar_zm nar_zm_read_binary(const char* filename, int row_major, int* err) {
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// tiled matrix file, reading only the tiles they intersect.
+// If there's an error, puts error code in err.
+nar_pm nar_pm_read_tiled_subarray(const char* filename, 
+    int start_row, int start_col, int end_row, int end_col,
+    int row_major, int* err) {
     try {
-        BinaryFile<std::complex<double>> f(filename, ios_base::in);
-        nar_zm v = new Matrix<std::complex<double>>(f.read_matrix(row_major));
+        TiledFile<void*> f(filename, ios_base::in);
+        nar_pm mat = new Matrix<void*>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
         if (err) *err = 0;
-        return v;
+        return mat;
     } catch (const FileError& e) {
         if (err) *err = 1;
         return nullptr;
@@ -1993,135 +10873,137 @@ nar_zm nar_zm_read_binary(const char* filename, int row_major, int* err) {
         return nullptr;
     }
 }
-
-// Writes MATRIX to file.
-int nar_zm_write_binary(nar_zm v, const char* filename) {
+// Reads up to max_rows more rows, into a new view to free with
+// nar_pm_free. The view shares the reader's buffer, so the next
+// call overwrites its elements. Returns null at the end of the file, or
+// if there's an error, when it also puts the error code in err, as for
+// nar_pm_reader_open.
+nar_pm nar_pm_reader_next(nar_pm_reader reader, int max_rows, int* err) {
     try {
-        BinaryFile<std::complex<double>> f(filename, ios_base::out);
-        f.write_matrix(*v);
-        return 0;
+        const Matrix<void*>& block = reader->next(
+            std::max<Index>(max_rows, 0));
+        if (err) *err = 0;
+        if (block.get_rows() == 0 && max_rows > 0) {
+            return nullptr;
+        }
+        return new Matrix<void*>(block);
     } catch (const FileError& e) {
-        return 1;
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
     }
 }
-
-
-
 // Main routines for vectors and matrices of the given type
+// with int64_t sizes, indices and strides
 
-nar_xv nar_xv_alloc(int n) {
-    return new Vector<char>(n);
+nar_pv nar_pv_alloc_64(int64_t n) {
+    return new Vector<void*>(n);
 }
 
-void nar_xv_free(nar_xv v) {
-    delete v;
+// Contents are unspecified until written
+nar_pv nar_pv_alloc_uninit_64(int64_t n) {
+    return new Vector<void*>(n, uninitialized);
 }
 
-nar_xv nar_xv_copy(nar_xv v) {
-    return new Vector<char>(v->copy());
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_pv nar_pv_wrap_64(void** ptr, int64_t n, int64_t inc,
+    nar_release_fn release, void* ctx) {
+    return new Vector<void*>(wrap_vector((void**) ptr, n, inc,
+        [release, ctx](void** p) { if (release) release(p, ctx); }));
 }
 
-int nar_xv_valid(nar_xv v, int i) {
+int nar_pv_valid_64(nar_pv v, int64_t i) {
     return v->in_range(i);
 }
 
-nar_xv nar_xv_slice(nar_xv v, int start, int end) {
-    return new Vector<char>(v->slice(start, end));
+nar_pv nar_pv_slice_64(nar_pv v, int64_t start, int64_t end) {
+    return new Vector<void*>(v->slice(start, end));
 }
 
-int nar_xv_slice_safe(nar_xv* out, nar_xv v, int start, int end) {
+int nar_pv_slice_safe_64(nar_pv* out, nar_pv v, int64_t start, int64_t end) {
     try {
-        *out = new Vector<char>(v->slice<true>(start, end));
+        *out = new Vector<void*>(v->slice<true>(start, end));
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-char* nar_xv_pointer(nar_xv v) {
-    return (char*) v->pointer();
-}
-
-int nar_xv_inc(nar_xv v) {
+int64_t nar_pv_inc_64(nar_pv v) {
     return v->get_inc();
 }
 
-int nar_xv_n(nar_xv v) {
+int64_t nar_pv_n_64(nar_pv v) {
     return v->get_n();
 }
 
-int nar_xv_eq(nar_xv v1, nar_xv v2) {
-    return (*v1) == (*v2);
-}
-
-int nar_xv_assign(nar_xv v1, nar_xv v2) {
-    try {
-        v1->assign(*v2);
-        return 0;
-    } catch (const std::out_of_range& e) {
-        return 1;
-    }
-}
-
 // For matrices
 
-nar_xm nar_xm_alloc(int rows, int cols, int row_major) {
-    return new Matrix<char>(rows, cols, row_major);
+nar_pm nar_pm_alloc_64(int64_t rows, int64_t cols, int row_major) {
+    return new Matrix<void*>(rows, cols, row_major);
 }
 
-void nar_xm_free(nar_xm mat) {
-    delete mat;
+// Contents are unspecified until written
+nar_pm nar_pm_alloc_uninit_64(int64_t rows, int64_t cols, int row_major) {
+    return new Matrix<void*>(rows, cols, row_major, uninitialized);
 }
 
-nar_xm nar_xm_copy(nar_xm mat) {
-    return new Matrix<char>(mat->copy());
+// View over memory owned by the caller. No copy is made.
+// release(ptr, ctx) is called when the last view is freed (if not NULL).
+nar_pm nar_pm_wrap_64(void** ptr, int64_t rows, int64_t cols,
+    int64_t inc_row, int64_t inc_col, nar_release_fn release, void* ctx) {
+    return new Matrix<void*>(wrap_matrix((void**) ptr, rows, cols,
+        inc_row, inc_col,
+        [release, ctx](void** p) { if (release) release(p, ctx); }));
 }
 
-int nar_xm_valid(nar_xm mat, int i, int j) {
+int nar_pm_valid_64(nar_pm mat, int64_t i, int64_t j) {
     return mat->in_range(i,j);
 }
 
-enum nar_order nar_xm_order(nar_xm mat) {
-    return (nar_order) mat->get_order();
-}
-
 // Slicing parts of matrix
-nar_xv nar_xm_row(nar_xm mat, int i) {
-    return new Vector<char>(mat->row(i));
+nar_pv nar_pm_row_64(nar_pm mat, int64_t i) {
+    return new Vector<void*>(mat->row(i));
 }
 
-nar_xv nar_xm_col(nar_xm mat, int j) {
-    return new Vector<char>(mat->col(j));
+nar_pv nar_pm_col_64(nar_pm mat, int64_t j) {
+    return new Vector<void*>(mat->col(j));
 }
 
-nar_xm nar_xm_subarray(nar_xm mat, int start_row,
-    int start_col, int end_row, int end_col) {
-    return new Matrix<char>(mat->subarray(
+nar_pm nar_pm_subarray_64(nar_pm mat, int64_t start_row,
+    int64_t start_col, int64_t end_row, int64_t end_col) {
+    return new Matrix<void*>(mat->subarray(
         start_row, start_col, end_row, end_col));
 }
 
-int nar_xm_row_safe(nar_xv* x, nar_xm mat, int i) {
+int nar_pm_row_safe_64(nar_pv* x, nar_pm mat, int64_t i) {
     try {
-        *x = new Vector<char>(mat->row<true>(i));
+        *x = new Vector<void*>(mat->row<true>(i));
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_xm_col_safe(nar_xv* x, nar_xm mat, int j) {
+int nar_pm_col_safe_64(nar_pv* x, nar_pm mat, int64_t j) {
     try {
-        *x = new Vector<char>(mat->col<true>(j));
+        *x = new Vector<void*>(mat->col<true>(j));
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_xm_subarray_safe(nar_xm* x, nar_xm mat, int start_row,
-    int start_col, int end_row, int end_col) {
+int nar_pm_subarray_safe_64(nar_pm* x, nar_pm mat, int64_t start_row,
+    int64_t start_col, int64_t end_row, int64_t end_col) {
     try {
-        *x = new Matrix<char>(mat->subarray<true>(
+        *x = new Matrix<void*>(mat->subarray<true>(
             start_row, start_col, end_row, end_col));
         return 0;
     } catch (...) {
@@ -2129,12 +11011,7 @@ int nar_xm_subarray_safe(nar_xm* x, nar_xm mat, int start_row,
     }
 }
 
-// Matrix attributes and dimensions
-char* nar_xm_pointer(nar_xm mat) {
-    return (char*) mat->pointer();
-}
-
-int nar_xm_get_ld(nar_xm mat) {
+int64_t nar_pm_get_ld_64(nar_pm mat) {
     try {
         return mat->get_ld();
     } catch (...) {
@@ -2142,95 +11019,258 @@ int nar_xm_get_ld(nar_xm mat) {
     }
 }
 
-int nar_xm_get_rows(nar_xm mat) {
+int64_t nar_pm_inc_row_64(nar_pm mat) {
+    return mat->get_inc_row();
+}
+
+int64_t nar_pm_inc_col_64(nar_pm mat) {
+    return mat->get_inc_col();
+}
+
+int64_t nar_pm_get_rows_64(nar_pm mat) {
     return mat->get_rows();
 }
 
-int nar_xm_get_cols(nar_xm mat) {
+int64_t nar_pm_get_cols_64(nar_pm mat) {
     return mat->get_cols();
 }
+// No bounds checking
+void* nar_pv_get_64(nar_pv v, int64_t i) {
+    return (*v)[i];
+}
 
-int nar_xm_eq(nar_xm mat1, nar_xm mat2) {
-    return (*mat1) == (*mat2);
+void nar_pv_set_64(nar_pv v, int64_t i, void* x) {
+    (*v)[i] = x;
 }
 
-int nar_xm_assign(nar_xm mat1, nar_xm mat2) {
+void* nar_pm_get_64(nar_pm mat, int64_t i, int64_t j) {
+    return (*mat)(i,j);
+}
+
+void nar_pm_set_64(nar_pm mat, int64_t i, int64_t j, void* x) {
+    (*mat)(i,j) = x;
+}
+
+// Bounds-checked versions
+int nar_pv_get_safe_64(void** x, nar_pv v, int64_t i) {
     try {
-        mat1->assign(*mat2);
+        *x = v->at(i);
         return 0;
-    } catch (const std::out_of_range& e) {
+    } catch (...) {
         return 1;
     }
 }
 
+int nar_pv_set_safe_64(nar_pv v, int64_t i, void* x) {
+    try {
+        v->at(i) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
 
-// Display strings
-char* nar_xm_display_string(nar_xm mat) {
-    return string_to_char(display_string(*mat));
+int nar_pm_get_safe_64(void** x, nar_pm mat, int64_t i, int64_t j) {
+    try {
+        *x = mat->at(i,j);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
 
-char* nar_xv_display_string(nar_xv v) {
-    return string_to_char(display_string(*v));
+int nar_pm_set_safe_64(nar_pm mat, int64_t i, int64_t j, void* x) {
+    try {
+        mat->at(i,j) = x;
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
-// No bounds checking
-char nar_xv_get(nar_xv v, int i) {
-    return (*v)[i];
+// Batched element access through caller buffers.
+// These are bounds-checked and return 1 if anything is out of range.
+// Ranges with start > end are out of range; empty ones do nothing.
+
+// Copies elements [start, end) to out
+int nar_pv_get_range_64(void** out, nar_pv v,
+    int64_t start, int64_t end) {
+    try {
+        Vector<void*> part = v->slice<true>(start, end);
+        strided_copy((void**) out, 1, 
+            part.pointer(), part.get_inc(), part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
 
-void nar_xv_set(nar_xv v, int i, char x) {
-    (*v)[i] = x;
+// Overwrites elements [start, end) with the contents of in
+int nar_pv_set_range_64(nar_pv v, int64_t start, int64_t end,
+    void* const* in) {
+    try {
+        Vector<void*> part = v->slice<true>(start, end);
+        strided_copy(part.pointer(), part.get_inc(), 
+            (void* const*) in, 1, part.get_n());
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
 
-char nar_xm_get(nar_xm mat, int i, int j) {
-    return (*mat)(i,j);
+// Copies the elements at idx[0..count) to out
+int nar_pv_gather_64(void** out, nar_pv v,
+    const int64_t* idx, int64_t count) {
+    try {
+        v->gather<true>((void**) out, idx, count);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
 
-void nar_xm_set(nar_xm mat, int i, int j, char x) {
-    (*mat)(i,j) = x;
+// Writes in[0..count) to the elements at idx[0..count)
+int nar_pv_scatter_64(nar_pv v, const int64_t* idx,
+    int64_t count, void* const* in) {
+    try {
+        v->scatter<true>(idx, count, (void* const*) in);
+        return 0;
+    } catch (...) {
+        return 1;
+    }
 }
 
-// Bounds-checked versions
-int nar_xv_get_safe(char* x, nar_xv v, int i) {
+// Copies [start_row, end_row) x [start_col, end_col) to out,
+// which is packed in row major or column major order
+int nar_pm_get_block_64(void** out, nar_pm mat,
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major) {
     try {
-        *x = v->at(i);
+        Matrix<void*> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d((void**) out, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            rows, cols);
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_xv_set_safe(nar_xv v, int i, char x) {
+// Overwrites [start_row, end_row) x [start_col, end_col) with in,
+// which is packed in row major or column major order
+int nar_pm_set_block_64(nar_pm mat,
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    void* const* in, int row_major) {
     try {
-        v->at(i) = x;
+        Matrix<void*> part = mat->subarray<true>(
+            start_row, start_col, end_row, end_col);
+        Index rows = part.get_rows(), cols = part.get_cols();
+        strided_copy_2d(part.pointer(), part.get_inc_row(), part.get_inc_col(),
+            (void* const*) in, 
+            row_major ? cols : 1, row_major ? 1 : rows,
+            rows, cols);
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_xm_get_safe(char* x, nar_xm mat, int i, int j) {
+// Copies the elements at (rows_idx[k], cols_idx[k]) to out[k]
+int nar_pm_gather_64(void** out, nar_pm mat,
+    const int64_t* rows_idx, const int64_t* cols_idx, int64_t count) {
     try {
-        *x = mat->at(i,j);
+        mat->gather<true>((void**) out, rows_idx, cols_idx, count);
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
-int nar_xm_set_safe(nar_xm mat, int i, int j, char x) {
+// Writes in[k] to the elements at (rows_idx[k], cols_idx[k])
+int nar_pm_scatter_64(nar_pm mat, const int64_t* rows_idx,
+    const int64_t* cols_idx, int64_t count, void* const* in) {
     try {
-        mat->at(i,j) = x;
+        mat->scatter<true>(rows_idx, cols_idx, count, (void* const*) in);
         return 0;
     } catch (...) {
         return 1;
     }
 }
 
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// binary matrix file without reading the rest of it.
+// If there's an error, puts error code in err.
+nar_pm nar_pm_read_binary_subarray_64(const char* filename, 
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major, int* err) {
+    try {
+        BinaryFile<void*> f(filename, ios_base::in);
+        nar_pm mat = new Matrix<void*>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+
+// Reads rows [start_row, end_row) and columns [start_col, end_col) of a
+// tiled matrix file, reading only the tiles they intersect.
+// If there's an error, puts error code in err.
+nar_pm nar_pm_read_tiled_subarray_64(const char* filename, 
+    int64_t start_row, int64_t start_col, int64_t end_row, int64_t end_col,
+    int row_major, int* err) {
+    try {
+        TiledFile<void*> f(filename, ios_base::in);
+        nar_pm mat = new Matrix<void*>(f.read_subarray(
+            start_row, start_col, end_row, end_col, row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
+}
+// Reads up to max_rows more rows, into a new view to free with
+// nar_pm_free. The view shares the reader's buffer, so the next
+// call overwrites its elements. Returns null at the end of the file, or
+// if there's an error, when it also puts the error code in err, as for
+// nar_pm_reader_open.
+nar_pm nar_pm_reader_next_64(nar_pm_reader reader, int64_t max_rows, int* err) {
+    try {
+        const Matrix<void*>& block = reader->next(
+            std::max<Index>(max_rows, 0));
+        if (err) *err = 0;
+        if (block.get_rows() == 0 && max_rows > 0) {
+            return nullptr;
+        }
+        return new Matrix<void*>(block);
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
+}
+
 // Reads vector from file. If there's an error, puts error code in err.
-nar_xv nar_xv_read(const char* filename, int* err) {
+nar_pv nar_pv_read(const char* filename, int* err) {
     try {
-        File<char> f(filename, ios_base::in);
-        nar_xv v = new Vector<char>(f.read_vector());
+        File<void*> f(filename, ios_base::in);
+        nar_pv v = new Vector<void*>(f.read_vector());
         if (err) *err = 0;
         return v;
     } catch (const FileError& e) {
@@ -2243,9 +11283,9 @@ nar_xv nar_xv_read(const char* filename, int* err) {
 }
 
 // Writes vector to file.
-int nar_xv_write(nar_xv v, const char* filename, const char* sep) {
+int nar_pv_write(nar_pv v, const char* filename, const char* sep) {
     try {
-        File<char> f(filename, ios_base::out);
+        File<void*> f(filename, ios_base::out);
         f.write_vector(*v, sep);
         return 0;
     } catch (const FileError& e) {
@@ -2254,10 +11294,10 @@ int nar_xv_write(nar_xv v, const char* filename, const char* sep) {
 }
 
 // Reads MATRIX from file. If there's an error, puts error code in err.
-nar_xm nar_xm_read(const char* filename, int row_major, int* err) {
+nar_pm nar_pm_read(const char* filename, int row_major, int* err) {
     try {
-        File<char> f(filename, ios_base::in);
-        nar_xm v = new Matrix<char>(f.read_matrix(row_major));
+        File<void*> f(filename, ios_base::in);
+        nar_pm v = new Matrix<void*>(f.read_matrix(row_major));
         if (err) *err = 0;
         return v;
     } catch (const FileError& e) {
@@ -2270,9 +11310,9 @@ nar_xm nar_xm_read(const char* filename, int row_major, int* err) {
 }
 
 // Writes MATRIX to file.
-int nar_xm_write(nar_xm v, const char* filename, const char* sep) {
+int nar_pm_write(nar_pm v, const char* filename, const char* sep) {
     try {
-        File<char> f(filename, ios_base::out);
+        File<void*> f(filename, ios_base::out);
         f.write_matrix(*v, sep);
         return 0;
     } catch (const FileError& e) {
@@ -2281,12 +11321,110 @@ int nar_xm_write(nar_xm v, const char* filename, const char* sep) {
 }
 
 
+// Reads vector from file into dest, reusing its memory. The file must
+// hold a vector of dest's length. Returns the error code.
+int nar_pv_read_into(nar_pv dest, const char* filename) {
+    try {
+        File<void*> f(filename, ios_base::in);
+        f.read_vector_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Reads matrix from file into dest, reusing its memory. The file must
+// hold a matrix of dest's dimensions. Returns the error code.
+int nar_pm_read_into(nar_pm dest, const char* filename) {
+    try {
+        File<void*> f(filename, ios_base::in);
+        f.read_matrix_into(*dest);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    } catch (const FormatError& e) {
+        return 2;
+    }
+}
+
+// Starts reading vector from file on the I/O threads.
+// nar_future_wait returns the vector and error code.
+nar_future nar_pv_read_async(const char* filename) {
+    std::string name(filename);
+    return start_async([name]() {
+        int err;
+        void* v = nar_pv_read(name.c_str(), &err);
+        return Future::Result(v, err);
+    });
+}
+
+// Starts writing vector to file on the I/O threads. v mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_pv_write_async(nar_pv v, const char* filename, const char* sep) {
+    std::string name(filename);
+    std::string separator(sep);
+    return start_async([=]() {
+        int status = nar_pv_write(v, name.c_str(), separator.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Starts reading matrix from file on the I/O threads.
+// nar_future_wait returns the matrix and error code.
+nar_future nar_pm_read_async(const char* filename, int row_major) {
+    std::string name(filename);
+    return start_async([name, row_major]() {
+        int err;
+        void* mat = nar_pm_read(name.c_str(), row_major, &err);
+        return Future::Result(mat, err);
+    });
+}
+
+// Starts writing matrix to file on the I/O threads. mat mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_pm_write_async(nar_pm mat, const char* filename, const char* sep) {
+    std::string name(filename);
+    std::string separator(sep);
+    return start_async([=]() {
+        int status = nar_pm_write(mat, name.c_str(), separator.c_str());
+        return Future::Result(nullptr, status);
+    });
+}
+
+// Writes vector to file with precision significant digits for floating
+// point values, or NAR_PRECISION_SHORTEST for the fewest that read back
+// exactly.
+int nar_pv_write_precision(nar_pv v, const char* filename, const char* sep, int precision) {
+    try {
+        File<void*> f(filename, ios_base::out);
+        f.write_vector(*v, sep, precision);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
+// Writes matrix to file with precision significant digits for floating
+// point values, or NAR_PRECISION_SHORTEST for the fewest that read back
+// exactly.
+int nar_pm_write_precision(nar_pm v, const char* filename, const char* sep, int precision) {
+    try {
+        File<void*> f(filename, ios_base::out);
+        f.write_matrix(*v, sep, precision);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
+}
+
 
 // Reads vector from file. If there's an error, puts error code in err.
-nar_xv nar_xv_read_binary(const char* filename, int* err) {
+nar_pv nar_pv_read_binary(const char* filename, int* err) {
     try {
-        BinaryFile<char> f(filename, ios_base::in);
-        nar_xv v = new Vector<char>(f.read_vector());
+        BinaryFile<void*> f(filename, ios_base::in);
+        nar_pv v = new Vector<void*>(f.read_vector());
         if (err) *err = 0;
         return v;
     } catch (const FileError& e) {
@@ -2299,9 +11437,9 @@ nar_xv nar_xv_read_binary(const char* filename, int* err) {
 }
 
 // Writes vector to file.
-int nar_xv_write_binary(nar_xv v, const char* filename) {
+int nar_pv_write_binary(nar_pv v, const char* filename) {
     try {
-        BinaryFile<char> f(filename, ios_base::out);
+        BinaryFile<void*> f(filename, ios_base::out);
         f.write_vector(*v);
         return 0;
     } catch (const FileError& e) {
@@ -2310,10 +11448,10 @@ int nar_xv_write_binary(nar_xv v, const char* filename) {
 }
 
 // Reads MATRIX from file. If there's an error, puts error code in err.
-nar_xm nar_xm_read_binary(const char* filename, int row_major, int* err) {
+nar_pm nar_pm_read_binary(const char* filename, int row_major, int* err) {
     try {
-        BinaryFile<char> f(filename, ios_base::in);
-        nar_xm v = new Matrix<char>(f.read_matrix(row_major));
+        BinaryFile<void*> f(filename, ios_base::in);
+        nar_pm v = new Matrix<void*>(f.read_matrix(row_major));
         if (err) *err = 0;
         return v;
     } catch (const FileError& e) {
@@ -2326,9 +11464,9 @@ nar_xm nar_xm_read_binary(const char* filename, int row_major, int* err) {
 }
 
 // Writes MATRIX to file.
-int nar_xm_write_binary(nar_xm v, const char* filename) {
+int nar_pm_write_binary(nar_pm v, const char* filename) {
     try {
-        BinaryFile<char> f(filename, ios_base::out);
+        BinaryFile<void*> f(filename, ios_base::out);
         f.write_matrix(*v);
         return 0;
     } catch (const FileError& e) {
@@ -2337,231 +11475,323 @@ int nar_xm_write_binary(nar_xm v, const char* filename) {
 }
 
 
-
-// Main routines for vectors and matrices of the given type
-
-nar_pv nar_pv_alloc(int n) {
-    return new Vector<void*>(n);
-}
-
-void nar_pv_free(nar_pv v) {
-    delete v;
-}
-
-nar_pv nar_pv_copy(nar_pv v) {
-    return new Vector<void*>(v->copy());
-}
-
-int nar_pv_valid(nar_pv v, int i) {
-    return v->in_range(i);
-}
-
-nar_pv nar_pv_slice(nar_pv v, int start, int end) {
-    return new Vector<void*>(v->slice(start, end));
-}
-
-int nar_pv_slice_safe(nar_pv* out, nar_pv v, int start, int end) {
+// Reads vector from file into dest, reusing its memory. The file must
+// hold a vector of dest's length. Returns the error code.
+int nar_pv_read_binary_into(nar_pv dest, const char* filename) {
     try {
-        *out = new Vector<void*>(v->slice<true>(start, end));
+        BinaryFile<void*> f(filename, ios_base::in);
+        f.read_vector_into(*dest);
         return 0;
-    } catch (...) {
+    } catch (const FileError& e) {
         return 1;
+    } catch (const FormatError& e) {
+        return 2;
     }
 }
 
-void** nar_pv_pointer(nar_pv v) {
-    return (void**) v->pointer();
-}
-
-int nar_pv_inc(nar_pv v) {
-    return v->get_inc();
-}
-
-int nar_pv_n(nar_pv v) {
-    return v->get_n();
-}
-
-int nar_pv_eq(nar_pv v1, nar_pv v2) {
-    return (*v1) == (*v2);
-}
-
-int nar_pv_assign(nar_pv v1, nar_pv v2) {
+// Reads matrix from file into dest, reusing its memory. The file must
+// hold a matrix of dest's dimensions. Returns the error code.
+int nar_pm_read_binary_into(nar_pm dest, const char* filename) {
     try {
-        v1->assign(*v2);
+        BinaryFile<void*> f(filename, ios_base::in);
+        f.read_matrix_into(*dest);
         return 0;
-    } catch (const std::out_of_range& e) {
+    } catch (const FileError& e) {
         return 1;
+    } catch (const FormatError& e) {
+        return 2;
     }
 }
 
-// For matrices
+// Starts reading vector from file on the I/O threads.
+// nar_future_wait returns the vector and error code.
+nar_future nar_pv_read_binary_async(const char* filename) {
+    std::string name(filename);
+    return start_async([name]() {
+        int err;
+        void* v = nar_pv_read_binary(name.c_str(), &err);
+        return Future::Result(v, err);
+    });
+}
 
-nar_pm nar_pm_alloc(int rows, int cols, int row_major) {
-    return new Matrix<void*>(rows, cols, row_major);
+// Starts writing vector to file on the I/O threads. v mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_pv_write_binary_async(nar_pv v, const char* filename) {
+    std::string name(filename);
+    return start_async([=]() {
+        int status = nar_pv_write_binary(v, name.c_str());
+        return Future::Result(nullptr, status);
+    });
 }
 
-void nar_pm_free(nar_pm mat) {
-    delete mat;
+// Starts reading matrix from file on the I/O threads.
+// nar_future_wait returns the matrix and error code.
+nar_future nar_pm_read_binary_async(const char* filename, int row_major) {
+    std::string name(filename);
+    return start_async([name, row_major]() {
+        int err;
+        void* mat = nar_pm_read_binary(name.c_str(), row_major, &err);
+        return Future::Result(mat, err);
+    });
 }
 
-nar_pm nar_pm_copy(nar_pm mat) {
-    return new Matrix<void*>(mat->copy());
+// Starts writing matrix to file on the I/O threads. mat mustn't change
+// or be freed until nar_future_wait returns the status.
+nar_future nar_pm_write_binary_async(nar_pm mat, const char* filename) {
+    std::string name(filename);
+    return start_async([=]() {
+        int status = nar_pm_write_binary(mat, name.c_str());
+        return Future::Result(nullptr, status);
+    });
 }
 
-int nar_pm_valid(nar_pm mat, int i, int j) {
-    return mat->in_range(i,j);
+// Maps a binary file written by nar_pv_write_binary into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_pv nar_pv_mmap(const char* filename, enum nar_map_mode mode, int* err) {
+    try {
+        BinaryFile<void*> f(filename, ios_base::in);
+        nar_pv v = new Vector<void*>(f.map_vector((MapMode) mode));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
 }
 
-enum nar_order nar_pm_order(nar_pm mat) {
-    return (nar_order) mat->get_order();
+// Maps a binary file written by nar_pm_write_binary into memory.
+// The matrix has the order it was stored in, so column major matrices
+// map as column major. The file stays mapped until the last view of it
+// is freed. If there's an error, puts error code in err.
+nar_pm nar_pm_mmap(const char* filename, enum nar_map_mode mode, int* err) {
+    try {
+        BinaryFile<void*> f(filename, ios_base::in);
+        nar_pm mat = new Matrix<void*>(f.map_matrix((MapMode) mode));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
 }
 
-// Slicing parts of matrix
-nar_pv nar_pm_row(nar_pm mat, int i) {
-    return new Vector<void*>(mat->row(i));
+// Writes vector to a binary file, compressed in chunks.
+// nar_pv_read_binary reads it back.
+int nar_pv_write_binary_compressed(nar_pv v, const char* filename) {
+    try {
+        BinaryFile<void*> f(filename, ios_base::out);
+        f.set_compressed(true);
+        f.write_vector(*v);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
 }
 
-nar_pv nar_pm_col(nar_pm mat, int j) {
-    return new Vector<void*>(mat->col(j));
+// Writes matrix to a binary file, compressed in chunks.
+// nar_pm_read_binary reads it back.
+int nar_pm_write_binary_compressed(nar_pm mat, const char* filename) {
+    try {
+        BinaryFile<void*> f(filename, ios_base::out);
+        f.set_compressed(true);
+        f.write_matrix(*mat);
+        return 0;
+    } catch (const FileError& e) {
+        return 1;
+    }
 }
 
-nar_pm nar_pm_subarray(nar_pm mat, int start_row,
-    int start_col, int end_row, int end_col) {
-    return new Matrix<void*>(mat->subarray(
-        start_row, start_col, end_row, end_col));
+// Reads a 1D array from a NumPy .npy file.
+// If there's an error, puts error code in err.
+nar_pv nar_pv_read_npy(const char* filename, int* err) {
+    try {
+        NpyFile<void*> f(filename, ios_base::in);
+        nar_pv v = new Vector<void*>(f.read_vector());
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    }
 }
 
-int nar_pm_row_safe(nar_pv* x, nar_pm mat, int i) {
+// Reads the named 1D array from an uncompressed NumPy .npz archive.
+// If there's an error, puts error code in err.
+nar_pv nar_pv_read_npz(const char* filename, const char* name, int* err) {
     try {
-        *x = new Vector<void*>(mat->row<true>(i));
-        return 0;
-    } catch (...) {
-        return 1;
+        NpyFile<void*> f(filename, ios_base::in);
+        nar_pv v = new Vector<void*>(
+            f.read_vector(f.find_entry(name)));
+        if (err) *err = 0;
+        return v;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
     }
 }
 
-int nar_pm_col_safe(nar_pv* x, nar_pm mat, int j) {
+// Writes vector to a NumPy .npy file.
+int nar_pv_write_npy(nar_pv v, const char* filename) {
     try {
-        *x = new Vector<void*>(mat->col<true>(j));
+        NpyFile<void*> f(filename, ios_base::out);
+        f.write_vector(*v);
         return 0;
-    } catch (...) {
+    } catch (const FileError& e) {
         return 1;
     }
 }
 
-int nar_pm_subarray_safe(nar_pm* x, nar_pm mat, int start_row,
-    int start_col, int end_row, int end_col) {
+// Reads a 2D array from a NumPy .npy file. Fortran order arrays become
+// column major matrices. If there's an error, puts error code in err.
+nar_pm nar_pm_read_npy(const char* filename, int* err) {
     try {
-        *x = new Matrix<void*>(mat->subarray<true>(
-            start_row, start_col, end_row, end_col));
-        return 0;
-    } catch (...) {
-        return 1;
+        NpyFile<void*> f(filename, ios_base::in);
+        nar_pm mat = new Matrix<void*>(f.read_matrix());
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
     }
 }
 
-// Matrix attributes and dimensions
-void** nar_pm_pointer(nar_pm mat) {
-    return (void**) mat->pointer();
-}
-
-int nar_pm_get_ld(nar_pm mat) {
+// Reads the named 2D array from an uncompressed NumPy .npz archive.
+// If there's an error, puts error code in err.
+nar_pm nar_pm_read_npz(const char* filename, const char* name, int* err) {
     try {
-        return mat->get_ld();
-    } catch (...) {
-        return -1; // Not contiguously ordered
+        NpyFile<void*> f(filename, ios_base::in);
+        nar_pm mat = new Matrix<void*>(
+            f.read_matrix(f.find_entry(name)));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
     }
 }
 
-int nar_pm_get_rows(nar_pm mat) {
-    return mat->get_rows();
-}
-
-int nar_pm_get_cols(nar_pm mat) {
-    return mat->get_cols();
-}
-
-int nar_pm_eq(nar_pm mat1, nar_pm mat2) {
-    return (*mat1) == (*mat2);
-}
-
-int nar_pm_assign(nar_pm mat1, nar_pm mat2) {
+// Writes matrix to a NumPy .npy file. Column major matrices
+// are written in Fortran order.
+int nar_pm_write_npy(nar_pm mat, const char* filename) {
     try {
-        mat1->assign(*mat2);
+        NpyFile<void*> f(filename, ios_base::out);
+        f.write_matrix(*mat);
         return 0;
-    } catch (const std::out_of_range& e) {
+    } catch (const FileError& e) {
         return 1;
     }
 }
 
-
-// Display strings
-char* nar_pm_display_string(nar_pm mat) {
-    return string_to_char(display_string(*mat));
-}
-
-char* nar_pv_display_string(nar_pv v) {
-    return string_to_char(display_string(*v));
-}
-// No bounds checking
-void* nar_pv_get(nar_pv v, int i) {
-    return (*v)[i];
-}
-
-void nar_pv_set(nar_pv v, int i, void* x) {
-    (*v)[i] = x;
-}
-
-void* nar_pm_get(nar_pm mat, int i, int j) {
-    return (*mat)(i,j);
-}
-
-void nar_pm_set(nar_pm mat, int i, int j, void* x) {
-    (*mat)(i,j) = x;
+// Opens a text matrix file for reading a block of rows at a time.
+// If there's an error, puts error code in err: 1 if the file can't be
+// read, 2 if it's malformed and 3 for anything else, such as running
+// out of memory.
+nar_pm_reader nar_pm_reader_open(const char* filename, int* err) {
+    try {
+        nar_pm_reader reader = 
+            new MatrixReader<void*>(filename, false);
+        if (err) *err = 0;
+        return reader;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
+    } catch (...) {
+        if (err) *err = 3;
+        return nullptr;
+    }
 }
 
-// Bounds-checked versions
-int nar_pv_get_safe(void** x, nar_pv v, int i) {
+// Opens a binary matrix file for reading a block of rows at a time.
+// If there's an error, puts error code in err, as for
+// nar_pm_reader_open.
+nar_pm_reader nar_pm_reader_open_binary(const char* filename, int* err) {
     try {
-        *x = v->at(i);
-        return 0;
+        nar_pm_reader reader = 
+            new MatrixReader<void*>(filename, true);
+        if (err) *err = 0;
+        return reader;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
     } catch (...) {
-        return 1;
+        if (err) *err = 3;
+        return nullptr;
     }
 }
 
-int nar_pv_set_safe(nar_pv v, int i, void* x) {
+void nar_pm_reader_close(nar_pm_reader reader) {
+    delete reader;
+}
+
+// Reads a matrix from a tiled file. If there's an error, puts error code in err.
+nar_pm nar_pm_read_tiled(const char* filename, int row_major, int* err) {
     try {
-        v->at(i) = x;
-        return 0;
-    } catch (...) {
-        return 1;
+        TiledFile<void*> f(filename, ios_base::in);
+        nar_pm mat = new Matrix<void*>(f.read_matrix(row_major));
+        if (err) *err = 0;
+        return mat;
+    } catch (const FileError& e) {
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
     }
 }
 
-int nar_pm_get_safe(void** x, nar_pm mat, int i, int j) {
+// Writes matrix to a file as tiles of tile_rows x tile_cols elements.
+// Tile sizes of 0 use the default of 256.
+int nar_pm_write_tiled(nar_pm mat, const char* filename, int tile_rows, int tile_cols) {
     try {
-        *x = mat->at(i,j);
+        TiledFile<void*> f(filename, ios_base::out);
+        f.write_matrix(*mat, tile_rows, tile_cols);
         return 0;
-    } catch (...) {
+    } catch (const FileError& e) {
         return 1;
     }
 }
 
-int nar_pm_set_safe(nar_pm mat, int i, int j, void* x) {
+// Adds vector to archive under name, replacing any entry with that name.
+int nar_pv_archive_put(nar_archive archive, const char* name, nar_pv v) {
     try {
-        mat->at(i,j) = x;
+        archive->put(name, *v);
         return 0;
-    } catch (...) {
+    } catch (const FileError& e) {
         return 1;
     }
 }
 
-// Reads vector from file. If there's an error, puts error code in err.
-nar_pv nar_pv_read(const char* filename, int* err) {
+// Reads the named vector from archive.
+// If there's an error, puts error code in err.
+nar_pv nar_pv_archive_get(nar_archive archive, const char* name, int* err) {
     try {
-        File<void*> f(filename, ios_base::in);
-        nar_pv v = new Vector<void*>(f.read_vector());
+        nar_pv v = new Vector<void*>(
+            archive->get_vector<void*>(name));
         if (err) *err = 0;
         return v;
     } catch (const FileError& e) {
@@ -2573,22 +11803,13 @@ nar_pv nar_pv_read(const char* filename, int* err) {
     }
 }
 
-// Writes vector to file.
-int nar_pv_write(nar_pv v, const char* filename, const char* sep) {
-    try {
-        File<void*> f(filename, ios_base::out);
-        f.write_vector(*v, sep);
-        return 0;
-    } catch (const FileError& e) {
-        return 1;
-    }
-}
-
-// Reads MATRIX from file. If there's an error, puts error code in err.
-nar_pm nar_pm_read(const char* filename, int row_major, int* err) {
+// Maps the named vector from archive into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_pv nar_pv_archive_map(nar_archive archive, const char* name, enum nar_map_mode mode, int* err) {
     try {
-        File<void*> f(filename, ios_base::in);
-        nar_pm v = new Matrix<void*>(f.read_matrix(row_major));
+        nar_pv v = new Vector<void*>(
+            archive->map_vector<void*>(name, (MapMode) mode));
         if (err) *err = 0;
         return v;
     } catch (const FileError& e) {
@@ -2600,26 +11821,24 @@ nar_pm nar_pm_read(const char* filename, int row_major, int* err) {
     }
 }
 
-// Writes MATRIX to file.
-int nar_pm_write(nar_pm v, const char* filename, const char* sep) {
+// Adds matrix to archive under name, replacing any entry with that name.
+int nar_pm_archive_put(nar_archive archive, const char* name, nar_pm mat) {
     try {
-        File<void*> f(filename, ios_base::out);
-        f.write_matrix(*v, sep);
+        archive->put(name, *mat);
         return 0;
     } catch (const FileError& e) {
         return 1;
     }
 }
 
-
-
-// Reads vector from file. If there's an error, puts error code in err.
-nar_pv nar_pv_read_binary(const char* filename, int* err) {
+// Reads the named matrix from archive, in the order it was stored in.
+// If there's an error, puts error code in err.
+nar_pm nar_pm_archive_get(nar_archive archive, const char* name, int* err) {
     try {
-        BinaryFile<void*> f(filename, ios_base::in);
-        nar_pv v = new Vector<void*>(f.read_vector());
+        nar_pm mat = new Matrix<void*>(
+            archive->get_matrix<void*>(name));
         if (err) *err = 0;
-        return v;
+        return mat;
     } catch (const FileError& e) {
         if (err) *err = 1;
         return nullptr;
@@ -2629,24 +11848,72 @@ nar_pv nar_pv_read_binary(const char* filename, int* err) {
     }
 }
 
-// Writes vector to file.
-int nar_pv_write_binary(nar_pv v, const char* filename) {
+// Maps the named matrix from archive into memory.
+// The file stays mapped until the last view of it is freed.
+// If there's an error, puts error code in err.
+nar_pm nar_pm_archive_map(nar_archive archive, const char* name, enum nar_map_mode mode, int* err) {
     try {
-        BinaryFile<void*> f(filename, ios_base::out);
-        f.write_vector(*v);
-        return 0;
+        nar_pm mat = new Matrix<void*>(
+            archive->map_matrix<void*>(name, (MapMode) mode));
+        if (err) *err = 0;
+        return mat;
     } catch (const FileError& e) {
-        return 1;
+        if (err) *err = 1;
+        return nullptr;
+    } catch (const FormatError& e) {
+        if (err) *err = 2;
+        return nullptr;
     }
 }
 
-// Reads MATRIX from file. If there's an error, puts error code in err.
-nar_pm nar_pm_read_binary(const char* filename, int row_major, int* err) {
+
+
+// Threads used by the parallel file routines. 0 means one per core.
+// Asynchronous reads and writes pick up changes when next started.
+void nar_set_io_threads(int threads) {
+    io_threads() = threads;
+}
+
+int nar_get_io_threads(void) {
+    return io_threads();
+}
+
+// Threads used by matrix products and expression evaluation. Work too
+// small to gain from more threads runs on fewer. 0 means one per core.
+void nar_set_num_threads(int threads) {
+    compute_threads() = threads;
+}
+
+int nar_get_num_threads(void) {
+    return compute_threads();
+}
+
+// Whether an asynchronous read or write has finished
+int nar_future_poll(nar_future future) {
+    return future->ready();
+}
+
+// Waits for an asynchronous read or write and frees the future.
+// Returns what was read (null for writes) and puts the error code
+// or write status in err. The code is 3 if it failed some other way,
+// such as running out of memory.
+void* nar_future_wait(nar_future future, int* err) {
+    Future::Result result(nullptr, async_error);
     try {
-        BinaryFile<void*> f(filename, ios_base::in);
-        nar_pm v = new Matrix<void*>(f.read_matrix(row_major));
+        result = future->get();
+    } catch (...) {}
+    delete future;
+    if (err) *err = result.second;
+    return result.first;
+}
+
+// Opens an archive of named vectors and matrices.
+// If there's an error, puts error code in err.
+nar_archive nar_archive_open(const char* filename, enum nar_archive_mode mode, int* err) {
+    try {
+        nar_archive archive = new Archive(filename, (ArchiveMode) mode);
         if (err) *err = 0;
-        return v;
+        return archive;
     } catch (const FileError& e) {
         if (err) *err = 1;
         return nullptr;
@@ -2656,21 +11923,127 @@ nar_pm nar_pm_read_binary(const char* filename, int row_major, int* err) {
     }
 }
 
-// Writes MATRIX to file.
-int nar_pm_write_binary(nar_pm v, const char* filename) {
+// Writes the directory of a writable archive and frees it.
+// Returns 1 if the directory couldn't be written.
+int nar_archive_close(nar_archive archive) {
+    int status = 0;
     try {
-        BinaryFile<void*> f(filename, ios_base::out);
-        f.write_matrix(*v);
-        return 0;
+        archive->close();
     } catch (const FileError& e) {
-        return 1;
+        status = 1;
     }
+    delete archive;
+    return status;
 }
 
-
-
+int nar_archive_contains(nar_archive archive, const char* name) {
+    return archive->contains(name);
+}
 
 // Need this to delete strings outputted from this library
 void nar_string_free(char* s) {
     delete[] s;
 }
+
+// Elementwise expressions over double vectors and matrices, evaluated
+// in one fused pass by nar_expr_eval_into. Building an expression
+// doesn't consume its operands; free every nar_expr with nar_expr_free.
+
+nar_expr nar_expr_var(nar_dv v) {
+    return new RuntimeExpression(RuntimeExpression::variable(*v));
+}
+
+nar_expr nar_expr_var_matrix(nar_dm mat) {
+    return new RuntimeExpression(RuntimeExpression::variable(*mat));
+}
+
+// A scalar, which takes the shape of whatever it's combined with
+nar_expr nar_expr_const(double x) {
+    return new RuntimeExpression(RuntimeExpression::constant(x));
+}
+
+nar_expr nar_expr_add(nar_expr a, nar_expr b) {
+    return new RuntimeExpression(RuntimeExpression::binary(ADD_EXPR, *a, *b));
+}
+
+nar_expr nar_expr_sub(nar_expr a, nar_expr b) {
+    return new RuntimeExpression(RuntimeExpression::binary(SUBTRACT_EXPR, *a, *b));
+}
+
+nar_expr nar_expr_mul(nar_expr a, nar_expr b) {
+    return new RuntimeExpression(RuntimeExpression::binary(MULTIPLY_EXPR, *a, *b));
+}
+
+nar_expr nar_expr_div(nar_expr a, nar_expr b) {
+    return new RuntimeExpression(RuntimeExpression::binary(DIVIDE_EXPR, *a, *b));
+}
+
+nar_expr nar_expr_pow(nar_expr a, nar_expr b) {
+    return new RuntimeExpression(RuntimeExpression::binary(POW_EXPR, *a, *b));
+}
+
+// Minimum and maximum as fmin and fmax, which ignore NaN
+nar_expr nar_expr_min(nar_expr a, nar_expr b) {
+    return new RuntimeExpression(RuntimeExpression::binary(MIN_EXPR, *a, *b));
+}
+
+nar_expr nar_expr_max(nar_expr a, nar_expr b) {
+    return new RuntimeExpression(RuntimeExpression::binary(MAX_EXPR, *a, *b));
+}
+
+nar_expr nar_expr_neg(nar_expr a) {
+    return new RuntimeExpression(RuntimeExpression::unary(NEGATE_EXPR, *a));
+}
+
+nar_expr nar_expr_abs(nar_expr a) {
+    return new RuntimeExpression(RuntimeExpression::unary(ABS_EXPR, *a));
+}
+
+nar_expr nar_expr_exp(nar_expr a) {
+    return new RuntimeExpression(RuntimeExpression::unary(EXP_EXPR, *a));
+}
+
+nar_expr nar_expr_log(nar_expr a) {
+    return new RuntimeExpression(RuntimeExpression::unary(LOG_EXPR, *a));
+}
+
+nar_expr nar_expr_sqrt(nar_expr a) {
+    return new RuntimeExpression(RuntimeExpression::unary(SQRT_EXPR, *a));
+}
+
+nar_expr nar_expr_sin(nar_expr a) {
+    return new RuntimeExpression(RuntimeExpression::unary(SIN_EXPR, *a));
+}
+
+nar_expr nar_expr_cos(nar_expr a) {
+    return new RuntimeExpression(RuntimeExpression::unary(COS_EXPR, *a));
+}
+
+nar_expr nar_expr_tanh(nar_expr a) {
+    return new RuntimeExpression(RuntimeExpression::unary(TANH_EXPR, *a));
+}
+
+// Overwrites the elements of dest with the value of e. Variables may be
+// dest itself, but not other views that overlap it. Returns 1 if the
+// dimensions don't match.
+int nar_expr_eval_into(nar_expr e, nar_dv dest) {
+    try {
+        e->evaluate_into(*dest);
+        return 0;
+    } catch (const DimensionError& err) {
+        return 1;
+    }
+}
+
+int nar_expr_eval_into_matrix(nar_expr e, nar_dm dest) {
+    try {
+        e->evaluate_into(*dest);
+        return 0;
+    } catch (const DimensionError& err) {
+        return 1;
+    }
+}
+
+void nar_expr_free(nar_expr e) {
+    delete e;
+}
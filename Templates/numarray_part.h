@@ -1,14 +1,132 @@
 /* This file was automatically generated.  Do not edit! */
 #undef INTERFACE
+void nar_expr_free(nar_expr e);
+int nar_expr_eval_into_matrix(nar_expr e,nar_dm dest);
+int nar_expr_eval_into(nar_expr e,nar_dv dest);
+nar_expr nar_expr_tanh(nar_expr a);
+nar_expr nar_expr_cos(nar_expr a);
+nar_expr nar_expr_sin(nar_expr a);
+nar_expr nar_expr_sqrt(nar_expr a);
+nar_expr nar_expr_log(nar_expr a);
+nar_expr nar_expr_exp(nar_expr a);
+nar_expr nar_expr_abs(nar_expr a);
+nar_expr nar_expr_neg(nar_expr a);
+nar_expr nar_expr_max(nar_expr a,nar_expr b);
+nar_expr nar_expr_min(nar_expr a,nar_expr b);
+nar_expr nar_expr_pow(nar_expr a,nar_expr b);
+nar_expr nar_expr_div(nar_expr a,nar_expr b);
+nar_expr nar_expr_mul(nar_expr a,nar_expr b);
+nar_expr nar_expr_sub(nar_expr a,nar_expr b);
+nar_expr nar_expr_add(nar_expr a,nar_expr b);
+nar_expr nar_expr_const(double x);
+nar_expr nar_expr_var_matrix(nar_dm mat);
+nar_expr nar_expr_var(nar_dv v);
 void nar_string_free(char *s);
+int nar_archive_contains(nar_archive archive,const char *name);
+int nar_archive_close(nar_archive archive);
+nar_archive nar_archive_open(const char *filename,enum nar_archive_mode mode,int *err);
+void *nar_future_wait(nar_future future,int *err);
+int nar_future_poll(nar_future future);
+int nar_get_num_threads(void);
+void nar_set_num_threads(int threads);
+int nar_get_io_threads(void);
+void nar_set_io_threads(int threads);
+nar_pm nar_pm_archive_map(nar_archive archive,const char *name,enum nar_map_mode mode,int *err);
+nar_pm nar_pm_archive_get(nar_archive archive,const char *name,int *err);
+int nar_pm_archive_put(nar_archive archive,const char *name,nar_pm mat);
+nar_pv nar_pv_archive_map(nar_archive archive,const char *name,enum nar_map_mode mode,int *err);
+nar_pv nar_pv_archive_get(nar_archive archive,const char *name,int *err);
+int nar_pv_archive_put(nar_archive archive,const char *name,nar_pv v);
+int nar_pm_write_tiled(nar_pm mat,const char *filename,int tile_rows,int tile_cols);
+nar_pm nar_pm_read_tiled(const char *filename,int row_major,int *err);
+void nar_pm_reader_close(nar_pm_reader reader);
+nar_pm_reader nar_pm_reader_open_binary(const char *filename,int *err);
+nar_pm_reader nar_pm_reader_open(const char *filename,int *err);
+int nar_pm_write_npy(nar_pm mat,const char *filename);
+nar_pm nar_pm_read_npz(const char *filename,const char *name,int *err);
+nar_pm nar_pm_read_npy(const char *filename,int *err);
+int nar_pv_write_npy(nar_pv v,const char *filename);
+nar_pv nar_pv_read_npz(const char *filename,const char *name,int *err);
+nar_pv nar_pv_read_npy(const char *filename,int *err);
+int nar_pm_write_binary_compressed(nar_pm mat,const char *filename);
+int nar_pv_write_binary_compressed(nar_pv v,const char *filename);
+nar_pm nar_pm_mmap(const char *filename,enum nar_map_mode mode,int *err);
+nar_pv nar_pv_mmap(const char *filename,enum nar_map_mode mode,int *err);
+nar_future nar_pm_write_binary_async(nar_pm mat,const char *filename);
+nar_future nar_pm_read_binary_async(const char *filename,int row_major);
+nar_future nar_pv_write_binary_async(nar_pv v,const char *filename);
+nar_future nar_pv_read_binary_async(const char *filename);
+int nar_pm_read_binary_into(nar_pm dest,const char *filename);
+int nar_pv_read_binary_into(nar_pv dest,const char *filename);
 int nar_pm_write_binary(nar_pm v,const char *filename);
 nar_pm nar_pm_read_binary(const char *filename,int row_major,int *err);
 int nar_pv_write_binary(nar_pv v,const char *filename);
 nar_pv nar_pv_read_binary(const char *filename,int *err);
+int nar_pm_write_precision(nar_pm v,const char *filename,const char *sep,int precision);
+int nar_pv_write_precision(nar_pv v,const char *filename,const char *sep,int precision);
+nar_future nar_pm_write_async(nar_pm mat,const char *filename,const char *sep);
+nar_future nar_pm_read_async(const char *filename,int row_major);
+nar_future nar_pv_write_async(nar_pv v,const char *filename,const char *sep);
+nar_future nar_pv_read_async(const char *filename);
+int nar_pm_read_into(nar_pm dest,const char *filename);
+int nar_pv_read_into(nar_pv dest,const char *filename);
 int nar_pm_write(nar_pm v,const char *filename,const char *sep);
 nar_pm nar_pm_read(const char *filename,int row_major,int *err);
 int nar_pv_write(nar_pv v,const char *filename,const char *sep);
 nar_pv nar_pv_read(const char *filename,int *err);
+nar_pm nar_pm_reader_next_64(nar_pm_reader reader,int64_t max_rows,int *err);
+nar_pm nar_pm_read_tiled_subarray_64(const char *filename,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major,int *err);
+nar_pm nar_pm_read_binary_subarray_64(const char *filename,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major,int *err);
+int nar_pm_scatter_64(nar_pm mat,const int64_t *rows_idx,const int64_t *cols_idx,int64_t count,void *const *in);
+int nar_pm_gather_64(void **out,nar_pm mat,const int64_t *rows_idx,const int64_t *cols_idx,int64_t count);
+int nar_pm_set_block_64(nar_pm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,void *const *in,int row_major);
+int nar_pm_get_block_64(void **out,nar_pm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major);
+int nar_pv_scatter_64(nar_pv v,const int64_t *idx,int64_t count,void *const *in);
+int nar_pv_gather_64(void **out,nar_pv v,const int64_t *idx,int64_t count);
+int nar_pv_set_range_64(nar_pv v,int64_t start,int64_t end,void *const *in);
+int nar_pv_get_range_64(void **out,nar_pv v,int64_t start,int64_t end);
+int nar_pm_set_safe_64(nar_pm mat,int64_t i,int64_t j,void *x);
+int nar_pm_get_safe_64(void **x,nar_pm mat,int64_t i,int64_t j);
+int nar_pv_set_safe_64(nar_pv v,int64_t i,void *x);
+int nar_pv_get_safe_64(void **x,nar_pv v,int64_t i);
+void nar_pm_set_64(nar_pm mat,int64_t i,int64_t j,void *x);
+void *nar_pm_get_64(nar_pm mat,int64_t i,int64_t j);
+void nar_pv_set_64(nar_pv v,int64_t i,void *x);
+void *nar_pv_get_64(nar_pv v,int64_t i);
+int64_t nar_pm_get_cols_64(nar_pm mat);
+int64_t nar_pm_get_rows_64(nar_pm mat);
+int64_t nar_pm_inc_col_64(nar_pm mat);
+int64_t nar_pm_inc_row_64(nar_pm mat);
+int64_t nar_pm_get_ld_64(nar_pm mat);
+int nar_pm_subarray_safe_64(nar_pm *x,nar_pm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col);
+int nar_pm_col_safe_64(nar_pv *x,nar_pm mat,int64_t j);
+int nar_pm_row_safe_64(nar_pv *x,nar_pm mat,int64_t i);
+nar_pm nar_pm_subarray_64(nar_pm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col);
+nar_pv nar_pm_col_64(nar_pm mat,int64_t j);
+nar_pv nar_pm_row_64(nar_pm mat,int64_t i);
+int nar_pm_valid_64(nar_pm mat,int64_t i,int64_t j);
+nar_pm nar_pm_wrap_64(void **ptr,int64_t rows,int64_t cols,int64_t inc_row,int64_t inc_col,nar_release_fn release,void *ctx);
+nar_pm nar_pm_alloc_uninit_64(int64_t rows,int64_t cols,int row_major);
+nar_pm nar_pm_alloc_64(int64_t rows,int64_t cols,int row_major);
+int64_t nar_pv_n_64(nar_pv v);
+int64_t nar_pv_inc_64(nar_pv v);
+int nar_pv_slice_safe_64(nar_pv *out,nar_pv v,int64_t start,int64_t end);
+nar_pv nar_pv_slice_64(nar_pv v,int64_t start,int64_t end);
+int nar_pv_valid_64(nar_pv v,int64_t i);
+nar_pv nar_pv_wrap_64(void **ptr,int64_t n,int64_t inc,nar_release_fn release,void *ctx);
+nar_pv nar_pv_alloc_uninit_64(int64_t n);
+nar_pv nar_pv_alloc_64(int64_t n);
+nar_pm nar_pm_reader_next(nar_pm_reader reader,int max_rows,int *err);
+nar_pm nar_pm_read_tiled_subarray(const char *filename,int start_row,int start_col,int end_row,int end_col,int row_major,int *err);
+nar_pm nar_pm_read_binary_subarray(const char *filename,int start_row,int start_col,int end_row,int end_col,int row_major,int *err);
+int nar_pm_scatter(nar_pm mat,const int *rows_idx,const int *cols_idx,int count,void *const *in);
+int nar_pm_gather(void **out,nar_pm mat,const int *rows_idx,const int *cols_idx,int count);
+int nar_pm_set_block(nar_pm mat,int start_row,int start_col,int end_row,int end_col,void *const *in,int row_major);
+int nar_pm_get_block(void **out,nar_pm mat,int start_row,int start_col,int end_row,int end_col,int row_major);
+int nar_pv_scatter(nar_pv v,const int *idx,int count,void *const *in);
+int nar_pv_gather(void **out,nar_pv v,const int *idx,int count);
+int nar_pv_set_range(nar_pv v,int start,int end,void *const *in);
+int nar_pv_get_range(void **out,nar_pv v,int start,int end);
 int nar_pm_set_safe(nar_pm mat,int i,int j,void *x);
 int nar_pm_get_safe(void **x,nar_pm mat,int i,int j);
 int nar_pv_set_safe(nar_pv v,int i,void *x);
@@ -17,44 +135,140 @@ void nar_pm_set(nar_pm mat,int i,int j,void *x);
 void *nar_pm_get(nar_pm mat,int i,int j);
 void nar_pv_set(nar_pv v,int i,void *x);
 void *nar_pv_get(nar_pv v,int i);
-char *nar_pv_display_string(nar_pv v);
-char *nar_pm_display_string(nar_pm mat);
-int nar_pm_assign(nar_pm mat1,nar_pm mat2);
-int nar_pm_eq(nar_pm mat1,nar_pm mat2);
 int nar_pm_get_cols(nar_pm mat);
 int nar_pm_get_rows(nar_pm mat);
+int nar_pm_inc_col(nar_pm mat);
+int nar_pm_inc_row(nar_pm mat);
 int nar_pm_get_ld(nar_pm mat);
-void **nar_pm_pointer(nar_pm mat);
 int nar_pm_subarray_safe(nar_pm *x,nar_pm mat,int start_row,int start_col,int end_row,int end_col);
 int nar_pm_col_safe(nar_pv *x,nar_pm mat,int j);
 int nar_pm_row_safe(nar_pv *x,nar_pm mat,int i);
 nar_pm nar_pm_subarray(nar_pm mat,int start_row,int start_col,int end_row,int end_col);
 nar_pv nar_pm_col(nar_pm mat,int j);
 nar_pv nar_pm_row(nar_pm mat,int i);
-enum nar_order nar_pm_order(nar_pm mat);
 int nar_pm_valid(nar_pm mat,int i,int j);
-nar_pm nar_pm_copy(nar_pm mat);
-void nar_pm_free(nar_pm mat);
+nar_pm nar_pm_wrap(void **ptr,int rows,int cols,int inc_row,int inc_col,nar_release_fn release,void *ctx);
+nar_pm nar_pm_alloc_uninit(int rows,int cols,int row_major);
 nar_pm nar_pm_alloc(int rows,int cols,int row_major);
-int nar_pv_assign(nar_pv v1,nar_pv v2);
-int nar_pv_eq(nar_pv v1,nar_pv v2);
 int nar_pv_n(nar_pv v);
 int nar_pv_inc(nar_pv v);
-void **nar_pv_pointer(nar_pv v);
 int nar_pv_slice_safe(nar_pv *out,nar_pv v,int start,int end);
 nar_pv nar_pv_slice(nar_pv v,int start,int end);
 int nar_pv_valid(nar_pv v,int i);
+nar_pv nar_pv_wrap(void **ptr,int n,int inc,nar_release_fn release,void *ctx);
+nar_pv nar_pv_alloc_uninit(int n);
+nar_pv nar_pv_alloc(int n);
+char *nar_pv_display_string(nar_pv v);
+char *nar_pm_display_string(nar_pm mat);
+int nar_pm_assign(nar_pm mat1,nar_pm mat2);
+int nar_pm_eq(nar_pm mat1,nar_pm mat2);
+void nar_pm_describe(nar_pm mat,struct nar_view *out);
+void **nar_pm_pointer(nar_pm mat);
+enum nar_order nar_pm_order(nar_pm mat);
+nar_pm nar_pm_copy(nar_pm mat);
+void nar_pm_free(nar_pm mat);
+int nar_pv_assign(nar_pv v1,nar_pv v2);
+int nar_pv_eq(nar_pv v1,nar_pv v2);
+void nar_pv_describe(nar_pv v,struct nar_view *out);
+void **nar_pv_pointer(nar_pv v);
 nar_pv nar_pv_copy(nar_pv v);
 void nar_pv_free(nar_pv v);
-nar_pv nar_pv_alloc(int n);
+nar_xm nar_xm_archive_map(nar_archive archive,const char *name,enum nar_map_mode mode,int *err);
+nar_xm nar_xm_archive_get(nar_archive archive,const char *name,int *err);
+int nar_xm_archive_put(nar_archive archive,const char *name,nar_xm mat);
+nar_xv nar_xv_archive_map(nar_archive archive,const char *name,enum nar_map_mode mode,int *err);
+nar_xv nar_xv_archive_get(nar_archive archive,const char *name,int *err);
+int nar_xv_archive_put(nar_archive archive,const char *name,nar_xv v);
+int nar_xm_write_tiled(nar_xm mat,const char *filename,int tile_rows,int tile_cols);
+nar_xm nar_xm_read_tiled(const char *filename,int row_major,int *err);
+void nar_xm_reader_close(nar_xm_reader reader);
+nar_xm_reader nar_xm_reader_open_binary(const char *filename,int *err);
+nar_xm_reader nar_xm_reader_open(const char *filename,int *err);
+int nar_xm_write_npy(nar_xm mat,const char *filename);
+nar_xm nar_xm_read_npz(const char *filename,const char *name,int *err);
+nar_xm nar_xm_read_npy(const char *filename,int *err);
+int nar_xv_write_npy(nar_xv v,const char *filename);
+nar_xv nar_xv_read_npz(const char *filename,const char *name,int *err);
+nar_xv nar_xv_read_npy(const char *filename,int *err);
+int nar_xm_write_binary_compressed(nar_xm mat,const char *filename);
+int nar_xv_write_binary_compressed(nar_xv v,const char *filename);
+nar_xm nar_xm_mmap(const char *filename,enum nar_map_mode mode,int *err);
+nar_xv nar_xv_mmap(const char *filename,enum nar_map_mode mode,int *err);
+nar_future nar_xm_write_binary_async(nar_xm mat,const char *filename);
+nar_future nar_xm_read_binary_async(const char *filename,int row_major);
+nar_future nar_xv_write_binary_async(nar_xv v,const char *filename);
+nar_future nar_xv_read_binary_async(const char *filename);
+int nar_xm_read_binary_into(nar_xm dest,const char *filename);
+int nar_xv_read_binary_into(nar_xv dest,const char *filename);
 int nar_xm_write_binary(nar_xm v,const char *filename);
 nar_xm nar_xm_read_binary(const char *filename,int row_major,int *err);
 int nar_xv_write_binary(nar_xv v,const char *filename);
 nar_xv nar_xv_read_binary(const char *filename,int *err);
+int nar_xm_write_precision(nar_xm v,const char *filename,const char *sep,int precision);
+int nar_xv_write_precision(nar_xv v,const char *filename,const char *sep,int precision);
+nar_future nar_xm_write_async(nar_xm mat,const char *filename,const char *sep);
+nar_future nar_xm_read_async(const char *filename,int row_major);
+nar_future nar_xv_write_async(nar_xv v,const char *filename,const char *sep);
+nar_future nar_xv_read_async(const char *filename);
+int nar_xm_read_into(nar_xm dest,const char *filename);
+int nar_xv_read_into(nar_xv dest,const char *filename);
 int nar_xm_write(nar_xm v,const char *filename,const char *sep);
 nar_xm nar_xm_read(const char *filename,int row_major,int *err);
 int nar_xv_write(nar_xv v,const char *filename,const char *sep);
 nar_xv nar_xv_read(const char *filename,int *err);
+nar_xm nar_xm_reader_next_64(nar_xm_reader reader,int64_t max_rows,int *err);
+nar_xm nar_xm_read_tiled_subarray_64(const char *filename,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major,int *err);
+nar_xm nar_xm_read_binary_subarray_64(const char *filename,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major,int *err);
+int nar_xm_scatter_64(nar_xm mat,const int64_t *rows_idx,const int64_t *cols_idx,int64_t count,char const *in);
+int nar_xm_gather_64(char *out,nar_xm mat,const int64_t *rows_idx,const int64_t *cols_idx,int64_t count);
+int nar_xm_set_block_64(nar_xm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,char const *in,int row_major);
+int nar_xm_get_block_64(char *out,nar_xm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major);
+int nar_xv_scatter_64(nar_xv v,const int64_t *idx,int64_t count,char const *in);
+int nar_xv_gather_64(char *out,nar_xv v,const int64_t *idx,int64_t count);
+int nar_xv_set_range_64(nar_xv v,int64_t start,int64_t end,char const *in);
+int nar_xv_get_range_64(char *out,nar_xv v,int64_t start,int64_t end);
+int nar_xm_set_safe_64(nar_xm mat,int64_t i,int64_t j,char x);
+int nar_xm_get_safe_64(char *x,nar_xm mat,int64_t i,int64_t j);
+int nar_xv_set_safe_64(nar_xv v,int64_t i,char x);
+int nar_xv_get_safe_64(char *x,nar_xv v,int64_t i);
+void nar_xm_set_64(nar_xm mat,int64_t i,int64_t j,char x);
+char nar_xm_get_64(nar_xm mat,int64_t i,int64_t j);
+void nar_xv_set_64(nar_xv v,int64_t i,char x);
+char nar_xv_get_64(nar_xv v,int64_t i);
+int64_t nar_xm_get_cols_64(nar_xm mat);
+int64_t nar_xm_get_rows_64(nar_xm mat);
+int64_t nar_xm_inc_col_64(nar_xm mat);
+int64_t nar_xm_inc_row_64(nar_xm mat);
+int64_t nar_xm_get_ld_64(nar_xm mat);
+int nar_xm_subarray_safe_64(nar_xm *x,nar_xm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col);
+int nar_xm_col_safe_64(nar_xv *x,nar_xm mat,int64_t j);
+int nar_xm_row_safe_64(nar_xv *x,nar_xm mat,int64_t i);
+nar_xm nar_xm_subarray_64(nar_xm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col);
+nar_xv nar_xm_col_64(nar_xm mat,int64_t j);
+nar_xv nar_xm_row_64(nar_xm mat,int64_t i);
+int nar_xm_valid_64(nar_xm mat,int64_t i,int64_t j);
+nar_xm nar_xm_wrap_64(char *ptr,int64_t rows,int64_t cols,int64_t inc_row,int64_t inc_col,nar_release_fn release,void *ctx);
+nar_xm nar_xm_alloc_uninit_64(int64_t rows,int64_t cols,int row_major);
+nar_xm nar_xm_alloc_64(int64_t rows,int64_t cols,int row_major);
+int64_t nar_xv_n_64(nar_xv v);
+int64_t nar_xv_inc_64(nar_xv v);
+int nar_xv_slice_safe_64(nar_xv *out,nar_xv v,int64_t start,int64_t end);
+nar_xv nar_xv_slice_64(nar_xv v,int64_t start,int64_t end);
+int nar_xv_valid_64(nar_xv v,int64_t i);
+nar_xv nar_xv_wrap_64(char *ptr,int64_t n,int64_t inc,nar_release_fn release,void *ctx);
+nar_xv nar_xv_alloc_uninit_64(int64_t n);
+nar_xv nar_xv_alloc_64(int64_t n);
+nar_xm nar_xm_reader_next(nar_xm_reader reader,int max_rows,int *err);
+nar_xm nar_xm_read_tiled_subarray(const char *filename,int start_row,int start_col,int end_row,int end_col,int row_major,int *err);
+nar_xm nar_xm_read_binary_subarray(const char *filename,int start_row,int start_col,int end_row,int end_col,int row_major,int *err);
+int nar_xm_scatter(nar_xm mat,const int *rows_idx,const int *cols_idx,int count,char const *in);
+int nar_xm_gather(char *out,nar_xm mat,const int *rows_idx,const int *cols_idx,int count);
+int nar_xm_set_block(nar_xm mat,int start_row,int start_col,int end_row,int end_col,char const *in,int row_major);
+int nar_xm_get_block(char *out,nar_xm mat,int start_row,int start_col,int end_row,int end_col,int row_major);
+int nar_xv_scatter(nar_xv v,const int *idx,int count,char const *in);
+int nar_xv_gather(char *out,nar_xv v,const int *idx,int count);
+int nar_xv_set_range(nar_xv v,int start,int end,char const *in);
+int nar_xv_get_range(char *out,nar_xv v,int start,int end);
 int nar_xm_set_safe(nar_xm mat,int i,int j,char x);
 int nar_xm_get_safe(char *x,nar_xm mat,int i,int j);
 int nar_xv_set_safe(nar_xv v,int i,char x);
@@ -63,44 +277,150 @@ void nar_xm_set(nar_xm mat,int i,int j,char x);
 char nar_xm_get(nar_xm mat,int i,int j);
 void nar_xv_set(nar_xv v,int i,char x);
 char nar_xv_get(nar_xv v,int i);
-char *nar_xv_display_string(nar_xv v);
-char *nar_xm_display_string(nar_xm mat);
-int nar_xm_assign(nar_xm mat1,nar_xm mat2);
-int nar_xm_eq(nar_xm mat1,nar_xm mat2);
 int nar_xm_get_cols(nar_xm mat);
 int nar_xm_get_rows(nar_xm mat);
+int nar_xm_inc_col(nar_xm mat);
+int nar_xm_inc_row(nar_xm mat);
 int nar_xm_get_ld(nar_xm mat);
-char *nar_xm_pointer(nar_xm mat);
 int nar_xm_subarray_safe(nar_xm *x,nar_xm mat,int start_row,int start_col,int end_row,int end_col);
 int nar_xm_col_safe(nar_xv *x,nar_xm mat,int j);
 int nar_xm_row_safe(nar_xv *x,nar_xm mat,int i);
 nar_xm nar_xm_subarray(nar_xm mat,int start_row,int start_col,int end_row,int end_col);
 nar_xv nar_xm_col(nar_xm mat,int j);
 nar_xv nar_xm_row(nar_xm mat,int i);
-enum nar_order nar_xm_order(nar_xm mat);
 int nar_xm_valid(nar_xm mat,int i,int j);
-nar_xm nar_xm_copy(nar_xm mat);
-void nar_xm_free(nar_xm mat);
+nar_xm nar_xm_wrap(char *ptr,int rows,int cols,int inc_row,int inc_col,nar_release_fn release,void *ctx);
+nar_xm nar_xm_alloc_uninit(int rows,int cols,int row_major);
 nar_xm nar_xm_alloc(int rows,int cols,int row_major);
-int nar_xv_assign(nar_xv v1,nar_xv v2);
-int nar_xv_eq(nar_xv v1,nar_xv v2);
 int nar_xv_n(nar_xv v);
 int nar_xv_inc(nar_xv v);
-char *nar_xv_pointer(nar_xv v);
 int nar_xv_slice_safe(nar_xv *out,nar_xv v,int start,int end);
 nar_xv nar_xv_slice(nar_xv v,int start,int end);
 int nar_xv_valid(nar_xv v,int i);
+nar_xv nar_xv_wrap(char *ptr,int n,int inc,nar_release_fn release,void *ctx);
+nar_xv nar_xv_alloc_uninit(int n);
+nar_xv nar_xv_alloc(int n);
+char *nar_xv_display_string(nar_xv v);
+char *nar_xm_display_string(nar_xm mat);
+int nar_xm_assign(nar_xm mat1,nar_xm mat2);
+int nar_xm_eq(nar_xm mat1,nar_xm mat2);
+void nar_xm_describe(nar_xm mat,struct nar_view *out);
+char *nar_xm_pointer(nar_xm mat);
+enum nar_order nar_xm_order(nar_xm mat);
+nar_xm nar_xm_copy(nar_xm mat);
+void nar_xm_free(nar_xm mat);
+int nar_xv_assign(nar_xv v1,nar_xv v2);
+int nar_xv_eq(nar_xv v1,nar_xv v2);
+void nar_xv_describe(nar_xv v,struct nar_view *out);
+char *nar_xv_pointer(nar_xv v);
 nar_xv nar_xv_copy(nar_xv v);
 void nar_xv_free(nar_xv v);
-nar_xv nar_xv_alloc(int n);
+int nar_zm_gemv(double alpha_re,double alpha_im,nar_zm a,enum nar_transpose trans,nar_zv x,double beta_re,double beta_im,nar_zv y);
+int nar_zm_gemm(double alpha_re,double alpha_im,nar_zm a,enum nar_transpose trans_a,nar_zm b,enum nar_transpose trans_b,double beta_re,double beta_im,nar_zm c);
+double nar_zv_asum(nar_zv x);
+double nar_zv_nrm2(nar_zv x);
+void nar_zv_scal(double a,double b,nar_zv x);
+int nar_zv_dotc(double *a,double *b,nar_zv x,nar_zv y);
+int nar_zv_dot(double *a,double *b,nar_zv x,nar_zv y);
+int nar_zv_axpy(double a,double b,nar_zv x,nar_zv y);
+nar_zm nar_zm_archive_map(nar_archive archive,const char *name,enum nar_map_mode mode,int *err);
+nar_zm nar_zm_archive_get(nar_archive archive,const char *name,int *err);
+int nar_zm_archive_put(nar_archive archive,const char *name,nar_zm mat);
+nar_zv nar_zv_archive_map(nar_archive archive,const char *name,enum nar_map_mode mode,int *err);
+nar_zv nar_zv_archive_get(nar_archive archive,const char *name,int *err);
+int nar_zv_archive_put(nar_archive archive,const char *name,nar_zv v);
+int nar_zm_write_tiled(nar_zm mat,const char *filename,int tile_rows,int tile_cols);
+nar_zm nar_zm_read_tiled(const char *filename,int row_major,int *err);
+void nar_zm_reader_close(nar_zm_reader reader);
+nar_zm_reader nar_zm_reader_open_binary(const char *filename,int *err);
+nar_zm_reader nar_zm_reader_open(const char *filename,int *err);
+int nar_zm_write_npy(nar_zm mat,const char *filename);
+nar_zm nar_zm_read_npz(const char *filename,const char *name,int *err);
+nar_zm nar_zm_read_npy(const char *filename,int *err);
+int nar_zv_write_npy(nar_zv v,const char *filename);
+nar_zv nar_zv_read_npz(const char *filename,const char *name,int *err);
+nar_zv nar_zv_read_npy(const char *filename,int *err);
+int nar_zm_write_binary_compressed(nar_zm mat,const char *filename);
+int nar_zv_write_binary_compressed(nar_zv v,const char *filename);
+nar_zm nar_zm_mmap(const char *filename,enum nar_map_mode mode,int *err);
+nar_zv nar_zv_mmap(const char *filename,enum nar_map_mode mode,int *err);
+nar_future nar_zm_write_binary_async(nar_zm mat,const char *filename);
+nar_future nar_zm_read_binary_async(const char *filename,int row_major);
+nar_future nar_zv_write_binary_async(nar_zv v,const char *filename);
+nar_future nar_zv_read_binary_async(const char *filename);
+int nar_zm_read_binary_into(nar_zm dest,const char *filename);
+int nar_zv_read_binary_into(nar_zv dest,const char *filename);
 int nar_zm_write_binary(nar_zm v,const char *filename);
 nar_zm nar_zm_read_binary(const char *filename,int row_major,int *err);
 int nar_zv_write_binary(nar_zv v,const char *filename);
 nar_zv nar_zv_read_binary(const char *filename,int *err);
+int nar_zm_write_precision(nar_zm v,const char *filename,const char *sep,int precision);
+int nar_zv_write_precision(nar_zv v,const char *filename,const char *sep,int precision);
+nar_future nar_zm_write_async(nar_zm mat,const char *filename,const char *sep);
+nar_future nar_zm_read_async(const char *filename,int row_major);
+nar_future nar_zv_write_async(nar_zv v,const char *filename,const char *sep);
+nar_future nar_zv_read_async(const char *filename);
+int nar_zm_read_into(nar_zm dest,const char *filename);
+int nar_zv_read_into(nar_zv dest,const char *filename);
 int nar_zm_write(nar_zm v,const char *filename,const char *sep);
 nar_zm nar_zm_read(const char *filename,int row_major,int *err);
 int nar_zv_write(nar_zv v,const char *filename,const char *sep);
 nar_zv nar_zv_read(const char *filename,int *err);
+nar_zm nar_zm_reader_next_64(nar_zm_reader reader,int64_t max_rows,int *err);
+int64_t nar_zv_iamax_64(nar_zv x);
+nar_zm nar_zm_read_tiled_subarray_64(const char *filename,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major,int *err);
+nar_zm nar_zm_read_binary_subarray_64(const char *filename,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major,int *err);
+int nar_zm_scatter_64(nar_zm mat,const int64_t *rows_idx,const int64_t *cols_idx,int64_t count,double const *in);
+int nar_zm_gather_64(double *out,nar_zm mat,const int64_t *rows_idx,const int64_t *cols_idx,int64_t count);
+int nar_zm_set_block_64(nar_zm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,double const *in,int row_major);
+int nar_zm_get_block_64(double *out,nar_zm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major);
+int nar_zv_scatter_64(nar_zv v,const int64_t *idx,int64_t count,double const *in);
+int nar_zv_gather_64(double *out,nar_zv v,const int64_t *idx,int64_t count);
+int nar_zv_set_range_64(nar_zv v,int64_t start,int64_t end,double const *in);
+int nar_zv_get_range_64(double *out,nar_zv v,int64_t start,int64_t end);
+int nar_zm_set_safe_64(nar_zm mat,int64_t i,int64_t j,double a,double b);
+int nar_zm_get_safe_64(double *a,double *b,nar_zm mat,int64_t i,int64_t j);
+int nar_zv_set_safe_64(nar_zv v,int64_t i,double a,double b);
+int nar_zv_get_safe_64(double *a,double *b,nar_zv v,int64_t i);
+void nar_zm_set_64(nar_zm mat,int64_t i,int64_t j,double a,double b);
+void nar_zm_get_64(double *a,double *b,nar_zm mat,int64_t i,int64_t j);
+void nar_zv_set_64(nar_zv v,int64_t i,double a,double b);
+void nar_zv_get_64(double *a,double *b,nar_zv v,int64_t i);
+int64_t nar_zm_get_cols_64(nar_zm mat);
+int64_t nar_zm_get_rows_64(nar_zm mat);
+int64_t nar_zm_inc_col_64(nar_zm mat);
+int64_t nar_zm_inc_row_64(nar_zm mat);
+int64_t nar_zm_get_ld_64(nar_zm mat);
+int nar_zm_subarray_safe_64(nar_zm *x,nar_zm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col);
+int nar_zm_col_safe_64(nar_zv *x,nar_zm mat,int64_t j);
+int nar_zm_row_safe_64(nar_zv *x,nar_zm mat,int64_t i);
+nar_zm nar_zm_subarray_64(nar_zm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col);
+nar_zv nar_zm_col_64(nar_zm mat,int64_t j);
+nar_zv nar_zm_row_64(nar_zm mat,int64_t i);
+int nar_zm_valid_64(nar_zm mat,int64_t i,int64_t j);
+nar_zm nar_zm_wrap_64(double *ptr,int64_t rows,int64_t cols,int64_t inc_row,int64_t inc_col,nar_release_fn release,void *ctx);
+nar_zm nar_zm_alloc_uninit_64(int64_t rows,int64_t cols,int row_major);
+nar_zm nar_zm_alloc_64(int64_t rows,int64_t cols,int row_major);
+int64_t nar_zv_n_64(nar_zv v);
+int64_t nar_zv_inc_64(nar_zv v);
+int nar_zv_slice_safe_64(nar_zv *out,nar_zv v,int64_t start,int64_t end);
+nar_zv nar_zv_slice_64(nar_zv v,int64_t start,int64_t end);
+int nar_zv_valid_64(nar_zv v,int64_t i);
+nar_zv nar_zv_wrap_64(double *ptr,int64_t n,int64_t inc,nar_release_fn release,void *ctx);
+nar_zv nar_zv_alloc_uninit_64(int64_t n);
+nar_zv nar_zv_alloc_64(int64_t n);
+nar_zm nar_zm_reader_next(nar_zm_reader reader,int max_rows,int *err);
+int nar_zv_iamax(nar_zv x);
+nar_zm nar_zm_read_tiled_subarray(const char *filename,int start_row,int start_col,int end_row,int end_col,int row_major,int *err);
+nar_zm nar_zm_read_binary_subarray(const char *filename,int start_row,int start_col,int end_row,int end_col,int row_major,int *err);
+int nar_zm_scatter(nar_zm mat,const int *rows_idx,const int *cols_idx,int count,double const *in);
+int nar_zm_gather(double *out,nar_zm mat,const int *rows_idx,const int *cols_idx,int count);
+int nar_zm_set_block(nar_zm mat,int start_row,int start_col,int end_row,int end_col,double const *in,int row_major);
+int nar_zm_get_block(double *out,nar_zm mat,int start_row,int start_col,int end_row,int end_col,int row_major);
+int nar_zv_scatter(nar_zv v,const int *idx,int count,double const *in);
+int nar_zv_gather(double *out,nar_zv v,const int *idx,int count);
+int nar_zv_set_range(nar_zv v,int start,int end,double const *in);
+int nar_zv_get_range(double *out,nar_zv v,int start,int end);
 int nar_zm_set_safe(nar_zm mat,int i,int j,double a,double b);
 int nar_zm_get_safe(double *a,double *b,nar_zm mat,int i,int j);
 int nar_zv_set_safe(nar_zv v,int i,double a,double b);
@@ -109,44 +429,150 @@ void nar_zm_set(nar_zm mat,int i,int j,double a,double b);
 void nar_zm_get(double *a,double *b,nar_zm mat,int i,int j);
 void nar_zv_set(nar_zv v,int i,double a,double b);
 void nar_zv_get(double *a,double *b,nar_zv v,int i);
-char *nar_zv_display_string(nar_zv v);
-char *nar_zm_display_string(nar_zm mat);
-int nar_zm_assign(nar_zm mat1,nar_zm mat2);
-int nar_zm_eq(nar_zm mat1,nar_zm mat2);
 int nar_zm_get_cols(nar_zm mat);
 int nar_zm_get_rows(nar_zm mat);
+int nar_zm_inc_col(nar_zm mat);
+int nar_zm_inc_row(nar_zm mat);
 int nar_zm_get_ld(nar_zm mat);
-double *nar_zm_pointer(nar_zm mat);
 int nar_zm_subarray_safe(nar_zm *x,nar_zm mat,int start_row,int start_col,int end_row,int end_col);
 int nar_zm_col_safe(nar_zv *x,nar_zm mat,int j);
 int nar_zm_row_safe(nar_zv *x,nar_zm mat,int i);
 nar_zm nar_zm_subarray(nar_zm mat,int start_row,int start_col,int end_row,int end_col);
 nar_zv nar_zm_col(nar_zm mat,int j);
 nar_zv nar_zm_row(nar_zm mat,int i);
-enum nar_order nar_zm_order(nar_zm mat);
 int nar_zm_valid(nar_zm mat,int i,int j);
-nar_zm nar_zm_copy(nar_zm mat);
-void nar_zm_free(nar_zm mat);
+nar_zm nar_zm_wrap(double *ptr,int rows,int cols,int inc_row,int inc_col,nar_release_fn release,void *ctx);
+nar_zm nar_zm_alloc_uninit(int rows,int cols,int row_major);
 nar_zm nar_zm_alloc(int rows,int cols,int row_major);
-int nar_zv_assign(nar_zv v1,nar_zv v2);
-int nar_zv_eq(nar_zv v1,nar_zv v2);
 int nar_zv_n(nar_zv v);
 int nar_zv_inc(nar_zv v);
-double *nar_zv_pointer(nar_zv v);
 int nar_zv_slice_safe(nar_zv *out,nar_zv v,int start,int end);
 nar_zv nar_zv_slice(nar_zv v,int start,int end);
 int nar_zv_valid(nar_zv v,int i);
+nar_zv nar_zv_wrap(double *ptr,int n,int inc,nar_release_fn release,void *ctx);
+nar_zv nar_zv_alloc_uninit(int n);
+nar_zv nar_zv_alloc(int n);
+char *nar_zv_display_string(nar_zv v);
+char *nar_zm_display_string(nar_zm mat);
+int nar_zm_assign(nar_zm mat1,nar_zm mat2);
+int nar_zm_eq(nar_zm mat1,nar_zm mat2);
+void nar_zm_describe(nar_zm mat,struct nar_view *out);
+double *nar_zm_pointer(nar_zm mat);
+enum nar_order nar_zm_order(nar_zm mat);
+nar_zm nar_zm_copy(nar_zm mat);
+void nar_zm_free(nar_zm mat);
+int nar_zv_assign(nar_zv v1,nar_zv v2);
+int nar_zv_eq(nar_zv v1,nar_zv v2);
+void nar_zv_describe(nar_zv v,struct nar_view *out);
+double *nar_zv_pointer(nar_zv v);
 nar_zv nar_zv_copy(nar_zv v);
 void nar_zv_free(nar_zv v);
-nar_zv nar_zv_alloc(int n);
+int nar_cm_gemv(float alpha_re,float alpha_im,nar_cm a,enum nar_transpose trans,nar_cv x,float beta_re,float beta_im,nar_cv y);
+int nar_cm_gemm(float alpha_re,float alpha_im,nar_cm a,enum nar_transpose trans_a,nar_cm b,enum nar_transpose trans_b,float beta_re,float beta_im,nar_cm c);
+float nar_cv_asum(nar_cv x);
+float nar_cv_nrm2(nar_cv x);
+void nar_cv_scal(float a,float b,nar_cv x);
+int nar_cv_dotc(float *a,float *b,nar_cv x,nar_cv y);
+int nar_cv_dot(float *a,float *b,nar_cv x,nar_cv y);
+int nar_cv_axpy(float a,float b,nar_cv x,nar_cv y);
+nar_cm nar_cm_archive_map(nar_archive archive,const char *name,enum nar_map_mode mode,int *err);
+nar_cm nar_cm_archive_get(nar_archive archive,const char *name,int *err);
+int nar_cm_archive_put(nar_archive archive,const char *name,nar_cm mat);
+nar_cv nar_cv_archive_map(nar_archive archive,const char *name,enum nar_map_mode mode,int *err);
+nar_cv nar_cv_archive_get(nar_archive archive,const char *name,int *err);
+int nar_cv_archive_put(nar_archive archive,const char *name,nar_cv v);
+int nar_cm_write_tiled(nar_cm mat,const char *filename,int tile_rows,int tile_cols);
+nar_cm nar_cm_read_tiled(const char *filename,int row_major,int *err);
+void nar_cm_reader_close(nar_cm_reader reader);
+nar_cm_reader nar_cm_reader_open_binary(const char *filename,int *err);
+nar_cm_reader nar_cm_reader_open(const char *filename,int *err);
+int nar_cm_write_npy(nar_cm mat,const char *filename);
+nar_cm nar_cm_read_npz(const char *filename,const char *name,int *err);
+nar_cm nar_cm_read_npy(const char *filename,int *err);
+int nar_cv_write_npy(nar_cv v,const char *filename);
+nar_cv nar_cv_read_npz(const char *filename,const char *name,int *err);
+nar_cv nar_cv_read_npy(const char *filename,int *err);
+int nar_cm_write_binary_compressed(nar_cm mat,const char *filename);
+int nar_cv_write_binary_compressed(nar_cv v,const char *filename);
+nar_cm nar_cm_mmap(const char *filename,enum nar_map_mode mode,int *err);
+nar_cv nar_cv_mmap(const char *filename,enum nar_map_mode mode,int *err);
+nar_future nar_cm_write_binary_async(nar_cm mat,const char *filename);
+nar_future nar_cm_read_binary_async(const char *filename,int row_major);
+nar_future nar_cv_write_binary_async(nar_cv v,const char *filename);
+nar_future nar_cv_read_binary_async(const char *filename);
+int nar_cm_read_binary_into(nar_cm dest,const char *filename);
+int nar_cv_read_binary_into(nar_cv dest,const char *filename);
 int nar_cm_write_binary(nar_cm v,const char *filename);
 nar_cm nar_cm_read_binary(const char *filename,int row_major,int *err);
 int nar_cv_write_binary(nar_cv v,const char *filename);
 nar_cv nar_cv_read_binary(const char *filename,int *err);
+int nar_cm_write_precision(nar_cm v,const char *filename,const char *sep,int precision);
+int nar_cv_write_precision(nar_cv v,const char *filename,const char *sep,int precision);
+nar_future nar_cm_write_async(nar_cm mat,const char *filename,const char *sep);
+nar_future nar_cm_read_async(const char *filename,int row_major);
+nar_future nar_cv_write_async(nar_cv v,const char *filename,const char *sep);
+nar_future nar_cv_read_async(const char *filename);
+int nar_cm_read_into(nar_cm dest,const char *filename);
+int nar_cv_read_into(nar_cv dest,const char *filename);
 int nar_cm_write(nar_cm v,const char *filename,const char *sep);
 nar_cm nar_cm_read(const char *filename,int row_major,int *err);
 int nar_cv_write(nar_cv v,const char *filename,const char *sep);
 nar_cv nar_cv_read(const char *filename,int *err);
+nar_cm nar_cm_reader_next_64(nar_cm_reader reader,int64_t max_rows,int *err);
+int64_t nar_cv_iamax_64(nar_cv x);
+nar_cm nar_cm_read_tiled_subarray_64(const char *filename,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major,int *err);
+nar_cm nar_cm_read_binary_subarray_64(const char *filename,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major,int *err);
+int nar_cm_scatter_64(nar_cm mat,const int64_t *rows_idx,const int64_t *cols_idx,int64_t count,float const *in);
+int nar_cm_gather_64(float *out,nar_cm mat,const int64_t *rows_idx,const int64_t *cols_idx,int64_t count);
+int nar_cm_set_block_64(nar_cm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,float const *in,int row_major);
+int nar_cm_get_block_64(float *out,nar_cm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major);
+int nar_cv_scatter_64(nar_cv v,const int64_t *idx,int64_t count,float const *in);
+int nar_cv_gather_64(float *out,nar_cv v,const int64_t *idx,int64_t count);
+int nar_cv_set_range_64(nar_cv v,int64_t start,int64_t end,float const *in);
+int nar_cv_get_range_64(float *out,nar_cv v,int64_t start,int64_t end);
+int nar_cm_set_safe_64(nar_cm mat,int64_t i,int64_t j,float a,float b);
+int nar_cm_get_safe_64(float *a,float *b,nar_cm mat,int64_t i,int64_t j);
+int nar_cv_set_safe_64(nar_cv v,int64_t i,float a,float b);
+int nar_cv_get_safe_64(float *a,float *b,nar_cv v,int64_t i);
+void nar_cm_set_64(nar_cm mat,int64_t i,int64_t j,float a,float b);
+void nar_cm_get_64(float *a,float *b,nar_cm mat,int64_t i,int64_t j);
+void nar_cv_set_64(nar_cv v,int64_t i,float a,float b);
+void nar_cv_get_64(float *a,float *b,nar_cv v,int64_t i);
+int64_t nar_cm_get_cols_64(nar_cm mat);
+int64_t nar_cm_get_rows_64(nar_cm mat);
+int64_t nar_cm_inc_col_64(nar_cm mat);
+int64_t nar_cm_inc_row_64(nar_cm mat);
+int64_t nar_cm_get_ld_64(nar_cm mat);
+int nar_cm_subarray_safe_64(nar_cm *x,nar_cm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col);
+int nar_cm_col_safe_64(nar_cv *x,nar_cm mat,int64_t j);
+int nar_cm_row_safe_64(nar_cv *x,nar_cm mat,int64_t i);
+nar_cm nar_cm_subarray_64(nar_cm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col);
+nar_cv nar_cm_col_64(nar_cm mat,int64_t j);
+nar_cv nar_cm_row_64(nar_cm mat,int64_t i);
+int nar_cm_valid_64(nar_cm mat,int64_t i,int64_t j);
+nar_cm nar_cm_wrap_64(float *ptr,int64_t rows,int64_t cols,int64_t inc_row,int64_t inc_col,nar_release_fn release,void *ctx);
+nar_cm nar_cm_alloc_uninit_64(int64_t rows,int64_t cols,int row_major);
+nar_cm nar_cm_alloc_64(int64_t rows,int64_t cols,int row_major);
+int64_t nar_cv_n_64(nar_cv v);
+int64_t nar_cv_inc_64(nar_cv v);
+int nar_cv_slice_safe_64(nar_cv *out,nar_cv v,int64_t start,int64_t end);
+nar_cv nar_cv_slice_64(nar_cv v,int64_t start,int64_t end);
+int nar_cv_valid_64(nar_cv v,int64_t i);
+nar_cv nar_cv_wrap_64(float *ptr,int64_t n,int64_t inc,nar_release_fn release,void *ctx);
+nar_cv nar_cv_alloc_uninit_64(int64_t n);
+nar_cv nar_cv_alloc_64(int64_t n);
+nar_cm nar_cm_reader_next(nar_cm_reader reader,int max_rows,int *err);
+int nar_cv_iamax(nar_cv x);
+nar_cm nar_cm_read_tiled_subarray(const char *filename,int start_row,int start_col,int end_row,int end_col,int row_major,int *err);
+nar_cm nar_cm_read_binary_subarray(const char *filename,int start_row,int start_col,int end_row,int end_col,int row_major,int *err);
+int nar_cm_scatter(nar_cm mat,const int *rows_idx,const int *cols_idx,int count,float const *in);
+int nar_cm_gather(float *out,nar_cm mat,const int *rows_idx,const int *cols_idx,int count);
+int nar_cm_set_block(nar_cm mat,int start_row,int start_col,int end_row,int end_col,float const *in,int row_major);
+int nar_cm_get_block(float *out,nar_cm mat,int start_row,int start_col,int end_row,int end_col,int row_major);
+int nar_cv_scatter(nar_cv v,const int *idx,int count,float const *in);
+int nar_cv_gather(float *out,nar_cv v,const int *idx,int count);
+int nar_cv_set_range(nar_cv v,int start,int end,float const *in);
+int nar_cv_get_range(float *out,nar_cv v,int start,int end);
 int nar_cm_set_safe(nar_cm mat,int i,int j,float a,float b);
 int nar_cm_get_safe(float *a,float *b,nar_cm mat,int i,int j);
 int nar_cv_set_safe(nar_cv v,int i,float a,float b);
@@ -155,44 +581,149 @@ void nar_cm_set(nar_cm mat,int i,int j,float a,float b);
 void nar_cm_get(float *a,float *b,nar_cm mat,int i,int j);
 void nar_cv_set(nar_cv v,int i,float a,float b);
 void nar_cv_get(float *a,float *b,nar_cv v,int i);
-char *nar_cv_display_string(nar_cv v);
-char *nar_cm_display_string(nar_cm mat);
-int nar_cm_assign(nar_cm mat1,nar_cm mat2);
-int nar_cm_eq(nar_cm mat1,nar_cm mat2);
 int nar_cm_get_cols(nar_cm mat);
 int nar_cm_get_rows(nar_cm mat);
+int nar_cm_inc_col(nar_cm mat);
+int nar_cm_inc_row(nar_cm mat);
 int nar_cm_get_ld(nar_cm mat);
-float *nar_cm_pointer(nar_cm mat);
 int nar_cm_subarray_safe(nar_cm *x,nar_cm mat,int start_row,int start_col,int end_row,int end_col);
 int nar_cm_col_safe(nar_cv *x,nar_cm mat,int j);
 int nar_cm_row_safe(nar_cv *x,nar_cm mat,int i);
 nar_cm nar_cm_subarray(nar_cm mat,int start_row,int start_col,int end_row,int end_col);
 nar_cv nar_cm_col(nar_cm mat,int j);
 nar_cv nar_cm_row(nar_cm mat,int i);
-enum nar_order nar_cm_order(nar_cm mat);
 int nar_cm_valid(nar_cm mat,int i,int j);
-nar_cm nar_cm_copy(nar_cm mat);
-void nar_cm_free(nar_cm mat);
+nar_cm nar_cm_wrap(float *ptr,int rows,int cols,int inc_row,int inc_col,nar_release_fn release,void *ctx);
+nar_cm nar_cm_alloc_uninit(int rows,int cols,int row_major);
 nar_cm nar_cm_alloc(int rows,int cols,int row_major);
-int nar_cv_assign(nar_cv v1,nar_cv v2);
-int nar_cv_eq(nar_cv v1,nar_cv v2);
 int nar_cv_n(nar_cv v);
 int nar_cv_inc(nar_cv v);
-float *nar_cv_pointer(nar_cv v);
 int nar_cv_slice_safe(nar_cv *out,nar_cv v,int start,int end);
 nar_cv nar_cv_slice(nar_cv v,int start,int end);
 int nar_cv_valid(nar_cv v,int i);
+nar_cv nar_cv_wrap(float *ptr,int n,int inc,nar_release_fn release,void *ctx);
+nar_cv nar_cv_alloc_uninit(int n);
+nar_cv nar_cv_alloc(int n);
+char *nar_cv_display_string(nar_cv v);
+char *nar_cm_display_string(nar_cm mat);
+int nar_cm_assign(nar_cm mat1,nar_cm mat2);
+int nar_cm_eq(nar_cm mat1,nar_cm mat2);
+void nar_cm_describe(nar_cm mat,struct nar_view *out);
+float *nar_cm_pointer(nar_cm mat);
+enum nar_order nar_cm_order(nar_cm mat);
+nar_cm nar_cm_copy(nar_cm mat);
+void nar_cm_free(nar_cm mat);
+int nar_cv_assign(nar_cv v1,nar_cv v2);
+int nar_cv_eq(nar_cv v1,nar_cv v2);
+void nar_cv_describe(nar_cv v,struct nar_view *out);
+float *nar_cv_pointer(nar_cv v);
 nar_cv nar_cv_copy(nar_cv v);
 void nar_cv_free(nar_cv v);
-nar_cv nar_cv_alloc(int n);
+int nar_dm_gemv(double alpha,nar_dm a,enum nar_transpose trans,nar_dv x,double beta,nar_dv y);
+int nar_dm_gemm(double alpha,nar_dm a,enum nar_transpose trans_a,nar_dm b,enum nar_transpose trans_b,double beta,nar_dm c);
+double nar_dv_asum(nar_dv x);
+double nar_dv_nrm2(nar_dv x);
+void nar_dv_scal(double alpha,nar_dv x);
+int nar_dv_dot(double *result,nar_dv x,nar_dv y);
+int nar_dv_axpy(double alpha,nar_dv x,nar_dv y);
+nar_dm nar_dm_archive_map(nar_archive archive,const char *name,enum nar_map_mode mode,int *err);
+nar_dm nar_dm_archive_get(nar_archive archive,const char *name,int *err);
+int nar_dm_archive_put(nar_archive archive,const char *name,nar_dm mat);
+nar_dv nar_dv_archive_map(nar_archive archive,const char *name,enum nar_map_mode mode,int *err);
+nar_dv nar_dv_archive_get(nar_archive archive,const char *name,int *err);
+int nar_dv_archive_put(nar_archive archive,const char *name,nar_dv v);
+int nar_dm_write_tiled(nar_dm mat,const char *filename,int tile_rows,int tile_cols);
+nar_dm nar_dm_read_tiled(const char *filename,int row_major,int *err);
+void nar_dm_reader_close(nar_dm_reader reader);
+nar_dm_reader nar_dm_reader_open_binary(const char *filename,int *err);
+nar_dm_reader nar_dm_reader_open(const char *filename,int *err);
+int nar_dm_write_npy(nar_dm mat,const char *filename);
+nar_dm nar_dm_read_npz(const char *filename,const char *name,int *err);
+nar_dm nar_dm_read_npy(const char *filename,int *err);
+int nar_dv_write_npy(nar_dv v,const char *filename);
+nar_dv nar_dv_read_npz(const char *filename,const char *name,int *err);
+nar_dv nar_dv_read_npy(const char *filename,int *err);
+int nar_dm_write_binary_compressed(nar_dm mat,const char *filename);
+int nar_dv_write_binary_compressed(nar_dv v,const char *filename);
+nar_dm nar_dm_mmap(const char *filename,enum nar_map_mode mode,int *err);
+nar_dv nar_dv_mmap(const char *filename,enum nar_map_mode mode,int *err);
+nar_future nar_dm_write_binary_async(nar_dm mat,const char *filename);
+nar_future nar_dm_read_binary_async(const char *filename,int row_major);
+nar_future nar_dv_write_binary_async(nar_dv v,const char *filename);
+nar_future nar_dv_read_binary_async(const char *filename);
+int nar_dm_read_binary_into(nar_dm dest,const char *filename);
+int nar_dv_read_binary_into(nar_dv dest,const char *filename);
 int nar_dm_write_binary(nar_dm v,const char *filename);
 nar_dm nar_dm_read_binary(const char *filename,int row_major,int *err);
 int nar_dv_write_binary(nar_dv v,const char *filename);
 nar_dv nar_dv_read_binary(const char *filename,int *err);
+int nar_dm_write_precision(nar_dm v,const char *filename,const char *sep,int precision);
+int nar_dv_write_precision(nar_dv v,const char *filename,const char *sep,int precision);
+nar_future nar_dm_write_async(nar_dm mat,const char *filename,const char *sep);
+nar_future nar_dm_read_async(const char *filename,int row_major);
+nar_future nar_dv_write_async(nar_dv v,const char *filename,const char *sep);
+nar_future nar_dv_read_async(const char *filename);
+int nar_dm_read_into(nar_dm dest,const char *filename);
+int nar_dv_read_into(nar_dv dest,const char *filename);
 int nar_dm_write(nar_dm v,const char *filename,const char *sep);
 nar_dm nar_dm_read(const char *filename,int row_major,int *err);
 int nar_dv_write(nar_dv v,const char *filename,const char *sep);
 nar_dv nar_dv_read(const char *filename,int *err);
+nar_dm nar_dm_reader_next_64(nar_dm_reader reader,int64_t max_rows,int *err);
+int64_t nar_dv_iamax_64(nar_dv x);
+nar_dm nar_dm_read_tiled_subarray_64(const char *filename,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major,int *err);
+nar_dm nar_dm_read_binary_subarray_64(const char *filename,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major,int *err);
+int nar_dm_scatter_64(nar_dm mat,const int64_t *rows_idx,const int64_t *cols_idx,int64_t count,double const *in);
+int nar_dm_gather_64(double *out,nar_dm mat,const int64_t *rows_idx,const int64_t *cols_idx,int64_t count);
+int nar_dm_set_block_64(nar_dm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,double const *in,int row_major);
+int nar_dm_get_block_64(double *out,nar_dm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major);
+int nar_dv_scatter_64(nar_dv v,const int64_t *idx,int64_t count,double const *in);
+int nar_dv_gather_64(double *out,nar_dv v,const int64_t *idx,int64_t count);
+int nar_dv_set_range_64(nar_dv v,int64_t start,int64_t end,double const *in);
+int nar_dv_get_range_64(double *out,nar_dv v,int64_t start,int64_t end);
+int nar_dm_set_safe_64(nar_dm mat,int64_t i,int64_t j,double x);
+int nar_dm_get_safe_64(double *x,nar_dm mat,int64_t i,int64_t j);
+int nar_dv_set_safe_64(nar_dv v,int64_t i,double x);
+int nar_dv_get_safe_64(double *x,nar_dv v,int64_t i);
+void nar_dm_set_64(nar_dm mat,int64_t i,int64_t j,double x);
+double nar_dm_get_64(nar_dm mat,int64_t i,int64_t j);
+void nar_dv_set_64(nar_dv v,int64_t i,double x);
+double nar_dv_get_64(nar_dv v,int64_t i);
+int64_t nar_dm_get_cols_64(nar_dm mat);
+int64_t nar_dm_get_rows_64(nar_dm mat);
+int64_t nar_dm_inc_col_64(nar_dm mat);
+int64_t nar_dm_inc_row_64(nar_dm mat);
+int64_t nar_dm_get_ld_64(nar_dm mat);
+int nar_dm_subarray_safe_64(nar_dm *x,nar_dm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col);
+int nar_dm_col_safe_64(nar_dv *x,nar_dm mat,int64_t j);
+int nar_dm_row_safe_64(nar_dv *x,nar_dm mat,int64_t i);
+nar_dm nar_dm_subarray_64(nar_dm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col);
+nar_dv nar_dm_col_64(nar_dm mat,int64_t j);
+nar_dv nar_dm_row_64(nar_dm mat,int64_t i);
+int nar_dm_valid_64(nar_dm mat,int64_t i,int64_t j);
+nar_dm nar_dm_wrap_64(double *ptr,int64_t rows,int64_t cols,int64_t inc_row,int64_t inc_col,nar_release_fn release,void *ctx);
+nar_dm nar_dm_alloc_uninit_64(int64_t rows,int64_t cols,int row_major);
+nar_dm nar_dm_alloc_64(int64_t rows,int64_t cols,int row_major);
+int64_t nar_dv_n_64(nar_dv v);
+int64_t nar_dv_inc_64(nar_dv v);
+int nar_dv_slice_safe_64(nar_dv *out,nar_dv v,int64_t start,int64_t end);
+nar_dv nar_dv_slice_64(nar_dv v,int64_t start,int64_t end);
+int nar_dv_valid_64(nar_dv v,int64_t i);
+nar_dv nar_dv_wrap_64(double *ptr,int64_t n,int64_t inc,nar_release_fn release,void *ctx);
+nar_dv nar_dv_alloc_uninit_64(int64_t n);
+nar_dv nar_dv_alloc_64(int64_t n);
+nar_dm nar_dm_reader_next(nar_dm_reader reader,int max_rows,int *err);
+int nar_dv_iamax(nar_dv x);
+nar_dm nar_dm_read_tiled_subarray(const char *filename,int start_row,int start_col,int end_row,int end_col,int row_major,int *err);
+nar_dm nar_dm_read_binary_subarray(const char *filename,int start_row,int start_col,int end_row,int end_col,int row_major,int *err);
+int nar_dm_scatter(nar_dm mat,const int *rows_idx,const int *cols_idx,int count,double const *in);
+int nar_dm_gather(double *out,nar_dm mat,const int *rows_idx,const int *cols_idx,int count);
+int nar_dm_set_block(nar_dm mat,int start_row,int start_col,int end_row,int end_col,double const *in,int row_major);
+int nar_dm_get_block(double *out,nar_dm mat,int start_row,int start_col,int end_row,int end_col,int row_major);
+int nar_dv_scatter(nar_dv v,const int *idx,int count,double const *in);
+int nar_dv_gather(double *out,nar_dv v,const int *idx,int count);
+int nar_dv_set_range(nar_dv v,int start,int end,double const *in);
+int nar_dv_get_range(double *out,nar_dv v,int start,int end);
 int nar_dm_set_safe(nar_dm mat,int i,int j,double x);
 int nar_dm_get_safe(double *x,nar_dm mat,int i,int j);
 int nar_dv_set_safe(nar_dv v,int i,double x);
@@ -201,44 +732,149 @@ void nar_dm_set(nar_dm mat,int i,int j,double x);
 double nar_dm_get(nar_dm mat,int i,int j);
 void nar_dv_set(nar_dv v,int i,double x);
 double nar_dv_get(nar_dv v,int i);
-char *nar_dv_display_string(nar_dv v);
-char *nar_dm_display_string(nar_dm mat);
-int nar_dm_assign(nar_dm mat1,nar_dm mat2);
-int nar_dm_eq(nar_dm mat1,nar_dm mat2);
 int nar_dm_get_cols(nar_dm mat);
 int nar_dm_get_rows(nar_dm mat);
+int nar_dm_inc_col(nar_dm mat);
+int nar_dm_inc_row(nar_dm mat);
 int nar_dm_get_ld(nar_dm mat);
-double *nar_dm_pointer(nar_dm mat);
 int nar_dm_subarray_safe(nar_dm *x,nar_dm mat,int start_row,int start_col,int end_row,int end_col);
 int nar_dm_col_safe(nar_dv *x,nar_dm mat,int j);
 int nar_dm_row_safe(nar_dv *x,nar_dm mat,int i);
 nar_dm nar_dm_subarray(nar_dm mat,int start_row,int start_col,int end_row,int end_col);
 nar_dv nar_dm_col(nar_dm mat,int j);
 nar_dv nar_dm_row(nar_dm mat,int i);
-enum nar_order nar_dm_order(nar_dm mat);
 int nar_dm_valid(nar_dm mat,int i,int j);
-nar_dm nar_dm_copy(nar_dm mat);
-void nar_dm_free(nar_dm mat);
+nar_dm nar_dm_wrap(double *ptr,int rows,int cols,int inc_row,int inc_col,nar_release_fn release,void *ctx);
+nar_dm nar_dm_alloc_uninit(int rows,int cols,int row_major);
 nar_dm nar_dm_alloc(int rows,int cols,int row_major);
-int nar_dv_assign(nar_dv v1,nar_dv v2);
-int nar_dv_eq(nar_dv v1,nar_dv v2);
 int nar_dv_n(nar_dv v);
 int nar_dv_inc(nar_dv v);
-double *nar_dv_pointer(nar_dv v);
 int nar_dv_slice_safe(nar_dv *out,nar_dv v,int start,int end);
 nar_dv nar_dv_slice(nar_dv v,int start,int end);
 int nar_dv_valid(nar_dv v,int i);
+nar_dv nar_dv_wrap(double *ptr,int n,int inc,nar_release_fn release,void *ctx);
+nar_dv nar_dv_alloc_uninit(int n);
+nar_dv nar_dv_alloc(int n);
+char *nar_dv_display_string(nar_dv v);
+char *nar_dm_display_string(nar_dm mat);
+int nar_dm_assign(nar_dm mat1,nar_dm mat2);
+int nar_dm_eq(nar_dm mat1,nar_dm mat2);
+void nar_dm_describe(nar_dm mat,struct nar_view *out);
+double *nar_dm_pointer(nar_dm mat);
+enum nar_order nar_dm_order(nar_dm mat);
+nar_dm nar_dm_copy(nar_dm mat);
+void nar_dm_free(nar_dm mat);
+int nar_dv_assign(nar_dv v1,nar_dv v2);
+int nar_dv_eq(nar_dv v1,nar_dv v2);
+void nar_dv_describe(nar_dv v,struct nar_view *out);
+double *nar_dv_pointer(nar_dv v);
 nar_dv nar_dv_copy(nar_dv v);
 void nar_dv_free(nar_dv v);
-nar_dv nar_dv_alloc(int n);
+int nar_sm_gemv(float alpha,nar_sm a,enum nar_transpose trans,nar_sv x,float beta,nar_sv y);
+int nar_sm_gemm(float alpha,nar_sm a,enum nar_transpose trans_a,nar_sm b,enum nar_transpose trans_b,float beta,nar_sm c);
+float nar_sv_asum(nar_sv x);
+float nar_sv_nrm2(nar_sv x);
+void nar_sv_scal(float alpha,nar_sv x);
+int nar_sv_dot(float *result,nar_sv x,nar_sv y);
+int nar_sv_axpy(float alpha,nar_sv x,nar_sv y);
+nar_sm nar_sm_archive_map(nar_archive archive,const char *name,enum nar_map_mode mode,int *err);
+nar_sm nar_sm_archive_get(nar_archive archive,const char *name,int *err);
+int nar_sm_archive_put(nar_archive archive,const char *name,nar_sm mat);
+nar_sv nar_sv_archive_map(nar_archive archive,const char *name,enum nar_map_mode mode,int *err);
+nar_sv nar_sv_archive_get(nar_archive archive,const char *name,int *err);
+int nar_sv_archive_put(nar_archive archive,const char *name,nar_sv v);
+int nar_sm_write_tiled(nar_sm mat,const char *filename,int tile_rows,int tile_cols);
+nar_sm nar_sm_read_tiled(const char *filename,int row_major,int *err);
+void nar_sm_reader_close(nar_sm_reader reader);
+nar_sm_reader nar_sm_reader_open_binary(const char *filename,int *err);
+nar_sm_reader nar_sm_reader_open(const char *filename,int *err);
+int nar_sm_write_npy(nar_sm mat,const char *filename);
+nar_sm nar_sm_read_npz(const char *filename,const char *name,int *err);
+nar_sm nar_sm_read_npy(const char *filename,int *err);
+int nar_sv_write_npy(nar_sv v,const char *filename);
+nar_sv nar_sv_read_npz(const char *filename,const char *name,int *err);
+nar_sv nar_sv_read_npy(const char *filename,int *err);
+int nar_sm_write_binary_compressed(nar_sm mat,const char *filename);
+int nar_sv_write_binary_compressed(nar_sv v,const char *filename);
+nar_sm nar_sm_mmap(const char *filename,enum nar_map_mode mode,int *err);
+nar_sv nar_sv_mmap(const char *filename,enum nar_map_mode mode,int *err);
+nar_future nar_sm_write_binary_async(nar_sm mat,const char *filename);
+nar_future nar_sm_read_binary_async(const char *filename,int row_major);
+nar_future nar_sv_write_binary_async(nar_sv v,const char *filename);
+nar_future nar_sv_read_binary_async(const char *filename);
+int nar_sm_read_binary_into(nar_sm dest,const char *filename);
+int nar_sv_read_binary_into(nar_sv dest,const char *filename);
 int nar_sm_write_binary(nar_sm v,const char *filename);
 nar_sm nar_sm_read_binary(const char *filename,int row_major,int *err);
 int nar_sv_write_binary(nar_sv v,const char *filename);
 nar_sv nar_sv_read_binary(const char *filename,int *err);
+int nar_sm_write_precision(nar_sm v,const char *filename,const char *sep,int precision);
+int nar_sv_write_precision(nar_sv v,const char *filename,const char *sep,int precision);
+nar_future nar_sm_write_async(nar_sm mat,const char *filename,const char *sep);
+nar_future nar_sm_read_async(const char *filename,int row_major);
+nar_future nar_sv_write_async(nar_sv v,const char *filename,const char *sep);
+nar_future nar_sv_read_async(const char *filename);
+int nar_sm_read_into(nar_sm dest,const char *filename);
+int nar_sv_read_into(nar_sv dest,const char *filename);
 int nar_sm_write(nar_sm v,const char *filename,const char *sep);
 nar_sm nar_sm_read(const char *filename,int row_major,int *err);
 int nar_sv_write(nar_sv v,const char *filename,const char *sep);
 nar_sv nar_sv_read(const char *filename,int *err);
+nar_sm nar_sm_reader_next_64(nar_sm_reader reader,int64_t max_rows,int *err);
+int64_t nar_sv_iamax_64(nar_sv x);
+nar_sm nar_sm_read_tiled_subarray_64(const char *filename,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major,int *err);
+nar_sm nar_sm_read_binary_subarray_64(const char *filename,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major,int *err);
+int nar_sm_scatter_64(nar_sm mat,const int64_t *rows_idx,const int64_t *cols_idx,int64_t count,float const *in);
+int nar_sm_gather_64(float *out,nar_sm mat,const int64_t *rows_idx,const int64_t *cols_idx,int64_t count);
+int nar_sm_set_block_64(nar_sm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,float const *in,int row_major);
+int nar_sm_get_block_64(float *out,nar_sm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major);
+int nar_sv_scatter_64(nar_sv v,const int64_t *idx,int64_t count,float const *in);
+int nar_sv_gather_64(float *out,nar_sv v,const int64_t *idx,int64_t count);
+int nar_sv_set_range_64(nar_sv v,int64_t start,int64_t end,float const *in);
+int nar_sv_get_range_64(float *out,nar_sv v,int64_t start,int64_t end);
+int nar_sm_set_safe_64(nar_sm mat,int64_t i,int64_t j,float x);
+int nar_sm_get_safe_64(float *x,nar_sm mat,int64_t i,int64_t j);
+int nar_sv_set_safe_64(nar_sv v,int64_t i,float x);
+int nar_sv_get_safe_64(float *x,nar_sv v,int64_t i);
+void nar_sm_set_64(nar_sm mat,int64_t i,int64_t j,float x);
+float nar_sm_get_64(nar_sm mat,int64_t i,int64_t j);
+void nar_sv_set_64(nar_sv v,int64_t i,float x);
+float nar_sv_get_64(nar_sv v,int64_t i);
+int64_t nar_sm_get_cols_64(nar_sm mat);
+int64_t nar_sm_get_rows_64(nar_sm mat);
+int64_t nar_sm_inc_col_64(nar_sm mat);
+int64_t nar_sm_inc_row_64(nar_sm mat);
+int64_t nar_sm_get_ld_64(nar_sm mat);
+int nar_sm_subarray_safe_64(nar_sm *x,nar_sm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col);
+int nar_sm_col_safe_64(nar_sv *x,nar_sm mat,int64_t j);
+int nar_sm_row_safe_64(nar_sv *x,nar_sm mat,int64_t i);
+nar_sm nar_sm_subarray_64(nar_sm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col);
+nar_sv nar_sm_col_64(nar_sm mat,int64_t j);
+nar_sv nar_sm_row_64(nar_sm mat,int64_t i);
+int nar_sm_valid_64(nar_sm mat,int64_t i,int64_t j);
+nar_sm nar_sm_wrap_64(float *ptr,int64_t rows,int64_t cols,int64_t inc_row,int64_t inc_col,nar_release_fn release,void *ctx);
+nar_sm nar_sm_alloc_uninit_64(int64_t rows,int64_t cols,int row_major);
+nar_sm nar_sm_alloc_64(int64_t rows,int64_t cols,int row_major);
+int64_t nar_sv_n_64(nar_sv v);
+int64_t nar_sv_inc_64(nar_sv v);
+int nar_sv_slice_safe_64(nar_sv *out,nar_sv v,int64_t start,int64_t end);
+nar_sv nar_sv_slice_64(nar_sv v,int64_t start,int64_t end);
+int nar_sv_valid_64(nar_sv v,int64_t i);
+nar_sv nar_sv_wrap_64(float *ptr,int64_t n,int64_t inc,nar_release_fn release,void *ctx);
+nar_sv nar_sv_alloc_uninit_64(int64_t n);
+nar_sv nar_sv_alloc_64(int64_t n);
+nar_sm nar_sm_reader_next(nar_sm_reader reader,int max_rows,int *err);
+int nar_sv_iamax(nar_sv x);
+nar_sm nar_sm_read_tiled_subarray(const char *filename,int start_row,int start_col,int end_row,int end_col,int row_major,int *err);
+nar_sm nar_sm_read_binary_subarray(const char *filename,int start_row,int start_col,int end_row,int end_col,int row_major,int *err);
+int nar_sm_scatter(nar_sm mat,const int *rows_idx,const int *cols_idx,int count,float const *in);
+int nar_sm_gather(float *out,nar_sm mat,const int *rows_idx,const int *cols_idx,int count);
+int nar_sm_set_block(nar_sm mat,int start_row,int start_col,int end_row,int end_col,float const *in,int row_major);
+int nar_sm_get_block(float *out,nar_sm mat,int start_row,int start_col,int end_row,int end_col,int row_major);
+int nar_sv_scatter(nar_sv v,const int *idx,int count,float const *in);
+int nar_sv_gather(float *out,nar_sv v,const int *idx,int count);
+int nar_sv_set_range(nar_sv v,int start,int end,float const *in);
+int nar_sv_get_range(float *out,nar_sv v,int start,int end);
 int nar_sm_set_safe(nar_sm mat,int i,int j,float x);
 int nar_sm_get_safe(float *x,nar_sm mat,int i,int j);
 int nar_sv_set_safe(nar_sv v,int i,float x);
@@ -247,44 +883,147 @@ void nar_sm_set(nar_sm mat,int i,int j,float x);
 float nar_sm_get(nar_sm mat,int i,int j);
 void nar_sv_set(nar_sv v,int i,float x);
 float nar_sv_get(nar_sv v,int i);
-char *nar_sv_display_string(nar_sv v);
-char *nar_sm_display_string(nar_sm mat);
-int nar_sm_assign(nar_sm mat1,nar_sm mat2);
-int nar_sm_eq(nar_sm mat1,nar_sm mat2);
 int nar_sm_get_cols(nar_sm mat);
 int nar_sm_get_rows(nar_sm mat);
+int nar_sm_inc_col(nar_sm mat);
+int nar_sm_inc_row(nar_sm mat);
 int nar_sm_get_ld(nar_sm mat);
-float *nar_sm_pointer(nar_sm mat);
 int nar_sm_subarray_safe(nar_sm *x,nar_sm mat,int start_row,int start_col,int end_row,int end_col);
 int nar_sm_col_safe(nar_sv *x,nar_sm mat,int j);
 int nar_sm_row_safe(nar_sv *x,nar_sm mat,int i);
 nar_sm nar_sm_subarray(nar_sm mat,int start_row,int start_col,int end_row,int end_col);
 nar_sv nar_sm_col(nar_sm mat,int j);
 nar_sv nar_sm_row(nar_sm mat,int i);
-enum nar_order nar_sm_order(nar_sm mat);
 int nar_sm_valid(nar_sm mat,int i,int j);
-nar_sm nar_sm_copy(nar_sm mat);
-void nar_sm_free(nar_sm mat);
+nar_sm nar_sm_wrap(float *ptr,int rows,int cols,int inc_row,int inc_col,nar_release_fn release,void *ctx);
+nar_sm nar_sm_alloc_uninit(int rows,int cols,int row_major);
 nar_sm nar_sm_alloc(int rows,int cols,int row_major);
-int nar_sv_assign(nar_sv v1,nar_sv v2);
-int nar_sv_eq(nar_sv v1,nar_sv v2);
 int nar_sv_n(nar_sv v);
 int nar_sv_inc(nar_sv v);
-float *nar_sv_pointer(nar_sv v);
 int nar_sv_slice_safe(nar_sv *out,nar_sv v,int start,int end);
 nar_sv nar_sv_slice(nar_sv v,int start,int end);
 int nar_sv_valid(nar_sv v,int i);
+nar_sv nar_sv_wrap(float *ptr,int n,int inc,nar_release_fn release,void *ctx);
+nar_sv nar_sv_alloc_uninit(int n);
+nar_sv nar_sv_alloc(int n);
+char *nar_sv_display_string(nar_sv v);
+char *nar_sm_display_string(nar_sm mat);
+int nar_sm_assign(nar_sm mat1,nar_sm mat2);
+int nar_sm_eq(nar_sm mat1,nar_sm mat2);
+void nar_sm_describe(nar_sm mat,struct nar_view *out);
+float *nar_sm_pointer(nar_sm mat);
+enum nar_order nar_sm_order(nar_sm mat);
+nar_sm nar_sm_copy(nar_sm mat);
+void nar_sm_free(nar_sm mat);
+int nar_sv_assign(nar_sv v1,nar_sv v2);
+int nar_sv_eq(nar_sv v1,nar_sv v2);
+void nar_sv_describe(nar_sv v,struct nar_view *out);
+float *nar_sv_pointer(nar_sv v);
 nar_sv nar_sv_copy(nar_sv v);
 void nar_sv_free(nar_sv v);
-nar_sv nar_sv_alloc(int n);
+uint64_t nar_lv_asum(nar_lv x);
+double nar_lv_nrm2(nar_lv x);
+void nar_lv_scal(long alpha,nar_lv x);
+int nar_lv_dot(long *result,nar_lv x,nar_lv y);
+int nar_lv_axpy(long alpha,nar_lv x,nar_lv y);
+nar_lm nar_lm_archive_map(nar_archive archive,const char *name,enum nar_map_mode mode,int *err);
+nar_lm nar_lm_archive_get(nar_archive archive,const char *name,int *err);
+int nar_lm_archive_put(nar_archive archive,const char *name,nar_lm mat);
+nar_lv nar_lv_archive_map(nar_archive archive,const char *name,enum nar_map_mode mode,int *err);
+nar_lv nar_lv_archive_get(nar_archive archive,const char *name,int *err);
+int nar_lv_archive_put(nar_archive archive,const char *name,nar_lv v);
+int nar_lm_write_tiled(nar_lm mat,const char *filename,int tile_rows,int tile_cols);
+nar_lm nar_lm_read_tiled(const char *filename,int row_major,int *err);
+void nar_lm_reader_close(nar_lm_reader reader);
+nar_lm_reader nar_lm_reader_open_binary(const char *filename,int *err);
+nar_lm_reader nar_lm_reader_open(const char *filename,int *err);
+int nar_lm_write_npy(nar_lm mat,const char *filename);
+nar_lm nar_lm_read_npz(const char *filename,const char *name,int *err);
+nar_lm nar_lm_read_npy(const char *filename,int *err);
+int nar_lv_write_npy(nar_lv v,const char *filename);
+nar_lv nar_lv_read_npz(const char *filename,const char *name,int *err);
+nar_lv nar_lv_read_npy(const char *filename,int *err);
+int nar_lm_write_binary_compressed(nar_lm mat,const char *filename);
+int nar_lv_write_binary_compressed(nar_lv v,const char *filename);
+nar_lm nar_lm_mmap(const char *filename,enum nar_map_mode mode,int *err);
+nar_lv nar_lv_mmap(const char *filename,enum nar_map_mode mode,int *err);
+nar_future nar_lm_write_binary_async(nar_lm mat,const char *filename);
+nar_future nar_lm_read_binary_async(const char *filename,int row_major);
+nar_future nar_lv_write_binary_async(nar_lv v,const char *filename);
+nar_future nar_lv_read_binary_async(const char *filename);
+int nar_lm_read_binary_into(nar_lm dest,const char *filename);
+int nar_lv_read_binary_into(nar_lv dest,const char *filename);
 int nar_lm_write_binary(nar_lm v,const char *filename);
 nar_lm nar_lm_read_binary(const char *filename,int row_major,int *err);
 int nar_lv_write_binary(nar_lv v,const char *filename);
 nar_lv nar_lv_read_binary(const char *filename,int *err);
+int nar_lm_write_precision(nar_lm v,const char *filename,const char *sep,int precision);
+int nar_lv_write_precision(nar_lv v,const char *filename,const char *sep,int precision);
+nar_future nar_lm_write_async(nar_lm mat,const char *filename,const char *sep);
+nar_future nar_lm_read_async(const char *filename,int row_major);
+nar_future nar_lv_write_async(nar_lv v,const char *filename,const char *sep);
+nar_future nar_lv_read_async(const char *filename);
+int nar_lm_read_into(nar_lm dest,const char *filename);
+int nar_lv_read_into(nar_lv dest,const char *filename);
 int nar_lm_write(nar_lm v,const char *filename,const char *sep);
 nar_lm nar_lm_read(const char *filename,int row_major,int *err);
 int nar_lv_write(nar_lv v,const char *filename,const char *sep);
 nar_lv nar_lv_read(const char *filename,int *err);
+nar_lm nar_lm_reader_next_64(nar_lm_reader reader,int64_t max_rows,int *err);
+int64_t nar_lv_iamax_64(nar_lv x);
+nar_lm nar_lm_read_tiled_subarray_64(const char *filename,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major,int *err);
+nar_lm nar_lm_read_binary_subarray_64(const char *filename,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major,int *err);
+int nar_lm_scatter_64(nar_lm mat,const int64_t *rows_idx,const int64_t *cols_idx,int64_t count,long const *in);
+int nar_lm_gather_64(long *out,nar_lm mat,const int64_t *rows_idx,const int64_t *cols_idx,int64_t count);
+int nar_lm_set_block_64(nar_lm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,long const *in,int row_major);
+int nar_lm_get_block_64(long *out,nar_lm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major);
+int nar_lv_scatter_64(nar_lv v,const int64_t *idx,int64_t count,long const *in);
+int nar_lv_gather_64(long *out,nar_lv v,const int64_t *idx,int64_t count);
+int nar_lv_set_range_64(nar_lv v,int64_t start,int64_t end,long const *in);
+int nar_lv_get_range_64(long *out,nar_lv v,int64_t start,int64_t end);
+int nar_lm_set_safe_64(nar_lm mat,int64_t i,int64_t j,long x);
+int nar_lm_get_safe_64(long *x,nar_lm mat,int64_t i,int64_t j);
+int nar_lv_set_safe_64(nar_lv v,int64_t i,long x);
+int nar_lv_get_safe_64(long *x,nar_lv v,int64_t i);
+void nar_lm_set_64(nar_lm mat,int64_t i,int64_t j,long x);
+long nar_lm_get_64(nar_lm mat,int64_t i,int64_t j);
+void nar_lv_set_64(nar_lv v,int64_t i,long x);
+long nar_lv_get_64(nar_lv v,int64_t i);
+int64_t nar_lm_get_cols_64(nar_lm mat);
+int64_t nar_lm_get_rows_64(nar_lm mat);
+int64_t nar_lm_inc_col_64(nar_lm mat);
+int64_t nar_lm_inc_row_64(nar_lm mat);
+int64_t nar_lm_get_ld_64(nar_lm mat);
+int nar_lm_subarray_safe_64(nar_lm *x,nar_lm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col);
+int nar_lm_col_safe_64(nar_lv *x,nar_lm mat,int64_t j);
+int nar_lm_row_safe_64(nar_lv *x,nar_lm mat,int64_t i);
+nar_lm nar_lm_subarray_64(nar_lm mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col);
+nar_lv nar_lm_col_64(nar_lm mat,int64_t j);
+nar_lv nar_lm_row_64(nar_lm mat,int64_t i);
+int nar_lm_valid_64(nar_lm mat,int64_t i,int64_t j);
+nar_lm nar_lm_wrap_64(long *ptr,int64_t rows,int64_t cols,int64_t inc_row,int64_t inc_col,nar_release_fn release,void *ctx);
+nar_lm nar_lm_alloc_uninit_64(int64_t rows,int64_t cols,int row_major);
+nar_lm nar_lm_alloc_64(int64_t rows,int64_t cols,int row_major);
+int64_t nar_lv_n_64(nar_lv v);
+int64_t nar_lv_inc_64(nar_lv v);
+int nar_lv_slice_safe_64(nar_lv *out,nar_lv v,int64_t start,int64_t end);
+nar_lv nar_lv_slice_64(nar_lv v,int64_t start,int64_t end);
+int nar_lv_valid_64(nar_lv v,int64_t i);
+nar_lv nar_lv_wrap_64(long *ptr,int64_t n,int64_t inc,nar_release_fn release,void *ctx);
+nar_lv nar_lv_alloc_uninit_64(int64_t n);
+nar_lv nar_lv_alloc_64(int64_t n);
+nar_lm nar_lm_reader_next(nar_lm_reader reader,int max_rows,int *err);
+int nar_lv_iamax(nar_lv x);
+nar_lm nar_lm_read_tiled_subarray(const char *filename,int start_row,int start_col,int end_row,int end_col,int row_major,int *err);
+nar_lm nar_lm_read_binary_subarray(const char *filename,int start_row,int start_col,int end_row,int end_col,int row_major,int *err);
+int nar_lm_scatter(nar_lm mat,const int *rows_idx,const int *cols_idx,int count,long const *in);
+int nar_lm_gather(long *out,nar_lm mat,const int *rows_idx,const int *cols_idx,int count);
+int nar_lm_set_block(nar_lm mat,int start_row,int start_col,int end_row,int end_col,long const *in,int row_major);
+int nar_lm_get_block(long *out,nar_lm mat,int start_row,int start_col,int end_row,int end_col,int row_major);
+int nar_lv_scatter(nar_lv v,const int *idx,int count,long const *in);
+int nar_lv_gather(long *out,nar_lv v,const int *idx,int count);
+int nar_lv_set_range(nar_lv v,int start,int end,long const *in);
+int nar_lv_get_range(long *out,nar_lv v,int start,int end);
 int nar_lm_set_safe(nar_lm mat,int i,int j,long x);
 int nar_lm_get_safe(long *x,nar_lm mat,int i,int j);
 int nar_lv_set_safe(nar_lv v,int i,long x);
@@ -293,44 +1032,147 @@ void nar_lm_set(nar_lm mat,int i,int j,long x);
 long nar_lm_get(nar_lm mat,int i,int j);
 void nar_lv_set(nar_lv v,int i,long x);
 long nar_lv_get(nar_lv v,int i);
-char *nar_lv_display_string(nar_lv v);
-char *nar_lm_display_string(nar_lm mat);
-int nar_lm_assign(nar_lm mat1,nar_lm mat2);
-int nar_lm_eq(nar_lm mat1,nar_lm mat2);
 int nar_lm_get_cols(nar_lm mat);
 int nar_lm_get_rows(nar_lm mat);
+int nar_lm_inc_col(nar_lm mat);
+int nar_lm_inc_row(nar_lm mat);
 int nar_lm_get_ld(nar_lm mat);
-long *nar_lm_pointer(nar_lm mat);
 int nar_lm_subarray_safe(nar_lm *x,nar_lm mat,int start_row,int start_col,int end_row,int end_col);
 int nar_lm_col_safe(nar_lv *x,nar_lm mat,int j);
 int nar_lm_row_safe(nar_lv *x,nar_lm mat,int i);
 nar_lm nar_lm_subarray(nar_lm mat,int start_row,int start_col,int end_row,int end_col);
 nar_lv nar_lm_col(nar_lm mat,int j);
 nar_lv nar_lm_row(nar_lm mat,int i);
-enum nar_order nar_lm_order(nar_lm mat);
 int nar_lm_valid(nar_lm mat,int i,int j);
-nar_lm nar_lm_copy(nar_lm mat);
-void nar_lm_free(nar_lm mat);
+nar_lm nar_lm_wrap(long *ptr,int rows,int cols,int inc_row,int inc_col,nar_release_fn release,void *ctx);
+nar_lm nar_lm_alloc_uninit(int rows,int cols,int row_major);
 nar_lm nar_lm_alloc(int rows,int cols,int row_major);
-int nar_lv_assign(nar_lv v1,nar_lv v2);
-int nar_lv_eq(nar_lv v1,nar_lv v2);
 int nar_lv_n(nar_lv v);
 int nar_lv_inc(nar_lv v);
-long *nar_lv_pointer(nar_lv v);
 int nar_lv_slice_safe(nar_lv *out,nar_lv v,int start,int end);
 nar_lv nar_lv_slice(nar_lv v,int start,int end);
 int nar_lv_valid(nar_lv v,int i);
+nar_lv nar_lv_wrap(long *ptr,int n,int inc,nar_release_fn release,void *ctx);
+nar_lv nar_lv_alloc_uninit(int n);
+nar_lv nar_lv_alloc(int n);
+char *nar_lv_display_string(nar_lv v);
+char *nar_lm_display_string(nar_lm mat);
+int nar_lm_assign(nar_lm mat1,nar_lm mat2);
+int nar_lm_eq(nar_lm mat1,nar_lm mat2);
+void nar_lm_describe(nar_lm mat,struct nar_view *out);
+long *nar_lm_pointer(nar_lm mat);
+enum nar_order nar_lm_order(nar_lm mat);
+nar_lm nar_lm_copy(nar_lm mat);
+void nar_lm_free(nar_lm mat);
+int nar_lv_assign(nar_lv v1,nar_lv v2);
+int nar_lv_eq(nar_lv v1,nar_lv v2);
+void nar_lv_describe(nar_lv v,struct nar_view *out);
+long *nar_lv_pointer(nar_lv v);
 nar_lv nar_lv_copy(nar_lv v);
 void nar_lv_free(nar_lv v);
-nar_lv nar_lv_alloc(int n);
+uint64_t nar_iv_asum(nar_iv x);
+double nar_iv_nrm2(nar_iv x);
+void nar_iv_scal(int alpha,nar_iv x);
+int nar_iv_dot(int *result,nar_iv x,nar_iv y);
+int nar_iv_axpy(int alpha,nar_iv x,nar_iv y);
+nar_im nar_im_archive_map(nar_archive archive,const char *name,enum nar_map_mode mode,int *err);
+nar_im nar_im_archive_get(nar_archive archive,const char *name,int *err);
+int nar_im_archive_put(nar_archive archive,const char *name,nar_im mat);
+nar_iv nar_iv_archive_map(nar_archive archive,const char *name,enum nar_map_mode mode,int *err);
+nar_iv nar_iv_archive_get(nar_archive archive,const char *name,int *err);
+int nar_iv_archive_put(nar_archive archive,const char *name,nar_iv v);
+int nar_im_write_tiled(nar_im mat,const char *filename,int tile_rows,int tile_cols);
+nar_im nar_im_read_tiled(const char *filename,int row_major,int *err);
+void nar_im_reader_close(nar_im_reader reader);
+nar_im_reader nar_im_reader_open_binary(const char *filename,int *err);
+nar_im_reader nar_im_reader_open(const char *filename,int *err);
+int nar_im_write_npy(nar_im mat,const char *filename);
+nar_im nar_im_read_npz(const char *filename,const char *name,int *err);
+nar_im nar_im_read_npy(const char *filename,int *err);
+int nar_iv_write_npy(nar_iv v,const char *filename);
+nar_iv nar_iv_read_npz(const char *filename,const char *name,int *err);
+nar_iv nar_iv_read_npy(const char *filename,int *err);
+int nar_im_write_binary_compressed(nar_im mat,const char *filename);
+int nar_iv_write_binary_compressed(nar_iv v,const char *filename);
+nar_im nar_im_mmap(const char *filename,enum nar_map_mode mode,int *err);
+nar_iv nar_iv_mmap(const char *filename,enum nar_map_mode mode,int *err);
+nar_future nar_im_write_binary_async(nar_im mat,const char *filename);
+nar_future nar_im_read_binary_async(const char *filename,int row_major);
+nar_future nar_iv_write_binary_async(nar_iv v,const char *filename);
+nar_future nar_iv_read_binary_async(const char *filename);
+int nar_im_read_binary_into(nar_im dest,const char *filename);
+int nar_iv_read_binary_into(nar_iv dest,const char *filename);
 int nar_im_write_binary(nar_im v,const char *filename);
 nar_im nar_im_read_binary(const char *filename,int row_major,int *err);
 int nar_iv_write_binary(nar_iv v,const char *filename);
 nar_iv nar_iv_read_binary(const char *filename,int *err);
+int nar_im_write_precision(nar_im v,const char *filename,const char *sep,int precision);
+int nar_iv_write_precision(nar_iv v,const char *filename,const char *sep,int precision);
+nar_future nar_im_write_async(nar_im mat,const char *filename,const char *sep);
+nar_future nar_im_read_async(const char *filename,int row_major);
+nar_future nar_iv_write_async(nar_iv v,const char *filename,const char *sep);
+nar_future nar_iv_read_async(const char *filename);
+int nar_im_read_into(nar_im dest,const char *filename);
+int nar_iv_read_into(nar_iv dest,const char *filename);
 int nar_im_write(nar_im v,const char *filename,const char *sep);
 nar_im nar_im_read(const char *filename,int row_major,int *err);
 int nar_iv_write(nar_iv v,const char *filename,const char *sep);
 nar_iv nar_iv_read(const char *filename,int *err);
+nar_im nar_im_reader_next_64(nar_im_reader reader,int64_t max_rows,int *err);
+int64_t nar_iv_iamax_64(nar_iv x);
+nar_im nar_im_read_tiled_subarray_64(const char *filename,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major,int *err);
+nar_im nar_im_read_binary_subarray_64(const char *filename,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major,int *err);
+int nar_im_scatter_64(nar_im mat,const int64_t *rows_idx,const int64_t *cols_idx,int64_t count,int const *in);
+int nar_im_gather_64(int *out,nar_im mat,const int64_t *rows_idx,const int64_t *cols_idx,int64_t count);
+int nar_im_set_block_64(nar_im mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int const *in,int row_major);
+int nar_im_get_block_64(int *out,nar_im mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col,int row_major);
+int nar_iv_scatter_64(nar_iv v,const int64_t *idx,int64_t count,int const *in);
+int nar_iv_gather_64(int *out,nar_iv v,const int64_t *idx,int64_t count);
+int nar_iv_set_range_64(nar_iv v,int64_t start,int64_t end,int const *in);
+int nar_iv_get_range_64(int *out,nar_iv v,int64_t start,int64_t end);
+int nar_im_set_safe_64(nar_im mat,int64_t i,int64_t j,int x);
+int nar_im_get_safe_64(int *x,nar_im mat,int64_t i,int64_t j);
+int nar_iv_set_safe_64(nar_iv v,int64_t i,int x);
+int nar_iv_get_safe_64(int *x,nar_iv v,int64_t i);
+void nar_im_set_64(nar_im mat,int64_t i,int64_t j,int x);
+int nar_im_get_64(nar_im mat,int64_t i,int64_t j);
+void nar_iv_set_64(nar_iv v,int64_t i,int x);
+int nar_iv_get_64(nar_iv v,int64_t i);
+int64_t nar_im_get_cols_64(nar_im mat);
+int64_t nar_im_get_rows_64(nar_im mat);
+int64_t nar_im_inc_col_64(nar_im mat);
+int64_t nar_im_inc_row_64(nar_im mat);
+int64_t nar_im_get_ld_64(nar_im mat);
+int nar_im_subarray_safe_64(nar_im *x,nar_im mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col);
+int nar_im_col_safe_64(nar_iv *x,nar_im mat,int64_t j);
+int nar_im_row_safe_64(nar_iv *x,nar_im mat,int64_t i);
+nar_im nar_im_subarray_64(nar_im mat,int64_t start_row,int64_t start_col,int64_t end_row,int64_t end_col);
+nar_iv nar_im_col_64(nar_im mat,int64_t j);
+nar_iv nar_im_row_64(nar_im mat,int64_t i);
+int nar_im_valid_64(nar_im mat,int64_t i,int64_t j);
+nar_im nar_im_wrap_64(int *ptr,int64_t rows,int64_t cols,int64_t inc_row,int64_t inc_col,nar_release_fn release,void *ctx);
+nar_im nar_im_alloc_uninit_64(int64_t rows,int64_t cols,int row_major);
+nar_im nar_im_alloc_64(int64_t rows,int64_t cols,int row_major);
+int64_t nar_iv_n_64(nar_iv v);
+int64_t nar_iv_inc_64(nar_iv v);
+int nar_iv_slice_safe_64(nar_iv *out,nar_iv v,int64_t start,int64_t end);
+nar_iv nar_iv_slice_64(nar_iv v,int64_t start,int64_t end);
+int nar_iv_valid_64(nar_iv v,int64_t i);
+nar_iv nar_iv_wrap_64(int *ptr,int64_t n,int64_t inc,nar_release_fn release,void *ctx);
+nar_iv nar_iv_alloc_uninit_64(int64_t n);
+nar_iv nar_iv_alloc_64(int64_t n);
+nar_im nar_im_reader_next(nar_im_reader reader,int max_rows,int *err);
+int nar_iv_iamax(nar_iv x);
+nar_im nar_im_read_tiled_subarray(const char *filename,int start_row,int start_col,int end_row,int end_col,int row_major,int *err);
+nar_im nar_im_read_binary_subarray(const char *filename,int start_row,int start_col,int end_row,int end_col,int row_major,int *err);
+int nar_im_scatter(nar_im mat,const int *rows_idx,const int *cols_idx,int count,int const *in);
+int nar_im_gather(int *out,nar_im mat,const int *rows_idx,const int *cols_idx,int count);
+int nar_im_set_block(nar_im mat,int start_row,int start_col,int end_row,int end_col,int const *in,int row_major);
+int nar_im_get_block(int *out,nar_im mat,int start_row,int start_col,int end_row,int end_col,int row_major);
+int nar_iv_scatter(nar_iv v,const int *idx,int count,int const *in);
+int nar_iv_gather(int *out,nar_iv v,const int *idx,int count);
+int nar_iv_set_range(nar_iv v,int start,int end,int const *in);
+int nar_iv_get_range(int *out,nar_iv v,int start,int end);
 int nar_im_set_safe(nar_im mat,int i,int j,int x);
 int nar_im_get_safe(int *x,nar_im mat,int i,int j);
 int nar_iv_set_safe(nar_iv v,int i,int x);
@@ -339,33 +1181,41 @@ void nar_im_set(nar_im mat,int i,int j,int x);
 int nar_im_get(nar_im mat,int i,int j);
 void nar_iv_set(nar_iv v,int i,int x);
 int nar_iv_get(nar_iv v,int i);
-char *nar_iv_display_string(nar_iv v);
-char *nar_im_display_string(nar_im mat);
-int nar_im_assign(nar_im mat1,nar_im mat2);
-int nar_im_eq(nar_im mat1,nar_im mat2);
 int nar_im_get_cols(nar_im mat);
 int nar_im_get_rows(nar_im mat);
+int nar_im_inc_col(nar_im mat);
+int nar_im_inc_row(nar_im mat);
 int nar_im_get_ld(nar_im mat);
-int *nar_im_pointer(nar_im mat);
 int nar_im_subarray_safe(nar_im *x,nar_im mat,int start_row,int start_col,int end_row,int end_col);
 int nar_im_col_safe(nar_iv *x,nar_im mat,int j);
 int nar_im_row_safe(nar_iv *x,nar_im mat,int i);
 nar_im nar_im_subarray(nar_im mat,int start_row,int start_col,int end_row,int end_col);
 nar_iv nar_im_col(nar_im mat,int j);
 nar_iv nar_im_row(nar_im mat,int i);
-enum nar_order nar_im_order(nar_im mat);
 int nar_im_valid(nar_im mat,int i,int j);
-nar_im nar_im_copy(nar_im mat);
-void nar_im_free(nar_im mat);
+nar_im nar_im_wrap(int *ptr,int rows,int cols,int inc_row,int inc_col,nar_release_fn release,void *ctx);
+nar_im nar_im_alloc_uninit(int rows,int cols,int row_major);
 nar_im nar_im_alloc(int rows,int cols,int row_major);
-int nar_iv_assign(nar_iv v1,nar_iv v2);
-int nar_iv_eq(nar_iv v1,nar_iv v2);
 int nar_iv_n(nar_iv v);
 int nar_iv_inc(nar_iv v);
-int *nar_iv_pointer(nar_iv v);
 int nar_iv_slice_safe(nar_iv *out,nar_iv v,int start,int end);
 nar_iv nar_iv_slice(nar_iv v,int start,int end);
 int nar_iv_valid(nar_iv v,int i);
+nar_iv nar_iv_wrap(int *ptr,int n,int inc,nar_release_fn release,void *ctx);
+nar_iv nar_iv_alloc_uninit(int n);
+nar_iv nar_iv_alloc(int n);
+char *nar_iv_display_string(nar_iv v);
+char *nar_im_display_string(nar_im mat);
+int nar_im_assign(nar_im mat1,nar_im mat2);
+int nar_im_eq(nar_im mat1,nar_im mat2);
+void nar_im_describe(nar_im mat,struct nar_view *out);
+int *nar_im_pointer(nar_im mat);
+enum nar_order nar_im_order(nar_im mat);
+nar_im nar_im_copy(nar_im mat);
+void nar_im_free(nar_im mat);
+int nar_iv_assign(nar_iv v1,nar_iv v2);
+int nar_iv_eq(nar_iv v1,nar_iv v2);
+void nar_iv_describe(nar_iv v,struct nar_view *out);
+int *nar_iv_pointer(nar_iv v);
 nar_iv nar_iv_copy(nar_iv v);
 void nar_iv_free(nar_iv v);
-nar_iv nar_iv_alloc(int n);
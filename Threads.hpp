@@ -0,0 +1,160 @@
+#ifndef _THREADS
+#define _THREADS
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <vector>
+#include <algorithm>
+
+#include "Arrays.hpp"
+
+// Number of threads for parallel kernels. 0 means one per core.
+inline std::atomic<int>& compute_threads() {
+    static std::atomic<int> threads(0);
+    return threads;
+}
+
+inline int compute_thread_count() {
+    int threads = compute_threads();
+    if (threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return threads;
+}
+
+// Number of tasks to split work into, so each task does at least
+// min_work, there are no more than max_tasks and no more than threads
+inline int parallel_tasks(Index work, Index min_work, Index max_tasks) {
+    Index tasks = std::min<Index>({work / min_work, max_tasks,
+        compute_thread_count()});
+    return std::max<Index>(tasks, 1);
+}
+
+// Start of part k of [0, n) split into parts pieces whose lengths are
+// multiples of r, except for the last
+inline Index split_start(Index n, Index r, int parts, int k) {
+    Index units = (n + r - 1) / r;
+    return std::min(n, units * k / parts * r);
+}
+
+// Threads kept for parallel kernels. run(tasks, f) calls f(k) for k in
+// [0, tasks), on the calling thread and tasks - 1 workers, and returns
+// once all calls have finished. Workers are started on first use and
+// wait for the next call in between. Calls from inside f, and calls from
+// other threads while the pool is busy, run their tasks one after
+// another on the calling thread.
+class ThreadPool {
+public:
+    ThreadPool() {}
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : workers) {
+            t.join();
+        }
+    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    // Rethrows the exception from the lowest numbered failed task
+    template <class F>
+    void run(int tasks, F f) {
+        std::unique_lock<std::mutex> busy;
+        if (tasks > 1 && !inside_task()) {
+            busy = std::unique_lock<std::mutex>(running, std::try_to_lock);
+        }
+        if (!busy.owns_lock()) {
+            for (int k = 0; k < tasks; ++k) {
+                f(k);
+            }
+            return;
+        }
+        while ((int) workers.size() < tasks - 1) {
+            int id = workers.size() + 1;
+            long seen = generation;
+            workers.emplace_back([this, id, seen]() { work(id, seen); });
+        }
+        std::function<void(int)> job(std::ref(f));
+        errors.assign(tasks, nullptr);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            current = &job;
+            task_count = tasks;
+            remaining = tasks - 1;
+            ++generation;
+        }
+        wake.notify_all();
+        call(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return remaining == 0; });
+        current = nullptr;
+        lock.unlock();
+        for (auto& e : errors) {
+            if (e) {
+                std::rethrow_exception(e);
+            }
+        }
+    }
+private:
+    // Whether this thread is running a task of the pool, so it mustn't
+    // wait for the pool. The caller may already hold running.
+    static bool& inside_task() {
+        thread_local bool inside = false;
+        return inside;
+    }
+    void call(int k) {
+        inside_task() = true;
+        try {
+            (*current)(k);
+        } catch (...) {
+            errors[k] = std::current_exception();
+        }
+        inside_task() = false;
+    }
+    // Runs task id of each call, from the call after the one numbered seen
+    void work(int id, long seen) {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this, seen]() {
+                    return stopping || generation != seen;
+                });
+                if (stopping) {
+                    return;
+                }
+                seen = generation;
+                if (id >= task_count) {
+                    continue;
+                }
+            }
+            call(id);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --remaining;
+            }
+            done.notify_one();
+        }
+    }
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors;
+    std::function<void(int)>* current = nullptr;
+    int task_count = 0, remaining = 0;
+    long generation = 0;
+    std::mutex running, mutex;
+    std::condition_variable wake, done;
+    bool stopping = false;
+};
+
+// Pool shared by all parallel kernels
+inline ThreadPool& thread_pool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+#endif
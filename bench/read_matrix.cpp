@@ -0,0 +1,96 @@
+// Times File<double>::read_matrix against the reader it replaced, which
+// found the dimensions with an istringstream per line and then parsed
+// the file a second time the same way.
+//
+// Usage: read_matrix [rows] [cols] [filename]
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+
+#include "../IO.hpp"
+
+// The previous File<T>::read_matrix
+template <class T>
+Matrix<T> legacy_read_matrix(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw FileError("Couldn't open " + filename);
+    }
+    std::string line;
+    Index rows = 0, cols = -1;
+    T x;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        Index line_cols = 0;
+        while (iss >> x) {
+            line_cols++;
+        }
+        if (cols < 0) {
+            cols = line_cols;
+        } else if (cols != line_cols) {
+            throw FormatError("Uneven line lengths.");
+        }
+        rows++;
+    }
+    file.clear();
+    file.seekg(0);
+    Matrix<T> out(rows, cols, true, uninitialized);
+    for (Index i = 0; i < rows; ++i) {
+        std::getline(file, line);
+        std::istringstream iss(line);
+        for (Index j = 0; j < cols; ++j) {
+            iss >> x;
+            if (iss.fail()) {
+                throw FormatError("Couldn't read value.");
+            }
+            out(i,j) = x;
+        }
+    }
+    return out;
+}
+
+template <class F>
+double seconds(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    Index rows = argc > 1 ? std::atol(argv[1]) : 200000;
+    Index cols = argc > 2 ? std::atol(argv[2]) : 50;
+    std::string filename = argc > 3 ? argv[3] : "read_matrix_bench.txt";
+    Matrix<double> mat(rows, cols);
+    std::mt19937 gen(1);
+    std::normal_distribution<double> dist;
+    for (Index i = 0; i < rows; ++i) {
+        for (Index j = 0; j < cols; ++j) {
+            mat(i,j) = dist(gen);
+        }
+    }
+    {
+        File<double> f(filename, ios_base::out | ios_base::trunc);
+        f.write_matrix(mat);
+    }
+    Matrix<double> before, after;
+    double legacy = seconds([&]() {
+        before = legacy_read_matrix<double>(filename);
+    });
+    double current = seconds([&]() {
+        File<double> f(filename, ios_base::in);
+        after = f.read_matrix();
+    });
+    std::remove(filename.c_str());
+    if (!(before == after)) {
+        std::printf("Readers disagree\n");
+        return 1;
+    }
+    std::printf("%ld x %ld doubles\n", (long) rows, (long) cols);
+    std::printf("istringstream reader: %.3f s\n", legacy);
+    std::printf("read_matrix:          %.3f s (%.1fx)\n",
+        current, legacy / current);
+    return 0;
+}
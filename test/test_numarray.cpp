@@ -0,0 +1,659 @@
+// Tests for libnumarray, run by make test. Kernels are compared with
+// naive loops, and files are written and read back in a scratch
+// directory. Failed checks are printed, and the exit status is 1 if
+// there were any.
+
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "numarray.h"
+#include "Expression.hpp"
+
+typedef std::complex<double> Complex;
+
+static int checks = 0, failures = 0;
+
+#define CHECK(condition) check(condition, #condition, __LINE__)
+
+void check(bool ok, const char* what, int line) {
+    ++checks;
+    if (!ok) {
+        ++failures;
+        std::printf("test_numarray.cpp:%d: failed: %s\n", line, what);
+    }
+}
+
+// Whether f throws E
+template <class E, class F>
+bool throws(F f) {
+    try {
+        f();
+    } catch (const E&) {
+        return true;
+    } catch (...) {
+    }
+    return false;
+}
+
+static std::mt19937 rng(12345);
+
+template <class T>
+T random_value() {
+    std::normal_distribution<double> normal;
+    if constexpr (std::is_same<T, Complex>::value) {
+        return Complex(normal(rng), normal(rng));
+    } else if constexpr (std::is_integral<T>::value) {
+        return T(std::uniform_int_distribution<int>(-100, 100)(rng));
+    } else {
+        return T(normal(rng));
+    }
+}
+
+template <class T>
+Matrix<T> random_matrix(Index rows, Index cols, bool row_major = true) {
+    Matrix<T> m(rows, cols, row_major);
+    for (Index i = 0; i < rows; ++i) {
+        for (Index j = 0; j < cols; ++j) {
+            m(i, j) = random_value<T>();
+        }
+    }
+    return m;
+}
+
+// A strided vector of n random values, every inc'th element of a matrix
+// column
+template <class T>
+Vector<T> random_vector(Index n, Index inc = 1) {
+    return random_matrix<T>(n, inc, false).col(0);
+}
+
+// Relative error allowed in sums of T
+template <class T>
+double sum_tolerance() {
+    return std::is_same<typename RealPart<T>::type, float>::value ?
+        1e-3 : 1e-9;
+}
+
+template <class T>
+bool close(T x, T y, double tolerance = 1e-10) {
+    return std::abs(x - y) <= tolerance * (1 + std::abs(y));
+}
+
+template <class T>
+bool close(const Matrix<T>& a, const Matrix<T>& b, double tolerance = 1e-10) {
+    if (a.get_rows() != b.get_rows() || a.get_cols() != b.get_cols()) {
+        return false;
+    }
+    for (Index i = 0; i < a.get_rows(); ++i) {
+        for (Index j = 0; j < a.get_cols(); ++j) {
+            if (!close(a(i, j), b(i, j), tolerance)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <class T>
+bool close(const Vector<T>& a, const Vector<T>& b, double tolerance = 1e-10) {
+    if (a.get_n() != b.get_n()) {
+        return false;
+    }
+    for (Index i = 0; i < a.get_n(); ++i) {
+        if (!close(a[i], b[i], tolerance)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Files go in a directory of their own, removed at the end
+static std::filesystem::path scratch;
+
+std::string scratch_file(const std::string& name) {
+    return (scratch / name).string();
+}
+
+// Arrays
+
+void test_copy_assign() {
+    Vector<double> x = random_vector<double>(5);
+    Vector<double> view = x;
+    Vector<double> copy = x.copy();
+    view[0] = 42;
+    CHECK(x[0] == 42);
+    CHECK(copy[0] != 42);
+    copy.assign(x);
+    CHECK(copy == x && copy.pointer() != x.pointer());
+    CHECK(throws<DimensionError>([&] { copy.assign(Vector<double>(4)); }));
+
+    Matrix<double> a = random_matrix<double>(3, 4);
+    Matrix<double> b(3, 4, false);
+    b.assign(a);
+    CHECK(b == a && b.get_order() == COL_MAJOR_ORDER);
+    Matrix<double> shared = a;
+    shared(2, 3) = -1;
+    CHECK(a(2, 3) == -1);
+    Matrix<double> sub = a.subarray(1, 1, 3, 4);
+    CHECK(sub.get_rows() == 2 && sub.get_cols() == 3 && sub(0, 0) == a(1, 1));
+    CHECK(a.row(2)[3] == -1 && a.col(3)[2] == -1);
+}
+
+void test_expressions() {
+    Index n = 1001;
+    Vector<double> x = random_vector<double>(n, 3);
+    Vector<double> z = random_vector<double>(n);
+    Vector<double> y;
+    y = 1.5 * x - z / 2 + 1;
+    bool ok = y.get_n() == n;
+    for (Index i = 0; ok && i < n; ++i) {
+        ok = close(y[i], 1.5 * x[i] - z[i] / 2 + 1);
+    }
+    CHECK(ok);
+
+    // = rebinds like copy assignment, assign writes in place
+    Vector<double> view = x;
+    double x0 = x[0];
+    view = x * 2.0;
+    CHECK(x[0] == x0 && view[0] == 2 * x0);
+    view = x;
+    view.assign(x + x);
+    CHECK(x[0] == 2 * x0);
+    CHECK(throws<DimensionError>([&] { z.assign(x + Vector<double>(2)); }));
+
+    // Scalars are promoted with the elements
+    Vector<int> vi(2);
+    vi[0] = 1;
+    vi[1] = 2;
+    Vector<double> promoted = 2.5 * vi;
+    CHECK(promoted[0] == 2.5 && promoted[1] == 5);
+    Vector<int> truncated = 2.5 * vi;
+    CHECK(truncated[0] == 2 && truncated[1] == 5);
+    Vector<std::complex<float>> c(1);
+    c[0] = {2, -1};
+    Vector<std::complex<float>> c2 = 0.5 * c + 1;
+    CHECK(c2[0] == std::complex<float>(2, -0.5f));
+
+    // Matrices of different orders
+    Matrix<double> a = random_matrix<double>(40, 30);
+    Matrix<double> b = random_matrix<double>(40, 30, false);
+    Matrix<double> c0 = random_matrix<double>(50, 50, false);
+    Matrix<double> cm = c0.subarray(3, 5, 43, 35);
+    Matrix<double> before = cm.copy();
+    cm.assign(0.5 * a - b * cm + 2);
+    ok = true;
+    for (Index i = 0; i < 40; ++i) {
+        for (Index j = 0; j < 30; ++j) {
+            ok = ok && close(cm(i, j),
+                0.5 * a(i, j) - b(i, j) * before(i, j) + 2);
+        }
+    }
+    CHECK(ok);
+}
+
+void test_runtime_expression() {
+    typedef RuntimeExpression E;
+    for (int threads : {1, 3}) {
+        compute_threads() = threads;
+        // Large enough to be split across threads
+        Index n = 3 * expr_min_work + 17;
+        Vector<double> x = random_vector<double>(n, 2);
+        Vector<double> y = random_vector<double>(n);
+        Vector<double> out(n);
+        E vx = E::variable(x), vy = E::variable(y);
+        E shared = E::binary(MULTIPLY_EXPR, vx, vy);
+        E e = E::binary(ADD_EXPR,
+            E::binary(SUBTRACT_EXPR, shared, E::unary(SIN_EXPR, vx)),
+            E::binary(MAX_EXPR, E::unary(ABS_EXPR, shared), E::constant(0.5)));
+        e.evaluate_into(out);
+        bool ok = true;
+        for (Index i = 0; ok && i < n; ++i) {
+            double s = x[i] * y[i];
+            ok = close(out[i], s - std::sin(x[i]) + std::max(std::abs(s), 0.5));
+        }
+        CHECK(ok);
+        // dest may be a variable
+        Vector<double> old = x.copy();
+        E::binary(DIVIDE_EXPR, E::unary(EXP_EXPR, vx), E::constant(2))
+            .evaluate_into(x);
+        ok = true;
+        for (Index i = 0; ok && i < n; ++i) {
+            ok = close(x[i], std::exp(old[i]) / 2);
+        }
+        CHECK(ok);
+
+        Matrix<double> a = random_matrix<double>(30, 20);
+        Matrix<double> b = random_matrix<double>(30, 20, false);
+        Matrix<double> m(30, 20, false);
+        E::binary(POW_EXPR, E::unary(ABS_EXPR, E::variable(a)),
+            E::variable(b)).evaluate_into(m);
+        ok = true;
+        for (Index i = 0; i < 30; ++i) {
+            for (Index j = 0; j < 20; ++j) {
+                ok = ok && close(m(i, j), std::pow(std::abs(a(i, j)), b(i, j)));
+            }
+        }
+        CHECK(ok);
+        CHECK(throws<DimensionError>([&] {
+            E::binary(ADD_EXPR, vx, E::variable(a)).evaluate_into(out);
+        }));
+    }
+    compute_threads() = 0;
+}
+
+// BLAS
+
+template <class T>
+void test_blas1() {
+    double tolerance = sum_tolerance<T>();
+    bool ok = true;
+    for (Index n : {0, 1, 7, 8, 9, 100, 1001}) {
+        for (Index inc : {1, 3}) {
+            Vector<T> x = random_vector<T>(n, inc);
+            Vector<T> y = random_vector<T>(n, inc);
+            T dot_xy = T(), dotc_xy = T();
+            double sum = 0, squares = 0, largest = -1;
+            Index largest_at = -1;
+            for (Index i = 0; i < n; ++i) {
+                dot_xy += x[i] * y[i];
+                dotc_xy += conjugate(x[i]) * y[i];
+                double m = magnitude(x[i]);
+                sum += m;
+                squares += std::norm(x[i]);
+                if (m > largest) {
+                    largest = m;
+                    largest_at = i;
+                }
+            }
+            ok = ok && close(dot(x, y), dot_xy, tolerance) &&
+                close(dotc(x, y), dotc_xy, tolerance);
+            ok = ok && close(double(asum(x)), sum, tolerance);
+            ok = ok && close(double(nrm2(x)), std::sqrt(squares), tolerance);
+            ok = ok && iamax(x) == largest_at;
+            Vector<T> expected = y.copy();
+            for (Index i = 0; i < n; ++i) {
+                expected[i] += T(3) * x[i];
+            }
+            axpy(T(3), x, y);
+            ok = ok && close(y, expected, tolerance);
+            scal(T(-2), y);
+            for (Index i = 0; i < n; ++i) {
+                expected[i] *= T(-2);
+            }
+            ok = ok && close(y, expected, tolerance);
+        }
+    }
+    CHECK(ok);
+    CHECK(throws<DimensionError>([] {
+        dot(Vector<T>(3), Vector<T>(4));
+    }));
+}
+
+void test_blas1_edges() {
+    // Integer sums don't wrap
+    Vector<int> big(4);
+    for (Index i = 0; i < 4; ++i) {
+        big[i] = i % 2 ? std::numeric_limits<int>::min() :
+            std::numeric_limits<int>::max();
+    }
+    CHECK(asum(big) == 4 * std::uint64_t(1u << 31) - 2);
+    CHECK(nar_iv_asum(&big) == 4 * std::uint64_t(1u << 31) - 2);
+    Vector<long> longs(2);
+    longs[0] = longs[1] = std::numeric_limits<long>::min();
+    CHECK(asum(longs) == 0); // 2^64 wraps
+
+    // The first NaN is the largest
+    Vector<double> x(4);
+    x[0] = 1;
+    x[1] = NAN;
+    x[2] = 5;
+    x[3] = NAN;
+    CHECK(iamax(x) == 1);
+    x[0] = NAN;
+    CHECK(iamax(x) == 0);
+    CHECK(iamax(Vector<double>(0)) == -1);
+
+    // Norms that would overflow or underflow when squared
+    Vector<double> huge(2), tiny(2);
+    huge[0] = huge[1] = 1e200;
+    tiny[0] = tiny[1] = 1e-200;
+    CHECK(close(nrm2(huge), std::sqrt(2.0) * 1e200));
+    CHECK(close(nrm2(tiny), std::sqrt(2.0) * 1e-200));
+}
+
+// op(a)(i,j)
+template <class T>
+T op(const Matrix<T>& a, Transpose trans, Index i, Index j) {
+    if (trans == NO_TRANSPOSE) {
+        return a(i, j);
+    }
+    return trans == TRANSPOSE ? a(j, i) : conjugate(a(j, i));
+}
+
+template <class T>
+void test_gemm() {
+    const Transpose transposes[] = {
+        NO_TRANSPOSE, TRANSPOSE, CONJUGATE_TRANSPOSE};
+    // The second size crosses the kc and mc cache blocks
+    const Index sizes[][3] = {{37, 29, 41}, {301, 70, 300}};
+    bool ok = true;
+    for (int threads : {1, 3}) {
+        compute_threads() = threads;
+        for (auto& size : sizes) {
+            Index m = size[0], n = size[1], k = size[2];
+            for (Transpose trans_a : transposes)
+            for (Transpose trans_b : transposes)
+            for (int orders = 0; orders < 8; ++orders) {
+                bool a_rows = trans_a == NO_TRANSPOSE;
+                bool b_rows = trans_b == NO_TRANSPOSE;
+                Matrix<T> a = random_matrix<T>(a_rows ? m : k,
+                    a_rows ? k : m, orders & 1);
+                Matrix<T> b = random_matrix<T>(b_rows ? k : n,
+                    b_rows ? n : k, orders & 2);
+                Matrix<T> c = random_matrix<T>(m, n, orders & 4);
+                T alpha = random_value<T>(), beta = random_value<T>();
+                Matrix<T> expected(m, n);
+                for (Index i = 0; i < m; ++i) {
+                    for (Index j = 0; j < n; ++j) {
+                        T sum = T();
+                        for (Index p = 0; p < k; ++p) {
+                            sum += op(a, trans_a, i, p) * op(b, trans_b, p, j);
+                        }
+                        expected(i, j) = alpha * sum + beta * c(i, j);
+                    }
+                }
+                gemm(alpha, a, trans_a, b, trans_b, beta, c);
+                ok = ok && close(c, expected, sum_tolerance<T>());
+            }
+        }
+    }
+    CHECK(ok);
+
+    // c isn't read when beta is 0
+    Matrix<T> a = random_matrix<T>(5, 6), b = random_matrix<T>(6, 7);
+    Matrix<T> c(5, 7);
+    for (Index i = 0; i < 5; ++i) {
+        for (Index j = 0; j < 7; ++j) {
+            c(i, j) = T(NAN);
+        }
+    }
+    gemm(T(1), a, NO_TRANSPOSE, b, NO_TRANSPOSE, T(), c);
+    T sum = T();
+    for (Index p = 0; p < 6; ++p) {
+        sum += a(4, p) * b(p, 6);
+    }
+    CHECK(close(c(4, 6), sum));
+    CHECK(throws<DimensionError>([&] {
+        gemm(T(1), a, TRANSPOSE, b, NO_TRANSPOSE, T(), c);
+    }));
+    compute_threads() = 0;
+}
+
+template <class T>
+void test_gemv() {
+    bool ok = true;
+    for (int threads : {1, 3}) {
+        compute_threads() = threads;
+        for (Transpose trans : {NO_TRANSPOSE, TRANSPOSE, CONJUGATE_TRANSPOSE})
+        for (bool row_major : {true, false}) {
+            Index m = 503, n = 97;
+            bool plain = trans == NO_TRANSPOSE;
+            Matrix<T> a = random_matrix<T>(plain ? m : n, plain ? n : m,
+                row_major);
+            Vector<T> x = random_vector<T>(n, 2);
+            Vector<T> y = random_vector<T>(m, 3);
+            T alpha = random_value<T>(), beta = random_value<T>();
+            Vector<T> expected(m);
+            for (Index i = 0; i < m; ++i) {
+                T sum = T();
+                for (Index j = 0; j < n; ++j) {
+                    sum += op(a, trans, i, j) * x[j];
+                }
+                expected[i] = alpha * sum + beta * y[i];
+            }
+            gemv(alpha, a, trans, x, beta, y);
+            ok = ok && close(y, expected, sum_tolerance<T>());
+            if (plain) {
+                Vector<T> product = a * x;
+                Vector<T> naive(m);
+                for (Index i = 0; i < m; ++i) {
+                    for (Index j = 0; j < n; ++j) {
+                        naive[i] += a(i, j) * x[j];
+                    }
+                }
+                ok = ok && close(product, naive, sum_tolerance<T>());
+            }
+        }
+    }
+    CHECK(ok);
+    CHECK(throws<DimensionError>([] {
+        Matrix<T> a(3, 4);
+        Vector<T> x(3);
+        Vector<T> y = a * x;
+    }));
+    compute_threads() = 0;
+}
+
+// Files
+
+void test_text() {
+    Matrix<double> m = random_matrix<double>(20, 7);
+    {
+        File<double> f(scratch_file("m.txt"), ios_base::out);
+        f.write_matrix(m, " ", 17); // Enough digits to read back exactly
+    }
+    File<double> f(scratch_file("m.txt"), ios_base::in);
+    CHECK(f.read_matrix(false) == m);
+    {
+        std::ofstream bad(scratch_file("bad.txt"));
+        bad << "1 2 3\n4 5\n";
+    }
+    CHECK(throws<FormatError>([] {
+        File<double>(scratch_file("bad.txt"), ios_base::in).read_matrix();
+    }));
+
+    MatrixReader<double> reader(scratch_file("m.txt"), false);
+    Index total = 0;
+    bool ok = true;
+    for (;;) {
+        const Matrix<double>& block = reader.next(6);
+        if (block.get_rows() == 0) {
+            break;
+        }
+        ok = ok && block == m.subarray(total, 0,
+            total + block.get_rows(), 7);
+        total += block.get_rows();
+    }
+    CHECK(ok && total == 20);
+}
+
+void test_binary(bool compressed) {
+    std::string name = scratch_file(compressed ? "c.bin" : "b.bin");
+    Index rows = 3001, cols = 13;
+    for (bool row_major : {true, false}) {
+        Matrix<double> m = random_matrix<double>(rows, cols, row_major);
+        {
+            BinaryFile<double> f(name, ios_base::out);
+            f.set_compressed(compressed);
+            f.write_matrix(m);
+        }
+        BinaryFile<double> f(name, ios_base::in);
+        CHECK(f.read_matrix(!row_major) == m);
+        Matrix<double> sub = f.read_subarray(1000, 3, 2999, 11, row_major);
+        CHECK(sub == m.subarray(1000, 3, 2999, 11));
+        CHECK(f.read_subarray(5, 5, 5, 9).get_rows() == 0);
+        CHECK(throws<FormatError>([&] { f.read_subarray(0, 0, rows + 1, 1); }));
+
+        MatrixReader<double> reader(name, true);
+        Index total = 0;
+        bool ok = true;
+        for (;;) {
+            const Matrix<double>& block = reader.next(700);
+            if (block.get_rows() == 0) {
+                break;
+            }
+            ok = ok && block == m.subarray(total, 0,
+                total + block.get_rows(), cols);
+            total += block.get_rows();
+        }
+        CHECK(ok && total == rows);
+    }
+    Vector<int> v = random_vector<int>(777, 2);
+    {
+        BinaryFile<int> f(name, ios_base::out);
+        f.set_compressed(compressed);
+        f.write_vector(v);
+    }
+    CHECK(BinaryFile<int>(name, ios_base::in).read_vector() == v);
+}
+
+void test_tiled() {
+    std::string name = scratch_file("t.bin");
+    Matrix<float> m = random_matrix<float>(250, 130, false);
+    {
+        TiledFile<float> f(name, ios_base::out);
+        f.write_matrix(m, 64, 48);
+    }
+    TiledFile<float> f(name, ios_base::in);
+    CHECK(f.read_matrix() == m);
+    CHECK(f.read_subarray(60, 40, 200, 100, false) ==
+        m.subarray(60, 40, 200, 100));
+    CHECK(throws<FormatError>([&] { f.read_subarray(0, 0, 251, 1); }));
+}
+
+void test_npy() {
+    std::string name = scratch_file("a.npy");
+    for (bool row_major : {true, false}) {
+        Matrix<double> m = random_matrix<double>(17, 9, row_major);
+        {
+            NpyFile<double> f(name, ios_base::out);
+            f.write_matrix(m);
+        }
+        CHECK(NpyFile<double>(name, ios_base::in).read_matrix() == m);
+    }
+    Vector<Complex> v = random_vector<Complex>(31, 3);
+    {
+        NpyFile<Complex> f(name, ios_base::out);
+        f.write_vector(v);
+    }
+    CHECK(NpyFile<Complex>(name, ios_base::in).read_vector() == v);
+    CHECK(throws<FormatError>([&] {
+        NpyFile<double>(name, ios_base::in).read_vector();
+    }));
+}
+
+void test_archive() {
+    std::string name = scratch_file("a.nar");
+    Vector<double> x = random_vector<double>(1000);
+    Matrix<float> m = random_matrix<float>(30, 20, false);
+    {
+        Archive a(name, WRITE_ARCHIVE);
+        a.put("x", x);
+        a.put("m", m);
+    }
+    {
+        Archive a(name, APPEND_ARCHIVE);
+        a.put("x", Vector<double>(x * 2.0));
+        a.put("y", x);
+    }
+    Archive a(name, READ_ARCHIVE);
+    CHECK(a.contains("m") && a.contains("y") && !a.contains("z"));
+    CHECK(a.get_matrix<float>("m") == m);
+    CHECK(a.get_vector<double>("y") == x);
+    Vector<double> mapped = a.map_vector<double>("x");
+    CHECK(mapped.get_n() == 1000 && mapped[999] == 2 * x[999]);
+    CHECK(throws<FormatError>([&] { a.get_vector<float>("x"); }));
+}
+
+// The C interface, which reports errors through codes
+
+void test_c_interface() {
+    int err = -1;
+    nar_dm missing = nar_dm_read_binary(scratch_file("none").c_str(), 1, &err);
+    CHECK(missing == nullptr && err == 1);
+    {
+        std::ofstream bad(scratch_file("bad.bin"), std::ios::binary);
+        bad << "not a matrix";
+    }
+    nar_dm corrupt = nar_dm_read_binary(scratch_file("bad.bin").c_str(), 1, &err);
+    CHECK(corrupt == nullptr && err == 2);
+
+    Matrix<double> m = random_matrix<double>(300, 40);
+    std::string name = scratch_file("capi.bin");
+    CHECK(nar_dm_write_binary(&m, name.c_str()) == 0);
+    for (int threads : {1, 3}) {
+        nar_set_io_threads(threads);
+        std::vector<nar_future> futures;
+        for (int i = 0; i < 4; ++i) {
+            futures.push_back(nar_dm_read_binary_async(name.c_str(), i % 2));
+        }
+        futures.push_back(nar_dm_read_binary_async(
+            scratch_file("none").c_str(), 1));
+        for (int i = 0; i < 4; ++i) {
+            nar_dm read = (nar_dm) nar_future_wait(futures[i], &err);
+            CHECK(read != nullptr && err == 0 && *read == m);
+            nar_dm_free(read);
+        }
+        CHECK(nar_future_wait(futures[4], &err) == nullptr && err == 1);
+    }
+    nar_set_io_threads(0);
+
+    nar_dm_reader reader = nar_dm_reader_open_binary(name.c_str(), &err);
+    CHECK(reader != nullptr && err == 0);
+    Index total = 0;
+    bool ok = true;
+    for (;;) {
+        nar_dm block = nar_dm_reader_next_64(reader, INT64_MAX, &err);
+        if (block == nullptr || nar_dm_get_rows(block) == 0) {
+            nar_dm_free(block);
+            break;
+        }
+        ok = ok && *block == m.subarray(total, 0,
+            total + block->get_rows(), 40);
+        total += block->get_rows();
+        nar_dm_free(block);
+    }
+    CHECK(ok && total == 300 && err == 0);
+    nar_dm_reader_close(reader);
+    CHECK(nar_dm_reader_open_binary(scratch_file("bad.bin").c_str(),
+        &err) == nullptr && err == 2);
+}
+
+int main() {
+    scratch = std::filesystem::temp_directory_path() /
+        ("numarray_test_" + std::to_string(getpid()));
+    std::filesystem::create_directories(scratch);
+
+    test_copy_assign();
+    test_expressions();
+    test_runtime_expression();
+    test_blas1<double>();
+    test_blas1<float>();
+    test_blas1<Complex>();
+    test_blas1<int>();
+    test_blas1_edges();
+    test_gemm<double>();
+    test_gemm<Complex>();
+    test_gemv<double>();
+    test_gemv<std::complex<float>>();
+    test_text();
+    test_binary(false);
+    test_binary(true);
+    test_tiled();
+    test_npy();
+    test_archive();
+    test_c_interface();
+
+    std::filesystem::remove_all(scratch);
+    std::printf("%d of %d checks failed\n", failures, checks);
+    return failures > 0;
+}